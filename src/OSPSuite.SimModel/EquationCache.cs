@@ -0,0 +1,116 @@
+﻿using System.Runtime.InteropServices;
+
+namespace OSPSuite.SimModel
+{
+   internal class EquationCacheImports
+   {
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetEquationCacheMaximumSize(int maximumSize);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetEquationCacheMaximumSize();
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void ClearEquationCache();
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void GetEquationCacheStatistics(out int size, out long hits, out long misses, out long evictions);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SaveEquationCache(string fileName, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int LoadEquationCache(string fileName, out bool success, out string errorMessage);
+   }
+
+   /// <summary>
+   /// Statistics of the equation cache (s. <see cref="EquationCache"/>)
+   /// </summary>
+   public class EquationCacheStatistics
+   {
+      /// <summary>
+      /// Number of cached equations
+      /// </summary>
+      public int Size { get; internal set; }
+
+      /// <summary>
+      /// Number of lookups which found the parsed equation in the cache
+      /// </summary>
+      public long Hits { get; internal set; }
+
+      /// <summary>
+      /// Number of lookups which did not find the parsed equation in the cache (equation was parsed)
+      /// </summary>
+      public long Misses { get; internal set; }
+
+      /// <summary>
+      /// Number of equations removed from the cache because it was full
+      /// </summary>
+      public long Evictions { get; internal set; }
+   }
+
+   /// <summary>
+   /// Process-wide cache of parsed equations, shared by all simulations with
+   /// <see cref="SimulationOptions.UseEquationCache"/> set.
+   /// Equations already parsed for another simulation (with the same inputs) are not parsed again while finalizing.
+   /// </summary>
+   public static class EquationCache
+   {
+      private static void evaluateCppCallResult(bool success, string errorMessage)
+      {
+         PInvokeHelper.EvaluateCppCallResult(success, errorMessage);
+      }
+
+      /// <summary>
+      /// Maximum number of cached equations (<value>0</value>: unbounded).
+      /// Least recently used equations are removed if the cache is full.
+      /// Default value is <value>10000</value>
+      /// </summary>
+      public static int MaximumSize
+      {
+         get => EquationCacheImports.GetEquationCacheMaximumSize();
+         set => EquationCacheImports.SetEquationCacheMaximumSize(value);
+      }
+
+      /// <summary>
+      /// Removes all equations from the cache and resets the statistics
+      /// </summary>
+      public static void Clear()
+      {
+         EquationCacheImports.ClearEquationCache();
+      }
+
+      /// <summary>
+      /// Current size and hit/miss statistics of the cache
+      /// </summary>
+      public static EquationCacheStatistics Statistics
+      {
+         get
+         {
+            EquationCacheImports.GetEquationCacheStatistics(out var size, out var hits, out var misses, out var evictions);
+            return new EquationCacheStatistics {Size = size, Hits = hits, Misses = misses, Evictions = evictions};
+         }
+      }
+
+      /// <summary>
+      /// Saves all cached equations to <paramref name="fileName"/> (e.g. to be loaded by the next process)
+      /// </summary>
+      public static void SaveToFile(string fileName)
+      {
+         EquationCacheImports.SaveEquationCache(fileName, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+      }
+
+      /// <summary>
+      /// Adds the equations saved by <see cref="SaveToFile"/> to the cache.
+      /// Files saved by another SimModel version are ignored.
+      /// </summary>
+      /// <returns>Number of equations added to the cache</returns>
+      public static int LoadFromFile(string fileName)
+      {
+         var numberOfEquations = EquationCacheImports.LoadEquationCache(fileName, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+         return numberOfEquations;
+      }
+   }
+}
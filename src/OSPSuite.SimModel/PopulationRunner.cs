@@ -0,0 +1,508 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+
+namespace OSPSuite.SimModel
+{
+   internal class PopulationRunnerImports
+   {
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern IntPtr CreatePopulationRunner(IntPtr simulation);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void DisposePopulationRunner(IntPtr populationRunner);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetPopulationRunnerNumberOfThreads(IntPtr populationRunner, int numberOfThreads);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetPopulationRunnerExecutionMode(IntPtr populationRunner, int executionMode);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetPopulationRunnerEnsembleSize(IntPtr populationRunner, int ensembleSize);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetPopulationVariableParameters(IntPtr populationRunner, [In] string[] entityIds, int size);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetPopulationVariableSpecies(IntPtr populationRunner, [In] string[] entityIds, int size);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetPopulationOutputs(IntPtr populationRunner, [In] string[] entityIds, int size);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetPopulationNumberOfTimePoints(IntPtr populationRunner, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void RunPopulation(IntPtr populationRunner, int numberOfIndividuals, [In] double[,] values,
+         [In, Out] double[] results, [In, Out] int[] statuses, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void CancelPopulationRun(IntPtr populationRunner);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetPopulationRunProgress(IntPtr populationRunner);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern string GetPopulationRunMessage(IntPtr populationRunner, int individual, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetPopulationNumberOfIndividualsSolvedInEnsembles(IntPtr populationRunner);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetPopulationNumberOfStolenTasks(IntPtr populationRunner);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern string GetPopulationEnsembleErrors(IntPtr populationRunner);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int FillPopulationWorkerProcesses(IntPtr populationRunner, [In, Out] int[] processIds, int size);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void FillPopulationTimeValues(IntPtr populationRunner, [In, Out] double[] timeValues, int size, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void StartPopulationStreamingRun(IntPtr populationRunner, int numberOfIndividuals, [In] double[,] values,
+         IntPtr callback, IntPtr userData, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern IntPtr GetNextPopulationResult(IntPtr populationRunner, int timeoutMs);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern bool IsPopulationStreamingRunCompleted(IntPtr populationRunner);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void ReleasePopulationResult(IntPtr populationRunner, IntPtr result);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void FinishPopulationStreamingRun(IntPtr populationRunner, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void GetIndividualResultProperties(IntPtr result, out int individual, out int status, out int numberOfOutputs, out int numberOfTimePoints);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern string GetIndividualResultMessage(IntPtr result);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern IntPtr GetIndividualResultTimeValues(IntPtr result);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern IntPtr GetIndividualResultValues(IntPtr result);
+   }
+
+   public enum IndividualRunStatus
+   {
+      Success = 0,
+      SuccessWithWarnings = 1,
+      Failed = 2
+   }
+
+   public enum PopulationExecutionMode
+   {
+      /// <summary>
+      /// Worker threads, each with its own copy of the simulation
+      /// </summary>
+      Threads = 0,
+
+      /// <summary>
+      /// Forked worker processes sharing the finalized simulation copy-on-write (Linux and macOS only).
+      /// A crashing worker process only fails the individual it was running
+      /// </summary>
+      Processes = 1
+   }
+
+   /// <summary>
+   /// Results of one population run. Values of all individuals are stored in one array
+   /// with the layout [individual x output x time point]
+   /// </summary>
+   public class PopulationRunResults
+   {
+      private readonly IList<string> _outputs;
+      private readonly IndividualRunStatus[] _statuses;
+      private readonly string[] _messages;
+
+      internal PopulationRunResults(IList<string> outputs, double[] times, double[] values, IndividualRunStatus[] statuses, string[] messages)
+      {
+         _outputs = outputs;
+         _statuses = statuses;
+         _messages = messages;
+         Times = times;
+         AllValues = values;
+      }
+
+      public int NumberOfIndividuals => _statuses.Length;
+
+      public int NumberOfTimePoints => Times.Length;
+
+      public IEnumerable<string> Outputs => _outputs;
+
+      /// <summary>
+      /// Output time points (empty if no individual could be simulated)
+      /// </summary>
+      public double[] Times { get; }
+
+      /// <summary>
+      /// Values of all outputs of all individuals: [individual x output x time point]
+      /// </summary>
+      public double[] AllValues { get; }
+
+      public IndividualRunStatus StatusFor(int individual) => _statuses[individual];
+
+      /// <summary>
+      /// Error message (failed run) or solver warnings of the individual
+      /// </summary>
+      public string MessageFor(int individual) => _messages[individual];
+
+      public double[] ValuesFor(int individual, string outputEntityId)
+      {
+         var outputIndex = _outputs.IndexOf(outputEntityId);
+         if (outputIndex < 0)
+            throw new ArgumentException($"{outputEntityId} is not an output of the population run");
+
+         var numberOfTimePoints = AllValues.Length / (NumberOfIndividuals * _outputs.Count);
+         var values = new double[numberOfTimePoints];
+         Array.Copy(AllValues, (individual * _outputs.Count + outputIndex) * numberOfTimePoints, values, 0, numberOfTimePoints);
+
+         return values;
+      }
+   }
+
+   /// <summary>
+   /// Result of one individual delivered by a streaming population run. 
+   /// Values are read directly from the native result buffer, which is reused for other individuals once the result is disposed
+   /// </summary>
+   public class IndividualPopulationResult : IDisposable
+   {
+      private readonly IntPtr _populationRunner;
+      private readonly IList<string> _outputs;
+      private IntPtr _result;
+      private readonly int _numberOfTimePoints;
+
+      internal IndividualPopulationResult(IntPtr populationRunner, IntPtr result, IList<string> outputs)
+      {
+         _populationRunner = populationRunner;
+         _result = result;
+         _outputs = outputs;
+
+         PopulationRunnerImports.GetIndividualResultProperties(_result, out var individual, out var status, out _, out _numberOfTimePoints);
+         Individual = individual;
+         Status = (IndividualRunStatus) status;
+         Message = PopulationRunnerImports.GetIndividualResultMessage(_result);
+      }
+
+      /// <summary>
+      /// Index of the individual (row of the values matrix)
+      /// </summary>
+      public int Individual { get; }
+
+      public IndividualRunStatus Status { get; }
+
+      /// <summary>
+      /// Error message (failed run) or solver warnings of the individual
+      /// </summary>
+      public string Message { get; }
+
+      /// <summary>
+      /// Output time points (empty if no individual of the worker could be simulated so far)
+      /// </summary>
+      public double[] Times
+      {
+         get
+         {
+            var timeValues = PopulationRunnerImports.GetIndividualResultTimeValues(validResult());
+            var times = new double[timeValues == IntPtr.Zero ? 0 : _numberOfTimePoints];
+            if (times.Length > 0)
+               Marshal.Copy(timeValues, times, 0, times.Length);
+
+            return times;
+         }
+      }
+
+      public double[] ValuesFor(string outputEntityId)
+      {
+         var outputIndex = _outputs.IndexOf(outputEntityId);
+         if (outputIndex < 0)
+            throw new ArgumentException($"{outputEntityId} is not an output of the population run");
+
+         var values = new double[_numberOfTimePoints];
+         if (values.Length > 0)
+         {
+            var allValues = PopulationRunnerImports.GetIndividualResultValues(validResult());
+            Marshal.Copy(IntPtr.Add(allValues, outputIndex * _numberOfTimePoints * sizeof(double)), values, 0, values.Length);
+         }
+
+         return values;
+      }
+
+      private IntPtr validResult()
+      {
+         if (_result == IntPtr.Zero)
+            throw new ObjectDisposedException(nameof(IndividualPopulationResult));
+
+         return _result;
+      }
+
+      /// <summary>
+      /// Returns the native result buffer to the population runner
+      /// </summary>
+      public void Dispose()
+      {
+         if (_result == IntPtr.Zero)
+            return;
+
+         PopulationRunnerImports.ReleasePopulationResult(_populationRunner, _result);
+         _result = IntPtr.Zero;
+      }
+   }
+
+   /// <summary>
+   /// Runs a finalized simulation for many individuals on a native thread pool.
+   /// All varied parameters and species must be set as variable before finalizing the simulation.
+   /// </summary>
+   public class PopulationRunner : IDisposable
+   {
+      private readonly IntPtr _populationRunner;
+      private IList<string> _variableParameters = new List<string>();
+      private IList<string> _variableSpecies = new List<string>();
+      private IList<string> _outputs = new List<string>();
+      private int _numberOfThreads;
+      private PopulationExecutionMode _executionMode = PopulationExecutionMode.Threads;
+      private int _ensembleSize = 1;
+      private bool _disposed = false;
+
+      private void evaluateCppCallResult(bool success, string errorMessage)
+      {
+         PInvokeHelper.EvaluateCppCallResult(success, errorMessage);
+      }
+
+      public PopulationRunner(Simulation simulation)
+      {
+         _populationRunner = PopulationRunnerImports.CreatePopulationRunner(simulation.Handle);
+      }
+
+      /// <summary>
+      /// Number of threads used. Default value is 0 (= number of hardware threads)
+      /// </summary>
+      public int NumberOfThreads
+      {
+         get => _numberOfThreads;
+         set
+         {
+            _numberOfThreads = value;
+            PopulationRunnerImports.SetPopulationRunnerNumberOfThreads(_populationRunner, value);
+         }
+      }
+
+      /// <summary>
+      /// Execution mode of the population run. Default is <see cref="PopulationExecutionMode.Threads"/>
+      /// </summary>
+      public PopulationExecutionMode ExecutionMode
+      {
+         get => _executionMode;
+         set
+         {
+            _executionMode = value;
+            PopulationRunnerImports.SetPopulationRunnerExecutionMode(_populationRunner, (int) value);
+         }
+      }
+
+      /// <summary>
+      /// Number of individuals solved together as one block-diagonal ODE system by a worker thread
+      /// (<see cref="PopulationExecutionMode.Threads"/> only). Pays off for small models.
+      /// Default value is 1 (every individual is solved on its own)
+      /// </summary>
+      public int EnsembleSize
+      {
+         get => _ensembleSize;
+         set
+         {
+            _ensembleSize = value;
+            PopulationRunnerImports.SetPopulationRunnerEnsembleSize(_populationRunner, value);
+         }
+      }
+
+      /// <summary>
+      /// Entity ids of the parameters varied per individual (first columns of the values matrix)
+      /// </summary>
+      public IEnumerable<string> VariableParameters
+      {
+         get => _variableParameters;
+         set
+         {
+            _variableParameters = value.ToList();
+            PopulationRunnerImports.SetPopulationVariableParameters(_populationRunner, _variableParameters.ToArray(), _variableParameters.Count);
+         }
+      }
+
+      /// <summary>
+      /// Entity ids of the species whose initial values are varied per individual 
+      /// (columns of the values matrix following the variable parameters)
+      /// </summary>
+      public IEnumerable<string> VariableSpecies
+      {
+         get => _variableSpecies;
+         set
+         {
+            _variableSpecies = value.ToList();
+            PopulationRunnerImports.SetPopulationVariableSpecies(_populationRunner, _variableSpecies.ToArray(), _variableSpecies.Count);
+         }
+      }
+
+      /// <summary>
+      /// Entity ids of the (persistable) species and observers returned for every individual
+      /// </summary>
+      public IEnumerable<string> Outputs
+      {
+         get => _outputs;
+         set
+         {
+            _outputs = value.ToList();
+            PopulationRunnerImports.SetPopulationOutputs(_populationRunner, _outputs.ToArray(), _outputs.Count);
+         }
+      }
+
+      /// <summary>
+      /// Runs the simulation for all individuals. 
+      /// </summary>
+      /// <param name="values">[individual x (variable parameters, variable species)]</param>
+      public PopulationRunResults Run(double[,] values)
+      {
+         var numberOfIndividuals = values.GetLength(0);
+         if (values.GetLength(1) != _variableParameters.Count + _variableSpecies.Count)
+            throw new ArgumentException("Number of columns does not match the number of variable parameters and species");
+
+         var numberOfTimePoints = PopulationRunnerImports.GetPopulationNumberOfTimePoints(_populationRunner, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+
+         var results = new double[numberOfIndividuals * _outputs.Count * numberOfTimePoints];
+         var statuses = new int[numberOfIndividuals];
+
+         PopulationRunnerImports.RunPopulation(_populationRunner, numberOfIndividuals, values, results, statuses, out success, out errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+
+         var messages = new string[numberOfIndividuals];
+         for (var individual = 0; individual < numberOfIndividuals; individual++)
+         {
+            messages[individual] = PopulationRunnerImports.GetPopulationRunMessage(_populationRunner, individual, out success, out errorMessage);
+            evaluateCppCallResult(success, errorMessage);
+         }
+
+         var times = new double[statuses.Any(s => s != (int) IndividualRunStatus.Failed) ? numberOfTimePoints : 0];
+         PopulationRunnerImports.FillPopulationTimeValues(_populationRunner, times, times.Length, out success, out errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+
+         return new PopulationRunResults(_outputs.ToList(), times, results, statuses.Select(s => (IndividualRunStatus) s).ToArray(), messages);
+      }
+
+      /// <summary>
+      /// Starts the population run in the background (thread execution mode only). 
+      /// Results of the individuals are retrieved by <see cref="NextResult"/> as soon as they are finished
+      /// </summary>
+      /// <param name="values">[individual x (variable parameters, variable species)]</param>
+      public void StartStreaming(double[,] values)
+      {
+         if (values.GetLength(1) != _variableParameters.Count + _variableSpecies.Count)
+            throw new ArgumentException("Number of columns does not match the number of variable parameters and species");
+
+         PopulationRunnerImports.StartPopulationStreamingRun(_populationRunner, values.GetLength(0), values, IntPtr.Zero, IntPtr.Zero, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+      }
+
+      /// <summary>
+      /// Next finished individual of the streaming run or null if no result was available within <paramref name="timeoutMs"/>
+      /// (0: don't wait; -1: wait until a result is available or the run is completed). 
+      /// Returned result must be disposed to make its buffer available for other individuals
+      /// </summary>
+      public IndividualPopulationResult NextResult(int timeoutMs = -1)
+      {
+         var result = PopulationRunnerImports.GetNextPopulationResult(_populationRunner, timeoutMs);
+         return result == IntPtr.Zero ? null : new IndividualPopulationResult(_populationRunner, result, _outputs.ToList());
+      }
+
+      /// <summary>
+      /// True if all results of the streaming run were retrieved
+      /// </summary>
+      public bool StreamingCompleted => PopulationRunnerImports.IsPopulationStreamingRunCompleted(_populationRunner);
+
+      /// <summary>
+      /// Waits until the streaming run is finished
+      /// </summary>
+      public void FinishStreaming()
+      {
+         PopulationRunnerImports.FinishPopulationStreamingRun(_populationRunner, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+      }
+
+      /// <summary>
+      /// Cancels the population run started in another thread. 
+      /// Individuals which were not simulated completely are marked as failed
+      /// </summary>
+      public void Cancel()
+      {
+         PopulationRunnerImports.CancelPopulationRun(_populationRunner);
+      }
+
+      /// <summary>
+      /// Progress (0..100) of the running population simulation
+      /// </summary>
+      public int Progress => PopulationRunnerImports.GetPopulationRunProgress(_populationRunner);
+
+      /// <summary>
+      /// Number of individuals of the latest run solved in ensembles (s. <see cref="EnsembleSize"/>).
+      /// All other individuals were run on their own
+      /// </summary>
+      public int NumberOfIndividualsSolvedInEnsembles => PopulationRunnerImports.GetPopulationNumberOfIndividualsSolvedInEnsembles(_populationRunner);
+
+      /// <summary>
+      /// Number of individuals (or ensembles) of the latest run (<see cref="PopulationExecutionMode.Threads"/> only)
+      /// taken over by another worker thread than the one they were scheduled for
+      /// </summary>
+      public int NumberOfStolenTasks => PopulationRunnerImports.GetPopulationNumberOfStolenTasks(_populationRunner);
+
+      /// <summary>
+      /// Process ids of the worker processes of the current run (<see cref="PopulationExecutionMode.Processes"/> only)
+      /// </summary>
+      public IEnumerable<int> WorkerProcessIds
+      {
+         get
+         {
+            var processIds = new int[0];
+            int numberOfProcesses;
+
+            //workers might be started in the meantime
+            while ((numberOfProcesses = PopulationRunnerImports.FillPopulationWorkerProcesses(_populationRunner, processIds, processIds.Length)) > processIds.Length)
+               processIds = new int[numberOfProcesses];
+
+            return processIds.Take(numberOfProcesses).ToList();
+         }
+      }
+
+      /// <summary>
+      /// Errors of the ensembles of the latest run which failed as a whole (their individuals were run on their own)
+      /// </summary>
+      public IEnumerable<string> EnsembleErrors =>
+         PopulationRunnerImports.GetPopulationEnsembleErrors(_populationRunner).Split(new[] {'\n'}, StringSplitOptions.RemoveEmptyEntries);
+
+      public void Dispose()
+      {
+         Dispose(true);
+         GC.SuppressFinalize(this);
+      }
+
+      ~PopulationRunner()
+      {
+         Dispose(false);
+      }
+
+      protected virtual void Dispose(bool disposing)
+      {
+         if (_disposed)
+            return;
+
+         PopulationRunnerImports.DisposePopulationRunner(_populationRunner);
+
+         _disposed = true;
+      }
+   }
+}
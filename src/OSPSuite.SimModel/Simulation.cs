@@ -25,9 +25,33 @@ internal class SimulationImports
       [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
       public static extern void FinalizeSimulation(IntPtr simulation, out bool success, out string errorMessage);
 
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern IntPtr CloneSimulation(IntPtr simulation, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SavePreparsedModel(IntPtr simulation, string fileName, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void LoadSimulationFromPreparsedModel(IntPtr simulation, string fileName, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetNumberOfVariableParameters(IntPtr simulation);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void FillVariableParameterIndices(IntPtr simulation, [In, Out] int[] parameterIndices, int size, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetNumberOfVariableSpecies(IntPtr simulation);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void FillVariableSpeciesIndices(IntPtr simulation, [In, Out] int[] speciesIndices, int size, out bool success, out string errorMessage);
+
       [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
       public static extern int GetSimulationProgress(IntPtr simulation);
 
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetNumberOfDeferredFormulas(IntPtr simulation);
+
       [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
       public static extern void CancelSimulationRun(IntPtr simulation);
 
@@ -43,6 +67,9 @@ internal class SimulationImports
       [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
       public static extern void RunSimulation(IntPtr simulation, out bool toleranceWasReduced, out double newAbsTol, out double newRelTol, out bool success, out string errorMessage);
 
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void FillSimulationRunStatistics(IntPtr simulation, ref SimulationRunStatisticsStructure statistics);
+
       [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
       public static extern int GetNumberOfTimePoints(IntPtr simulation);
 
@@ -235,9 +262,13 @@ private void evaluateCppCallResult(bool success, string errorMessage)
          PInvokeHelper.EvaluateCppCallResult(success, errorMessage);
       }
 
-      public Simulation()
+      public Simulation() : this(SimulationImports.CreateSimulation())
+      {
+      }
+
+      private Simulation(IntPtr simulation)
       {
-         _simulation = SimulationImports.CreateSimulation();
+         _simulation = simulation;
 
          _allParameters = SimulationImports.CreateParameterInfoVector();
          _variableParameters = new List<ParameterProperties>();
@@ -283,6 +314,90 @@ public void LoadFromXMLString(string xmlString)
          fillParameterAndSpeciesProperties();
       }
 
+      /// <summary>
+      /// Load simulation from a preparsed model created by <see cref="SavePreparsedModel"/>.
+      /// XML parsing, schema validation and parsing of the equations are skipped; all other steps of
+      /// loading and finalizing are performed as for the simulation XML.
+      /// Simulation is finalized; variable parameters and species are the same as in the
+      /// saved simulation and have the values they had when it was saved
+      /// </summary>
+      /// <param name="fileName">Full path of a preparsed model file</param>
+      public void LoadFromPreparsedModel(string fileName)
+      {
+         SimulationImports.LoadSimulationFromPreparsedModel(_simulation, fileName, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+
+         fillParameterAndSpeciesProperties();
+
+         //variable parameters and species were already set by the native simulation
+         var parameterIndices = nativeVariableParameterIndices();
+         var speciesIndices = nativeVariableSpeciesIndices();
+
+         //values of the preparsed model are set by finalize
+         FinalizeSimulation();
+
+         setVariablePropertiesFrom(parameterIndices, speciesIndices);
+      }
+
+      /// <summary>
+      /// Creates a finalized copy of the (finalized) simulation with the same variable parameters and species and their current values.
+      /// The copy can be run independently of this simulation. It is a reload of the simulation: only parsing of the XML text
+      /// and the schema validation are skipped, loading and finalizing are repeated (so cloning takes almost as long as loading).
+      /// If the XML DOM was released or not created (<see cref="SimulationOptions.LeanMode"/>, <see cref="SimulationOptions.StreamingXMLLoad"/>),
+      /// the simulation must keep its XML string (<see cref="SimulationOptions.KeepXMLNodeAsString"/>)
+      /// </summary>
+      public Simulation Clone()
+      {
+         var nativeClone = SimulationImports.CloneSimulation(_simulation, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+
+         var clone = new Simulation(nativeClone);
+         clone.fillParameterAndSpeciesProperties();
+         clone.setVariablePropertiesFrom(clone.nativeVariableParameterIndices(), clone.nativeVariableSpeciesIndices());
+
+         return clone;
+      }
+
+      private int[] nativeVariableParameterIndices()
+      {
+         var numberOfVariableParameters = SimulationImports.GetNumberOfVariableParameters(_simulation);
+         var parameterIndices = new int[numberOfVariableParameters];
+         SimulationImports.FillVariableParameterIndices(_simulation, parameterIndices, numberOfVariableParameters, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+
+         return parameterIndices;
+      }
+
+      private int[] nativeVariableSpeciesIndices()
+      {
+         var numberOfVariableSpecies = SimulationImports.GetNumberOfVariableSpecies(_simulation);
+         var speciesIndices = new int[numberOfVariableSpecies];
+         SimulationImports.FillVariableSpeciesIndices(_simulation, speciesIndices, numberOfVariableSpecies, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+
+         return speciesIndices;
+      }
+
+      private void setVariablePropertiesFrom(int[] parameterIndices, int[] speciesIndices)
+      {
+         var allParameters = ParameterProperties.ToList();
+         _variableParameters = parameterIndices.Select(idx => allParameters[idx]).ToList();
+
+         var allSpecies = SpeciesProperties.ToList();
+         _variableSpecies = speciesIndices.Select(idx => allSpecies[idx]).ToList();
+      }
+
+      /// <summary>
+      /// Save the (finalized) simulation as preparsed model, which is loaded without XML parsing, schema validation
+      /// and equation parsing (s. <see cref="LoadFromPreparsedModel"/>). It is not a serialization of the finalized simulation. Simulation must have been loaded from XML or from a preparsed model
+      /// </summary>
+      /// <param name="fileName">Full path of the preparsed model file</param>
+      public void SavePreparsedModel(string fileName)
+      {
+         SimulationImports.SavePreparsedModel(_simulation, fileName, out var success, out var errorMessage);
+         evaluateCppCallResult(success, errorMessage);
+      }
+
       private void fillParameterAndSpeciesProperties()
       {
          SimulationImports.FillParameterProperties(_simulation, _allParameters, out var success, out var errorMessage);
@@ -306,6 +421,12 @@ public void FinalizeSimulation()
       /// </summary>
       public int Progress => SimulationImports.GetSimulationProgress(_simulation);
 
+      /// <summary>
+      /// Number of formulas not finalized yet because they are not required for the simulation run
+      /// (s. <see cref="SimulationOptions.LazyFinalize"/>)
+      /// </summary>
+      public int NumberOfDeferredFormulas => SimulationImports.GetNumberOfDeferredFormulas(_simulation);
+
       /// <summary>
       /// Cancels current simulation run
       /// </summary>
@@ -316,6 +437,8 @@ public void Cancel()
 
       internal string ObjectPathDelimiter => SimulationImports.GetObjectPathDelimiter(_simulation);
 
+      internal IntPtr Handle => _simulation;
+
       public void RunSimulation()
       {
          SimulationImports.RunSimulation(_simulation, out var toleranceWasReduced,out var newAbsTol,out var newRelTol, out var success, out var errorMessage);
@@ -324,6 +447,7 @@ public void RunSimulation()
          RunStatistics.ToleranceWasReduced = toleranceWasReduced;
          RunStatistics.UsedAbsoluteTolerance = newAbsTol;
          RunStatistics.UsedRelativeTolerance = newRelTol;
+         RunStatistics.UpdateFromSimulation();
 
          fillSolverWarnings();
       }
@@ -33,6 +33,26 @@ internal struct SimulationOptionsStructure
 
       [MarshalAs(UnmanagedType.I1)]
       public bool UseFloatComparisonInUserOutputTimePoints;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool AutoSolverConfiguration;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool SolveLinearSystemsExactly;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool StreamingXMLLoad;
+
+      public int NumberOfFinalizeThreads;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool UseEquationCache;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool LazyFinalize;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool LeanMode;
    }
 
    public class SimulationOptions
@@ -153,6 +173,98 @@ public bool UseFloatComparisonInUserOutputTimePoints
          set => setOptions(() => _simulationOptions.UseFloatComparisonInUserOutputTimePoints = value);
       }
 
+      /// <summary>
+      /// If set to <value>true</value>, the linear solver (dense or band) and the integration method (BDF or Adams)
+      /// are selected automatically from the size, the bandwidth and the stiffness of the ODE system.
+      /// Must be set BEFORE finalizing the simulation.
+      /// The selected configuration is reported in <see cref="SimulationRunStatistics"/>.
+      /// Default value is <value>false</value>
+      /// </summary>
+      public bool AutoSolverConfiguration
+      {
+         get => _simulationOptions.AutoSolverConfiguration;
+         set => setOptions(() => _simulationOptions.AutoSolverConfiguration = value);
+      }
+
+      /// <summary>
+      /// If set to <value>true</value>, ODE systems which are linear with constant coefficients between
+      /// switch points (e.g. linear PK models) are solved by the action of the matrix exponential
+      /// instead of the CVODES integrator. Intended for non-stiff linear systems.
+      /// Whether the system is linear is checked at the start of every simulation run.
+      /// Default value is <value>false</value>
+      /// </summary>
+      public bool SolveLinearSystemsExactly
+      {
+         get => _simulationOptions.SolveLinearSystemsExactly;
+         set => setOptions(() => _simulationOptions.SolveLinearSystemsExactly = value);
+      }
+
+      /// <summary>
+      /// If set to <value>true</value>, the simulation XML is read element by element
+      /// without keeping the XML document in memory, which reduces the peak memory during loading.
+      /// Simulations loaded this way cannot be cloned or saved as preparsed model.
+      /// Must be set BEFORE loading the simulation.
+      /// Default value is <value>false</value>
+      /// </summary>
+      public bool StreamingXMLLoad
+      {
+         get => _simulationOptions.StreamingXMLLoad;
+         set => setOptions(() => _simulationOptions.StreamingXMLLoad = value);
+      }
+
+      /// <summary>
+      /// Number of threads used for finalizing the formulas of the simulation.
+      /// <value>1</value>: formulas are finalized sequentially; values &lt;= 0: number of hardware threads.
+      /// The finalized simulation does not depend on the number of threads.
+      /// Must be set BEFORE finalizing the simulation.
+      /// Default value is <value>1</value>
+      /// </summary>
+      public int NumberOfFinalizeThreads
+      {
+         get => _simulationOptions.NumberOfFinalizeThreads;
+         set => setOptions(() => _simulationOptions.NumberOfFinalizeThreads = value);
+      }
+
+      /// <summary>
+      /// If set to <value>true</value>: parsed equations are taken from (and added to) the process-wide
+      /// <see cref="EquationCache"/>, so equations already parsed for another simulation are not parsed again.
+      /// Must be set BEFORE finalizing the simulation.
+      /// Default value is <value>false</value>
+      /// </summary>
+      public bool UseEquationCache
+      {
+         get => _simulationOptions.UseEquationCache;
+         set => setOptions(() => _simulationOptions.UseEquationCache = value);
+      }
+
+      /// <summary>
+      /// If set to <value>true</value>: only formulas used by species, observers and switches
+      /// (directly or via the parameters they use) are finalized with the simulation.
+      /// All other formulas are finalized on demand (e.g. when their parameter properties are filled).
+      /// Simulation results do not depend on this option.
+      /// Must be set BEFORE finalizing the simulation.
+      /// Default value is <value>false</value>
+      /// </summary>
+      public bool LazyFinalize
+      {
+         get => _simulationOptions.LazyFinalize;
+         set => setOptions(() => _simulationOptions.LazyFinalize = value);
+      }
+
+      /// <summary>
+      /// If set to <value>true</value>: the XML document of the simulation is released after finalizing,
+      /// which reduces the memory of a finalized simulation.
+      /// Simulation cannot be cloned or saved as preparsed model then.
+      /// <see cref="Simulation.SimulationXMLString"/> is still available if <see cref="KeepXMLNodeAsString"/> is set.
+      /// Must be set BEFORE finalizing the simulation.
+      /// Default value is <value>false</value>
+      /// </summary>
+      public bool LeanMode
+      {
+         get => _simulationOptions.LeanMode;
+         set => setOptions(() => _simulationOptions.LeanMode = value);
+      }
+
       public string LogFile
       {
          get => _logFile;
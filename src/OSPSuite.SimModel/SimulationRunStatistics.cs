@@ -1,7 +1,39 @@
 ﻿using System;
+using System.Runtime.InteropServices;
 
 namespace OSPSuite.SimModel
 {
+   internal struct SimulationRunStatisticsStructure
+   {
+      public double SetupTime;
+
+      public double SolveTime;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool SolverInstanceReused;
+
+      public int AvoidedSolverRestarts;
+
+      public int ScheduledSwitches;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool BandLinearSolverUsed;
+
+      public int LowerHalfBandWidth;
+
+      public int UpperHalfBandWidth;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool AdamsMethodUsed;
+
+      public double SpectralRadiusEstimate;
+
+      [MarshalAs(UnmanagedType.I1)]
+      public bool LinearSystemSolvedExactly;
+
+      public double BDFSwitchTime;
+   }
+
    /// <summary>
    /// Stores some information about successful simulation run: used tolerances, number of ODE variables, ...
    /// </summary>
@@ -15,6 +47,37 @@ public SimulationRunStatistics(IntPtr simulation)
          ToleranceWasReduced = false;
          UsedAbsoluteTolerance = double.NaN;
          UsedRelativeTolerance = double.NaN;
+         SetupTime = double.NaN;
+         SolveTime = double.NaN;
+         SolverInstanceReused = false;
+         AvoidedSolverRestarts = 0;
+         ScheduledSwitches = 0;
+         BandLinearSolverUsed = false;
+         LowerHalfBandWidth = 0;
+         UpperHalfBandWidth = 0;
+         AdamsMethodUsed = false;
+         SpectralRadiusEstimate = double.NaN;
+         LinearSystemSolvedExactly = false;
+         BDFSwitchTime = double.NaN;
+      }
+
+      internal void UpdateFromSimulation()
+      {
+         var statistics = new SimulationRunStatisticsStructure();
+         SimulationImports.FillSimulationRunStatistics(_simulation, ref statistics);
+
+         SetupTime = statistics.SetupTime;
+         SolveTime = statistics.SolveTime;
+         SolverInstanceReused = statistics.SolverInstanceReused;
+         AvoidedSolverRestarts = statistics.AvoidedSolverRestarts;
+         ScheduledSwitches = statistics.ScheduledSwitches;
+         BandLinearSolverUsed = statistics.BandLinearSolverUsed;
+         LowerHalfBandWidth = statistics.LowerHalfBandWidth;
+         UpperHalfBandWidth = statistics.UpperHalfBandWidth;
+         AdamsMethodUsed = statistics.AdamsMethodUsed;
+         SpectralRadiusEstimate = statistics.SpectralRadiusEstimate;
+         LinearSystemSolvedExactly = statistics.LinearSystemSolvedExactly;
+         BDFSwitchTime = statistics.BDFSwitchTime;
       }
 
       /// <summary>
@@ -37,5 +100,74 @@ public SimulationRunStatistics(IntPtr simulation)
       /// </summary>
       public double UsedRelativeTolerance { get; internal set; }
 
+      /// <summary>
+      /// Returns time (in seconds) spent for preparing the ODE system and the solver
+      /// (calculation of initial values and output time points, creating or reinitializing the solver instance)
+      /// </summary>
+      public double SetupTime { get; internal set; }
+
+      /// <summary>
+      /// Returns time (in seconds) spent for solving the ODE system
+      /// </summary>
+      public double SolveTime { get; internal set; }
+
+      /// <summary>
+      /// Returns true, if the solver instance of the previous run was reinitialized instead of creating a new one.
+      /// (can only be the case if problem size and solver settings did not change between the runs)
+      /// </summary>
+      public bool SolverInstanceReused { get; internal set; }
+
+      /// <summary>
+      /// Returns the number of switch updates which did not require a solver restart
+      /// (because changed quantities are not used in the ODE system or were changed continuously)
+      /// </summary>
+      public int AvoidedSolverRestarts { get; internal set; }
+
+      /// <summary>
+      /// Returns the number of switches with time-only conditions (e.g. "Time = StartTime")
+      /// which were fired from the precompiled switch schedule
+      /// </summary>
+      public int ScheduledSwitches { get; internal set; }
+
+      /// <summary>
+      /// Returns true, if the band linear solver was used (otherwise: dense linear solver)
+      /// </summary>
+      public bool BandLinearSolverUsed { get; internal set; }
+
+      /// <summary>
+      /// Returns the lower half bandwidth of the ODE system (if band linear solver was used)
+      /// </summary>
+      public int LowerHalfBandWidth { get; internal set; }
+
+      /// <summary>
+      /// Returns the upper half bandwidth of the ODE system (if band linear solver was used)
+      /// </summary>
+      public int UpperHalfBandWidth { get; internal set; }
+
+      /// <summary>
+      /// Returns true, if the Adams method was used for the whole run (otherwise: BDF, at least from <see cref="BDFSwitchTime"/> on).
+      /// (can only be the case if <see cref="SimulationOptions.AutoSolverConfiguration"/> was set to <value>true</value>
+      /// </summary>
+      public bool AdamsMethodUsed { get; internal set; }
+
+      /// <summary>
+      /// Returns the estimated spectral radius of the Jacobian at the simulation start time, 
+      /// which was used to select the integration method.
+      /// NaN if <see cref="SimulationOptions.AutoSolverConfiguration"/> was set to <value>false</value>
+      /// </summary>
+      public double SpectralRadiusEstimate { get; internal set; }
+
+      /// <summary>
+      /// Returns true, if the ODE system was linear and was solved by the matrix exponential.
+      /// (can only be the case if <see cref="SimulationOptions.SolveLinearSystemsExactly"/> was set to <value>true</value>
+      /// </summary>
+      public bool LinearSystemSolvedExactly { get; internal set; }
+
+      /// <summary>
+      /// Returns the time at which the Adams method was replaced by BDF, because the system became stiff 
+      /// after a switch (the stiffness is re-checked at every solver restart).
+      /// NaN if the integration method was not changed during the run
+      /// </summary>
+      public double BDFSwitchTime { get; internal set; }
    }
 }
@@ -1,15 +1,90 @@
-﻿using System;
-using OSPSuite.Utility.Exceptions;
+﻿using System.Runtime.InteropServices;
 
 namespace OSPSuite.SimModel
 {
+   internal class XMLSchemaCacheImports
+   {
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void LoadXMLSchemaFromFile(string fileName, string schemaNamespace, out bool success, out string errorMessage);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      [return: MarshalAs(UnmanagedType.I1)]
+      public static extern bool XMLSchemaIsInitialized();
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void SetMaximumNumberOfValidatedContents(int maximumNumber);
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern int GetMaximumNumberOfValidatedContents();
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void ClearValidatedContents();
+
+      [DllImport(SimModelImportDefinitions.NATIVE_DLL, CallingConvention = SimModelImportDefinitions.CALLING_CONVENTION)]
+      public static extern void GetValidatedContentsStatistics(out int numberOfValidatedContents, out long skippedValidations);
+   }
+
+   /// <summary>
+   /// Process-wide simulation schema, used by simulations with <see cref="SimulationOptions.ValidateWithXMLSchema"/> set.
+   /// Simulation XMLs already validated with the current schema are not validated again.
+   /// </summary>
    public class XMLSchemaCache
    {
-      public static void InitializeFromFile(string schemaFile)
+      /// <summary>
+      /// Loads the simulation schema from <paramref name="schemaFile"/>.
+      /// All XML contents validated with the previous schema will be validated again.
+      /// </summary>
+      /// <param name="schemaFile">Schema file</param>
+      /// <param name="schemaNamespace">Target namespace of the schema (<value>null</value>: keep the current namespace)</param>
+      public static void InitializeFromFile(string schemaFile, string schemaNamespace = null)
+      {
+         XMLSchemaCacheImports.LoadXMLSchemaFromFile(schemaFile, schemaNamespace ?? string.Empty, out var success, out var errorMessage);
+         PInvokeHelper.EvaluateCppCallResult(success, errorMessage);
+      }
+
+      public static bool IsInitialized => XMLSchemaCacheImports.XMLSchemaIsInitialized();
+
+      /// <summary>
+      /// Maximum number of validated XML contents remembered (<value>0</value>: validation results are not cached).
+      /// Least recently validated contents are forgotten if the maximum is exceeded.
+      /// Default value is <value>1000</value>
+      /// </summary>
+      public static int MaximumNumberOfValidatedContents
+      {
+         get => XMLSchemaCacheImports.GetMaximumNumberOfValidatedContents();
+         set => XMLSchemaCacheImports.SetMaximumNumberOfValidatedContents(value);
+      }
+
+      /// <summary>
+      /// Number of XML contents remembered as validated with the current schema
+      /// </summary>
+      public static int NumberOfValidatedContents
       {
-         throw new Exception("Not implemented yet");
+         get
+         {
+            XMLSchemaCacheImports.GetValidatedContentsStatistics(out var numberOfValidatedContents, out _);
+            return numberOfValidatedContents;
+         }
       }
 
-      public static bool IsInitialized => throw new OSPSuiteException("Not implemented yet");
+      /// <summary>
+      /// Number of validations skipped because the XML content was validated before
+      /// </summary>
+      public static long SkippedValidations
+      {
+         get
+         {
+            XMLSchemaCacheImports.GetValidatedContentsStatistics(out _, out var skippedValidations);
+            return skippedValidations;
+         }
+      }
+
+      /// <summary>
+      /// Forgets all validated XML contents and resets <see cref="SkippedValidations"/>
+      /// </summary>
+      public static void ClearValidatedContents()
+      {
+         XMLSchemaCacheImports.ClearValidatedContents();
+      }
    }
 }
@@ -18,12 +18,20 @@ namespace SimModelNative
 		int _lowerHalfBandWidth;
 		int _upperHalfBandWidth;
 
+		//fraction of nonzero entries in the dependency matrix of the ODE system
+		double _density;
+
 	public:
 		BandwidthReductionTask(Simulation * sim);
 		void ReorderDEVariables();
 
+		//calculates the half bandwidths which would be achieved by ReorderDEVariables
+		//and the density of the system WITHOUT reordering the DE variables
+		void EstimateHalfBandWidths();
+
 		int GetLowerHalfBandWidth();
 		int GetUpperHalfBandWidth();
+		double GetDensity();
 
 	protected:
 		std::vector<std::vector<bool> > getDependencyMatrix();
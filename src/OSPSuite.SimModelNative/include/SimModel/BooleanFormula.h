@@ -71,6 +71,7 @@ class EqualFormula :
       virtual double DE_Compute (const double * y, const double time, ScaleFactorUsageMode scaleFactorMode);
       virtual Formula* clone();
       virtual std::vector <double> SwitchTimePoints();
+      virtual bool AppendScheduledTimePoints(std::vector <double> & scheduledTimePoints);
 
 	protected:
       virtual void WriteFormulaMatlabCode (std::ostream & mrOut);
@@ -147,6 +148,7 @@ class OrFormula :
 	public:
       virtual double DE_Compute (const double * y, const double time, ScaleFactorUsageMode scaleFactorMode);
       virtual Formula* clone();
+      virtual bool AppendScheduledTimePoints(std::vector <double> & scheduledTimePoints);
 
 	protected:
       virtual void WriteFormulaMatlabCode (std::ostream & mrOut);
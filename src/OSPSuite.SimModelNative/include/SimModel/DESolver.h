@@ -15,6 +15,8 @@ enum { FUNCTIONAL, NEWTON };   //iter
 #include "SolverCallerInterface/SolverCaller.h"
 #include "SimModel/DESolverProperties.h"
 #include "SimModel/Parameter.h"
+#include "SimModel/LinearODESolver.h"
+#include "SimModel/OutputSchema.h"
 
 namespace SimModelNative
 {
@@ -29,10 +31,36 @@ typedef struct TimeYYDot
 	double YDot;
 }TimeValueTriple;
 
+//configuration for which a solver instance was created.
+//A solver instance is reused for the next run only if its configuration did not change
+struct SolverConfiguration
+{
+	std::string SolverName;
+	int NumberOfUnknowns;
+	int NumberOfSensitivityParameters;
+	double AbsTol;
+	double RelTol;
+	double H0;
+	double HMin;
+	double HMax;
+	long MxStep;
+	bool UseJacobian;
+	bool UseBandLinearSolver;
+	int LowerHalfBandWidth;
+	int UpperHalfBandWidth;
+	int LinearMultistepMethod;
+
+	SolverConfiguration();
+	bool operator==(const SolverConfiguration & other) const;
+};
+
 class DESolver :
 	public ObjectBase,
 	public ISolverCaller
 {
+	//solves the ODE systems of several simulations as one (block-diagonal) system
+	friend class EnsembleSolver;
+
 	private:
 		Simulation * _parentSim;
 
@@ -47,6 +75,34 @@ class DESolver :
 
 		SimModelSolverBase * SetupSolver(const double simStartTime, const double * initialvalues);
 
+		//---- solver instance and work arrays of the latest run.
+		//     Both are kept alive between the runs: solver instance is reinitialized
+		//     if its configuration did not change, work arrays are reallocated only if
+		//     the problem size changed
+		SimModelSolverBase * _solver;
+		SolverConfiguration _solverConfiguration;
+
+		int _workArraysSize;
+		double * _solution;            //solution vector of current problem
+		double * _solutionAboveAbsTol; //solution vector of current problem where all values in [-AbsTol..AbsTol] are set to zero
+
+		//sensitivity values for one time point [NumberOfUnknowns X NumberOfSensitivityParameters] 
+		double ** _sensitivityValues;
+		int _sensitivityValuesRows;
+		int _sensitivityValuesColumns;
+
+		SolverConfiguration CurrentSolverConfiguration();
+
+		//tries to reinitialize the solver instance of the previous run.
+		//Returns false if not possible (no solver yet, configuration changed, ...)
+		bool ReInitCachedSolver(const double simStartTime, const double * initialvalues);
+
+		//(re)allocate ODE variables cache, solution vectors and sensitivity matrix
+		//for the current problem size
+		void RedimWorkArrays();
+		void ReleaseWorkArrays();
+		void ReleaseSensitivityMatrix();
+
 		bool shouldContinueThisStep(double outTimePoint, double solverOutputTime, int iResultflag) const;
 
 		void myDoEvents();
@@ -72,15 +128,50 @@ class DESolver :
 		int _lowerHalfBandWidth;
 		int _upperHalfBandWidth;
 
+		//integration method of the current run (ADAMS or BDF)
+		//BDF is used unless automatic solver configuration selects ADAMS for a non-stiff system
+		int _linearMultistepMethod;
+
+		//estimates the spectral radius of the Jacobian at (t,y) by power iteration.
+		//Jacobian-vector products are approximated by finite differences of the RHS,
+		//so no Jacobian is required. Returns Inf if the RHS cannot be evaluated
+		double estimateSpectralRadius(double t, const double * y);
+
+		//true if the Adams method of the current run should be replaced by BDF because
+		//the system became stiff at the solver restart at <restartTime>
+		bool systemBecameStiff(double restartTime, double endTime);
+
+		void computeRhs(double t, const double * y, double * ydot);
+
+		//used instead of the solver instance if the ODE system of the current run
+		//is linear with constant coefficients between switch points
+		LinearODESolver _linearODESolver;
+
+		//(re)assembles the linear system at time <t> (after every switch affecting the RHS)
+		void assembleLinearSystem(double t);
+
 		TObjectList<Parameter> _sensitivityParameters; //cache for speedup
 
-		double ** redimSensitivityMatrix(void);
+		void redimSensitivityMatrix(void);
 
 		void storeSensitivityValues(int timeStepNumber, double ** sensitivityValues);
 
 		//calculate and set comparison thresholds for variables and observers
 		void setComparisonThresholds();
 
+		//---- phases of solving the ODE system shared by Solve_ODE and ensemble runs
+
+		//initial values, result arrays and work arrays of the run, initial switch update.
+		//Afterwards <_solution> contains the (scaled) initial values.
+		//Returns the output time points of the run
+		std::vector <OutputTimePoint> prepareSolving();
+
+		//saves <_solution> as result of the <timeStepNumber>-th output time point
+		void storeSolution(int timeStepNumber, double solverOutputTime);
+
+		//sets comparison thresholds and scales the results back
+		void finishSolving();
+
 protected:
 
 	//---- for debug purposes only
@@ -91,6 +182,10 @@ protected:
 
 	public:
 		DESolver ();
+		virtual ~DESolver ();
+
+		//release cached solver instance and work arrays
+		void ReleaseSolver ();
 
 		void LoadFromXMLNode (const XMLNode & pNode);
 		void XMLFinalizeInstance (const XMLNode & pNode, Simulation * sim);
@@ -0,0 +1,101 @@
+#ifndef _EnsembleSolver_H_
+#define _EnsembleSolver_H_
+
+#include "SimModel/OutputSchema.h"
+#include <vector>
+
+namespace SimModelNative
+{
+
+class Simulation;
+class DESolver;
+
+//Solves the ODE systems of several copies of one finalized model (ensemble members,
+//e.g. individuals of a population with different parameter values) as one
+//block-diagonal system
+//    y = [y_1, ..., y_K],   y_k' = f_k(t, y_k)
+//All members are integrated with one common step size, so step size control,
+//output and switch handling are shared by the ensemble. This pays off for small
+//models, where the overhead of a single solver run dominates the run time.
+//
+//The system is solved by the L-stable Rosenbrock method RODAS3 (order 3 with
+//embedded order 2 error estimate). The Jacobian of the stacked system is block-diagonal,
+//so only the blocks of the members are factorized and solved (block by block).
+//The error of every member is measured with its own tolerances: a step is accepted
+//only if it is accepted for every member. Switches are performed per member
+//at the output time points (as in DESolver::Solve_ODE).
+//
+//A member is removed from the ensemble if its RHS cannot be evaluated, if it
+//prevents the step size control from succeeding or if it was canceled.
+//Such members (and members which cannot be stacked, e.g. because of sensitivity
+//parameters or other output time points than the first member) are reported
+//as not solved and must be run on their own by Simulation::RunSimulation,
+//which also reduces tolerances if required
+class EnsembleSolver
+{
+private:
+	struct Member
+	{
+		Simulation * simulation;
+		DESolver * solver;
+		double * y;    //block of the member in the ensemble solution
+		double * yNew; //block of the member in the solution of the current step
+		double error;  //weighted RMS norm of the local error in the current step
+		double absTol;
+		double relTol;
+		bool isActive;
+	};
+
+	std::vector <Member> _members;
+
+	//size of one block (number of ODE variables of the model)
+	int _n;
+
+	std::vector <OutputTimePoint> _outputTimePoints;
+
+	std::vector <double> _y;
+	std::vector <double> _yNew;
+
+	//---- work arrays for one block (blocks are processed one after another)
+	std::vector <double> _rhs0;
+	std::vector <double> _rhs;
+	std::vector <double> _dfdt;
+	std::vector <double> _yStage;
+	std::vector <double> _stages;   //[number of stages x n]
+	std::vector <double> _matrix;   //[n x n], column major; LU factors of 1/(h*gamma)*I-J
+	std::vector <int> _pivots;
+	std::vector <double *> _jacobianColumns;
+
+	//prepares the run of every member and stacks the members which can be solved together
+	void setup(const std::vector <Simulation *> & simulations);
+
+	int numberOfActiveMembers() const;
+
+	//initial step size from the initial values and RHS of all members
+	double initialStepSize(double t, double tEnd);
+
+	//integrates all active members from <t> to <tEnd>, starting with step size <h>.
+	//Returns the proposed size of the next step
+	double integrateTo(double & t, double tEnd, double h, long maxNumberOfSteps, double hMin, double hMax);
+
+	//one RODAS3 step of size <h> for the member: sets member.yNew and member.error
+	void performStep(Member & member, double t, double h);
+
+	void computeJacobian(Member & member, double t, const double * y);
+
+	//LU decomposition of _matrix with partial pivoting. Returns false if singular
+	bool factorize();
+	void solve(double * b);
+
+public:
+	EnsembleSolver(void);
+
+	//solves all <simulations>, which must be copies of the same finalized model.
+	//Returns for every simulation if it was solved. Simulations not solved are
+	//left in the state before their run and can be run by RunSimulation
+	std::vector <bool> Solve(const std::vector <Simulation *> & simulations);
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_EnsembleSolver_H_
@@ -0,0 +1,96 @@
+#ifndef _EquationCache_H_
+#define _EquationCache_H_
+
+#include "SimModel/ParsedEquations.h"
+#include "XMLWrapper/XMLDocument.h"
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+namespace SimModelNative
+{
+
+//Process-wide cache of parsed equations, shared by all simulations using it
+//(s. SimulationOptions::UseEquationCache).
+//
+//The rate node of an equation parsed with given inputs (s. ParsedEquations::KeyFor)
+//is kept as template: the formula tree of every other explicit formula with the same
+//equation and inputs is created from (a copy of) the template and then bound to the
+//quantity references of that formula.
+//
+//Number of cached equations is bounded: least recently used equations are removed first.
+//
+//Concurrency: all methods can be called from any thread.
+//GetRateNode/AddRateNode require the lock (s. ParsedEquations::Mutex), all other methods take it themselves
+class EquationCache :
+	public ParsedEquations
+{
+private:
+	struct Entry
+	{
+		uint64_t key;
+		EquationInputs inputs; //compared on every lookup: keys are hashes
+		XMLNode rateNode; //owned by _rateNodesDocument
+	};
+
+	static std::atomic<EquationCache *> _instance;
+	static std::mutex _instanceMutex;
+
+	//most recently used first
+	std::list <Entry> _entries;
+	std::unordered_multimap <uint64_t, std::list <Entry>::iterator> _entriesByKey;
+
+	XMLDocument _rateNodesDocument;
+
+	size_t _maximumSize;
+	uint64_t _hits;
+	uint64_t _misses;
+	uint64_t _evictions;
+
+	std::list <Entry>::iterator find(uint64_t key, const EquationInputs & inputs);
+	void add(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode);
+	void removeLeastRecentlyUsed();
+	void shrink();
+	void clear();
+
+	//not copyable
+	EquationCache(const EquationCache &);
+	EquationCache & operator = (const EquationCache &);
+
+public:
+	//default maximum number of cached equations
+	static const size_t DEFAULT_MAXIMUM_SIZE = 10000;
+
+	static EquationCache * GetInstance();
+
+	EquationCache();
+	virtual ~EquationCache();
+
+	virtual XMLNode GetRateNode(uint64_t key, const EquationInputs & inputs);
+	virtual void AddRateNode(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode);
+
+	//maximum number of cached equations (0: unbounded).
+	//Least recently used equations are removed if the cache is larger
+	size_t GetMaximumSize();
+	void SetMaximumSize(size_t maximumSize);
+
+	//removes all equations and resets the statistics
+	void Clear();
+
+	//number of cached equations
+	size_t Size();
+
+	//lookups which did/did not find the equation; equations removed because the cache was full
+	void GetStatistics(uint64_t & hits, uint64_t & misses, uint64_t & evictions);
+
+	//writes all equations to an XML file (most recently used first)
+	void SaveToFile(const std::string & fileName);
+
+	//adds the equations of a file written by SaveToFile (up to the maximum size).
+	//Files written by another SimModel version or in another file format are ignored: returns the number of added equations
+	int LoadFromFile(const std::string & fileName);
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_EquationCache_H_
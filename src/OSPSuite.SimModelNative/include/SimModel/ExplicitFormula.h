@@ -3,6 +3,7 @@
 
 #include "SimModel/Formula.h"
 #include "SimModel/TObjectVector.h"
+#include "SimModel/ParsedEquations.h"
 #include "FuncParser/ParsedFunction.h"
 #include "XMLWrapper/XMLNode.h"
 #include <string>
@@ -22,6 +23,9 @@ class ExplicitFormula :
 private:
 	bool      _isGloballySimplified;
 
+	//parsed equations of the simulation (if any). Not owned
+	ParsedEquations * _parsedEquations;
+
 	FuncParserNative::ParsedFunction _funcParser;
 	void AddQuantityRefsFromXMLNode(XMLNode refListNode, Simulation * sim);
 
@@ -39,6 +43,13 @@ protected:
 		                           const std::vector<double> & parameterValues,
 		                           const std::vector<std::string> & parameterNotToSimplifyNames,
 								   bool simplifyParameter);
+
+	//parses the equation and returns its rate node (must be freed by the caller)
+	XMLNode ParseEquation(const std::vector<std::string> & variableNames, 
+		                  const std::vector<std::string> & parameterNames,
+		                  const std::vector<double> & parameterValues,
+		                  const std::vector<std::string> & parameterNotToSimplifyNames,
+		                  bool simplifyParameter);
 	
 	void WriteFormulaMatlabCode (std::ostream & mrOut);
 	void WriteFormulaCppCode (std::ostream & mrOut);
@@ -70,7 +81,9 @@ public:
 	virtual void Finalize();
 
 	std::vector <double> SwitchTimePoints();
+	virtual bool AppendScheduledTimePoints(std::vector <double> & scheduledTimePoints);
 	virtual bool IsConstant(bool forCurrentRunOnly);
+	virtual FormulaLinearity Linearity();
 
 	std::string Equation();
 
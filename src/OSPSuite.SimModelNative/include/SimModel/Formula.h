@@ -81,10 +81,20 @@ public:
 
 	virtual std::vector <double> SwitchTimePoints();
 
+	//returns true if the (boolean) formula is satisfied exactly at the time points
+	//appended to <scheduledTimePoints> and nowhere else, e.g. for
+	// (Time==P1) Or (Time==P2)
+	//where P1 and P2 are constant during the current simulation run
+	virtual bool AppendScheduledTimePoints(std::vector <double> & scheduledTimePoints);
+
 	virtual bool IsTime();
 
 	virtual bool IsConstant(bool forCurrentRunOnly);
 
+	//structural classification of the formula w.r.t. ODE variables for the current run.
+	//Conservative: FL_NONLINEAR is returned whenever linearity cannot be proven
+	virtual FormulaLinearity Linearity();
+
 	virtual std::string Equation();
 
 	virtual bool IsTable(void);
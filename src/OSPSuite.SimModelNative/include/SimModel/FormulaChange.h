@@ -36,6 +36,14 @@ protected:
 	double _speciesScaleFactor;
 	bool _useAsValue;
 
+	//false if the changed quantity is not used (directly or indirectly) in the RHS of the ODE system.
+	//Set by switch impact analysis during finalize
+	bool _affectsRHS;
+
+	//checks if the new value of the changed quantity is equal to its current value
+	//(in this case the RHS remains continuous and the solver need not to be restarted)
+	bool IsContinuousChange(double newValue, const double * y, double time);
+
 public:
 	FormulaChange(void);
 	virtual ~FormulaChange(void);
@@ -47,8 +55,20 @@ public:
 	void Finalize();
 
 	Formula * GetNewFormula(void);
+	Quantity * GetQuantity(void);
+	bool UseAsValue(void) const;
+
+	//performs formula change. Returns true if the quantity was effectively changed.
+	//<solverRestartRequired> is set to true if the change affects the RHS of the ODE system
+	//in a way that requires a solver restart (otherwise it is left untouched)
+	bool PerformSwitchUpdate (double * y, double time, bool & solverRestartRequired);
+
+	//checks if the changed quantity is used in the RHS of the ODE system,
+	//where <rhsParameterIds> are the ids of all parameters the RHS depends on
+	bool ChangedQuantityIsUsedInRHS(const std::set<int> & rhsParameterIds);
 
-	bool PerformSwitchUpdate (double * y, double time);
+	bool AffectsRHS() const;
+	void SetAffectsRHS(bool affectsRHS);
 
 	void WriteMatlabCode (std::ostream & mrOut);
 	void WriteCppCode(const std::map<int, formulaParameterInfo > & formulaParameterIDs, const std::set<int> & usedIDs, std::ostream & mrOut);
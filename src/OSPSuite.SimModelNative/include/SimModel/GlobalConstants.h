@@ -23,6 +23,14 @@ enum ScaleFactorUsageMode
 	IGNORE_SCALEFACTOR = 2
 };
 
+//dependency of a formula on the ODE variables y (between two switch points)
+enum FormulaLinearity
+{
+	FL_CONSTANT = 0,  //depends neither on y nor on time
+	FL_LINEAR = 1,    //affine in y, does not depend on time
+	FL_NONLINEAR = 2  //everything else
+};
+
 extern const char * csTime;
 extern const double csSimModelVersion;
 extern const double csSimModelMinVersion;
@@ -23,9 +23,6 @@ class HierarchicalFormulaObject :
 		//Index in the total list of all HierarchicalFormulaObjects 
 		//of the simulation (0..N-1)
 		int _hierarchicalObjectIndex;
-
-		//Total list of all HierarchicalFormulaObjects of the parent simulation
-		TObjectVector < HierarchicalFormulaObject > _simHierarchicalObjects;
 	
 	public:
 		HierarchicalFormulaObject ();
@@ -33,9 +30,11 @@ class HierarchicalFormulaObject :
 		void SetObjectIndex (int pIndex);
 		int GetObjectIndex ();
 		int GetHierarchyLevel ();
-		void SetHierarchicalObjects (TObjectVector < HierarchicalFormulaObject > & pHObjects);
+
+		//Increases the hierarchy level if one of the used objects has the same or a greater level.
+		//Objects are adjusted in dependency order (s. HierarchicalFormulaObjectGraph::DependencyOrder),
+		//so one call per object is sufficient
 		bool AdjustHierarchyLevel ();
-		void CheckCyclicDependencies ();
 
 		virtual std::vector < HierarchicalFormulaObject * > GetUsedHierarchicalFormulaObjects () = 0;
 };
@@ -0,0 +1,46 @@
+#ifndef _HierarchicalFormulaObjectGraph_H_
+#define _HierarchicalFormulaObjectGraph_H_
+
+#include "SimModel/HierarchicalFormulaObject.h"
+#include <string>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Dependency graph of the hierarchical formula objects of a simulation:
+//edge i -> j if object i uses object j (s. HierarchicalFormulaObject::GetUsedHierarchicalFormulaObjects).
+//
+//Graph is created once; ordering and cycle detection are linear in the size of the graph
+class HierarchicalFormulaObjectGraph
+{
+private:
+	const std::vector <HierarchicalFormulaObject *> & _objects;
+
+	//objects used by object i: _usedObjects[_firstUsedObject[i] .. _firstUsedObject[i+1]-1]
+	std::vector <int> _firstUsedObject;
+	std::vector <int> _usedObjects;
+
+	//shortest path from <start> back to <start> within the strongly connected component <component>
+	std::vector <int> cycleThrough(int start, const std::vector <int> & component, const std::vector <int> & componentOfObject) const;
+
+public:
+	//sets the object index of every object (s. HierarchicalFormulaObject::SetObjectIndex).
+	//Used objects not contained in <objects> are not part of the graph
+	HierarchicalFormulaObjectGraph(const std::vector <HierarchicalFormulaObject *> & objects);
+
+	//indices of the objects, every object after all objects it uses (Kahn's algorithm).
+	//Objects which are part of or depend on a cycle are missing
+	std::vector <int> DependencyOrder() const;
+
+	//indices of objects forming a cycle (each object uses the next one, the last one uses the first one).
+	//Empty if there are no cyclic dependencies (Tarjan's strongly connected components)
+	std::vector <int> FindCycle() const;
+
+	//e.g. "A -> B -> A"
+	std::string CycleDescription(const std::vector <int> & cycle) const;
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_HierarchicalFormulaObjectGraph_H_
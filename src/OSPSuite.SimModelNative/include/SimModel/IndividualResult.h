@@ -0,0 +1,60 @@
+#ifndef _IndividualResult_H_
+#define _IndividualResult_H_
+
+#include "SimModel/GlobalConstants.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Result of one individual delivered by a streaming population run.
+//Gives direct access to the result buffers until the result is released
+//(s. PopulationRunner::ReleaseResult); afterwards the buffers are reused for 
+//later individuals
+class IndividualResult
+{
+	friend class PopulationRunner;
+	friend class ResultQueue;
+
+private:
+	int _individual;
+	int _status;
+	std::string _message;
+	int _numberOfOutputs;
+	int _numberOfTimePoints;
+
+	std::vector <double> _timeValues; //[number of time points]
+	std::vector <double> _values;     //[number of outputs x number of time points]
+
+	//link to the next result in the result queue
+	std::atomic <IndividualResult *> _next;
+
+	IndividualResult(void);
+
+	//prepares the (recycled) buffers for the next individual
+	void Reset(int individual, int numberOfOutputs, int numberOfTimePoints);
+
+public:
+	SIM_EXPORT int Individual() const;
+
+	//s. PopulationRunner::IndividualRunStatus
+	SIM_EXPORT int Status() const;
+
+	//error message or solver warnings
+	SIM_EXPORT const std::string & Message() const;
+
+	SIM_EXPORT int NumberOfOutputs() const;
+	SIM_EXPORT int NumberOfTimePoints() const;
+
+	//empty (NULL) if the individual failed before any output time point was available
+	SIM_EXPORT const double * TimeValues() const;
+
+	//values of all outputs of the individual: [number of outputs x number of time points]
+	SIM_EXPORT const double * Values() const;
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_IndividualResult_H_
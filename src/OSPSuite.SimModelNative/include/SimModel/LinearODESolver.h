@@ -0,0 +1,60 @@
+#ifndef _LinearODESolver_H_
+#define _LinearODESolver_H_
+
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Exact solver for linear ODE systems with constant coefficients
+//    y' = A*y + b
+//The system is advanced by the action of the matrix exponential of the
+//augmented matrix [A b; 0 0] on [y; 1], using a truncated Taylor series
+//with time step scaling (only sparse matrix-vector products are required).
+//A and b are valid between two switch points: the system must be assembled
+//again after every switch which changes the RHS
+class LinearODESolver
+{
+private:
+	int _n;
+
+	//A in compressed sparse row format
+	std::vector <int> _rowStart;
+	std::vector <int> _columnIndex;
+	std::vector <double> _values;
+
+	//b/beta, where beta is the value of the augmented component
+	//(chosen s.t. the last column of the augmented matrix is not dominating its norm)
+	std::vector <double> _inhomogeneity;
+	double _beta;
+
+	//1-norm of the augmented matrix
+	double _norm;
+
+	//work arrays
+	std::vector <double> _term;
+	std::vector <double> _nextTerm;
+	std::vector <double> _result;
+
+	int _numberOfAssemblies;
+
+	//x_out = A*x + b/beta*xAugmented
+	void multiply(const double * x, double xAugmented, double * x_out);
+
+public:
+	LinearODESolver(void);
+
+	//sets A and b, where <jacobian> is the dense jacobian of the system
+	//(column major, see MATRIX_ELEM) and <rhsAtZero> = RHS(y=0)
+	void Assemble(int n, double * * jacobian, const double * rhsAtZero);
+
+	//replaces <y> by the solution after <timeStep>
+	void Advance(double * y, double timeStep);
+
+	int NumberOfAssemblies() const;
+	void Reset();
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_LinearODESolver_H_
@@ -0,0 +1,29 @@
+#ifndef _PInvokeEquationCache_H_
+#define _PInvokeEquationCache_H_
+
+#include "SimModel/EquationCache.h"
+#include "SimModel/GlobalConstants.h"
+
+namespace SimModelNative
+{
+   //-------------- C interface for PInvoke -----------------------------------------
+   //(process-wide equation cache, s. EquationCache)
+   extern "C"
+   {
+      //maximumSize: maximum number of cached equations (0: unbounded)
+      SIM_EXPORT void SetEquationCacheMaximumSize(int maximumSize);
+      SIM_EXPORT int GetEquationCacheMaximumSize();
+
+      SIM_EXPORT void ClearEquationCache();
+
+      SIM_EXPORT void GetEquationCacheStatistics(int& size, long long& hits, long long& misses, long long& evictions);
+
+      SIM_EXPORT void SaveEquationCache(const char* fileName, bool& success, char** errorMessage);
+
+      //returns the number of equations added from the file
+      SIM_EXPORT int LoadEquationCache(const char* fileName, bool& success, char** errorMessage);
+   }
+}//.. end "namespace SimModelNative"
+
+
+#endif //_PInvokeEquationCache_H_
@@ -0,0 +1,73 @@
+#ifndef _PInvokePopulationRunner_H_
+#define _PInvokePopulationRunner_H_
+
+#include "SimModel/PopulationRunner.h"
+
+namespace SimModelNative
+{
+   //-------------- C interface for PInvoke -----------------------------------------
+   extern "C"
+   {
+      SIM_EXPORT PopulationRunner* CreatePopulationRunner(Simulation* simulation);
+      SIM_EXPORT void DisposePopulationRunner(PopulationRunner* populationRunner);
+
+      SIM_EXPORT void SetPopulationRunnerNumberOfThreads(PopulationRunner* populationRunner, int numberOfThreads);
+
+      //executionMode: s. PopulationRunner::ExecutionMode
+      SIM_EXPORT void SetPopulationRunnerExecutionMode(PopulationRunner* populationRunner, int executionMode);
+
+      SIM_EXPORT void SetPopulationRunnerEnsembleSize(PopulationRunner* populationRunner, int ensembleSize);
+
+      //<entityIds> arrays have <size> elements
+      SIM_EXPORT void SetPopulationVariableParameters(PopulationRunner* populationRunner, const char** entityIds, int size);
+      SIM_EXPORT void SetPopulationVariableSpecies(PopulationRunner* populationRunner, const char** entityIds, int size);
+      SIM_EXPORT void SetPopulationOutputs(PopulationRunner* populationRunner, const char** entityIds, int size);
+
+      SIM_EXPORT int GetPopulationNumberOfTimePoints(PopulationRunner* populationRunner, bool& success, char** errorMessage);
+
+      //<values> has [numberOfIndividuals x (number of variable parameters + number of variable species)] elements,
+      //<results> has [numberOfIndividuals x number of outputs x number of time points] preallocated elements,
+      //<statuses> has <numberOfIndividuals> preallocated elements
+      SIM_EXPORT void RunPopulation(PopulationRunner* populationRunner, int numberOfIndividuals, const double* values,
+                                    double* results, int* statuses, bool& success, char** errorMessage);
+
+      //can be called from another thread while RunPopulation is running
+      SIM_EXPORT void CancelPopulationRun(PopulationRunner* populationRunner);
+      SIM_EXPORT long GetPopulationRunProgress(PopulationRunner* populationRunner);
+
+      //error message or solver warnings of the given individual in the latest population run
+      SIM_EXPORT char* GetPopulationRunMessage(PopulationRunner* populationRunner, int individual, bool& success, char** errorMessage);
+
+      //s. PopulationRunner::NumberOfIndividualsSolvedInEnsembles/NumberOfStolenTasks/EnsembleErrors (errors are separated by new lines)
+      SIM_EXPORT int GetPopulationNumberOfIndividualsSolvedInEnsembles(PopulationRunner* populationRunner);
+      SIM_EXPORT int GetPopulationNumberOfStolenTasks(PopulationRunner* populationRunner);
+      SIM_EXPORT char* GetPopulationEnsembleErrors(PopulationRunner* populationRunner);
+
+      //s. PopulationRunner::WorkerProcesses. <processIds> has preallocated memory for <size> elements;
+      //returns the number of worker processes (only the first <size> are filled in)
+      SIM_EXPORT int FillPopulationWorkerProcesses(PopulationRunner* populationRunner, int* processIds, int size);
+
+      //<timeValues> has preallocated memory for <size> elements
+      SIM_EXPORT void FillPopulationTimeValues(PopulationRunner* populationRunner, double* timeValues, int size, bool& success, char** errorMessage);
+
+      //---- streaming population run (s. PopulationRunner::StartStreamingRun)
+      //<values>: s. RunPopulation; <callback> can be NULL (results are retrieved by GetNextPopulationResult)
+      SIM_EXPORT void StartPopulationStreamingRun(PopulationRunner* populationRunner, int numberOfIndividuals, const double* values,
+                                                  PopulationRunner::ResultCallback callback, void* userData, bool& success, char** errorMessage);
+
+      //returns NULL if no result was available within <timeoutMs> or if all results were delivered (s. IsPopulationStreamingRunCompleted)
+      SIM_EXPORT IndividualResult* GetNextPopulationResult(PopulationRunner* populationRunner, int timeoutMs);
+      SIM_EXPORT bool IsPopulationStreamingRunCompleted(PopulationRunner* populationRunner);
+      SIM_EXPORT void ReleasePopulationResult(PopulationRunner* populationRunner, IndividualResult* result);
+      SIM_EXPORT void FinishPopulationStreamingRun(PopulationRunner* populationRunner, bool& success, char** errorMessage);
+
+      //access to the result buffers (valid until the result is released)
+      SIM_EXPORT void GetIndividualResultProperties(IndividualResult* result, int& individual, int& status, int& numberOfOutputs, int& numberOfTimePoints);
+      SIM_EXPORT char* GetIndividualResultMessage(IndividualResult* result);
+      SIM_EXPORT const double* GetIndividualResultTimeValues(IndividualResult* result);
+      SIM_EXPORT const double* GetIndividualResultValues(IndividualResult* result);
+   }
+}//.. end "namespace SimModelNative"
+
+
+#endif //_PInvokePopulationRunner_H_
@@ -17,10 +17,35 @@ namespace SimModelNative
       bool IdentifyUsedParameters;
       bool KeepXMLNodeAsString;
 		bool UseFloatComparisonInUserOutputTimePoints;
+      bool AutoSolverConfiguration;
+      bool SolveLinearSystemsExactly;
+      bool StreamingXMLLoad;
+      int NumberOfFinalizeThreads;
+      bool UseEquationCache;
+      bool LazyFinalize;
+      bool LeanMode;
 
       void CopyFrom(const SimulationOptions& options);
    };
 
+   struct SimulationRunStatisticsStructure
+   {
+      double SetupTime;
+      double SolveTime;
+      bool SolverInstanceReused;
+      int AvoidedSolverRestarts;
+      int ScheduledSwitches;
+      bool BandLinearSolverUsed;
+      int LowerHalfBandWidth;
+      int UpperHalfBandWidth;
+      bool AdamsMethodUsed;
+      double SpectralRadiusEstimate;
+      bool LinearSystemSolvedExactly;
+      double BDFSwitchTime;
+
+      void CopyFrom(const SimulationRunStatistics& statistics);
+   };
+
    //-------------- C interface for PInvoke -----------------------------------------
    extern "C"
    {
@@ -30,7 +55,23 @@ namespace SimModelNative
       SIM_EXPORT void LoadSimulationFromXMLFile(Simulation* simulation, const char* fileName, bool& success, char** errorMessage);
       SIM_EXPORT void LoadSimulationFromXMLString(Simulation* simulation, const char* simulationXML, bool& success, char** errorMessage);
       SIM_EXPORT void FinalizeSimulation(Simulation* simulation, bool& success, char** errorMessage);
+
+      //creates a finalized copy of a finalized simulation (s. Simulation::Clone)
+      //returned simulation must be disposed by the caller (DisposeSimulation)
+      SIM_EXPORT Simulation* CloneSimulation(Simulation* simulation, bool& success, char** errorMessage);
+
+      //preparsed model (s. Simulation::SavePreparsedModel/LoadFromPreparsedModel)
+      SIM_EXPORT void SavePreparsedModel(Simulation* simulation, const char* fileName, bool& success, char** errorMessage);
+      SIM_EXPORT void LoadSimulationFromPreparsedModel(Simulation* simulation, const char* fileName, bool& success, char** errorMessage);
+
+      //indices of the variable (not fixed) parameters/species in the parameter/species properties
+      SIM_EXPORT int GetNumberOfVariableParameters(Simulation* simulation);
+      SIM_EXPORT void FillVariableParameterIndices(Simulation* simulation, int* parameterIndices, int size, bool& success, char** errorMessage);
+      SIM_EXPORT int GetNumberOfVariableSpecies(Simulation* simulation);
+      SIM_EXPORT void FillVariableSpeciesIndices(Simulation* simulation, int* speciesIndices, int size, bool& success, char** errorMessage);
+
       SIM_EXPORT long GetSimulationProgress(Simulation* simulation);
+      SIM_EXPORT int GetNumberOfDeferredFormulas(Simulation* simulation);
       SIM_EXPORT void CancelSimulationRun(Simulation* simulation);
       //SIM_EXPORT char* GetSimModelVersion();
       SIM_EXPORT char* GetObjectPathDelimiter(Simulation* simulation);
@@ -41,6 +82,8 @@ namespace SimModelNative
 
       SIM_EXPORT void RunSimulation(Simulation* simulation, bool& toleranceWasReduced, double& newAbsTol, double& newRelTol, bool& success, char** errorMessage);
 
+      SIM_EXPORT void FillSimulationRunStatistics(Simulation* simulation, SimulationRunStatisticsStructure* statistics);
+
       SIM_EXPORT int GetNumberOfTimePoints(Simulation* simulation);
 
       //The caller must call GetNumberOfTimePoints() first and pass an array where NumberOfTimePoints elements are preallocated 
@@ -0,0 +1,27 @@
+#ifndef _PInvokeXMLSchemaCache_H_
+#define _PInvokeXMLSchemaCache_H_
+
+#include "SimModel/GlobalConstants.h"
+
+namespace SimModelNative
+{
+   //-------------- C interface for PInvoke -----------------------------------------
+   //(process-wide simulation schema and cache of validated XML contents, s. XMLCache)
+   extern "C"
+   {
+      //schemaNamespace: target namespace of the schema (empty: keep current namespace)
+      SIM_EXPORT void LoadXMLSchemaFromFile(const char* fileName, const char* schemaNamespace, bool& success, char** errorMessage);
+      SIM_EXPORT bool XMLSchemaIsInitialized();
+
+      //maximumNumber: maximum number of validated XML contents remembered (0: validation results are not cached)
+      SIM_EXPORT void SetMaximumNumberOfValidatedContents(int maximumNumber);
+      SIM_EXPORT int GetMaximumNumberOfValidatedContents();
+
+      SIM_EXPORT void ClearValidatedContents();
+
+      SIM_EXPORT void GetValidatedContentsStatistics(int& numberOfValidatedContents, long long& skippedValidations);
+   }
+}//.. end "namespace SimModelNative"
+
+
+#endif //_PInvokeXMLSchemaCache_H_
@@ -60,6 +60,7 @@ public:
 	Observer * CreateObserverWithId(long objectId, Formula * observerFormula);
 
 	bool IsConstant(bool forCurrentRunOnly);
+	FormulaLinearity Linearity();
 	bool IsTable(void);
 	void SetTablePoints(const std::vector <ValuePoint> & valuePoints);
 
@@ -33,6 +33,8 @@ class ParameterFormula :
 
 		virtual bool IsConstant(bool forCurrentRunOnly);
 
+		virtual FormulaLinearity Linearity();
+
 		virtual bool IsZero(void);
 
 		virtual std::vector <double> SwitchTimePoints();
@@ -0,0 +1,64 @@
+#ifndef _ParsedEquations_H_
+#define _ParsedEquations_H_
+
+#include "XMLWrapper/XMLNode.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//inputs of the equation parser (s. ExplicitFormula::CreateFormulaFromEquation)
+struct EquationInputs
+{
+	std::string equation;
+	std::vector<std::string> variableNames;
+	std::vector<std::string> parameterNames;
+	std::vector<double> parameterValues;
+	std::vector<std::string> parameterNotToSimplifyNames;
+	bool simplifyParameter;
+
+	//parameter values are compared by their bit patterns (as in ParsedEquations::KeyFor)
+	bool operator == (const EquationInputs & other) const;
+};
+
+//Source and/or recorder of the parsed equations of explicit formulas.
+//
+//An equation is parsed (s. ExplicitFormula::CreateFormulaFromEquation) into a
+//rate node, from which the formula tree is created. The rate node only depends on
+//the inputs of the parser, so it can be reused for the same inputs instead of
+//parsing the equation again.
+class ParsedEquations
+{
+private:
+	std::mutex _mutex;
+
+public:
+	virtual ~ParsedEquations()
+	{
+	}
+
+	//key of the parser inputs
+	static uint64_t KeyFor(const EquationInputs & inputs);
+
+	//rate node of the equation parsed with <inputs> (<key> = KeyFor(inputs)).
+	//Returns NULL node if not available. Returned node is a deep copy owned by the caller:
+	//it can be used without the lock and must be freed by the caller (XMLNode::FreeNode)
+	virtual XMLNode GetRateNode(uint64_t key, const EquationInputs & inputs) = 0;
+
+	//called for every equation which was parsed
+	virtual void AddRateNode(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode) = 0;
+
+	//formulas of a simulation may be finalized concurrently (s. Simulation::FinalizeFormulas):
+	//must be locked while calling GetRateNode/AddRateNode
+	std::mutex & Mutex()
+	{
+		return _mutex;
+	}
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_ParsedEquations_H_
@@ -0,0 +1,298 @@
+#ifndef _PopulationRunner_H_
+#define _PopulationRunner_H_
+
+#include "SimModel/Simulation.h"
+#include "SimModel/TaskScheduler.h"
+#include "SimModel/IndividualResult.h"
+#include "SimModel/ResultQueue.h"
+#include "SimModel/EnsembleSolver.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Runs one (loaded and finalized) model for many individuals in parallel.
+//
+//Every individual is defined by one row of the values matrix:
+//    [values of variable parameters, initial values of variable species]
+//The model itself is never run: every worker thread gets its own copy of
+//the model, created at the start of the population run by reloading and
+//finalizing the model again (s. Simulation::Clone).
+//
+//Results are written into one caller-provided buffer with the layout
+//    [individual x output x time point]
+//
+//In the process execution mode (Linux/macOS only), worker processes are forked
+//instead of starting threads. Workers inherit the finalized model copy-on-write
+//(no model copies are created), so components which are not thread safe are
+//never used concurrently within one process. Workers write their results directly
+//into the results buffer if it was created by AllocateResults (otherwise into a POSIX 
+//shared memory segment, copied at the end). A crashing worker only fails the individual it was
+//running; it is replaced by a new worker as long as individuals are left.
+//Forking is only safe if no other threads of the calling process are inside 
+//the SimModel library at the same time: the process execution mode is refused
+//while other simulations are loaded, finalized or run (s. forkIsSafe)
+//
+//In a streaming run (thread execution mode only), the population is run in the
+//background and the result of every individual is delivered as soon as it is
+//finished: either via a callback (called in the worker thread) or via a result
+//queue polled by the caller. Result buffers are reused once released
+//
+//In the thread execution mode, individuals can be solved in ensembles: every
+//worker thread stacks the ODE systems of several individuals into one block-diagonal 
+//system (s. EnsembleSolver). Individuals which cannot be solved in the ensemble 
+//are run on their own afterwards
+class PopulationRunner
+{
+public:
+	enum IndividualRunStatus
+	{
+		IRS_SUCCESS = 0,
+		IRS_SUCCESS_WITH_WARNINGS = 1, //solver warnings are returned by Message()
+		IRS_FAILED = 2                 //error message is returned by Message(); results are NaN
+	};
+
+	//called in the worker thread for every finished individual of a streaming run.
+	//Callback takes ownership of the result and must pass it to ReleaseResult() when done
+	typedef void (*ResultCallback)(IndividualResult * result, void * userData);
+
+	enum ExecutionMode
+	{
+		EM_THREADS = 0,  //worker threads, each with its own model copy
+		EM_PROCESSES = 1 //forked worker processes (Linux/macOS only)
+	};
+
+private:
+	//model copy used by one worker thread, with cached quantities of interest
+	struct Worker
+	{
+		Simulation * simulation;
+		std::vector <Parameter *> parameters;
+		std::vector <Species *> species;
+		std::vector <Quantity *> outputs;
+
+		//output time points of the first successful run
+		std::vector <double> timeValues;
+	};
+
+	//state of a population run in the process execution mode, 
+	//placed in the shared memory segment
+	struct ProcessRunState
+	{
+		std::atomic<int> nextIndividual;
+		std::atomic<int> numberOfFinishedIndividuals;
+		std::atomic<bool> cancelFlag;
+		std::atomic<bool> timeValuesAvailable;
+
+		int numberOfIndividuals;
+		int numberOfTimePoints;
+
+		std::atomic<int> * currentIndividuals; //[number of processes]: individual run by the process or -1
+		std::atomic<int> * statuses;           //[numberOfIndividuals]
+		double * timeValues;                   //[numberOfTimePoints]
+		double * results;                      //[numberOfIndividuals x number of outputs x numberOfTimePoints]
+		char * messages;                       //[numberOfIndividuals x PROCESS_MESSAGE_SIZE]
+
+		ProcessRunState() : nextIndividual(0), numberOfFinishedIndividuals(0), cancelFlag(false), timeValuesAvailable(false),
+		                    numberOfIndividuals(0), numberOfTimePoints(0), currentIndividuals(NULL), statuses(NULL),
+		                    timeValues(NULL), results(NULL), messages(NULL) {}
+	};
+
+	//max. length of the message of one individual in the process mode (incl. terminating 0)
+	static const int PROCESS_MESSAGE_SIZE = 1024;
+
+	//status of individuals not simulated (yet) in the process mode
+	static const int PROCESS_INDIVIDUAL_NOT_FINISHED = -1;
+
+	//interval (in ms) for checking the state of worker processes
+	static const int PROCESS_POLLING_INTERVAL = 10;
+
+	Simulation * _model;
+	int _numberOfThreads;
+	ExecutionMode _executionMode;
+	int _ensembleSize;
+
+	std::vector <std::string> _variableParameters;
+	std::vector <std::string> _variableSpecies;
+	std::vector <std::string> _outputs;
+
+	std::vector <Worker> _workers;
+
+	std::vector <std::string> _messages;
+	std::vector <double> _timeValues;
+
+	//---- ensembles of the latest run (s. solveEnsemble)
+	std::atomic<int> _numberOfIndividualsSolvedInEnsembles;
+	std::vector <std::string> _ensembleErrors; //protected by _runStateMutex
+
+	//state of the current population run (NULL if not running)
+	TaskGroup * _taskGroup;
+	ProcessRunState * _processRunState;
+	std::vector <int> _workerProcesses; //process ids
+	std::mutex _runStateMutex;
+
+	//Cancel() was called during the current run (also before its task group or process run state was created)
+	bool _cancelRequested;
+
+	//s. NumberOfStolenTasks
+	int _numberOfStolenTasks;
+
+	//---- streaming run
+	std::thread _streamingThread;
+	std::vector <double> _streamingValues;
+	ResultQueue _resultQueue;
+	ResultCallback _resultCallback;
+	void * _resultCallbackUserData;
+	std::string _streamingError;
+
+	//result buffers: all results created so far and results released for reuse
+	std::vector <IndividualResult *> _allResults;
+	std::vector <IndividualResult *> _freeResults;
+	std::mutex _resultPoolMutex;
+
+	IndividualResult * acquireResult(int individual, int numberOfTimePoints);
+	void runStreaming(int numberOfIndividuals, int numberOfThreads, int numberOfTimePoints);
+	bool isStreaming() const;
+
+	void validateSettings();
+	Simulation * createModelCopy();
+	void cacheQuantities(Worker & worker);
+	void prepareWorkers(int numberOfWorkers);
+	void releaseWorkers();
+
+	int numberOfValuesPerIndividual() const;
+	void setIndividualValues(Worker & worker, int individual, const double * values);
+	int numberOfWorkersFor(int numberOfIndividuals) const;
+
+	//runs one individual on the model copy of the worker and writes its results into
+	//<individualResults> ([number of outputs x numberOfTimePoints]). Never throws.
+	//If <solvedInEnsemble> is true, the model copy already contains the results of the individual
+	int runIndividual(Worker & worker, TaskGroup & taskGroup, int individual, const double * values, double * individualResults, 
+	                  int numberOfTimePoints, bool solvedInEnsemble = false);
+
+	//solves <numberOfMembers> individuals starting with <firstIndividual> on the model copies 
+	//of <workers> as one ensemble. Returns for every individual if it was solved. Never throws:
+	//errors of the ensemble are collected (s. EnsembleErrors) and its individuals are run on their own
+	std::vector <bool> solveEnsemble(Worker * workers, TaskGroup & taskGroup, int firstIndividual, int numberOfMembers, 
+	                                 const double * values);
+	void addEnsembleError(int firstIndividual, int numberOfMembers, const std::string & errorMessage);
+	void resetRunState();
+
+	//runs all individuals by the worker threads (workers must be prepared: 
+	//<ensemble size> workers per thread). Ensembles are solved before <runTask> is 
+	//called for their individuals
+	void scheduleIndividuals(int numberOfIndividuals, int numberOfThreads, const double * values,
+	                         const std::function<void(Worker & worker, TaskGroup & taskGroup, int individual, bool solvedInEnsemble)> & runTask);
+
+	void runInThreads(int numberOfIndividuals, const double * values, double * results, int * statuses, 
+	                  int numberOfThreads, int numberOfTimePoints);
+	void runInProcesses(int numberOfIndividuals, const double * values, double * results, int * statuses, 
+	                    int numberOfProcesses, int numberOfTimePoints);
+
+	//true if no other simulation is loaded, finalized or run in this process right now,
+	//so that no thread holds a lock of the library while worker processes are forked
+	static bool forkIsSafe();
+
+	//main loop of a forked worker process (never returns)
+	void runWorkerProcess(Worker & worker, ProcessRunState & state, int processSlot, const double * values);
+
+public:
+	SIM_EXPORT PopulationRunner(Simulation * model);
+	SIM_EXPORT virtual ~PopulationRunner();
+
+	//number of worker threads (or worker processes in the process execution mode)
+	//0 (default): number of hardware threads
+	SIM_EXPORT void SetNumberOfThreads(int numberOfThreads);
+	SIM_EXPORT int NumberOfThreads() const;
+
+	//EM_THREADS (default) or EM_PROCESSES
+	SIM_EXPORT void SetExecutionMode(ExecutionMode executionMode);
+	SIM_EXPORT ExecutionMode GetExecutionMode() const;
+
+	//number of individuals solved together as one ensemble by a worker thread 
+	//(thread execution mode only). 1 (default): every individual is run on its own.
+	//Every worker thread creates one model copy per ensemble member
+	SIM_EXPORT void SetEnsembleSize(int ensembleSize);
+	SIM_EXPORT int EnsembleSize() const;
+
+	//entity ids of the parameters/species varied per individual (columns of the values matrix).
+	//All of them must have been set as variable in the model before it was finalized
+	SIM_EXPORT void SetVariableParameters(const std::vector <std::string> & entityIds);
+	SIM_EXPORT void SetVariableSpecies(const std::vector <std::string> & entityIds);
+
+	//entity ids of the (persistable) species and observers returned for every individual
+	SIM_EXPORT void SetOutputs(const std::vector <std::string> & entityIds);
+
+	//number of time points of every output (incl. the simulation start time)
+	SIM_EXPORT int NumberOfTimePoints();
+
+	//<values>:  [numberOfIndividuals x (number of variable parameters + number of variable species)], row major
+	//<results>: [numberOfIndividuals x number of outputs x NumberOfTimePoints()], preallocated by the caller
+	//<statuses>: [numberOfIndividuals], receives IndividualRunStatus of every individual
+	//Throws only if the settings are invalid or (process execution mode) the worker processes cannot be 
+	//waited for; errors of single individuals are reported in <statuses>
+	SIM_EXPORT void Run(int numberOfIndividuals, const double * values, double * results, int * statuses);
+
+	//results buffer for <numberOfValues> values which can be shared with worker processes, so that
+	//they write their results directly into it (s. EM_PROCESSES). Must be passed to ReleaseResults()
+	SIM_EXPORT static double * AllocateResults(size_t numberOfValues);
+	SIM_EXPORT static void ReleaseResults(double * results);
+
+	//can be called from another thread during Run(): stops running individuals and 
+	//marks all individuals not simulated yet as failed
+	SIM_EXPORT void Cancel();
+
+	//progress (0..100) of the current population run
+	SIM_EXPORT long Progress();
+
+	//starts a streaming population run in the background and returns immediately.
+	//<values>: s. Run(); copied, so it's not required to keep them alive.
+	//If <callback> is NULL, results are retrieved by NextResult()
+	SIM_EXPORT void StartStreamingRun(int numberOfIndividuals, const double * values, 
+	                                  ResultCallback callback = NULL, void * userData = NULL);
+
+	//next finished individual of the streaming run or NULL if no result was available within 
+	//<timeoutMs> (0: don't wait; <0: wait until a result is available or the run is finished).
+	//Returned result must be passed to ReleaseResult() when done
+	SIM_EXPORT IndividualResult * NextResult(int timeoutMs);
+
+	//true if all results of the streaming run were delivered
+	SIM_EXPORT bool StreamingRunCompleted() const;
+
+	//makes the buffers of <result> available for the next individuals
+	//(result must not be accessed afterwards)
+	SIM_EXPORT void ReleaseResult(IndividualResult * result);
+
+	//waits until the streaming run is finished. Results not retrieved yet remain in the queue
+	SIM_EXPORT void FinishStreamingRun();
+
+	//error message or solver warnings of the given individual in the latest run
+	SIM_EXPORT const std::string & Message(int individual) const;
+
+	//output time points of the latest run (empty if no individual was simulated successfully)
+	SIM_EXPORT const std::vector <double> & TimeValues() const;
+
+	//number of individuals of the latest run solved in ensembles (s. SetEnsembleSize).
+	//All other individuals were run on their own
+	SIM_EXPORT int NumberOfIndividualsSolvedInEnsembles() const;
+
+	//number of individuals (or ensembles) of the latest run in the thread execution mode which were
+	//taken over by another worker thread than the one they were scheduled for (s. TaskScheduler)
+	SIM_EXPORT int NumberOfStolenTasks();
+
+	//process ids of the worker processes of the current run (process execution mode only)
+	SIM_EXPORT std::vector <int> WorkerProcesses();
+
+	//errors of ensembles of the latest run which failed as a whole
+	//(their individuals were run on their own)
+	SIM_EXPORT std::vector <std::string> EnsembleErrors();
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_PopulationRunner_H_
@@ -31,6 +31,7 @@ class PowerFormula :
 		virtual void Finalize();
 
 		virtual bool IsZero(void);
+		virtual FormulaLinearity Linearity();
 
 		virtual void AppendUsedVariables(std::set<int> & usedVariablesIndices, const std::set<int> & variablesIndicesUsedInSwitchAssignments);
 		virtual void AppendUsedParameters(std::set<int> & usedParameterIDs);
@@ -0,0 +1,207 @@
+#ifndef _PreparsedModel_H_
+#define _PreparsedModel_H_
+
+#include "SimModel/ParsedEquations.h"
+#include "SimModel/ParameterInfo.h"
+#include "SimModel/SpeciesInfo.h"
+#include "XMLWrapper/XMLDocument.h"
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Binary model format with the simulation XML and equations already parsed, s. Simulation::SavePreparsedModel.
+//
+//A preparsed model contains:
+// - the <Simulation> node as a flat table of elements, attributes and (interned) strings
+// - the rate nodes of all explicit formula equations parsed during finalizing
+//   (so the equation parser is not needed when loading)
+// - the variable parameters/species of the simulation with their current values
+//
+//It is NOT a serialization of the finalized simulation objects: the XML DOM is rebuilt
+//from the element table, and the simulation is loaded and finalized from it as usual.
+//Loading saves XML text parsing, schema validation and equation parsing only.
+//
+//All sections consist of fixed size records referencing each other by index.
+//Byte order is the one of the machine which created the file.
+namespace PreparsedModelFormat
+{
+	const uint32_t FORMAT_VERSION = 1;
+	const uint32_t BYTE_ORDER_MARK = 0x01020304;
+	const uint32_t NO_INDEX = 0xFFFFFFFF;
+
+	struct Section
+	{
+		uint64_t offset; //from the start of the file
+		uint64_t count;  //number of records (strings: number of bytes)
+	};
+
+	struct Header
+	{
+		char magic[8]; //"SMPMODEL"
+		uint32_t byteOrderMark;
+		uint32_t formatVersion;
+		char simModelVersion[32];
+		uint64_t fileSize;
+
+		Section strings; //zero terminated strings, referenced by offset
+		Section nodes;
+		Section attributes;
+		Section equations; //sorted by key
+		Section variableParameters;
+		Section tablePoints;
+		Section variableSpecies;
+
+		uint32_t simulationNode;
+		uint32_t useBandLinearSolver;
+	};
+
+	//element node. Nodes are stored in document order, so
+	//firstChild and nextSibling are always greater than the index of the node
+	struct Node
+	{
+		uint32_t name;
+		uint32_t value; //text of elements without child elements (or NO_INDEX)
+		uint32_t firstAttribute;
+		uint32_t numberOfAttributes;
+		uint32_t firstChild;  //or NO_INDEX
+		uint32_t nextSibling; //or NO_INDEX
+	};
+
+	struct Attribute
+	{
+		uint32_t name;
+		uint32_t value;
+	};
+
+	struct Equation
+	{
+		uint64_t key; //s. ParsedEquations::KeyFor
+		uint32_t equation;
+		uint32_t rateNode;
+	};
+
+	struct VariableParameter
+	{
+		int64_t id;
+		double value;
+		uint32_t calculateSensitivity;
+		uint32_t isTable;
+		uint32_t firstTablePoint;
+		uint32_t numberOfTablePoints;
+	};
+
+	struct TablePoint
+	{
+		double x;
+		double y;
+		uint32_t restartSolver;
+		uint32_t reserved;
+	};
+
+	struct VariableSpecies
+	{
+		int64_t id;
+		double value;
+		double scaleFactor;
+	};
+}
+
+//collects everything while the simulation is finalized and writes the file
+class PreparsedModelWriter :
+	public ParsedEquations
+{
+private:
+	std::vector <char> _strings;
+	std::unordered_map <std::string, uint32_t> _stringOffsets;
+
+	std::vector <PreparsedModelFormat::Node> _nodes;
+	std::vector <PreparsedModelFormat::Attribute> _attributes;
+	std::vector <PreparsedModelFormat::Equation> _equations;
+	std::vector <PreparsedModelFormat::VariableParameter> _variableParameters;
+	std::vector <PreparsedModelFormat::TablePoint> _tablePoints;
+	std::vector <PreparsedModelFormat::VariableSpecies> _variableSpecies;
+
+	uint32_t _simulationNode;
+	bool _useBandLinearSolver;
+
+	//equations are parsed more than once while finalizing (with different inputs)
+	std::set <std::pair <uint64_t, std::string> > _recordedEquations;
+
+	uint32_t addString(const std::string & value);
+	uint32_t addNode(const XMLNode & node);
+
+public:
+	PreparsedModelWriter();
+
+	void SetSimulationNode(const XMLNode & simulationNode);
+	void SetVariableParameters(std::vector <ParameterInfo> & variableParameters);
+	void SetVariableSpecies(std::vector <SpeciesInfo> & variableSpecies);
+	void SetUseBandLinearSolver(bool useBandLinearSolver);
+
+	//nothing available while compiling: all equations are parsed
+	virtual XMLNode GetRateNode(uint64_t key, const EquationInputs & inputs);
+	virtual void AddRateNode(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode);
+
+	void Write(const std::string & fileName);
+};
+
+//preparsed model file, read into memory
+class PreparsedModel :
+	public ParsedEquations
+{
+private:
+	std::string _fileName;
+	std::vector <uint64_t> _buffer; //file content
+	const char * _data;
+	uint64_t _size;
+
+	const PreparsedModelFormat::Header * _header;
+	const char * _strings;
+	const PreparsedModelFormat::Node * _nodes;
+	const PreparsedModelFormat::Attribute * _attributes;
+	const PreparsedModelFormat::Equation * _equations;
+	const PreparsedModelFormat::VariableParameter * _variableParameters;
+	const PreparsedModelFormat::TablePoint * _tablePoints;
+	const PreparsedModelFormat::VariableSpecies * _variableSpecies;
+
+	//rate nodes were created by another SimModel version and are not used
+	bool _ignoreEquations;
+
+	//document owning the rate nodes returned by GetRateNode
+	XMLDocument _rateNodesDocument;
+
+	void readFile();
+	void validate();
+
+	template <typename T> const T * section(const PreparsedModelFormat::Section & section, size_t recordSize);
+
+	const char * stringAt(uint32_t offset) const;
+	void fillNode(XMLNode & node, uint32_t nodeIndex) const;
+
+public:
+	//reads the file and checks its structure. Throws ErrorData if the file is not a valid preparsed model
+	PreparsedModel(const std::string & fileName);
+	virtual ~PreparsedModel();
+
+	//creates the XML document of the simulation. Returned document must be released by the caller
+	XMLDocument CreateSimulationDocument();
+
+	//variable parameters/species with the values they had when the model was saved
+	std::vector <ParameterInfo> VariableParameters();
+	std::vector <SpeciesInfo> VariableSpecies();
+	bool UseBandLinearSolver();
+
+	virtual XMLNode GetRateNode(uint64_t key, const EquationInputs & inputs);
+
+	//equations not contained in the preparsed model are parsed as usual: nothing to do
+	virtual void AddRateNode(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode);
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_PreparsedModel_H_
@@ -5,6 +5,7 @@
 #include "SimModel/ObjectBase.h"
 #include "SimModel/XMLLoader.h"
 #include "SimModel/QuantityInfo.h"
+#include "SimModel/StringPool.h"
 #include <set>
 
 namespace SimModelNative
@@ -12,6 +13,7 @@ namespace SimModelNative
 
 class Formula;
 class HierarchicalFormulaObject;
+class SimulationXMLWriter;
 
 //For now, Quantity = FormulaUsableObject (Species, Observer, Parameter)
 class Quantity : 
@@ -21,23 +23,25 @@ private:
 	void setPathWithoutRoot(const std::string & objectPathDelimiter);
 
 protected:
+	//strings repeated in many quantities are pooled (s. StringPool)
+
 	//quantity name
-	std::string _name;
+	PooledString _name;
 	//path+name
-	std::string _fullName; 
+	PooledString _fullName; 
 	
 	//path without root element, e.g. "Organism|Weight" (whereas full path would be "S1|Organism|Weight")
-	std::string _pathWithoutRoot;
+	PooledString _pathWithoutRoot;
 
-	std::string _description;
+	PooledString _description;
 
 	//original path to the parent container of the quantity
 	//not required by simmodel itself - useful only for 
 	//user-friendly quantity identification e.g. from Matlab
-	std::string _containerPath;
+	PooledString _containerPath;
 
 	//unit - for informative purposes only
-	std::string _unit;
+	PooledString _unit;
 
 	//should be saved as simulation output or not
 	bool _isPersistable;
@@ -47,6 +51,10 @@ protected:
 
 	bool _isFixed;
 
+	//initial value was set (s. SetInitialValue) since the latest simplification for the current run
+	//(s. RunSimplificationCache)
+	bool _initialValueChanged;
+
 	//Is (directly!) used in condition formula or one of formula changes
 	//(Only required for Matlab ODE export)
 	bool _isUsedBySwitch;
@@ -105,6 +113,9 @@ public:
 
 	virtual bool IsConstant(bool forCurrentRunOnly);
 
+	//see Formula::Linearity
+	virtual FormulaLinearity Linearity();
+
 	//Reset changes after one simulation run is performed
 	virtual void ResetState(void);
 
@@ -122,9 +133,15 @@ public:
 	//this resets original value as well
 	void SetInitialValue(double value);
 
+	bool InitialValueChanged(void);
+	void ResetInitialValueChanged(void);
+
 	//sets new value (e.g. if changed by switch)
 	void SetConstantValue(double value);
 
+	//value used if the quantity has no formula
+	double GetConstantValue(void);
+
 	HierarchicalFormulaObject * GetHierarchicalFormulaObject(void);
 
 	bool IsFormulaEqualTo(Formula * formula);
@@ -142,7 +159,7 @@ public:
 
 	//Used before saving the simulation to XML - replaces the formula of
 	//NOT FIXED quantity by its constant value
-	void UpdateFormulaInXMLNode(XMLNode & pFormulaListNode, XMLNode & pQuantitiesListNode);
+	void UpdateFormulaInXML(SimulationXMLWriter & xmlWriter);
 
 	long GetFormulaId(void);
 
@@ -68,6 +68,7 @@ public:
 	Species * GetSpecies() const;
 
 	bool IsConstant(bool forCurrentRunOnly);
+	FormulaLinearity Linearity();
 	bool IsChangedBySwitch(void);
 
 	void AppendUsedVariables(std::set<int> & usedVariablesIndices, const std::set<int> & variablesIndicesUsedInSwitchAssignments);
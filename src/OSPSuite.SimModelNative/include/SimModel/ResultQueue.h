@@ -0,0 +1,57 @@
+#ifndef _ResultQueue_H_
+#define _ResultQueue_H_
+
+#include "SimModel/IndividualResult.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace SimModelNative
+{
+
+//Queue of finished individual results with many producers (worker threads)
+//and one consumer (the caller of the streaming population run).
+//
+//Push() is lock-free (intrusive multi-producer single-consumer queue, s. D. Vyukov).
+//A mutex is only involved for waking up a consumer which is waiting in Pop()
+class ResultQueue
+{
+private:
+	std::atomic <IndividualResult *> _head; //last pushed result (producers)
+	IndividualResult * _tail;               //next result to pop (consumer)
+	IndividualResult _stub;
+
+	std::atomic <int> _size;
+	std::atomic <bool> _consumerWaiting;
+	std::atomic <bool> _isClosed;
+
+	std::mutex _mutex;
+	std::condition_variable _resultAvailable;
+
+	void pushNode(IndividualResult * result);
+	IndividualResult * tryPopNode();
+
+public:
+	ResultQueue(void);
+
+	//can be called from any thread
+	void Push(IndividualResult * result);
+
+	//consumer only: returns NULL if no result is available within <timeoutMs>
+	// (timeoutMs = 0: just poll; timeoutMs < 0: wait until a result is 
+	//  available or the queue is closed)
+	IndividualResult * Pop(int timeoutMs);
+
+	//no more results will be pushed: wakes up the waiting consumer
+	void Close();
+
+	//consumer only: makes the (empty) queue ready for the next run
+	void Reopen();
+
+	bool IsClosed() const;
+	int Size() const;
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_ResultQueue_H_
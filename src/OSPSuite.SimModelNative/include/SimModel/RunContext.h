@@ -0,0 +1,91 @@
+#ifndef _RunContext_H_
+#define _RunContext_H_
+
+#include "SimModel/SolverWarning.h"
+#include "SimModel/TObjectVector.h"
+#include "SimModel/SimulationRunStatistics.h"
+#include "SimModel/SwitchSchedule.h"
+
+#include <atomic>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Bookkeeping of one simulation run:
+// - output time values
+// - progress and cancellation flag
+// - solver warnings and run statistics
+// - switch schedule compiled for the run
+//
+//This is NOT all mutable state of a run. The following is still changed by a run
+//and stored in the model objects themselves:
+// - result values of species and observers (Variable)
+// - quantity values and formulas changed by switches (reset after the run)
+// - fired state of one time switches (Switch)
+// - solver instance and its work arrays (DESolver)
+//Thus a finalized simulation cannot be shared between concurrent runs: a second run
+//of the same instance is rejected (s. TryStartRun). Concurrent runs of one model
+//require separate simulation instances (s. Simulation::Clone, PopulationRunner),
+//so the memory needed per concurrent run is not reduced by the run context
+class RunContext
+{
+private:
+	std::vector<double> _timeValues;
+	int _latestTimeIndex;
+
+	std::atomic<long> _progress;
+	std::atomic<bool> _cancelFlag;
+	std::atomic<bool> _isRunning;
+
+	//cancellation flag of an external owner (e.g. task group), not reset between runs
+	const std::atomic<bool> * _externalCancelFlag;
+
+	TObjectVector<SolverWarning> _solverWarnings;
+	SimulationRunStatistics _runStatistics;
+	SwitchSchedule _switchSchedule;
+
+public:
+	RunContext(void);
+	~RunContext(void);
+
+	//prepare for the next simulation run 
+	//(clears warnings and statistics, resets progress and cancellation flag)
+	void Reset();
+
+	//release all run data (e.g. if the simulation is unloaded)
+	void Release();
+
+	//marks the simulation as running. False if it is already running (e.g. in another thread)
+	bool TryStartRun();
+	void FinishRun();
+
+	//allocate output time values and set the first time point
+	void RedimTimeValues(int numberOfTimePoints, double startTime);
+	void SetTimeValue(int index, double value);
+	double * TimeValues();
+	int NumberOfTimePoints() const;
+
+	long Progress() const;
+	void SetProgress(long progress);
+
+	//can be called from another thread during the simulation run
+	void Cancel();
+
+	//true if the run was canceled directly or via the external cancellation flag
+	bool IsCanceled() const;
+
+	//external cancellation flag is checked additionally to the own one (NULL: none)
+	void SetExternalCancelFlag(const std::atomic<bool> * externalCancelFlag);
+
+	void AddWarning(const std::string & msg, double solverTime);
+	void ClearSolverWarnings();
+	const TObjectVector<SolverWarning> & SolverWarnings() const;
+
+	SimulationRunStatistics & RunStatistics();
+	SwitchSchedule & GetSwitchSchedule();
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_RunContext_H_
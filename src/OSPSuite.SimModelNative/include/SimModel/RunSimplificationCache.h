@@ -0,0 +1,81 @@
+#ifndef _RunSimplificationCache_H_
+#define _RunSimplificationCache_H_
+
+#include "SimModel/HierarchicalFormulaObject.h"
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Caches the result of simplifying the hierarchical formula objects for the 
+//current run (s. Simulation::SimplifyObjects(true)) between simulation runs.
+//
+//Formulas which could be replaced by values in the previous run are replaced
+//by the cached values again. Only objects depending (directly or indirectly) on 
+//quantities whose values were changed since the previous run (s. Quantity::SetInitialValue)
+//are simplified again. Thus the setup cost of a run scales with the number of 
+//changed parameters/species and their dependent objects, not with the model size.
+class RunSimplificationCache
+{
+private:
+	//all hierarchical formula objects, sorted by hierarchy level (independent objects first)
+	std::vector <HierarchicalFormulaObject *> _objects;
+
+	//position in _objects for every hierarchical object index (s. HierarchicalFormulaObject::GetObjectIndex)
+	std::vector <int> _positionOfObjectIndex;
+
+	//positions of the objects which are directly using the object (by position)
+	std::vector <std::vector <int> > _dependentObjects;
+
+	//positions of the objects which can be changed between runs (not fixed)
+	std::vector <int> _variableObjects;
+
+	//objects whose formula was replaced by a value in the previous run
+	std::vector <bool> _isSimplified;
+	std::vector <double> _simplifiedValues;
+
+	//positions of all objects with _isSimplified = true
+	std::vector <int> _simplifiedObjects;
+	bool _simplifiedObjectsChanged;
+
+	//formula state of all objects before simplification (s. SaveFormulaState)
+	std::vector <bool> _hadFormula;
+
+	std::vector <bool> _isAffected;
+	std::vector <int> _affectedObjects;
+
+	bool _isValid;
+
+	//saves the simplification result of the object at <position>
+	void updateObject(int position, bool hadFormula);
+
+	void updateSimplifiedObjects();
+	void markAffectedObjects();
+
+public:
+	RunSimplificationCache();
+
+	//sets up the dependency graph. Must be called after the hierarchy levels of all objects were set
+	void Setup(const std::vector <std::vector <HierarchicalFormulaObject *> > & leveledObjects);
+
+	void Clear();
+
+	//false if no run simplification was cached yet: all objects must be simplified 
+	//and the results saved by SaveFormulaState()/Update() afterwards
+	bool IsValid() const;
+
+	//to be called before all objects are simplified for the current run
+	void SaveFormulaState();
+
+	//saves the results of simplifying all objects for the current run
+	void Update();
+
+	//simplifies all objects for the current run, which depend on changed objects.
+	//All other objects get the values cached in the previous run.
+	//Returns the number of objects which were simplified again
+	int SimplifyChangedObjects();
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_RunSimplificationCache_H_
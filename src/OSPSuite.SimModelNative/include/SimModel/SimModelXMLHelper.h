@@ -27,6 +27,14 @@ public:
 				    					  	   const XMLNode & pNode, 
 										       Simulation * sim);
 
+	//single list element (used when the XML is read element by element)
+	static void ObjectLoadFromXMLNode (TObjectList<T> & objectList, 
+	                                   const XMLNode & pObjectNode);
+
+	static void ObjectXMLFinalizeInstance (TObjectList<T> & objectList, 
+	                                       const XMLNode & pObjectNode, 
+	                                       Simulation * sim);
+
 	static void ObjectVectorLoadFromXMLNode(TObjectVector<T> & objectVector, 
 	                                        const XMLNode & pNode);
 
@@ -43,19 +51,24 @@ void SimModelXMLHelper<T>::ObjectListLoadFromXMLNode (TObjectList<T> & objectLis
 	if (pNode.IsNull()) return;
 
 	for (XMLNode pChild = pNode.GetFirstChild(); !pChild.IsNull();pChild = pChild.GetNextSibling()) 
-	{
-		// Get Object
-		T* newObj = new T();
-		//Load From XML NODE 
-		newObj->LoadFromXMLNode(pChild);
+		ObjectLoadFromXMLNode(objectList, pChild);
+}
 
-		//check if the id of the object is unique
-		if( objectList.Exists(newObj->GetId()))
-			throw ErrorData(ErrorData::ED_ERROR,"TObjectList::LoadFromXMLNode", "Object id is not unique in List "+ XMLHelper::ToString(newObj->GetId()));
-	
-		// Save object
-		objectList.Add(newObj);
-	}
+template < class T >
+void SimModelXMLHelper<T>::ObjectLoadFromXMLNode (TObjectList<T> & objectList, 
+                                                  const XMLNode & pObjectNode)
+{
+	// Get Object
+	T* newObj = new T();
+	//Load From XML NODE 
+	newObj->LoadFromXMLNode(pObjectNode);
+
+	//check if the id of the object is unique
+	if( objectList.Exists(newObj->GetId()))
+		throw ErrorData(ErrorData::ED_ERROR,"TObjectList::LoadFromXMLNode", "Object id is not unique in List "+ XMLHelper::ToString(newObj->GetId()));
+
+	// Save object
+	objectList.Add(newObj);
 }
 
 template < class T >
@@ -86,12 +99,18 @@ void SimModelXMLHelper<T>::ObjectListXMLFinalizeInstance (TObjectList<T> & objec
 	if (pNode.IsNull()) return;
 	
 	for (XMLNode pChild = pNode.GetFirstChild(); !pChild.IsNull();pChild = pChild.GetNextSibling()) 
-	{
-		T* newObj = objectList.GetObjectById((long)pChild.GetAttribute(XMLConstants::Id, INVALID_QUANTITY_ID));
-		assert(newObj != NULL); // Has been created with LoadFromXML	
-	
-		newObj->XMLFinalizeInstance(pChild,sim);
-	}
+		ObjectXMLFinalizeInstance(objectList, pChild, sim);
+}
+
+template < class T >
+void SimModelXMLHelper<T>::ObjectXMLFinalizeInstance (TObjectList<T> & objectList, 
+                                                      const XMLNode & pObjectNode, 
+                                                      Simulation * sim)
+{
+	T* newObj = objectList.GetObjectById((long)pObjectNode.GetAttribute(XMLConstants::Id, INVALID_QUANTITY_ID));
+	assert(newObj != NULL); // Has been created with LoadFromXML	
+
+	newObj->XMLFinalizeInstance(pObjectNode,sim);
 }
 
 template < class T >
@@ -20,8 +20,19 @@
 #include "SimModel/SolverWarning.h"
 #include "SimModel/QuantityInfo.h"
 #include "SimModel/SimulationOptions.h"
-
+#include "SimModel/RunContext.h"
+#include "SimModel/RunSimplificationCache.h"
+#include "SimModel/ParsedEquations.h"
+#include "SimModel/SimulationXMLWriter.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
+
+class XMLReader;
 
 namespace SimModelNative
 {
@@ -29,6 +40,9 @@ namespace SimModelNative
    class Simulation :
       public ObjectBase
    {
+      //runs several copies of one simulation as one (block-diagonal) ODE system
+      friend class EnsembleSolver;
+
    public:
       typedef std::vector <HierarchicalFormulaObject*> HierarchicalFormulaObjectVector;
 
@@ -44,14 +58,21 @@ namespace SimModelNative
       OutputSchema _outputSchema;
       SimulationOptions _options;
 
+      //bookkeeping of the current simulation run (s. RunContext for the run state stored in the model)
+      RunContext _runContext;
+
+      //loads, finalizations and runs of all simulations executed right now (s. NumberOfActiveOperations)
+      static std::atomic<int> _numberOfActiveOperations;
+
       int m_ODE_NumUnknowns;
       std::vector<Species*> _DE_Variables;
-      int _numberOfTimePoints;
-      double* m_TimeValues;
-      int m_TimeLatestIndex;
 
-      long   _progress;
-      bool _cancelFlag;
+      //DE variables sorted by hierarchy level of their initial value formulas
+      //(species with independent initial values first)
+      std::vector<Species*> _leveledDEVariables;
+
+      //results of simplifying formula objects for the current run, reused by the next run
+      RunSimplificationCache _runSimplificationCache;
 
       bool _isLoaded;
       bool _isFinalized;
@@ -60,7 +81,51 @@ namespace SimModelNative
       XMLNode m_SimNode;
       void ResetScalarProperties();
       void ResetSimulation();
-      void LoadFromXMLDocument();
+
+      //<contentHash>: hash of the XML (s. XMLHelper::ContentHash), used to skip repeated schema validations
+      void LoadFromXMLDocument(uint64_t contentHash);
+
+      //true if schema validation is switched on and the XML with <contentHash> 
+      //was not validated before (s. XMLCache::IsValidatedContent).
+      //<schemaGeneration> must be passed to XMLCache::AddValidatedContent after the validation
+      bool xmlValidationRequired(uint64_t contentHash, uint64_t & schemaGeneration);
+
+      //load simulation from the (already parsed) <Simulation> node
+      void LoadFromSimulationNode(const XMLNode& simNode);
+
+      //releases the XML DOM of a finalized simulation (s. SimulationOptions::LeanMode)
+      void releaseXMLDocument();
+
+      //save references to all parameters/species/observers in _allQuantities
+      void FillAllQuantities();
+
+      //species and observers by their path without root (s. GetQuantityByPath).
+      //Created on first use and recreated if species/observers were added
+      std::unordered_map<std::string, Quantity*> _quantitiesByPath;
+      int _numberOfQuantitiesByPath;
+
+      //true if the simulation XML can be read element by element (s. SimulationOptions::StreamingXMLLoad)
+      bool UseStreamingXMLLoad();
+
+      //load simulation without creating the XML DOM, in two passes over the XML:
+      //1st pass creates all objects, 2nd pass resolves their references.
+      //<openReader> opens the reader at the start of the XML and is called once per pass
+      void LoadFromXMLReader(const std::function<void(XMLReader&)>& openReader, uint64_t contentHash);
+
+      //reads the child elements of <Simulation> and loads (1st pass) or finalizes (2nd pass) the objects
+      void readSimulationElements(XMLReader& reader, bool finalize);
+
+      //source/recorder of parsed explicit formula equations (e.g. preparsed model). Can be empty
+      std::shared_ptr<ParsedEquations> _parsedEquations;
+
+      //values of the variable parameters/species of a preparsed model, set at the end of Finalize
+      std::vector<ParameterInfo> _pendingParameterValues;
+      std::vector<SpeciesInfo> _pendingSpeciesValues;
+
+      //infos of all variable (not fixed) parameters and species
+      void InitialFillVariableInfos(std::vector<ParameterInfo>& variableParameters,
+                                    std::vector<SpeciesInfo>& variableSpecies,
+                                    bool calculateSensitivity);
 
       //version of the SimModel-XML
       int _XML_Version;
@@ -68,6 +133,9 @@ namespace SimModelNative
       //cached simulation string (for saving simulation in XML)
       std::string m_XMLString;
 
+      //writes m_XMLString with the current values (s. GetSimulationXMLString). Created on first use
+      std::shared_ptr<SimulationXMLWriter> _xmlWriter;
+
       //all hierarchical formula objects of the simulation, 
       //saved level by level, starting with HFOBJECT_TOP_LEVEL
       std::vector <HierarchicalFormulaObjectVector> _leveledHierarchicalFormulaObjects;
@@ -82,11 +150,22 @@ namespace SimModelNative
       //
       void FinalizeFormulas();
 
+      //explicit formulas not required for the simulation run and thus not finalized yet
+      //(s. SimulationOptions::LazyFinalize). They are finalized on demand
+      std::set<Formula*> _deferredFormulas;
+
+      //finalizes <formula> if its finalization was deferred
+      void finalizeDeferredFormula(Formula* formula);
+
       // - reset formula/value state of all quantities after simulation run is finished
       //   (e.g. if changed by switches during simulation)
       // - reset state of the switches
       void ResetState();
 
+      //resets the run context and prepares all objects for the next run
+      //(everything done before the ODE system is solved)
+      void prepareRun();
+
       //
       void FinalizeSwitches();
 
@@ -112,8 +191,6 @@ namespace SimModelNative
       TObjectList<Quantity>  _allQuantities; //union of parameters/observers/species (refs)
       TObjectList<Parameter> _sensitivityParameters; //sensitivity parameters (refs)
 
-      TObjectVector<SolverWarning> _solverWarnings;
-
    public:
       SIM_EXPORT Simulation();
       SIM_EXPORT virtual ~Simulation();
@@ -124,6 +201,9 @@ namespace SimModelNative
       TObjectList<Parameter>& Parameters();
       SIM_EXPORT TObjectList<Species>& SpeciesList(); //unfortunately, plural von Species is Species :-)
       SIM_EXPORT TObjectList<Observer>& Observers();
+
+      //species or observer with the given path without root (species first). Returns NULL if not found
+      SIM_EXPORT Quantity* GetQuantityByPath(const std::string& pathWithoutRoot);
       TObjectList<Switch>& Switches();
       TObjectList<Formula>& Formulas();
 
@@ -144,6 +224,48 @@ namespace SimModelNative
       SIM_EXPORT void LoadFromXMLFile(const std::string& sFileName);
       SIM_EXPORT void LoadFromXMLString(const std::string& sSimulationXML);
 
+      //creates a finalized copy of the (finalized) simulation, with the same 
+      //variable parameters/species and their current values.
+      //The copy is NOT a copy of the finalized objects but a reload: all objects are loaded 
+      //again from the XML DOM which was already parsed by this simulation and finalized 
+      //again (incl. equation parsing, simplification and switch analysis). 
+      //Only parsing of the XML string and the schema validation are skipped, 
+      //thus cloning takes almost as long as loading and finalizing the simulation.
+      //If the XML DOM is not available (lean mode or streaming load), the copy is loaded from
+      //the XML string kept by this simulation (s. SimulationOptions::KeepXMLNodeAsString).
+      //Equations already parsed by this simulation (preparsed model) are reused by the copy.
+      //The copy has no own XML DOM and thus can only be cloned itself if it keeps the XML string.
+      //If <calculateSensitivity> is false, no parameter sensitivities are calculated by the copy.
+      //Returned object must be destroyed by caller!
+      SIM_EXPORT Simulation* Clone(bool calculateSensitivity = true);
+
+      //true if the XML DOM or the XML string required by Clone is available
+      bool CanBeCloned() const;
+
+      //saves the (finalized) simulation as preparsed model (s. PreparsedModel.h):
+      //the simulation XML, the parsed equations of all explicit formulas and
+      //the variable parameters/species with their current values.
+      //Simulation must have been loaded from XML
+      SIM_EXPORT void SavePreparsedModel(const std::string& fileName);
+
+      //loads the simulation from a preparsed model created by SavePreparsedModel.
+      //Neither the XML string is parsed nor the schema validation is performed, and 
+      //the equations of explicit formulas are not parsed again when finalizing.
+      //All other steps of loading and finalizing are performed as for the simulation XML.
+      //Variable parameters/species are set as in the saved simulation;
+      //their values are restored by Finalize()
+      SIM_EXPORT void LoadFromPreparsedModel(const std::string& fileName);
+
+      //returns the source/recorder of parsed equations used while finalizing (or NULL)
+      ParsedEquations* GetParsedEquations();
+
+      //finalizes all formulas whose finalization was deferred (s. SimulationOptions::LazyFinalize).
+      //Required e.g. before exporting the simulation
+      SIM_EXPORT void FinalizeDeferredFormulas();
+
+      //number of formulas not finalized yet
+      SIM_EXPORT int GetNumberOfDeferredFormulas() const;
+
       int GetODENumUnknowns();
       double GetStartTime();
 
@@ -154,6 +276,10 @@ namespace SimModelNative
       //replace formulas with values where possible
       void SimplifyObjects(bool forCurrentRunOnly);
 
+      //same as SimplifyObjects(true), but only objects depending on parameters/species
+      //changed since the previous run are simplified again
+      void SimplifyObjectsForCurrentRun();
+
       //Returns initial values of all DE variables (not scaled!)
       //Array must be destroyed by caller!
       double* GetDEInitialValues();
@@ -166,7 +292,8 @@ namespace SimModelNative
       // - y is DE solution at <time>, which will be UPDATED by the function
       // y must be allocated before function call
       //Returns true if at least one quantity was effectively changed by switches
-      bool PerformSwitchUpdate(double* y, double time);
+      //<solverRestartRequired> is set to true if any of the changes requires the solver restart
+      bool PerformSwitchUpdate(double* y, double time, bool& solverRestartRequired);
 
       //get species used in DE system by its DE index
       Species* GetDEVariableFromIndex(int DESpeciesIndex);
@@ -232,6 +359,16 @@ namespace SimModelNative
       SIM_EXPORT void ReleaseMemory();
 
       SIM_EXPORT SimulationOptions& Options();
+
+      //statistics of the latest simulation run
+      SIM_EXPORT SimulationRunStatistics& RunStatistics();
+
+      //state of the current (or latest) simulation run
+      RunContext& GetRunContext();
+
+      //number of loads, finalizations and runs of all simulations of the process executed right now
+      //(worker processes of a population run are only forked if there are none, s. PopulationRunner)
+      static int NumberOfActiveOperations();
    };
 
 }//.. end "namespace SimModelNative"
@@ -23,6 +23,20 @@ namespace SimModelNative
 		                                                //for user output time points.Otherwise: double
 		bool _identifyUsedParameters; //if set to false: ALL parameters will be marked as used in ODE variables/observes
 		                              //otherwise: only parameters really used will be marked
+		bool _autoSolverConfiguration; //if set to true: linear solver (dense/band) and integration method (BDF/Adams)
+		                               //are selected automatically from the structure and the stiffness of the ODE system
+		bool _solveLinearSystemsExactly; //if set to true: ODE systems which are linear in y (between switch points)
+		                                 //are solved by the matrix exponential instead of CVODES
+		bool _streamingXMLLoad; //if set to true: simulation XML is read element by element without creating the XML DOM
+		                        //(lower peak memory; cloning and saving as preparsed model are not available then)
+		int _numberOfFinalizeThreads; //number of threads used for finalizing the formulas of the simulation
+		                              //(1: sequential; <= 0: number of hardware threads)
+		bool _useEquationCache; //if set to true: parsed equations are taken from/added to the process-wide
+		                        //equation cache shared by all simulations (s. EquationCache)
+		bool _lazyFinalize; //if set to true: only formulas used by species, observers and switches are finalized;
+		                    //all other formulas are finalized on demand (s. Simulation::FinalizeFormulas)
+		bool _leanMode; //if set to true: XML DOM is released after finalize
+		                //(lower memory; cloning and saving as preparsed model are not available then)
 
 	public:
 		SimulationOptions();
@@ -58,6 +72,27 @@ namespace SimModelNative
 		SIM_EXPORT bool UseFloatComparisonInUserOutputTimePoints() const;
 		SIM_EXPORT void SetUseFloatComparisonInUserOutputTimePoints(bool);
 
+		SIM_EXPORT bool AutoSolverConfiguration() const;
+		SIM_EXPORT void SetAutoSolverConfiguration(bool autoSolverConfiguration);
+
+		SIM_EXPORT bool SolveLinearSystemsExactly() const;
+		SIM_EXPORT void SetSolveLinearSystemsExactly(bool solveLinearSystemsExactly);
+
+		SIM_EXPORT bool StreamingXMLLoad() const;
+		SIM_EXPORT void SetStreamingXMLLoad(bool streamingXMLLoad);
+
+		SIM_EXPORT int NumberOfFinalizeThreads() const;
+		SIM_EXPORT void SetNumberOfFinalizeThreads(int numberOfFinalizeThreads);
+
+		SIM_EXPORT bool UseEquationCache() const;
+		SIM_EXPORT void SetUseEquationCache(bool useEquationCache);
+
+		SIM_EXPORT bool LazyFinalize() const;
+		SIM_EXPORT void SetLazyFinalize(bool lazyFinalize);
+
+		SIM_EXPORT bool LeanMode() const;
+		SIM_EXPORT void SetLeanMode(bool leanMode);
+
 		void CopyFrom(SimulationOptions & srcOptions);
 	};
 
@@ -0,0 +1,69 @@
+#ifndef _SimulationRunStatistics_H_
+#define _SimulationRunStatistics_H_
+
+#include "SimModel/GlobalConstants.h"
+
+namespace SimModelNative
+{
+
+	//statistics of the latest simulation run
+	class SimulationRunStatistics
+	{
+
+	private:
+		double _setupTime; //time (in s) spent for preparing the ODE system and the solver
+		double _solveTime; //time (in s) spent in the main solver loop
+		bool _solverInstanceReused; //true if solver instance of the previous run could be reinitialized
+		int _avoidedSolverRestarts; //number of switch updates performed without solver restart
+		int _scheduledSwitches; //number of switches fired from the switch schedule (time-only conditions)
+
+		//---- solver configuration used in the run
+		bool _bandLinearSolverUsed;
+		int _lowerHalfBandWidth;
+		int _upperHalfBandWidth;
+		bool _adamsMethodUsed; //false: BDF
+		double _spectralRadiusEstimate; //NaN if not estimated (no automatic solver configuration)
+		double _bdfSwitchTime; //restart time at which Adams was replaced by BDF (NaN if not replaced)
+
+		bool _linearSystemSolvedExactly; //true if the (linear) ODE system was solved by the matrix exponential
+
+	public:
+		SimulationRunStatistics();
+
+		//reset all values before the next simulation run
+		void Reset();
+
+		SIM_EXPORT double SetupTime() const;
+		void AddSetupTime(double setupTime);
+
+		SIM_EXPORT double SolveTime() const;
+		void AddSolveTime(double solveTime);
+
+		SIM_EXPORT bool SolverInstanceReused() const;
+		void SetSolverInstanceReused(bool solverInstanceReused);
+
+		SIM_EXPORT int AvoidedSolverRestarts() const;
+		void IncrementAvoidedSolverRestarts();
+
+		SIM_EXPORT int ScheduledSwitches() const;
+		void SetScheduledSwitches(int scheduledSwitches);
+
+		SIM_EXPORT bool BandLinearSolverUsed() const;
+		SIM_EXPORT int LowerHalfBandWidth() const;
+		SIM_EXPORT int UpperHalfBandWidth() const;
+		SIM_EXPORT bool AdamsMethodUsed() const;
+		void SetSolverConfiguration(bool bandLinearSolverUsed, int lowerHalfBandWidth, int upperHalfBandWidth, bool adamsMethodUsed);
+
+		SIM_EXPORT double SpectralRadiusEstimate() const;
+		void SetSpectralRadiusEstimate(double spectralRadiusEstimate);
+
+		SIM_EXPORT double BDFSwitchTime() const;
+		void SetBDFSwitchTime(double bdfSwitchTime);
+
+		SIM_EXPORT bool LinearSystemSolvedExactly() const;
+		void SetLinearSystemSolvedExactly(bool linearSystemSolvedExactly);
+	};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_SimulationRunStatistics_H_
@@ -33,10 +33,21 @@ public:
 	//mark all parameters which are used in any ODE varaible or observer as unused
 	static void MarkUsedParameters(Simulation * sim);
 
+	//formulas required for the simulation run: initial and RHS formulas of species,
+	//formulas of observers, switch conditions and new formulas of switches,
+	//formulas of persistable parameters and formulas of all parameters used by them.
+	//Must be called after the objects of the simulation were simplified
+	static std::set<Formula *> FormulasUsedInSimulation(Simulation * sim);
+
 	//cache DE variables indices used in the RHS equations
 	//in order to speed up the jacobian calculation
 	static void CacheRHSUsedVariables(Simulation * sim);
 
+	//returns true if the ODE system of the current run is y' = A*y + b with
+	//A and b constant between switch points (must be called after the
+	//formulas were simplified for the current run)
+	static bool ODESystemIsLinear(Simulation * sim);
+
 	//for debug only: write out RHS dependency matrix
 	static void WriteRHSDependencyMatrix(Simulation * sim, const std::string & filename);
 };
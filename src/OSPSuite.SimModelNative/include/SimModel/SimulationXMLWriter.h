@@ -0,0 +1,137 @@
+#ifndef _SimulationXMLWriter_H_
+#define _SimulationXMLWriter_H_
+
+#include "SimModel/OutputSchema.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Writes the simulation XML (s. Simulation::GetSimulationXMLString) without creating an XML DOM:
+//the original XML text is copied, replacing only the parts changed by the simulation
+//(values of variable quantities, scale factors of species and output intervals).
+//
+//Positions of these parts are indexed once by a single pass over the original XML,
+//so writing the XML is linear in its size
+class SimulationXMLWriter
+{
+private:
+	//part [start, end) of the original XML
+	struct TextRange
+	{
+		size_t start;
+		size_t end;
+	};
+
+	//start or end tag of an element
+	struct Tag
+	{
+		size_t start;        //position of '<'
+		size_t end;          //position after '>'
+		size_t nameEnd;      //position after the element name
+		std::string name;    //element name with namespace prefix (if any)
+		bool isEndTag;
+		bool isEmptyElement; //<name ... />
+	};
+
+	//value attribute of a quantity element.
+	//If the attribute is missing, the range is empty and placed behind the element name.
+	//Quantities without value have a formula attribute (formulaId or initialValueFormulaId),
+	//which must be replaced when a value is set
+	struct ValueAttribute
+	{
+		TextRange value;
+		bool exists;
+		TextRange formulaAttribute; //complete attribute (name="id")
+		bool formulaAttributeExists;
+	};
+
+	//element which is not closed yet
+	struct OpenElement
+	{
+		std::string localName;
+		size_t start;
+		long id;
+	};
+
+	//original XML; must not be changed or destroyed as long as the writer is used
+	const std::string & _xml;
+
+	//namespace prefix of the <Simulation> element (e.g. "" or "sm:"), used for new elements
+	std::string _prefix;
+
+	//<Simulation> element (without XML declaration, comments etc. around it)
+	TextRange _simulationElement;
+
+	//value attribute of the elements in <ParameterList> and <VariableList> by quantity id
+	std::unordered_map <long, ValueAttribute> _quantityValues;
+
+	//<ScaleFactor> element by species id
+	std::unordered_map <long, TextRange> _scaleFactors;
+
+	//elements in <FormulaList> by formula id
+	std::unordered_map <long, TextRange> _formulas;
+
+	//<OutputIntervalList> and <OutputTimeList> elements of <OutputSchema>
+	std::vector <TextRange> _outputLists;
+
+	//new output intervals are inserted here: empty range in front of </OutputSchema>
+	//or "/>" of an empty <OutputSchema/> element
+	TextRange _outputSchemaEnd;
+	bool _hasOutputSchema;
+	bool _outputSchemaIsEmptyElement;
+	std::string _outputSchemaName;
+
+	//replacements for the next Write by start position; later replacements of the same part win
+	std::map <size_t, std::pair <size_t, std::string> > _replacements;
+
+	//next tag starting at or behind <position> (comments, CDATA sections, processing
+	//instructions and declarations are skipped). False if there are no more tags
+	bool nextTag(size_t & position, Tag & tag) const;
+
+	//position behind <delimiter> searched from <position>
+	size_t skipBehind(size_t position, const std::string & delimiter) const;
+
+	//range of the value of attribute <attributeName> of <tag>. False if the attribute is missing.
+	//<attributeStart> (if given) returns the position of the attribute name
+	bool findAttribute(const Tag & tag, const std::string & attributeName, TextRange & valueRange, size_t * attributeStart = NULL) const;
+
+	//value of the id attribute of <tag> (INVALID_QUANTITY_ID if missing)
+	long idOf(const Tag & tag) const;
+
+	void index();
+	void indexStartTag(const std::vector <OpenElement> & openElements, const Tag & tag, long id);
+	void indexElement(const std::vector <OpenElement> & openElements, const TextRange & range);
+
+	void replace(const TextRange & range, const std::string & text);
+
+	static std::string localNameOf(const std::string & name);
+
+public:
+	//indexes <xml>; <xml> must contain the <Simulation> element
+	SimulationXMLWriter(const std::string & xml);
+
+	//sets the value attribute of the parameter or species <quantityId> ("NaN" for NaN)
+	void SetQuantityValue(long quantityId, double value);
+
+	//replaces formula <formulaId> by an explicit formula with equation=<value>
+	void SetFormulaValue(long formulaId, double value);
+
+	void SetScaleFactor(long speciesId, double scaleFactor);
+
+	//replaces output intervals and time points of the original XML by the intervals of <outputSchema>
+	void SetOutputIntervals(OutputSchema & outputSchema);
+
+	//original XML with all replacements set since the last call
+	std::string Write();
+
+	//text of the <Simulation> element of <xml> (e.g. a complete simulation XML file)
+	static std::string SimulationElementOf(const std::string & xml);
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_SimulationXMLWriter_H_
@@ -0,0 +1,32 @@
+#ifndef _SolverConfigurationTask_H_
+#define _SolverConfigurationTask_H_
+
+namespace SimModelNative
+{
+
+class Simulation;
+
+//automatic selection of the linear solver and the integration method
+//(used if SimulationOptions::AutoSolverConfiguration() is set)
+class SolverConfigurationTask
+{
+public:
+	//selects dense or band linear solver from the size and the (RCM reduced)
+	//bandwidth of the ODE system.
+	//Must be called during Finalize, before the DE variables are reordered for the band solver
+	static void SelectLinearSolver(Simulation * sim);
+
+	//returns ADAMS for non-stiff systems and BDF otherwise.
+	//System is considered stiff if the estimated spectral radius of the Jacobian
+	//is large compared to the simulated time span
+	static int SelectIntegrationMethod(double spectralRadius, double timeSpan);
+
+private:
+	//band solver is used only if its LU factorization is considerably
+	//cheaper than the dense one
+	static bool UseBandLinearSolver(int numberOfUnknowns, int lowerHalfBandWidth, int upperHalfBandWidth);
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_SolverConfigurationTask_H_
@@ -44,13 +44,17 @@ public:
 	void SetODEScaleFactor (double p_ODEScaleFactor);
 
 	void LoadFromXMLNode (const XMLNode & pNode);
-    void UpdateScaleFactorInXMLNode(const XMLNode & speciesListNode);
+    void UpdateScaleFactorInXML(SimulationXMLWriter & xmlWriter);
     void XMLFinalizeInstance (const XMLNode & pNode, Simulation * sim);
 
 	std::vector < HierarchicalFormulaObject * > GetUsedHierarchicalFormulaObjects ();
 	
 	bool IsConstant(bool forCurrentRunOnly);
 	bool IsConstantDuringCalculation();
+	FormulaLinearity Linearity();
+
+	//true if all right hand side formulas are (at most) linear in y
+	bool HasLinearRHS();
 
 	double GetInitialValue (const double * y, double time);
 	double GetValue (const double * y, double time, ScaleFactorUsageMode scaleFactorMode);
@@ -82,6 +86,9 @@ public:
 	void WriteCppCode (std::ostream & mrOut);
 	Formula * GetInitialFormula();
 
+	//(not zero) right hand side formulas
+	TObjectList<Formula> & RHSFormulaList();
+
 	//will be called between Load and Finalize of the parent simulation
 	void InitialFillInfo(SpeciesInfo & info);
 
@@ -0,0 +1,70 @@
+#ifndef _StringPool_H_
+#define _StringPool_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace SimModelNative
+{
+
+//Process-wide pool of strings repeated in many objects (names, units, container paths etc.).
+//
+//Every value is stored once as long as it is used by any PooledString
+//(of any simulation) and removed from the pool with its last user.
+//
+//Concurrency: all methods can be called from any thread.
+//Values are distributed over independently locked shards by their hash,
+//so threads loading simulations concurrently rarely wait for each other
+class StringPool
+{
+private:
+	static const size_t NUMBER_OF_SHARDS = 64;
+
+	struct Shard
+	{
+		std::mutex mutex;
+
+		//key views the pooled value itself
+		std::unordered_map <std::string_view, std::weak_ptr <const std::string> > values;
+	};
+
+	Shard _shards[NUMBER_OF_SHARDS];
+
+	static StringPool & instance();
+
+	static Shard & shardOf(std::string_view value);
+
+	//called when the last user of <value> is gone
+	static void release(const std::string * value);
+
+public:
+	//pooled value equal to <value>
+	static std::shared_ptr <const std::string> Intern(const std::string & value);
+
+	//number of pooled values
+	static size_t Size();
+};
+
+//Immutable string shared by all objects holding the same value (s. StringPool)
+class PooledString
+{
+private:
+	std::shared_ptr <const std::string> _value; //empty for ""
+
+public:
+	PooledString();
+	PooledString(const std::string & value);
+	PooledString & operator = (const std::string & value);
+
+	const std::string & Value() const;
+	operator const std::string & () const;
+
+	bool IsEmpty() const;
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_StringPool_H_
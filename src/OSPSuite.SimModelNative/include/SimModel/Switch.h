@@ -21,6 +21,9 @@ protected:
 	bool _oneTime; //should the switch fire only the first time its condition formula is satisfied
 	bool _wasFired; //was switch already fired (relevant if oneTime=true)
 
+	//performs all formula changes of the switch (condition must be already checked)
+	bool FireSwitch (double * y, double time, bool & solverRestartRequired);
+
 public:
 	Switch(void);
 	virtual ~Switch(void);
@@ -31,7 +34,23 @@ public:
 	void SimplifyFormulas(bool forCurrentRunOnly);
 	void Finalize();
 
-	bool PerformSwitchUpdate (double * y, double time);
+	//returns true if at least one quantity was effectively changed by the switch.
+	//<solverRestartRequired> is set to true if any change requires a solver restart
+	bool PerformSwitchUpdate (double * y, double time, bool & solverRestartRequired);
+
+	//same as PerformSwitchUpdate, but without evaluation of the condition formula.
+	//Used for switches whose condition is known to be satisfied at <time>
+	//(s. ScheduledTimePoints)
+	bool PerformScheduledSwitchUpdate (double * y, double time, bool & solverRestartRequired);
+
+	//returns true if the switch condition is satisfied exactly at the time points
+	//appended to <scheduledTimePoints> (and is independent of the ODE variables)
+	//must be called after the formulas were simplified for the current run
+	bool ScheduledTimePoints(std::vector <double> & scheduledTimePoints);
+
+	TObjectVector<FormulaChange> & FormulaChanges();
+
+	Formula * GetConditionFormula();
 
 	std::vector <double> SwitchTimePoints();
 
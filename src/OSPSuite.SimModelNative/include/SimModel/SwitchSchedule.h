@@ -0,0 +1,48 @@
+#ifndef _SwitchSchedule_H_
+#define _SwitchSchedule_H_
+
+#include "SimModel/Switch.h"
+#include "SimModel/TObjectList.h"
+#include <vector>
+#include <utility>
+
+namespace SimModelNative
+{
+
+//Switch schedule of one simulation run.
+//Switches whose condition depends on the time only (e.g. "Time == P1" or
+//"(Time == P1) Or (Time == P2)" with P1, P2 constant during the run) are fired
+//directly from the schedule without evaluation of their condition formula.
+//Conditions of all other switches are evaluated at every switch/output time point
+class SwitchSchedule
+{
+private:
+	//(time point, switch index) of all scheduled switches, sorted by time point and switch index
+	std::vector <std::pair <double, int> > _scheduledSwitches;
+
+	//indices of all switches whose condition must be evaluated (sorted)
+	std::vector <int> _conditionalSwitches;
+
+	int _numberOfScheduledSwitches;
+	bool _isCompiled;
+
+public:
+	SwitchSchedule(void);
+
+	//classifies the switches and builds the schedule for the current run
+	//(must be called after the formulas were simplified for the current run)
+	void Compile(TObjectList<Switch> & switches);
+
+	bool IsCompiled() const;
+
+	//number of switches which are fired from the schedule
+	int NumberOfScheduledSwitches() const;
+
+	//performs the switch update at the given time point. Switches are processed
+	//in the same order as without schedule (by their index)
+	bool PerformSwitchUpdate(TObjectList<Switch> & switches, double * y, double time, bool & solverRestartRequired);
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_SwitchSchedule_H_
@@ -8,6 +8,8 @@
 namespace SimModelNative
 {
 
+class Simulation;
+
 class SwitchTask
 {
 public:
@@ -18,6 +20,12 @@ public:
 	//where P1 and P2 are CONSTANT during the simulation run and P3 is not, then
 	// DoubleQueue {P1.Value, P2.Value} will be returned
 	static DoubleQueue SwitchTimePoints(TObjectList<Switch>    & Switches);
+
+	//marks all formula changes whose target quantity is not used (neither directly
+	//nor indirectly) in the RHS of the ODE system. Performing such formula changes
+	//does not require a solver restart
+	//(must be called after formulas and switches were finalized)
+	static void AnalyzeSwitchImpact(Simulation * sim);
 };
 
 }//.. end "namespace SimModelNative"
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <assert.h>
 
 #include "ErrorData.h"
@@ -24,6 +25,12 @@ class TObjectList
 		long * _objectIds;
 		std::vector <std::string> _entityIds;
 		int m_size;
+
+		//indices of the objects by id/entity id (first object if not unique)
+		std::unordered_map <long, int> _indexById;
+		std::unordered_map <std::string, int> _indexByEntityId;
+
+		void clearIndices ();
 	
 	public:
 		TObjectList ();
@@ -50,12 +57,20 @@ template < class T >
 	_objectIds = NULL;
 }
 
+template < class T >
+void TObjectList<T>::clearIndices ()
+{
+	_entityIds.clear();
+	_indexById.clear();
+	_indexByEntityId.clear();
+}
+
 template < class T >
 T * TObjectList<T>::GetObjectByEntityId(const std::string & entityId)
 {
-	//Loop ids array and get Index of object with given id 
-	for (int i=0;i<m_size;i++)
-		if (_entityIds[i]==entityId) return m_List[i];
+	typename std::unordered_map <std::string, int>::const_iterator iter = _indexByEntityId.find(entityId);
+	if (iter != _indexByEntityId.end())
+		return m_List[iter->second];
 		
 	// Not Found
 	return NULL;
@@ -64,9 +79,9 @@ T * TObjectList<T>::GetObjectByEntityId(const std::string & entityId)
 template < class T >
 T * TObjectList<T>::GetObjectById (const long id) const
 {
-	//Loop ids array and get Index of object with given id 
-	for (int i=0;i<m_size;i++)
-		if (_objectIds[i]==id) return m_List[i];
+	typename std::unordered_map <long, int>::const_iterator iter = _indexById.find(id);
+	if (iter != _indexById.end())
+		return m_List[iter->second];
 		
 	// Not Found
 	return NULL;
@@ -96,16 +111,14 @@ void TObjectList<T>::clear ()
 	_objectIds=NULL;
 
 	m_List = NULL;
+
+	clearIndices();
 }
 
 template < class T >
 bool TObjectList<T>::Exists (const long id) const
 {
- 	for(int i=0;i<m_size;i++)
- 		if (_objectIds[i]== id) return true;
- 	
- 	//Not found
- 	return false;
+ 	return _indexById.find(id) != _indexById.end();
 }
 
 template < class T >
@@ -136,6 +149,10 @@ void TObjectList<T>::Add (T * pObject)
 	_objectIds[m_size-1]=objId;
 
 	_entityIds.push_back(pObject->GetEntityId());
+
+	//emplace keeps the index of the first object with the same id
+	_indexById.emplace(objId, m_size-1);
+	_indexByEntityId.emplace(_entityIds.back(), m_size-1);
 }
 
 template < class T >
@@ -157,6 +174,8 @@ void TObjectList<T>::FreeVector (void )
 		_objectIds = NULL;
 		
 		m_size = 0;
+
+		clearIndices();
 	}
 }
 
@@ -0,0 +1,181 @@
+#ifndef _TaskScheduler_H_
+#define _TaskScheduler_H_
+
+#include "SimModel/Simulation.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace SimModelNative
+{
+
+//Priority classes of scheduled tasks.
+//Pending tasks of a higher priority class are always started before pending tasks
+//of a lower one (tasks already running are never interrupted)
+enum TaskPriority
+{
+	TP_INTERACTIVE = 0, //short tasks a caller is waiting for
+	TP_BATCH = 1,       //e.g. individuals of a population run
+	TP_NUMBER_OF_PRIORITIES = 2
+};
+
+//Tasks submitted together (e.g. all individuals of one population run).
+//Allows to wait for, to cancel and to monitor the progress of the whole group
+class TaskGroup
+{
+	friend class TaskScheduler;
+
+private:
+	std::mutex _mutex;
+	std::condition_variable _allTasksFinished;
+
+	int _numberOfTasks;
+	int _numberOfFinishedTasks;
+	int _numberOfStolenTasks;
+
+	//max. number of tasks of the group running at the same time (0: unlimited)
+	//and slots (0.._maximumConcurrency-1) not used by a running task
+	int _maximumConcurrency;
+	std::vector <int> _freeSlots;
+
+	//queue of the scheduler which receives the tasks of the group (-1: not assigned yet)
+	int _homeQueue;
+
+	std::atomic<bool> _cancelFlag;
+
+	//simulations currently run by the tasks of the group
+	std::set <Simulation *> _runningSimulations;
+
+	//progress never decreases (a finished simulation is removed from the
+	//running simulations before its task is counted as finished)
+	long _progress;
+
+	void taskSubmitted();
+
+	//returns false if the maximum concurrency is reached.
+	//<stolen>: task is taken from the queue of another worker
+	bool tryAcquireSlot(int workerIndex, bool stolen, int & slot);
+
+	//returns true if a slot was released
+	bool taskFinished(int slot);
+
+	bool allTasksFinished();
+
+public:
+	TaskGroup(void);
+
+	//Limits the number of tasks of the group running at the same time (<=0: unlimited).
+	//Must be set before the first task is submitted
+	void SetMaximumConcurrency(int maximumConcurrency);
+	int MaximumConcurrency() const;
+
+	//Cooperative cancellation: running simulations of the group are stopped
+	//at their next cancellation check (s. Simulation::GetCancelFlag).
+	//Tasks not started yet are still executed and must check IsCanceled() themselves
+	void Cancel();
+	bool IsCanceled() const;
+
+	//must be called by a task before/after running a simulation, so that the
+	//simulation is canceled with the group and contributes to the group progress
+	void SimulationStarted(Simulation * simulation);
+	void SimulationFinished(Simulation * simulation);
+
+	//progress of the group (0..100): finished tasks and progress of running simulations
+	long Progress();
+
+	//number of tasks executed by another worker than the one whose queue they were placed in
+	int NumberOfStolenTasks();
+
+	//blocks until all submitted tasks of the group are finished.
+	//Must not be called by a task (s. TaskScheduler::Wait)
+	void Wait();
+};
+
+//Work-stealing scheduler, shared by all simulations of the process (s. GetInstance).
+//
+//Every worker has its own task queue per priority class. Tasks submitted by a worker
+//are placed in its own queue, all other tasks of a group in the queue of one worker
+//(chosen round robin per group). A worker takes tasks from the front of its own queue
+//and, once it is empty, steals from the back of the queues of the other workers.
+//So workers which got cheap tasks take over the remaining work of workers which got
+//expensive ones (e.g. individuals with tolerance reduction)
+class TaskScheduler
+{
+public:
+	//task is called with the slot (0..maximum concurrency of its group - 1) it is executed in,
+	//so that it can use resources owned by the slot (e.g. a model copy). For groups with
+	//unlimited concurrency, the slot is the index of the executing worker.
+	//Exceptions thrown by a task are swallowed: tasks must report their errors themselves
+	typedef std::function <void(int)> Task;
+
+private:
+	struct ScheduledTask
+	{
+		Task task;
+		TaskGroup * group;
+		int queue; //queue the task was placed in
+	};
+
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque <ScheduledTask> tasks[TP_NUMBER_OF_PRIORITIES];
+	};
+
+	static std::atomic<TaskScheduler *> _instance;
+	static std::mutex _instanceMutex;
+
+	//worker queues are only added (s. EnsureNumberOfThreads)
+	std::vector <std::unique_ptr <WorkerQueue> > _queues;
+	std::vector <std::thread> _threads;
+	mutable std::shared_mutex _queuesMutex;
+
+	std::mutex _mutex;
+	std::condition_variable _taskAvailable;
+	int _numberOfPendingTasks;
+	int _numberOfRunningTasks;
+
+	//changed whenever a pending task might have become executable
+	//(new task or free slot of a group with limited concurrency)
+	unsigned long long _generation;
+
+	std::atomic<unsigned int> _nextQueue;
+
+	TaskScheduler(int numberOfThreads);
+
+	void addWorkers(int numberOfThreads);
+	void workerLoop(int workerIndex);
+	bool tryTakeTask(int workerIndex, ScheduledTask & scheduledTask, int & slot);
+	void execute(ScheduledTask & scheduledTask, int slot);
+	void notifyTaskAvailable();
+
+public:
+	//scheduler with one worker per hardware thread; never destroyed
+	static TaskScheduler & GetInstance();
+
+	int NumberOfThreads() const;
+
+	//true if tasks of any group are pending or running (false if the scheduler was never used)
+	static bool HasActiveTasks();
+
+	//adds workers if less than <numberOfThreads> are available
+	//(e.g. more worker threads are requested for a population run than hardware threads are available)
+	void EnsureNumberOfThreads(int numberOfThreads);
+
+	void Submit(TaskGroup & group, const Task & task, TaskPriority priority = TP_BATCH);
+
+	//blocks until all tasks of <group> are finished.
+	//Called by a task, the worker executes other pending tasks in the meantime
+	void Wait(TaskGroup & group);
+};
+
+}//.. end "namespace SimModelNative"
+
+#endif //_TaskScheduler_H_
@@ -13,6 +13,7 @@ BandwidthReductionTask::BandwidthReductionTask(Simulation * sim)
 	_sim = sim;
 	_lowerHalfBandWidth = 0;
 	_upperHalfBandWidth = 0;
+	_density = 0.0;
 }
 
 int BandwidthReductionTask::GetLowerHalfBandWidth()
@@ -25,6 +26,51 @@ int BandwidthReductionTask::GetUpperHalfBandWidth()
 	return _upperHalfBandWidth;
 }
 
+double BandwidthReductionTask::GetDensity()
+{
+	return _density;
+}
+
+void BandwidthReductionTask::EstimateHalfBandWidths()
+{
+	vector<vector<bool> > dependencyMatrix = getDependencyMatrix();
+	size_t numberOfVariables = dependencyMatrix.size();
+
+	_lowerHalfBandWidth = 0;
+	_upperHalfBandWidth = 0;
+	_density = 0.0;
+
+	if (numberOfVariables == 0)
+		return;
+
+	Rcm rcm;
+	vector<unsigned int> indicesPermutation = rcm.GenRcm(dependencyMatrix);
+
+	//new index of every variable after reordering
+	vector<int> newIndices(numberOfVariables);
+	for (size_t i = 0; i < numberOfVariables; i++)
+		newIndices[indicesPermutation[i]] = (int)i;
+
+	size_t numberOfNonzeros = 0;
+
+	for (size_t i = 0; i < numberOfVariables; i++)
+	{
+		for (size_t j = 0; j < numberOfVariables; j++)
+		{
+			if (!dependencyMatrix[i][j])
+				continue;
+
+			numberOfNonzeros++;
+
+			int distance = newIndices[j] - newIndices[i];
+			_upperHalfBandWidth = max(_upperHalfBandWidth, distance);
+			_lowerHalfBandWidth = max(_lowerHalfBandWidth, -distance);
+		}
+	}
+
+	_density = (double)numberOfNonzeros / ((double)numberOfVariables * (double)numberOfVariables);
+}
+
 void BandwidthReductionTask::ReorderDEVariables()
 {
 	//---- get variable dependencies
@@ -372,6 +372,31 @@ vector <double> EqualFormula::SwitchTimePoints()
 	return SwitchTimePointFromComparisonFormula();
 }
 
+bool EqualFormula::AppendScheduledTimePoints(vector <double> & scheduledTimePoints)
+{
+	Formula * timePointFormula = NULL;
+
+	if (m_FirstOperandFormula->IsTime())
+		timePointFormula = m_SecondOperandFormula;
+	else if (m_SecondOperandFormula->IsTime())
+		timePointFormula = m_FirstOperandFormula;
+
+	//formula must be "Time == <Formula>" or "<Formula> == Time", where <Formula>
+	//is constant during the current run (so it will not change between the
+	//calculation of the schedule and the switch time point)
+	bool forCurrentRunOnly = true;
+	if ((timePointFormula == NULL) || !timePointFormula->IsConstant(forCurrentRunOnly))
+		return false;
+
+	double timePoint = timePointFormula->DE_Compute(NULL, 0.0, USE_SCALEFACTOR);
+
+	//NaN time point: condition is never satisfied
+	if (!isnan(timePoint))
+		scheduledTimePoints.push_back(timePoint);
+
+	return true;
+}
+
 //-------------------------------------------------------------------
 //---- GreaterEqual (A>=B)
 //-------------------------------------------------------------------
@@ -573,6 +598,20 @@ Formula* OrFormula::clone()
 	return f;
 }
 
+bool OrFormula::AppendScheduledTimePoints(vector <double> & scheduledTimePoints)
+{
+	//(A||B) can only be scheduled if both operands can be scheduled
+	vector <double> timePoints;
+
+	if (!m_FirstOperandFormula->AppendScheduledTimePoints(timePoints) ||
+		!m_SecondOperandFormula->AppendScheduledTimePoints(timePoints))
+		return false;
+
+	scheduledTimePoints.insert(scheduledTimePoints.end(), timePoints.begin(), timePoints.end());
+
+	return true;
+}
+
 void OrFormula::WriteFormulaMatlabCode (std::ostream & mrOut)
 {
 	m_FirstOperandFormula->WriteMatlabCode(mrOut);
@@ -188,6 +188,9 @@ namespace SimModelNative
 			sim->Finalize();
 		}
 
+		//all formulas are exported
+		sim->FinalizeDeferredFormulas();
+
 		sim->MarkQuantitiesUsedBySwitches();
 
 		////simplify parameters that could not be simplified earlier (in Finalize)
@@ -3,16 +3,60 @@
 #include "SimModel/MathHelper.h"
 #include "XMLWrapper/XMLHelper.h"
 #include "SimModel/SimulationTask.h"
+#include "SimModel/SolverConfigurationTask.h"
 
 #include "DynamicLibrary.h"
 
 #include <cmath>
+#include <cfloat>
+#include <algorithm>
 #include <ctime>
+#include <chrono>
 #include <vector>
 
 namespace SimModelNative
 {
 
+	static double secondsSince(const std::chrono::steady_clock::time_point & startTime)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
+	SolverConfiguration::SolverConfiguration()
+	{
+		NumberOfUnknowns = 0;
+		NumberOfSensitivityParameters = 0;
+		AbsTol = 0.0;
+		RelTol = 0.0;
+		H0 = 0.0;
+		HMin = 0.0;
+		HMax = 0.0;
+		MxStep = 0;
+		UseJacobian = false;
+		UseBandLinearSolver = false;
+		LowerHalfBandWidth = 0;
+		UpperHalfBandWidth = 0;
+		LinearMultistepMethod = BDF;
+	}
+
+	bool SolverConfiguration::operator==(const SolverConfiguration & other) const
+	{
+		return SolverName == other.SolverName &&
+			NumberOfUnknowns == other.NumberOfUnknowns &&
+			NumberOfSensitivityParameters == other.NumberOfSensitivityParameters &&
+			AbsTol == other.AbsTol &&
+			RelTol == other.RelTol &&
+			H0 == other.H0 &&
+			HMin == other.HMin &&
+			HMax == other.HMax &&
+			MxStep == other.MxStep &&
+			UseJacobian == other.UseJacobian &&
+			UseBandLinearSolver == other.UseBandLinearSolver &&
+			LowerHalfBandWidth == other.LowerHalfBandWidth &&
+			UpperHalfBandWidth == other.UpperHalfBandWidth &&
+			LinearMultistepMethod == other.LinearMultistepMethod;
+	}
+
 	SimModelSolverBase * DESolver::GetSolver ()
 	{
 		const char * ERROR_SOURCE = "DESolver::GetSolver";
@@ -70,6 +114,107 @@ namespace SimModelNative
 
 		_lowerHalfBandWidth = 0;
 		_upperHalfBandWidth = 0;
+
+		_linearMultistepMethod = BDF;
+
+		_solver = NULL;
+		_workArraysSize = 0;
+		_solution = NULL;
+		_solutionAboveAbsTol = NULL;
+		_sensitivityValues = NULL;
+		_sensitivityValuesRows = 0;
+		_sensitivityValuesColumns = 0;
+	}
+
+	DESolver::~DESolver ()
+	{
+		ReleaseSolver();
+	}
+
+	void DESolver::ReleaseSolver ()
+	{
+		if (_solver)
+			delete _solver;
+		_solver = NULL;
+		_solverConfiguration = SolverConfiguration();
+
+		ReleaseWorkArrays();
+	}
+
+	SolverConfiguration DESolver::CurrentSolverConfiguration()
+	{
+		SolverConfiguration configuration;
+
+		configuration.SolverName = m_UsedSolver;
+		configuration.NumberOfUnknowns = m_ODE_NumUnknowns;
+		configuration.NumberOfSensitivityParameters = _sensitivityParameters.size();
+		configuration.AbsTol = m_SolverProperties.GetAbsTol();
+		configuration.RelTol = m_SolverProperties.GetRelTol();
+		configuration.H0 = m_SolverProperties.GetH0();
+		configuration.HMin = m_SolverProperties.GetHMin();
+		configuration.HMax = m_SolverProperties.GetHMax();
+		configuration.MxStep = m_SolverProperties.GetMxStep();
+		configuration.UseJacobian = m_SolverProperties.GetUseJacobian();
+		configuration.UseBandLinearSolver = _useBandLinearSolver;
+		configuration.LowerHalfBandWidth = _lowerHalfBandWidth;
+		configuration.UpperHalfBandWidth = _upperHalfBandWidth;
+		configuration.LinearMultistepMethod = _linearMultistepMethod;
+
+		return configuration;
+	}
+
+	void DESolver::RedimWorkArrays()
+	{
+		const char * ERROR_SOURCE = "DESolver::RedimWorkArrays";
+
+		if (_workArraysSize != m_ODE_NumUnknowns)
+		{
+			ReleaseWorkArrays();
+
+			if (m_ODE_NumUnknowns > 0)
+			{
+				m_ODEVariables = new Species *[m_ODE_NumUnknowns];
+				_solution = new double[m_ODE_NumUnknowns];
+				_solutionAboveAbsTol = new double[m_ODE_NumUnknowns];
+
+				if (!m_ODEVariables || !_solution || !_solutionAboveAbsTol)
+					throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot allocate memory for solution vector");
+			}
+
+			_workArraysSize = m_ODE_NumUnknowns;
+		}
+
+		redimSensitivityMatrix();
+	}
+
+	void DESolver::ReleaseWorkArrays()
+	{
+		if (m_ODEVariables) delete[] m_ODEVariables;
+		m_ODEVariables = NULL;
+
+		if (_solution) delete[] _solution;
+		_solution = NULL;
+
+		if (_solutionAboveAbsTol) delete[] _solutionAboveAbsTol;
+		_solutionAboveAbsTol = NULL;
+
+		_workArraysSize = 0;
+
+		ReleaseSensitivityMatrix();
+	}
+
+	void DESolver::ReleaseSensitivityMatrix()
+	{
+		if (_sensitivityValues)
+		{
+			for (int i = 0; i < _sensitivityValuesRows; i++)
+				delete[] _sensitivityValues[i];
+			delete[] _sensitivityValues;
+		}
+
+		_sensitivityValues = NULL;
+		_sensitivityValuesRows = 0;
+		_sensitivityValuesColumns = 0;
 	}
 
 	bool DESolver::UseBandLinearSolver()
@@ -102,12 +247,46 @@ namespace SimModelNative
 		_upperHalfBandWidth = upperHalfBandWidth;
 	}
 
+	bool DESolver::ReInitCachedSolver(const double simStartTime, const double * initialvalues)
+	{
+		if (!_solver)
+			return false;
+
+		SolverConfiguration configuration = CurrentSolverConfiguration();
+
+		//values of sensitivity parameters can only be passed to the solver
+		//before its initialization. Thus solver instances with sensitivities are never reused
+		if (!(configuration == _solverConfiguration) || (configuration.NumberOfSensitivityParameters > 0))
+			return false;
+
+		vector <double> initialvalues_vec(initialvalues, initialvalues + m_ODE_NumUnknowns);
+
+		return _solver->ReInit(simStartTime, initialvalues_vec) == DE_NOERROR;
+	}
+
 	SimModelSolverBase * DESolver::SetupSolver(const double simStartTime, const double * initialvalues)
 	{
 		int i;
 
+		_parentSim->RunStatistics().SetSolverConfiguration(_useBandLinearSolver, _lowerHalfBandWidth, 
+			                                               _upperHalfBandWidth, _linearMultistepMethod == ADAMS);
+
+		//reuse solver instance of the previous run if possible
+		if (ReInitCachedSolver(simStartTime, initialvalues))
+		{
+			_parentSim->RunStatistics().SetSolverInstanceReused(true);
+			return _solver;
+		}
+
+		//solver instance of the previous run cannot be reused: release it
+		if (_solver)
+			delete _solver;
+		_solver = NULL;
+
 		//create new solver instance
 		SimModelSolverBase * pSolver = this->GetSolver();
+		_solver = pSolver;
+		_solverConfiguration = CurrentSolverConfiguration();
 
 		//initial time
 		pSolver->SetInitialTime(simStartTime);
@@ -138,14 +317,17 @@ namespace SimModelNative
 		pSolver->SetHMax(m_SolverProperties.GetHMax());
 
 		//set special solver options
-		pSolver->SetOption("MAXORD", 5);
+		//(max. order: 5 for BDF, 12 for Adams)
+		pSolver->SetOption("MAXORD", _linearMultistepMethod == ADAMS ? 12 : 5);
 		pSolver->SetOption("MXHNIL", 10);
-		pSolver->SetOption("LMM", BDF);
+		pSolver->SetOption("LMM", _linearMultistepMethod);
 		pSolver->SetOption("ITER", NEWTON);
 
 		//call main solver initialization routine
 		pSolver->Init();
 
+		_parentSim->RunStatistics().SetSolverInstanceReused(false);
+
 		//return created solver instance
 		return pSolver;
 	}
@@ -161,77 +343,63 @@ namespace SimModelNative
 	{
 		const char * ERROR_SOURCE = "DESolver::Solve_ODE";
 
-		SimModelSolverBase * pSolver = NULL;  //pointer to new solver instance
-		double * initialvalues = NULL;        //(scaled) initial values of DE variables
-		double * initialvaluesUnscaled = NULL;        //unscaled initial values of DE variables
-		double * solution = NULL;             //solution vector of current problem
-		double * solutionAboveAbsTol = NULL;  //solution vector of current problem where all values in [-AbsTol..AbsTol] are set to zero
-		double ** sensitivityValues = NULL;   //sensitivity values for one time point [NumberOfUnknowns X NumberOfSensitivityParameters] 
+		SimModelSolverBase * pSolver = NULL;  //pointer to the (new or reinitialized) solver instance
 
 		try
 		{
-			_rhs_outputs.clear();
-			_jacobian_outputs.clear();
-
 			int i;
 
+			//start of the setup phase (reported separately from the solving time)
+			std::chrono::steady_clock::time_point setupStartTime = std::chrono::steady_clock::now();
+
 			//simulation start time
 			double simStartTime = _parentSim->GetStartTime();
 
-			// Get number of unknowns (MUST be set BEFORE calling this->GetSolver())
-			m_ODE_NumUnknowns = _parentSim->GetODENumUnknowns();
-
 			//cache start execution time
 			//used to check if execution time limit exceeded (if applies)
 			double executionStartTime = clock() / (double)CLOCKS_PER_SEC;
 
-			//output time points of the simulation
-			vector <OutputTimePoint> outputTimePoints = SimulationTask::OutputTimePoints(_parentSim);
+			//initial values, result arrays and work arrays of the run
+			//(number of unknowns MUST be set BEFORE calling this->GetSolver())
+			vector <OutputTimePoint> outputTimePoints = prepareSolving();
 			int numberOfTimeSteps = (unsigned int)outputTimePoints.size();
-			int numberOfSimulatedTimeSteps = SimulationTask::NumberOfSimulatedTimeSteps(outputTimePoints);
 
-			//get scaled initial values for DE variables
-			initialvalues = _parentSim->GetDEInitialValuesScaled();
+			bool solverRestartRequired;
 
-			//get unscaled initial values
-			initialvaluesUnscaled = _parentSim->GetDEInitialValues();
-
-			//redim species/observers/time array of the simulation
-			_parentSim->RedimAndInitValues(numberOfSimulatedTimeSteps+1,
-				                           initialvalues, initialvaluesUnscaled); //+1 because of sim start time, 
-			                                                       //which is not included in outputTimePoints
-
-			//---- cache DE variables arranged by their ODE Index
-			m_ODEVariables= new Species * [m_ODE_NumUnknowns];
-			if (!m_ODEVariables)
-				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,"Cannot allocate memory for ODE variables");
-
-			for(i=0; i<m_ODE_NumUnknowns; i++)
-				m_ODEVariables[i] = _parentSim->GetDEVariableFromIndex(i);
-
-			//cache sensitivity parameters
-			_sensitivityParameters = _parentSim->SensitivityParameters();
-
-			//---- allocate memory for solution and switch updated solution
-			solution = new double [m_ODE_NumUnknowns];
-			solutionAboveAbsTol = new double [m_ODE_NumUnknowns];
-
-			if (!solution || !solutionAboveAbsTol)
-				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,"Cannot allocate memory for solution vector");
-
-			//---- perform initial switch update on <initialvalues>
-			_parentSim->PerformSwitchUpdate(initialvalues, simStartTime);
+			//---- select integration method from the stiffness of the system at the start time
+			//     (re-checked at every solver restart, s. below).
+			//     Solver instances with sensitivities cannot be replaced during the run (sensitivities 
+			//     would be lost): thus BDF is used for them as soon as switches could make the system stiff
+			_linearMultistepMethod = BDF;
+			if ((m_ODE_NumUnknowns > 0) && _parentSim->Options().AutoSolverConfiguration() &&
+				((_sensitivityParameters.size() == 0) || (_parentSim->Switches().size() == 0)))
+			{
+				double spectralRadius = estimateSpectralRadius(simStartTime, _solution);
+				double timeSpan = outputTimePoints.empty() ? 0.0 : outputTimePoints.back().Time() - simStartTime;
 
-			//initialize solution vector with initial data
-			for (i = 0; i < m_ODE_NumUnknowns; i++)
-				solution[i] = initialvalues[i];
+				_linearMultistepMethod = SolverConfigurationTask::SelectIntegrationMethod(spectralRadius, timeSpan);
+				_parentSim->RunStatistics().SetSpectralRadiusEstimate(spectralRadius);
+			}
 			
+			//---- linear ODE systems (with constant coefficients between switch points)
+			//     are solved by the matrix exponential if requested
+			bool solveLinearSystemExactly = (m_ODE_NumUnknowns > 0) && 
+			                                _parentSim->Options().SolveLinearSystemsExactly() &&
+			                                SimulationTask::ODESystemIsLinear(_parentSim);
+			_parentSim->RunStatistics().SetLinearSystemSolvedExactly(solveLinearSystemExactly);
+
+			if (solveLinearSystemExactly)
+			{
+				_linearODESolver.Reset();
+				assembleLinearSystem(simStartTime);
+			}
+
 			//---- setup DE solver
 			// If number of diff. eq. variables is =0 (no species or all specie constant)
 			// don't create the solver (actually nothing to solve)
 			// In this case, main loop will just fill output time vector and observers
-			if (m_ODE_NumUnknowns > 0)
-				pSolver = SetupSolver(simStartTime, initialvalues);
+			if ((m_ODE_NumUnknowns > 0) && !solveLinearSystemExactly)
+				pSolver = SetupSolver(simStartTime, _solution);
 
 			//---- check if in interactive mode
 			_showProgress = _parentSim->Options().ShowProgress();
@@ -242,10 +410,14 @@ namespace SimModelNative
 			//index of the next reached output time point
 			int TimeStepNumber = 0; 
 
+			//time reached in the previous step (required by the linear solver only)
+			double previousOutputTime = simStartTime;
+
 			_noOfInfiniteWarnings = 0;
-			
-			//allocate space for sensitivities
-			sensitivityValues = redimSensitivityMatrix();
+
+			//setup is finished, solving starts
+			_parentSim->RunStatistics().AddSetupTime(secondsSince(setupStartTime));
+			std::chrono::steady_clock::time_point solveStartTime = std::chrono::steady_clock::now();
 
 			//---- main DE loop
 			for(int timeStepIdx=0; timeStepIdx<numberOfTimeSteps; timeStepIdx++)
@@ -280,11 +452,16 @@ namespace SimModelNative
 				double solverOutputTime;
 				int iResultflag;
 
-				if (m_ODE_NumUnknowns > 0)
+				if (solveLinearSystemExactly)
+				{
+					_linearODESolver.Advance(_solution, outTimePoint.Time() - previousOutputTime);
+					solverOutputTime = outTimePoint.Time();
+				}
+				else if (m_ODE_NumUnknowns > 0)
 				{
 					do
 					{
-						iResultflag = pSolver->PerformSolverStep(outTimePoint.Time(), solution, sensitivityValues, solverOutputTime, SimModelSolverBase::SINGLE);
+						iResultflag = pSolver->PerformSolverStep(outTimePoint.Time(), _solution, _sensitivityValues, solverOutputTime, SimModelSolverBase::SINGLE);
 					} while (shouldContinueThisStep(outTimePoint.Time(), solverOutputTime, iResultflag));
 
 					if (_parentSim->GetCancelFlag())
@@ -317,107 +494,174 @@ namespace SimModelNative
 					//increase time step index
 					TimeStepNumber++;
 
-					//Update Observer values for this time step
-					// (use solution where all values in [-AbsTol..AbsTol] are set to zero!
-					for (i = 0; i < m_ODE_NumUnknowns; i++)
-						solutionAboveAbsTol[i] = solution[i];
-
-					SimulationTask::SetValuesBelowAbsTolLevelToZero(solutionAboveAbsTol, m_ODE_NumUnknowns, m_SolverProperties.GetAbsTol());
-					_parentSim->SetObserverValues(TimeStepNumber, solutionAboveAbsTol, solverOutputTime, sensitivityValues);
-
-					// Output solution at the current time step
-					_parentSim->SetTimeValue(TimeStepNumber,solverOutputTime);
-
-					//save solution at the current time step into the compartments
-					// (for non-persistable variables: just overwrite the (only) value)
-					for (i = 0; i < m_ODE_NumUnknowns; i++)
-						m_ODEVariables[i]->SetValue(m_ODEVariables[i]->IsPersistable() ? TimeStepNumber : 0, solution[i]);
-
-					//check for not allowed negative values
-					//(must be done BEFORE rescaling the values back)
-               if (_parentSim->GetSolver().GetSolverProperties().GetCheckForNegativeValues())
-						SimulationTask::CheckForNegativeValues(m_ODEVariables, m_ODE_NumUnknowns, m_SolverProperties.GetAbsTol(), solverOutputTime);
-
-					//save sensitivity values at the current time step for all variables
-					storeSensitivityValues(TimeStepNumber, sensitivityValues);
+					storeSolution(TimeStepNumber, solverOutputTime);
 				}
 
 				//---- perform switches
-				bool switchUpdate = _parentSim->PerformSwitchUpdate(solution, solverOutputTime);
+				bool switchUpdate = _parentSim->PerformSwitchUpdate(_solution, solverOutputTime, solverRestartRequired);
+
+				//changes of quantities not used in the RHS (or continuous changes) 
+				//don't require the solver restart
+				if (switchUpdate && !solverRestartRequired && !outTimePoint.RestartSystem() && (m_ODE_NumUnknowns > 0))
+					_parentSim->RunStatistics().IncrementAvoidedSolverRestarts();
 
-				if((switchUpdate || outTimePoint.RestartSystem()) &&(m_ODE_NumUnknowns > 0))
+				previousOutputTime = solverOutputTime;
+
+				if((solverRestartRequired || outTimePoint.RestartSystem()) && solveLinearSystemExactly)
+					assembleLinearSystem(solverOutputTime);
+				else if((solverRestartRequired || outTimePoint.RestartSystem()) &&(m_ODE_NumUnknowns > 0))
 				{
 					//create double vector for new initial value
 					std::vector <double> new_initialvalues_vec;
 					for (i = 0; i < m_ODE_NumUnknowns; i++)
-						new_initialvalues_vec.push_back(solution[i]);
+						new_initialvalues_vec.push_back(_solution[i]);
 
-					// Reset ODE system (we solve a new one)
-					iResultflag = pSolver->ReInit(solverOutputTime, new_initialvalues_vec);
+					if (systemBecameStiff(solverOutputTime, outputTimePoints.back().Time()))
+					{
+						//Adams method is not suitable anymore: continue with a new BDF solver instance
+						_linearMultistepMethod = BDF;
+						_parentSim->RunStatistics().SetBDFSwitchTime(solverOutputTime);
+						pSolver = SetupSolver(solverOutputTime, _solution);
+					}
+					else
+					{
+						// Reset ODE system (we solve a new one)
+						iResultflag = pSolver->ReInit(solverOutputTime, new_initialvalues_vec);
 
-					if (iResultflag != DE_NOERROR)
-						throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, pSolver->GetSolverErrMsg(iResultflag));
+						if (iResultflag != DE_NOERROR)
+							throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, pSolver->GetSolverErrMsg(iResultflag));
+					}
 				}
 
 			} // end of main DE loop
 
-			//---- Simulation is finished. 
-			//     We scale all values back
-			//     Value range [-AbsTol..AbsTol] is set to zero
-			//     Comparison Thresholds of variables and observers are calculated
+			//---- Simulation is finished (solver instance and work arrays are kept for the next run)
+			finishSolving();
 
-			//calculate and set comparison thresholds. This must be done BEFORE rescaling!
-			setComparisonThresholds();
+			_parentSim->RunStatistics().AddSolveTime(secondsSince(solveStartTime));
+		}
+		catch(...)
+		{
+			//state of the solver instance is undefined now: don't reuse it
+			if (_solver) delete _solver;
+			_solver = NULL;
 
-			for (i = 0; i < m_ODE_NumUnknowns; i++)
-			{
-				//setting values below abstol to zero must be done BEFORE rescaling!
-				m_ODEVariables[i]->SetValuesBelowAbsTolLevelToZero(m_SolverProperties.GetAbsTol());
+			//rethrow exception only if cancel flag is not set (otherwise: just exit)
+			if (!_parentSim->GetCancelFlag())
+				throw;
+		}
+	}
 
-				m_ODEVariables[i]->RescaleValues();
-			}
+	vector <OutputTimePoint> DESolver::prepareSolving()
+	{
+		double * initialvalues = NULL;         //(scaled) initial values of DE variables
+		double * initialvaluesUnscaled = NULL; //unscaled initial values of DE variables
+
+		try
+		{
+			_rhs_outputs.clear();
+			_jacobian_outputs.clear();
+
+			int i;
+
+			//simulation start time
+			double simStartTime = _parentSim->GetStartTime();
+
+			//get number of unknowns
+			m_ODE_NumUnknowns = _parentSim->GetODENumUnknowns();
+
+			//output time points of the simulation
+			vector <OutputTimePoint> outputTimePoints = SimulationTask::OutputTimePoints(_parentSim);
+			int numberOfSimulatedTimeSteps = SimulationTask::NumberOfSimulatedTimeSteps(outputTimePoints);
+
+			//get scaled initial values for DE variables
+			initialvalues = _parentSim->GetDEInitialValuesScaled();
+
+			//get unscaled initial values
+			initialvaluesUnscaled = _parentSim->GetDEInitialValues();
+
+			//redim species/observers/time array of the simulation
+			_parentSim->RedimAndInitValues(numberOfSimulatedTimeSteps+1,
+				                           initialvalues, initialvaluesUnscaled); //+1 because of sim start time, 
+			                                                       //which is not included in outputTimePoints
+
+			//cache sensitivity parameters
+			_sensitivityParameters = _parentSim->SensitivityParameters();
+
+			//---- allocate memory for ODE variables, solution and sensitivities
+			//     (arrays of the previous run are reused if problem size did not change)
+			RedimWorkArrays();
+
+			//---- cache DE variables arranged by their ODE Index
+			for(i=0; i<m_ODE_NumUnknowns; i++)
+				m_ODEVariables[i] = _parentSim->GetDEVariableFromIndex(i);
+
+			//---- perform initial switch update on <initialvalues>
+			bool solverRestartRequired;
+			_parentSim->PerformSwitchUpdate(initialvalues, simStartTime, solverRestartRequired);
+
+			//initialize solution vector with initial data
+			for (i = 0; i < m_ODE_NumUnknowns; i++)
+				_solution[i] = initialvalues[i];
 
-			//---- clean up
 			delete[] initialvalues; 
-			initialvalues = NULL;
 			delete[] initialvaluesUnscaled;
-			initialvaluesUnscaled = NULL;
-			delete[] solution;
-			solution = NULL;
-			delete[] solutionAboveAbsTol;
-			solutionAboveAbsTol = NULL;
-			delete[] m_ODEVariables;
-			m_ODEVariables = NULL;
-			delete pSolver;
-			pSolver = NULL;
-
-			if (sensitivityValues)
-			{
-				for (i = 0; i < m_ODE_NumUnknowns; i++)
-					delete[] sensitivityValues[i];
-				delete[] sensitivityValues;
-				sensitivityValues = NULL;
-			}
+
+			return outputTimePoints;
 		}
 		catch(...)
 		{
 			if (initialvalues) delete[] initialvalues;
 			if (initialvaluesUnscaled) delete[] initialvaluesUnscaled;
-			if (solution) delete[] solution;
-			if(solutionAboveAbsTol) delete[] solutionAboveAbsTol;
-			if (m_ODEVariables) delete[] m_ODEVariables;
-			if (pSolver) delete pSolver;
 
-			if (sensitivityValues)
-			{
-				for (int i = 0; i < m_ODE_NumUnknowns; i++)
-					delete[] sensitivityValues[i];
-				delete[] sensitivityValues;
-			}
+			throw;
+		}
+	}
 
-			//rethrow exception only if cancel flag is not set (otherwise: just exit)
-			if (!_parentSim->GetCancelFlag())
-				throw;
+	void DESolver::storeSolution(int timeStepNumber, double solverOutputTime)
+	{
+		int i;
+
+		//Update Observer values for this time step
+		// (use solution where all values in [-AbsTol..AbsTol] are set to zero!
+		for (i = 0; i < m_ODE_NumUnknowns; i++)
+			_solutionAboveAbsTol[i] = _solution[i];
+
+		SimulationTask::SetValuesBelowAbsTolLevelToZero(_solutionAboveAbsTol, m_ODE_NumUnknowns, m_SolverProperties.GetAbsTol());
+		_parentSim->SetObserverValues(timeStepNumber, _solutionAboveAbsTol, solverOutputTime, _sensitivityValues);
+
+		// Output solution at the current time step
+		_parentSim->SetTimeValue(timeStepNumber,solverOutputTime);
+
+		//save solution at the current time step into the compartments
+		// (for non-persistable variables: just overwrite the (only) value)
+		for (i = 0; i < m_ODE_NumUnknowns; i++)
+			m_ODEVariables[i]->SetValue(m_ODEVariables[i]->IsPersistable() ? timeStepNumber : 0, _solution[i]);
+
+		//check for not allowed negative values
+		//(must be done BEFORE rescaling the values back)
+		if (m_SolverProperties.GetCheckForNegativeValues())
+			SimulationTask::CheckForNegativeValues(m_ODEVariables, m_ODE_NumUnknowns, m_SolverProperties.GetAbsTol(), solverOutputTime);
+
+		//save sensitivity values at the current time step for all variables
+		storeSensitivityValues(timeStepNumber, _sensitivityValues);
+	}
+
+	void DESolver::finishSolving()
+	{
+		//---- We scale all values back
+		//     Value range [-AbsTol..AbsTol] is set to zero
+		//     Comparison Thresholds of variables and observers are calculated
+
+		//calculate and set comparison thresholds. This must be done BEFORE rescaling!
+		setComparisonThresholds();
+
+		for (int i = 0; i < m_ODE_NumUnknowns; i++)
+		{
+			//setting values below abstol to zero must be done BEFORE rescaling!
+			m_ODEVariables[i]->SetValuesBelowAbsTolLevelToZero(m_SolverProperties.GetAbsTol());
+
+			m_ODEVariables[i]->RescaleValues();
 		}
 	}
 
@@ -529,6 +773,114 @@ namespace SimModelNative
 		_parentSim = sim;
 	}
 
+	void DESolver::computeRhs(double t, const double * y, double * ydot)
+	{
+		int i;
+
+		for (i = 0; i < m_ODE_NumUnknowns; i++)
+			ydot[i] = 0.;
+
+		for (i = 0; i < m_ODE_NumUnknowns; i++)
+			m_ODEVariables[i]->DE_Rhs(ydot, y, t);
+	}
+
+	void DESolver::assembleLinearSystem(double t)
+	{
+		int i, n = m_ODE_NumUnknowns;
+
+		//for a linear system y' = A*y + b: A is the jacobian (at any y) and b = RHS(y=0)
+		vector <double> zero(n, 0.0), rhsAtZero(n);
+		vector <double> jacobianValues((size_t)n * n, 0.0);
+		vector <double *> jacobian(n);
+
+		for (i = 0; i < n; i++)
+			jacobian[i] = &jacobianValues[(size_t)i * n]; //column i (see MATRIX_ELEM)
+
+		for (i = 0; i < n; i++)
+			m_ODEVariables[i]->DE_Jacobian(&jacobian[0], &zero[0], t);
+
+		computeRhs(t, &zero[0], &rhsAtZero[0]);
+
+		_linearODESolver.Assemble(n, &jacobian[0], &rhsAtZero[0]);
+	}
+
+	bool DESolver::systemBecameStiff(double restartTime, double endTime)
+	{
+		//only runs started with the Adams method are checked (s. Solve_ODE);
+		//solver instances with sensitivities are never replaced
+		if ((_linearMultistepMethod != ADAMS) || (_sensitivityParameters.size() > 0) || (restartTime >= endTime))
+			return false;
+
+		double spectralRadius = estimateSpectralRadius(restartTime, _solution);
+
+		return SolverConfigurationTask::SelectIntegrationMethod(spectralRadius, endTime - restartTime) == BDF;
+	}
+
+	double DESolver::estimateSpectralRadius(double t, const double * y)
+	{
+		const int numberOfIterations = 20;
+		int i, iteration;
+
+		vector <double> rhs0(m_ODE_NumUnknowns), rhs(m_ODE_NumUnknowns);
+		vector <double> direction(m_ODE_NumUnknowns), yPerturbed(m_ODE_NumUnknowns);
+
+		try
+		{
+			computeRhs(t, y, &rhs0[0]);
+
+			//---- start direction (not parallel to any unit vector), normalized
+			double norm = 0.0, yNorm = 0.0;
+			for (i = 0; i < m_ODE_NumUnknowns; i++)
+			{
+				direction[i] = 1.0 + (i % 10) / 10.0;
+				norm += direction[i] * direction[i];
+				yNorm += y[i] * y[i];
+			}
+			norm = sqrt(norm);
+			for (i = 0; i < m_ODE_NumUnknowns; i++)
+				direction[i] /= norm;
+
+			double delta = sqrt(DBL_EPSILON) * max(1.0, sqrt(yNorm));
+
+			//---- power iteration: direction_(k+1) = J*direction_k / ||J*direction_k||
+			//     max_k ||J*direction_k|| is used as (upper) estimate of the spectral radius
+			double spectralRadius = 0.0;
+
+			for (iteration = 0; iteration < numberOfIterations; iteration++)
+			{
+				for (i = 0; i < m_ODE_NumUnknowns; i++)
+					yPerturbed[i] = y[i] + delta * direction[i];
+
+				computeRhs(t, &yPerturbed[0], &rhs[0]);
+
+				norm = 0.0;
+				for (i = 0; i < m_ODE_NumUnknowns; i++)
+				{
+					direction[i] = (rhs[i] - rhs0[i]) / delta;
+					norm += direction[i] * direction[i];
+				}
+				norm = sqrt(norm);
+
+				if (!MathHelper::IsFinite(norm))
+					return MathHelper::GetInf();
+
+				if (norm == 0.0)
+					break; //direction is in the null space of the Jacobian
+
+				spectralRadius = max(spectralRadius, norm);
+
+				for (i = 0; i < m_ODE_NumUnknowns; i++)
+					direction[i] /= norm;
+			}
+
+			return spectralRadius;
+		}
+		catch (...)
+		{
+			return MathHelper::GetInf();
+		}
+	}
+
 	Rhs_Return_Value DESolver::ODERhsFunction(double t, const double * y, const double * p, double * ydot, void * f_data)
 	{
 		//if in interactive mode:
@@ -586,16 +938,22 @@ namespace SimModelNative
 	//	return false;
 	//}
 
-	double ** DESolver::redimSensitivityMatrix()
+	void DESolver::redimSensitivityMatrix()
 	{
+		if ((_sensitivityValuesRows == m_ODE_NumUnknowns) && (_sensitivityValuesColumns == _sensitivityParameters.size()))
+			return; //matrix of the previous run can be reused
+
+		ReleaseSensitivityMatrix();
+
 		if (!_sensitivityParameters.size() || !m_ODE_NumUnknowns)
-			return NULL;
+			return;
 
-		double ** sensitivityValues = new double *[m_ODE_NumUnknowns];
+		_sensitivityValues = new double *[m_ODE_NumUnknowns];
 		for (int j = 0; j < m_ODE_NumUnknowns; j++)
-			sensitivityValues[j] = new double[_sensitivityParameters.size()];
+			_sensitivityValues[j] = new double[_sensitivityParameters.size()];
 
-		return sensitivityValues;
+		_sensitivityValuesRows = m_ODE_NumUnknowns;
+		_sensitivityValuesColumns = _sensitivityParameters.size();
 	}
 
 	//<sensitivityValues> has dimensions [NoOf_ODE_Variables] x [NoOf_Sensitivity_Parameters]
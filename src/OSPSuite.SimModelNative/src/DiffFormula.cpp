@@ -3,6 +3,7 @@
 #include "SimModel/GlobalConstants.h"
 #include "SimModel/ConstantFormula.h"
 #include <assert.h>
+#include <algorithm>
 
 namespace SimModelNative
 {
@@ -35,6 +36,11 @@ bool DiffFormula::IsZero(void)
 	return (minuendValue == subtrahendValue);
 }
 
+FormulaLinearity DiffFormula::Linearity()
+{
+	return std::max(m_MinuendFormula->Linearity(), m_SubtrahendFormula->Linearity());
+}
+
 void DiffFormula::LoadFromXMLNode (const XMLNode & pNode)
 {
 	// Check if the current tag is actually the one we expect
@@ -29,6 +29,14 @@ bool DivFormula::IsZero(void)
 	return m_NumeratorFormula->IsZero();
 }
 
+FormulaLinearity DivFormula::Linearity()
+{
+	if (m_DenominatorFormula->Linearity() != FL_CONSTANT)
+		return FL_NONLINEAR;
+
+	return m_NumeratorFormula->Linearity();
+}
+
 void DivFormula::LoadFromXMLNode (const XMLNode & pNode)
 {
 	// Check if the current tag is actually the one we expect
@@ -0,0 +1,567 @@
+#ifdef _WINDOWS
+#pragma warning(disable:4786)
+#endif
+
+#include "SimModel/EnsembleSolver.h"
+#include "SimModel/Simulation.h"
+#include "SimModel/MathHelper.h"
+#include <cmath>
+#include <cfloat>
+#include <ctime>
+#include <algorithm>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+//---- RODAS3 coefficients (Sandu et al., Atmospheric Environment 31, 1997)
+//     Stages K_s solve (1/(h*gamma)*I - J) * K_s = f(t + alpha_s*h, y + sum_j a_sj*K_j)
+//                                                  + sum_j c_sj/h*K_j + h*gamma_s*df/dt
+const int RODAS3_STAGES = 4;
+const double RODAS3_GAMMA = 0.5;
+const double RODAS3_A[RODAS3_STAGES][RODAS3_STAGES] = {{0, 0, 0, 0}, {0, 0, 0, 0}, {2, 0, 0, 0}, {2, 0, 1, 0}};
+const double RODAS3_C[RODAS3_STAGES][RODAS3_STAGES] = {{0, 0, 0, 0}, {4, 0, 0, 0}, {1, -1, 0, 0}, {1, -1, -8.0 / 3.0, 0}};
+const double RODAS3_ALPHA[RODAS3_STAGES] = {0, 0, 1, 1};
+const double RODAS3_GAMMAS[RODAS3_STAGES] = {0.5, 1.5, 0, 0};
+const bool RODAS3_NEW_RHS[RODAS3_STAGES] = {true, false, true, true}; //stage 2 reuses the RHS of stage 1
+const double RODAS3_M[RODAS3_STAGES] = {2, 0, 1, 1};                 //solution
+const double RODAS3_E[RODAS3_STAGES] = {0, 0, 0, 1};                 //local error estimate
+const double RODAS3_ERROR_ORDER = 3.0;
+
+//---- step size control
+const double STEP_SAFETY_FACTOR = 0.9;
+const double STEP_MIN_FACTOR = 0.2;
+const double STEP_MAX_FACTOR = 6.0;
+const double STEP_REJECT_FACTOR = 0.1; //after repeated rejections
+
+EnsembleSolver::EnsembleSolver(void)
+{
+	_n = 0;
+}
+
+vector <bool> EnsembleSolver::Solve(const vector <Simulation *> & simulations)
+{
+	size_t memberIdx;
+	vector <bool> solved(simulations.size(), false);
+
+	setup(simulations);
+
+	if (numberOfActiveMembers() > 0)
+	{
+		const DESolverProperties & solverProperties = _members[0].solver->m_SolverProperties;
+		const SimulationOptions & options = _members[0].simulation->Options();
+
+		const double startTime = _members[0].simulation->GetStartTime();
+		const long maxNumberOfSteps = solverProperties.GetMxStep() > 0 ? solverProperties.GetMxStep() : 500;
+		const double hMin = solverProperties.GetHMin();
+		const double hMax = solverProperties.GetHMax() > 0.0 ? solverProperties.GetHMax() : MathHelper::GetInf();
+		const double executionTimeLimit = options.ExecutionTimeLimit();
+		const double executionStartTime = clock() / (double)CLOCKS_PER_SEC;
+
+		double t = startTime;
+		double h = 0.0; //0: estimate at the start of the next output interval
+		int timeStepNumber = 0;
+
+		for (size_t timeStepIdx = 0; timeStepIdx < _outputTimePoints.size(); timeStepIdx++)
+		{
+			if (numberOfActiveMembers() == 0)
+				break;
+
+			//members exceeding the time limit fail again when run on their own
+			if ((executionTimeLimit > 0.0) && (clock() / (double)CLOCKS_PER_SEC - executionStartTime > executionTimeLimit))
+				break;
+
+			const OutputTimePoint & outTimePoint = _outputTimePoints[timeStepIdx];
+
+			if ((_n > 0) && (outTimePoint.Time() > t))
+			{
+				if (h <= 0.0)
+					h = solverProperties.GetH0() > 0.0 ? solverProperties.GetH0() : initialStepSize(t, outTimePoint.Time());
+
+				h = integrateTo(t, outTimePoint.Time(), h, maxNumberOfSteps, hMin, hMax);
+			}
+			t = outTimePoint.Time();
+
+			if (outTimePoint.SaveSystemSolution())
+				timeStepNumber++;
+
+			bool restartRequired = outTimePoint.RestartSystem();
+
+			for (memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+			{
+				Member & member = _members[memberIdx];
+				if (!member.isActive)
+					continue;
+
+				try
+				{
+					if (outTimePoint.SaveSystemSolution())
+					{
+						std::copy(member.y, member.y + _n, member.solver->_solution);
+						member.solver->storeSolution(timeStepNumber, t);
+					}
+
+					bool solverRestartRequired;
+					member.simulation->PerformSwitchUpdate(member.y, t, solverRestartRequired);
+					restartRequired |= solverRestartRequired;
+				}
+				catch (...)
+				{
+					member.isActive = false;
+				}
+			}
+
+			//solution is continued with the initial step size after discontinuities
+			if (restartRequired)
+				h = 0.0;
+		}
+
+		//---- only members which reached the end time are solved
+		const bool endTimeReached = _outputTimePoints.empty() || (t == _outputTimePoints.back().Time());
+
+		for (memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+		{
+			Member & member = _members[memberIdx];
+			if (!member.isActive || !endTimeReached)
+				continue;
+
+			try
+			{
+				member.solver->finishSolving();
+				member.simulation->_runContext.SetProgress(100);
+				solved[memberIdx] = true;
+			}
+			catch (...)
+			{
+				member.isActive = false;
+			}
+		}
+	}
+
+	//reset simulation state (parameter values changed by switches etc.)
+	for (memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+		_members[memberIdx].simulation->ResetState();
+
+	_members.clear();
+
+	return solved;
+}
+
+void EnsembleSolver::setup(const vector <Simulation *> & simulations)
+{
+	size_t memberIdx;
+	int numberOfStackedMembers = 0;
+
+	_members.clear();
+	_outputTimePoints.clear();
+	_n = 0;
+
+	for (memberIdx = 0; memberIdx < simulations.size(); memberIdx++)
+	{
+		Member member;
+		member.simulation = simulations[memberIdx];
+		member.solver = &member.simulation->m_Solver;
+		member.y = NULL;
+		member.yNew = NULL;
+		member.error = 0.0;
+		member.absTol = member.solver->m_SolverProperties.GetAbsTol();
+		member.relTol = member.solver->m_SolverProperties.GetRelTol();
+		member.isActive = false;
+
+		try
+		{
+			member.simulation->prepareRun();
+			vector <OutputTimePoint> outputTimePoints = member.solver->prepareSolving();
+
+			bool canBeStacked = (member.solver->_sensitivityParameters.size() == 0);
+
+			if (canBeStacked && (numberOfStackedMembers == 0))
+			{
+				_outputTimePoints = outputTimePoints;
+				_n = member.solver->m_ODE_NumUnknowns;
+			}
+			else if (canBeStacked)
+			{
+				canBeStacked = (member.solver->m_ODE_NumUnknowns == _n) && (outputTimePoints.size() == _outputTimePoints.size());
+
+				for (size_t i = 0; canBeStacked && (i < outputTimePoints.size()); i++)
+				{
+					canBeStacked = (outputTimePoints[i].Time() == _outputTimePoints[i].Time()) &&
+					               (outputTimePoints[i].SaveSystemSolution() == _outputTimePoints[i].SaveSystemSolution()) &&
+					               (outputTimePoints[i].RestartSystem() == _outputTimePoints[i].RestartSystem());
+				}
+			}
+
+			if (canBeStacked)
+			{
+				member.isActive = true;
+				numberOfStackedMembers++;
+			}
+		}
+		catch (...)
+		{
+			//error is reported when the member is run on its own
+		}
+
+		_members.push_back(member);
+	}
+
+	//---- stacked solution: members are arranged in blocks of size _n
+	_y.assign((size_t)numberOfStackedMembers * _n, 0.0);
+	_yNew.assign(_y.size(), 0.0);
+
+	double * block = _y.data(), * newBlock = _yNew.data();
+	for (memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+	{
+		Member & member = _members[memberIdx];
+		if (!member.isActive)
+			continue;
+
+		member.y = block;
+		member.yNew = newBlock;
+		std::copy(member.solver->_solution, member.solver->_solution + _n, member.y);
+
+		block += _n;
+		newBlock += _n;
+	}
+
+	_rhs0.assign(_n, 0.0);
+	_rhs.assign(_n, 0.0);
+	_dfdt.assign(_n, 0.0);
+	_yStage.assign(_n, 0.0);
+	_stages.assign((size_t)RODAS3_STAGES * _n, 0.0);
+	_matrix.assign((size_t)_n * _n, 0.0);
+	_pivots.assign(_n, 0);
+	_jacobianColumns.resize(_n);
+	for (int j = 0; j < _n; j++)
+		_jacobianColumns[j] = &_matrix[(size_t)j * _n];
+}
+
+int EnsembleSolver::numberOfActiveMembers() const
+{
+	int numberOfActiveMembers = 0;
+
+	for (size_t memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+		if (_members[memberIdx].isActive)
+			numberOfActiveMembers++;
+
+	return numberOfActiveMembers;
+}
+
+double EnsembleSolver::initialStepSize(double t, double tEnd)
+{
+	//h = 0.01*||y||/||f(t,y)|| (weighted norms), smallest value of all members
+	double h = tEnd - t;
+
+	for (size_t memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+	{
+		Member & member = _members[memberIdx];
+		if (!member.isActive)
+			continue;
+
+		try
+		{
+			member.solver->computeRhs(t, member.y, _rhs0.data());
+		}
+		catch (...)
+		{
+			member.isActive = false;
+			continue;
+		}
+
+		double yNorm = 0.0, rhsNorm = 0.0;
+		for (int i = 0; i < _n; i++)
+		{
+			const double weight = member.absTol + member.relTol * fabs(member.y[i]);
+			yNorm += pow(member.y[i] / weight, 2);
+			rhsNorm += pow(_rhs0[i] / weight, 2);
+		}
+		yNorm = sqrt(yNorm / _n);
+		rhsNorm = sqrt(rhsNorm / _n);
+
+		if (!MathHelper::IsFinite(rhsNorm))
+			continue; //step size is reduced by the step size control
+
+		if ((yNorm < 1e-5) || (rhsNorm < 1e-5))
+			h = min(h, 1e-6 * max(fabs(t), 1.0));
+		else
+			h = min(h, 0.01 * yNorm / rhsNorm);
+	}
+
+	return h;
+}
+
+double EnsembleSolver::integrateTo(double & t, double tEnd, double h, long maxNumberOfSteps, double hMin, double hMax)
+{
+	size_t memberIdx;
+	long numberOfSteps = 0;
+	int numberOfRejections = 0;
+	double hNext = h;
+
+	while ((t < tEnd) && (numberOfActiveMembers() > 0))
+	{
+		//don't overshoot the output time point (and avoid tiny last steps)
+		h = min(hNext, hMax);
+		const bool lastStep = (t + 1.01 * h >= tEnd);
+		if (lastStep)
+			h = tEnd - t;
+
+		//members which cannot be solved within <maxNumberOfSteps> fail (as in the solver)
+		if (++numberOfSteps > maxNumberOfSteps)
+		{
+			for (memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+				_members[memberIdx].isActive = false;
+			break;
+		}
+
+		//---- step of the whole ensemble, error is controlled per member
+		double maxError = 0.0;
+		Member * worstMember = NULL;
+
+		for (memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+		{
+			Member & member = _members[memberIdx];
+			if (!member.isActive)
+				continue;
+
+			if (member.simulation->GetCancelFlag())
+			{
+				member.isActive = false;
+				continue;
+			}
+
+			performStep(member, t, h);
+
+			if (member.isActive && ((worstMember == NULL) || !(member.error <= maxError)))
+			{
+				maxError = member.error;
+				worstMember = &member;
+			}
+		}
+
+		if (worstMember == NULL)
+			break; //no active members left
+
+		//---- step size proposal from the error of the worst member
+		double factor = MathHelper::IsFinite(maxError) ?
+		                STEP_SAFETY_FACTOR * pow(max(maxError, 1e-10), -1.0 / RODAS3_ERROR_ORDER) : STEP_MIN_FACTOR;
+		factor = min(STEP_MAX_FACTOR, max(STEP_MIN_FACTOR, factor));
+
+		if (maxError <= 1.0)
+		{
+			//step accepted for all members
+			for (memberIdx = 0; memberIdx < _members.size(); memberIdx++)
+			{
+				Member & member = _members[memberIdx];
+				if (member.isActive)
+					std::copy(member.yNew, member.yNew + _n, member.y);
+			}
+
+			t = lastStep ? tEnd : t + h;
+			hNext = (numberOfRejections > 0) ? min(h * factor, h) : h * factor;
+			numberOfRejections = 0;
+
+			continue;
+		}
+
+		//---- step rejected
+		numberOfRejections++;
+		hNext = h * ((numberOfRejections > 1) ? STEP_REJECT_FACTOR : factor);
+
+		//the worst member prevents the ensemble from continuing: it is solved on its own
+		if (hNext < max(hMin, 16.0 * DBL_EPSILON * max(fabs(t), 1.0)))
+		{
+			worstMember->isActive = false;
+			hNext = h;
+			numberOfRejections = 0;
+		}
+	}
+
+	return hNext;
+}
+
+void EnsembleSolver::performStep(Member & member, double t, double h)
+{
+	int i, j, stage;
+	DESolver & solver = *member.solver;
+	const double * y = member.y;
+
+	try
+	{
+		solver.computeRhs(t, y, _rhs0.data());
+
+		//---- time derivative of the RHS (switch-free between output time points)
+		const double delta = sqrt(DBL_EPSILON) * max(1e-5, fabs(t));
+		solver.computeRhs(t + delta, y, _rhs.data());
+		for (i = 0; i < _n; i++)
+			_dfdt[i] = (_rhs[i] - _rhs0[i]) / delta;
+
+		//---- 1/(h*gamma)*I - J
+		computeJacobian(member, t, y);
+
+		for (i = 0; i < _n * _n; i++)
+			_matrix[i] = -_matrix[i];
+		for (i = 0; i < _n; i++)
+			_matrix[(size_t)i * _n + i] += 1.0 / (h * RODAS3_GAMMA);
+
+		if (!factorize())
+		{
+			member.error = MathHelper::GetInf(); //step size is reduced
+			return;
+		}
+
+		//---- stages
+		for (stage = 0; stage < RODAS3_STAGES; stage++)
+		{
+			double * K = &_stages[(size_t)stage * _n];
+
+			if (stage == 0)
+				std::copy(_rhs0.begin(), _rhs0.end(), _rhs.begin());
+			else if (RODAS3_NEW_RHS[stage])
+			{
+				for (i = 0; i < _n; i++)
+				{
+					_yStage[i] = y[i];
+					for (j = 0; j < stage; j++)
+						_yStage[i] += RODAS3_A[stage][j] * _stages[(size_t)j * _n + i];
+				}
+
+				solver.computeRhs(t + RODAS3_ALPHA[stage] * h, _yStage.data(), _rhs.data());
+			}
+
+			for (i = 0; i < _n; i++)
+			{
+				K[i] = _rhs[i] + h * RODAS3_GAMMAS[stage] * _dfdt[i];
+				for (j = 0; j < stage; j++)
+					K[i] += RODAS3_C[stage][j] / h * _stages[(size_t)j * _n + i];
+			}
+
+			solve(K);
+		}
+
+		//---- new solution and weighted RMS norm of the local error
+		double error = 0.0;
+
+		for (i = 0; i < _n; i++)
+		{
+			double yNew = y[i], localError = 0.0;
+			for (stage = 0; stage < RODAS3_STAGES; stage++)
+			{
+				yNew += RODAS3_M[stage] * _stages[(size_t)stage * _n + i];
+				localError += RODAS3_E[stage] * _stages[(size_t)stage * _n + i];
+			}
+
+			member.yNew[i] = yNew;
+
+			const double weight = member.absTol + member.relTol * max(fabs(y[i]), fabs(yNew));
+			error += pow(localError / weight, 2);
+		}
+
+		error = sqrt(error / _n);
+
+		//not finite values are treated as (infinite) error, so the step size is reduced
+		member.error = MathHelper::IsFinite(error) ? error : MathHelper::GetInf();
+	}
+	catch (...)
+	{
+		member.isActive = false;
+	}
+}
+
+void EnsembleSolver::computeJacobian(Member & member, double t, const double * y)
+{
+	int i, j;
+	DESolver & solver = *member.solver;
+
+	std::fill(_matrix.begin(), _matrix.end(), 0.0);
+
+	//analytical jacobian if used by the solver of the model
+	if (solver.m_SolverProperties.GetUseJacobian())
+	{
+		for (i = 0; i < _n; i++)
+			solver.m_ODEVariables[i]->DE_Jacobian(_jacobianColumns.data(), y, t);
+		return;
+	}
+
+	//---- finite differences (RHS at y is in _rhs0)
+	std::copy(y, y + _n, _yStage.begin());
+
+	for (j = 0; j < _n; j++)
+	{
+		const double delta = sqrt(DBL_EPSILON) * max(fabs(y[j]), member.absTol);
+
+		_yStage[j] = y[j] + delta;
+		solver.computeRhs(t, _yStage.data(), _rhs.data());
+		_yStage[j] = y[j];
+
+		for (i = 0; i < _n; i++)
+			MATRIX_ELEM(_jacobianColumns, i, j) = (_rhs[i] - _rhs0[i]) / delta;
+	}
+}
+
+bool EnsembleSolver::factorize()
+{
+	int i, j, k;
+
+	for (k = 0; k < _n; k++)
+	{
+		double * columnK = _jacobianColumns[k];
+
+		//---- pivot search in column k
+		int pivot = k;
+		for (i = k + 1; i < _n; i++)
+			if (fabs(columnK[i]) > fabs(columnK[pivot]))
+				pivot = i;
+
+		_pivots[k] = pivot;
+
+		if ((columnK[pivot] == 0.0) || !MathHelper::IsFinite(columnK[pivot]))
+			return false;
+
+		if (pivot != k)
+			for (j = 0; j < _n; j++)
+				std::swap(_jacobianColumns[j][k], _jacobianColumns[j][pivot]);
+
+		for (i = k + 1; i < _n; i++)
+			columnK[i] /= columnK[k];
+
+		for (j = k + 1; j < _n; j++)
+		{
+			double * columnJ = _jacobianColumns[j];
+			const double factor = columnJ[k];
+			if (factor == 0.0)
+				continue;
+
+			for (i = k + 1; i < _n; i++)
+				columnJ[i] -= factor * columnK[i];
+		}
+	}
+
+	return true;
+}
+
+void EnsembleSolver::solve(double * b)
+{
+	int i, k;
+
+	for (k = 0; k < _n; k++)
+	{
+		std::swap(b[k], b[_pivots[k]]);
+
+		const double * columnK = _jacobianColumns[k];
+		for (i = k + 1; i < _n; i++)
+			b[i] -= columnK[i] * b[k];
+	}
+
+	for (k = _n - 1; k >= 0; k--)
+	{
+		const double * columnK = _jacobianColumns[k];
+
+		b[k] /= columnK[k];
+		for (i = 0; i < k; i++)
+			b[i] -= columnK[i] * b[k];
+	}
+}
+
+}//.. end "namespace SimModelNative"
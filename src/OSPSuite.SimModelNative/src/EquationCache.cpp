@@ -0,0 +1,422 @@
+#include "SimModel/EquationCache.h"
+#include "XMLWrapper/XMLHelper.h"
+#include "../../OSPSuite.SimModelNative/version.h"
+#include "ErrorData.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+static const char * EQUATION_CACHE_NODE = "EquationCache";
+static const char * EQUATION_NODE = "Equation";
+static const char * VERSION_ATTRIBUTE = "version";
+static const char * FORMAT_ATTRIBUTE = "format";
+static const char * EQUATION_ATTRIBUTE = "equation";
+static const char * SIMPLIFY_PARAMETER_ATTRIBUTE = "simplifyParameter";
+static const char * VARIABLE_NAMES_NODE = "VariableNames";
+static const char * PARAMETER_NAMES_NODE = "ParameterNames";
+static const char * PARAMETER_VALUES_NODE = "ParameterValues";
+static const char * PARAMETER_NOT_TO_SIMPLIFY_NAMES_NODE = "ParameterNotToSimplifyNames";
+static const char * NAME_NODE = "Name";
+static const char * VALUE_NODE = "Value";
+static const char * RATE_NODE = "Rate";
+
+//format 2: all parser inputs are stored with the equation
+static const char * FILE_FORMAT = "2";
+
+std::atomic<EquationCache *> EquationCache::_instance(NULL);
+std::mutex EquationCache::_instanceMutex;
+
+//copies attributes and child elements of <source> into <target>.
+//Text is only kept for elements without child elements (as in the parser output)
+static void copyElement(const XMLNode & source, XMLNode & target)
+{
+	vector <string> attributeNames, attributeValues;
+	source.GetAttributes(attributeNames, attributeValues);
+
+	for (size_t i = 0; i < attributeNames.size(); i++)
+		target.SetAttribute(attributeNames[i], attributeValues[i]);
+
+	bool hasChildElements = false;
+
+	for (XMLNode child = source.GetFirstChild(); !child.IsNull(); child = child.GetNextSibling())
+	{
+		if (!child.IsElement())
+			continue;
+
+		XMLNode targetChild = target.CreateChildNode(child.GetNodeName());
+		copyElement(child, targetChild);
+		hasChildElements = true;
+	}
+
+	if (!hasChildElements)
+	{
+		const string value = source.GetValue();
+		if (!value.empty())
+			target.SetValue(value);
+	}
+}
+
+static XMLNode firstChildElement(const XMLNode & node)
+{
+	for (XMLNode child = node.GetFirstChild(); !child.IsNull(); child = child.GetNextSibling())
+	{
+		if (child.IsElement())
+			return child;
+	}
+
+	return XMLNode();
+}
+
+static XMLNode childElement(const XMLNode & node, const char * name)
+{
+	for (XMLNode child = node.GetFirstChild(); !child.IsNull(); child = child.GetNextSibling())
+	{
+		if (child.IsElement() && child.HasName(name))
+			return child;
+	}
+
+	return XMLNode();
+}
+
+static void writeNames(XMLNode & equationNode, const char * nodeName, const vector <string> & names)
+{
+	XMLNode namesNode = equationNode.CreateChildNode(nodeName);
+
+	for (size_t i = 0; i < names.size(); i++)
+		namesNode.CreateChildNode(NAME_NODE).SetValue(names[i]);
+}
+
+static vector <string> readNames(const XMLNode & equationNode, const char * nodeName)
+{
+	vector <string> names;
+	XMLNode namesNode = childElement(equationNode, nodeName);
+
+	if (namesNode.IsNull())
+		return names;
+
+	for (XMLNode nameNode = namesNode.GetFirstChild(); !nameNode.IsNull(); nameNode = nameNode.GetNextSibling())
+	{
+		if (nameNode.IsElement() && nameNode.HasName(NAME_NODE))
+			names.push_back(nameNode.GetValue());
+	}
+
+	return names;
+}
+
+//values are stored as bit patterns, so that they are read back unchanged
+static void writeValues(XMLNode & equationNode, const vector <double> & values)
+{
+	XMLNode valuesNode = equationNode.CreateChildNode(PARAMETER_VALUES_NODE);
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		uint64_t bits;
+		memcpy(&bits, &values[i], sizeof(bits));
+		valuesNode.CreateChildNode(VALUE_NODE).SetValue(to_string(bits));
+	}
+}
+
+static vector <double> readValues(const XMLNode & equationNode)
+{
+	vector <double> values;
+	XMLNode valuesNode = childElement(equationNode, PARAMETER_VALUES_NODE);
+
+	if (valuesNode.IsNull())
+		return values;
+
+	for (XMLNode valueNode = valuesNode.GetFirstChild(); !valueNode.IsNull(); valueNode = valueNode.GetNextSibling())
+	{
+		if (!valueNode.IsElement() || !valueNode.HasName(VALUE_NODE))
+			continue;
+
+		const uint64_t bits = strtoull(valueNode.GetValue().c_str(), NULL, 10);
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		values.push_back(value);
+	}
+
+	return values;
+}
+
+EquationCache * EquationCache::GetInstance()
+{
+	EquationCache * instance = _instance.load(std::memory_order_acquire);
+	if (instance != NULL)
+		return instance;
+
+	lock_guard<mutex> lock(_instanceMutex);
+
+	instance = _instance.load(std::memory_order_relaxed);
+	if (instance == NULL)
+	{
+		instance = new EquationCache();
+		_instance.store(instance, std::memory_order_release);
+	}
+
+	return instance;
+}
+
+EquationCache::EquationCache()
+{
+	_maximumSize = DEFAULT_MAXIMUM_SIZE;
+	_hits = 0;
+	_misses = 0;
+	_evictions = 0;
+}
+
+EquationCache::~EquationCache()
+{
+	clear();
+
+	if (!_rateNodesDocument.IsNull())
+		_rateNodesDocument.Release();
+}
+
+list <EquationCache::Entry>::iterator EquationCache::find(uint64_t key, const EquationInputs & inputs)
+{
+	auto range = _entriesByKey.equal_range(key);
+
+	//all inputs are compared as well: keys are hashes
+	for (auto iter = range.first; iter != range.second; iter++)
+	{
+		if (iter->second->inputs == inputs)
+			return iter->second;
+	}
+
+	return _entries.end();
+}
+
+void EquationCache::add(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode)
+{
+	if (_rateNodesDocument.IsNull())
+		_rateNodesDocument.Create();
+
+	Entry entry;
+	entry.key = key;
+	entry.inputs = inputs;
+	entry.rateNode = _rateNodesDocument.CreateNode(rateNode.GetNodeName());
+	copyElement(rateNode, entry.rateNode);
+
+	_entries.push_front(entry);
+	_entriesByKey.insert(make_pair(key, _entries.begin()));
+
+	shrink();
+}
+
+void EquationCache::removeLeastRecentlyUsed()
+{
+	list <Entry>::iterator entry = prev(_entries.end());
+
+	auto range = _entriesByKey.equal_range(entry->key);
+	for (auto iter = range.first; iter != range.second; iter++)
+	{
+		if (iter->second == entry)
+		{
+			_entriesByKey.erase(iter);
+			break;
+		}
+	}
+
+	entry->rateNode.FreeNode();
+	_entries.erase(entry);
+}
+
+void EquationCache::shrink()
+{
+	if (_maximumSize == 0)
+		return;
+
+	while (_entries.size() > _maximumSize)
+	{
+		removeLeastRecentlyUsed();
+		_evictions++;
+	}
+}
+
+void EquationCache::clear()
+{
+	for (list <Entry>::iterator iter = _entries.begin(); iter != _entries.end(); iter++)
+		iter->rateNode.FreeNode();
+
+	_entries.clear();
+	_entriesByKey.clear();
+}
+
+XMLNode EquationCache::GetRateNode(uint64_t key, const EquationInputs & inputs)
+{
+	list <Entry>::iterator entry = find(key, inputs);
+
+	if (entry == _entries.end())
+	{
+		_misses++;
+		return XMLNode();
+	}
+
+	_hits++;
+	_entries.splice(_entries.begin(), _entries, entry);
+
+	//template stays in the cache: caller gets its own copy
+	return entry->rateNode.Clone(true);
+}
+
+void EquationCache::AddRateNode(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode)
+{
+	//same equation might have been parsed for another simulation in the meantime
+	if (find(key, inputs) != _entries.end())
+		return;
+
+	add(key, inputs, rateNode);
+}
+
+size_t EquationCache::GetMaximumSize()
+{
+	lock_guard<mutex> lock(Mutex());
+	return _maximumSize;
+}
+
+void EquationCache::SetMaximumSize(size_t maximumSize)
+{
+	lock_guard<mutex> lock(Mutex());
+
+	_maximumSize = maximumSize;
+	shrink();
+}
+
+void EquationCache::Clear()
+{
+	lock_guard<mutex> lock(Mutex());
+
+	clear();
+
+	_hits = 0;
+	_misses = 0;
+	_evictions = 0;
+}
+
+size_t EquationCache::Size()
+{
+	lock_guard<mutex> lock(Mutex());
+	return _entries.size();
+}
+
+void EquationCache::GetStatistics(uint64_t & hits, uint64_t & misses, uint64_t & evictions)
+{
+	lock_guard<mutex> lock(Mutex());
+
+	hits = _hits;
+	misses = _misses;
+	evictions = _evictions;
+}
+
+void EquationCache::SaveToFile(const string & fileName)
+{
+	lock_guard<mutex> lock(Mutex());
+
+	XMLDocument document = XMLDocument::FromString("<" + string(EQUATION_CACHE_NODE) + "/>");
+
+	try
+	{
+		XMLNode cacheNode = document.GetRootElement();
+		cacheNode.SetAttribute(VERSION_ATTRIBUTE, VER_FILE_VERSION_STR);
+		cacheNode.SetAttribute(FORMAT_ATTRIBUTE, FILE_FORMAT);
+
+		for (list <Entry>::iterator iter = _entries.begin(); iter != _entries.end(); iter++)
+		{
+			const EquationInputs & inputs = iter->inputs;
+
+			//key is not stored: it is computed from the inputs when loading
+			XMLNode equationNode = cacheNode.CreateChildNode(EQUATION_NODE);
+			equationNode.SetAttribute(EQUATION_ATTRIBUTE, inputs.equation);
+			equationNode.SetAttribute(SIMPLIFY_PARAMETER_ATTRIBUTE, inputs.simplifyParameter ? "1" : "0");
+
+			writeNames(equationNode, VARIABLE_NAMES_NODE, inputs.variableNames);
+			writeNames(equationNode, PARAMETER_NAMES_NODE, inputs.parameterNames);
+			writeValues(equationNode, inputs.parameterValues);
+			writeNames(equationNode, PARAMETER_NOT_TO_SIMPLIFY_NAMES_NODE, inputs.parameterNotToSimplifyNames);
+
+			XMLNode rateNode = equationNode.CreateChildNode(RATE_NODE).CreateChildNode(iter->rateNode.GetNodeName());
+			copyElement(iter->rateNode, rateNode);
+		}
+
+		document.ToFile(fileName, false);
+	}
+	catch (...)
+	{
+		document.Release();
+		throw;
+	}
+
+	document.Release();
+}
+
+int EquationCache::LoadFromFile(const string & fileName)
+{
+	const char * ERROR_SOURCE = "EquationCache::LoadFromFile";
+
+	lock_guard<mutex> lock(Mutex());
+
+	XMLDocument document = XMLDocument::FromFile(fileName);
+	int numberOfAddedEquations = 0;
+
+	try
+	{
+		XMLNode cacheNode = document.GetRootElement();
+
+		if (cacheNode.IsNull() || !cacheNode.HasName(EQUATION_CACHE_NODE))
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, fileName + " is not an equation cache file");
+
+		//rate nodes created by another SimModel version are not used (s. PreparsedModel)
+		if ((cacheNode.GetAttribute(VERSION_ATTRIBUTE) == VER_FILE_VERSION_STR) &&
+		    (cacheNode.GetAttribute(FORMAT_ATTRIBUTE) == FILE_FORMAT))
+		{
+			for (XMLNode equationNode = cacheNode.GetFirstChild(); !equationNode.IsNull(); equationNode = equationNode.GetNextSibling())
+			{
+				if (!equationNode.IsElement() || !equationNode.HasName(EQUATION_NODE))
+					continue;
+
+				if ((_maximumSize > 0) && (_entries.size() >= _maximumSize))
+					break;
+
+				EquationInputs inputs;
+				inputs.equation = equationNode.GetAttribute(EQUATION_ATTRIBUTE);
+				inputs.simplifyParameter = (equationNode.GetAttribute(SIMPLIFY_PARAMETER_ATTRIBUTE) == "1");
+				inputs.variableNames = readNames(equationNode, VARIABLE_NAMES_NODE);
+				inputs.parameterNames = readNames(equationNode, PARAMETER_NAMES_NODE);
+				inputs.parameterValues = readValues(equationNode);
+				inputs.parameterNotToSimplifyNames = readNames(equationNode, PARAMETER_NOT_TO_SIMPLIFY_NAMES_NODE);
+
+				XMLNode rateParentNode = childElement(equationNode, RATE_NODE);
+				XMLNode rateNode = rateParentNode.IsNull() ? XMLNode() : firstChildElement(rateParentNode);
+				if (rateNode.IsNull())
+					throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Rate node is missing for equation " + inputs.equation);
+
+				const uint64_t key = ParsedEquations::KeyFor(inputs);
+
+				if (find(key, inputs) != _entries.end())
+					continue;
+
+				//file is written most recently used first: keep that order behind the cached equations
+				add(key, inputs, rateNode);
+				_entries.splice(_entries.end(), _entries, _entries.begin());
+
+				numberOfAddedEquations++;
+			}
+		}
+	}
+	catch (...)
+	{
+		document.Release();
+		throw;
+	}
+
+	document.Release();
+
+	return numberOfAddedEquations;
+}
+
+}//.. end "namespace SimModelNative"
@@ -10,6 +10,8 @@
 #include "SimModel/FormulaFactory.h"
 #include "SimModel/ConstantFormula.h"
 #include "SimModel/Species.h"
+#include "SimModel/Simulation.h"
+#include <mutex>
 
 using namespace FuncParserNative;
 
@@ -22,6 +24,7 @@ ExplicitFormula::ExplicitFormula()
 {
 	_formula = NULL;
 	_isGloballySimplified = false;
+	_parsedEquations = NULL;
 }
 
 ExplicitFormula::~ExplicitFormula()
@@ -63,6 +66,8 @@ void ExplicitFormula::XMLFinalizeInstance (const XMLNode & pNode, Simulation * s
 {
 	ObjectBase::XMLFinalizeInstance(pNode, sim);
 
+	_parsedEquations = (sim != NULL) ? sim->GetParsedEquations() : NULL;
+
 	//add parameter references
 	AddQuantityRefsFromXMLNode(pNode.GetChildNode(XMLConstants::ParameterList), sim);
 
@@ -104,33 +109,41 @@ void ExplicitFormula::CreateFormulaFromEquation(const vector<string> & variableN
 	 										    const vector<string> & parameterNotToSimplifyNames,
 											    bool simplifyParameter)
 {
-   const char* ERROR_SOURCE = "ExplicitFormula::CreateFormulaFromEquation";
-	ParsedFunction parsedFunc;
+	XMLNode pRateNode;
+	EquationInputs inputs;
+	uint64_t key = 0;
 
-   try
-   {
-      parsedFunc.SetCaseSensitive(true);
-      parsedFunc.SetLogicOperatorsAllowed(true);
-      parsedFunc.SetLogicalNumericMixAllowed(true);
-      parsedFunc.SetSimplifyParametersAllowed(simplifyParameter);
+	//parsed equations are shared by all formulas of the simulation (s. Simulation::FinalizeFormulas)
+	//or even by all simulations (s. EquationCache), so they are locked only for the lookup.
+	//The returned rate node is a private copy and is used without the lock
 
-      parsedFunc.SetParameterNames(parameterNames);
-      parsedFunc.SetParameterValues(parameterValues);
-      parsedFunc.SetVariableNames(variableNames);
-      parsedFunc.SetParametersNotToSimplify(parameterNotToSimplifyNames);
+	//equation might have been parsed already with the same inputs (e.g. preparsed model)
+	if (_parsedEquations != NULL)
+	{
+		inputs.equation = _equation;
+		inputs.variableNames = variableNames;
+		inputs.parameterNames = parameterNames;
+		inputs.parameterValues = parameterValues;
+		inputs.parameterNotToSimplifyNames = parameterNotToSimplifyNames;
+		inputs.simplifyParameter = simplifyParameter;
 
-      parsedFunc.SetStringToParse(_equation);
-   }
-   catch(FuncParserErrorData& fpED)
-   {
-      throw ErrorData(ErrorData::ED_ERROR, fpED.GetSource(), fpED.GetDescription() + FormulaInfoForErrorMessage());
-   }
-   catch(...)
-   {
-      throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unknown error: " + FormulaInfoForErrorMessage());;
-   }
+		key = ParsedEquations::KeyFor(inputs);
+
+		lock_guard<mutex> lock(_parsedEquations->Mutex());
+		pRateNode = _parsedEquations->GetRateNode(key, inputs);
+	}
+
+	if (pRateNode.IsNull())
+	{
+		pRateNode = ParseEquation(variableNames, parameterNames, parameterValues,
+		                          parameterNotToSimplifyNames, simplifyParameter);
 
-	XMLNode pRateNode = GetRateNode(parsedFunc);
+		if (_parsedEquations != NULL)
+		{
+			lock_guard<mutex> lock(_parsedEquations->Mutex());
+			_parsedEquations->AddRateNode(key, inputs, pRateNode);
+		}
+	}
 	
 	if(_formula)
 	{
@@ -156,6 +169,41 @@ void ExplicitFormula::CreateFormulaFromEquation(const vector<string> & variableN
 	pRateNode.FreeNode();
 }
 
+XMLNode ExplicitFormula::ParseEquation(const vector<string> & variableNames, 
+	 								   const vector<string> & parameterNames,
+									   const vector<double> & parameterValues,
+	 								   const vector<string> & parameterNotToSimplifyNames,
+									   bool simplifyParameter)
+{
+   const char* ERROR_SOURCE = "ExplicitFormula::ParseEquation";
+	ParsedFunction parsedFunc;
+
+   try
+   {
+      parsedFunc.SetCaseSensitive(true);
+      parsedFunc.SetLogicOperatorsAllowed(true);
+      parsedFunc.SetLogicalNumericMixAllowed(true);
+      parsedFunc.SetSimplifyParametersAllowed(simplifyParameter);
+
+      parsedFunc.SetParameterNames(parameterNames);
+      parsedFunc.SetParameterValues(parameterValues);
+      parsedFunc.SetVariableNames(variableNames);
+      parsedFunc.SetParametersNotToSimplify(parameterNotToSimplifyNames);
+
+      parsedFunc.SetStringToParse(_equation);
+   }
+   catch(FuncParserErrorData& fpED)
+   {
+      throw ErrorData(ErrorData::ED_ERROR, fpED.GetSource(), fpED.GetDescription() + FormulaInfoForErrorMessage());
+   }
+   catch(...)
+   {
+      throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unknown error: " + FormulaInfoForErrorMessage());;
+   }
+
+	return GetRateNode(parsedFunc);
+}
+
 
 XMLNode ExplicitFormula::GetRateNode(ParsedFunction & parsedFunction)
 {
@@ -417,6 +465,16 @@ vector <double> ExplicitFormula::SwitchTimePoints()
 	return _formula->SwitchTimePoints();
 }
 
+bool ExplicitFormula::AppendScheduledTimePoints(vector <double> & scheduledTimePoints)
+{
+	return _formula->AppendScheduledTimePoints(scheduledTimePoints);
+}
+
+FormulaLinearity ExplicitFormula::Linearity()
+{
+	return _formula->Linearity();
+}
+
 bool ExplicitFormula::IsConstant(bool forCurrentRunOnly)
 {
 //	return (dynamic_cast<ConstantFormula *>(_formula) != NULL);
@@ -88,12 +88,22 @@ namespace SimModelNative
 		return false;
 	}
 
+	FormulaLinearity Formula::Linearity()
+	{
+		return IsConstant(true) ? FL_CONSTANT : FL_NONLINEAR;
+	}
+
 	vector <double> Formula::SwitchTimePoints()
 	{
 		throw ErrorData(ErrorData::ED_ERROR, "Formula::SwitchTimePoints", 
 						"Switch conditions seems to be setup incorrectly");
 	}
 
+	bool Formula::AppendScheduledTimePoints(vector <double> & /*scheduledTimePoints*/)
+	{
+		return false;
+	}
+
 	bool Formula::IsTable(void)
 	{
 		return false;
@@ -24,6 +24,7 @@ FormulaChange::FormulaChange(void)
 	_speciesDEIndex = DE_INVALID_INDEX;
 	_useAsValue = false; //per default, use formula and not its value if the parent switch fires
 	_speciesScaleFactor = 1.0;
+	_affectsRHS = true; //until proven otherwise by the switch impact analysis
 }
 
 FormulaChange::~FormulaChange(void)
@@ -73,7 +74,50 @@ Formula * FormulaChange::GetNewFormula(void)
 	return _newFormula;
 }
 
-bool FormulaChange::PerformSwitchUpdate(double * y, double time)
+Quantity * FormulaChange::GetQuantity(void)
+{
+	return _quantity;
+}
+
+bool FormulaChange::UseAsValue(void) const
+{
+	return _useAsValue;
+}
+
+bool FormulaChange::AffectsRHS() const
+{
+	return _affectsRHS;
+}
+
+void FormulaChange::SetAffectsRHS(bool affectsRHS)
+{
+	_affectsRHS = affectsRHS;
+}
+
+bool FormulaChange::ChangedQuantityIsUsedInRHS(const set<int> & rhsParameterIds)
+{
+	//species value change is a change of the ODE system state
+	if (dynamic_cast<Species*>(_quantity) != NULL)
+		return true;
+
+	//observer may be used in the RHS only indirectly via other formulas
+	Observer * observer = dynamic_cast<Observer*>(_quantity);
+	if (observer != NULL)
+		return observer->IsUsedInFormulas();
+
+	return rhsParameterIds.find(_quantity->GetId()) != rhsParameterIds.end();
+}
+
+bool FormulaChange::IsContinuousChange(double newValue, const double * y, double time)
+{
+	//only parameter values can be compared safely
+	if (dynamic_cast<Parameter*>(_quantity) == NULL)
+		return false;
+
+	return newValue == _quantity->GetValue(y, time, USE_SCALEFACTOR);
+}
+
+bool FormulaChange::PerformSwitchUpdate(double * y, double time, bool & solverRestartRequired)
 {
 	if(_speciesDEIndex != DE_INVALID_INDEX)
 	{
@@ -86,24 +130,34 @@ bool FormulaChange::PerformSwitchUpdate(double * y, double time)
 
 		y[_speciesDEIndex] = newValue;
 
-		return true; //simulation conditions changed by switch (solver restart needed)
+		solverRestartRequired = true; //simulation conditions changed by switch (solver restart needed)
+		return true; 
 	}
 
 	//---- object to change is not a species - set new formula or value
 	if (_useAsValue)
 	{
 		//set formula VALUE of the new formula
-		_quantity->SetConstantValue(_newFormula->DE_Compute(y, time, USE_SCALEFACTOR));
+		double newValue = _newFormula->DE_Compute(y, time, USE_SCALEFACTOR);
+
+		if (_affectsRHS && !IsContinuousChange(newValue, y, time))
+			solverRestartRequired = true;
+
+		_quantity->SetConstantValue(newValue);
 		return true;
 	}
 
 	if (_quantity->IsFormulaEqualTo(_newFormula))
 		return false; //same formula already set - no change
 
+	//restart the solver only if RHS changes discontinuously 
+	if (_affectsRHS && !IsContinuousChange(_newFormula->DE_Compute(y, time, USE_SCALEFACTOR), y, time))
+		solverRestartRequired = true;
+
 	//really new formula - set new FORMULA
 	_quantity->SetFormula(_newFormula);
 
-	return true; //simulation conditions changed by switch (solver restart needed)
+	return true; //simulation conditions changed by switch
 }
 
 void FormulaChange::Finalize()
@@ -0,0 +1,236 @@
+#include "SimModel/HierarchicalFormulaObjectGraph.h"
+#include <algorithm>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+static const int NOT_VISITED = -1;
+
+HierarchicalFormulaObjectGraph::HierarchicalFormulaObjectGraph(const vector <HierarchicalFormulaObject *> & objects) :
+	_objects(objects)
+{
+	const int numberOfObjects = (int)_objects.size();
+
+	for (int i = 0; i < numberOfObjects; i++)
+		_objects[i]->SetObjectIndex(i);
+
+	_firstUsedObject.reserve(numberOfObjects + 1);
+
+	for (int i = 0; i < numberOfObjects; i++)
+	{
+		_firstUsedObject.push_back((int)_usedObjects.size());
+
+		vector <HierarchicalFormulaObject *> usedObjects = _objects[i]->GetUsedHierarchicalFormulaObjects();
+
+		for (size_t j = 0; j < usedObjects.size(); j++)
+		{
+			const int usedIndex = usedObjects[j]->GetObjectIndex();
+
+			if ((usedIndex >= 0) && (usedIndex < numberOfObjects) && (_objects[usedIndex] == usedObjects[j]))
+				_usedObjects.push_back(usedIndex);
+		}
+	}
+
+	_firstUsedObject.push_back((int)_usedObjects.size());
+}
+
+vector <int> HierarchicalFormulaObjectGraph::DependencyOrder() const
+{
+	const int numberOfObjects = (int)_objects.size();
+
+	//---- reversed edges (objects using object j) and number of not yet ordered objects used by object i
+	vector <int> numberOfUsedObjects(numberOfObjects);
+	vector <int> firstUsingObject(numberOfObjects + 1, 0);
+	vector <int> usingObjects(_usedObjects.size());
+
+	for (int i = 0; i < numberOfObjects; i++)
+	{
+		numberOfUsedObjects[i] = _firstUsedObject[i + 1] - _firstUsedObject[i];
+
+		for (int k = _firstUsedObject[i]; k < _firstUsedObject[i + 1]; k++)
+			firstUsingObject[_usedObjects[k] + 1]++;
+	}
+
+	for (int j = 0; j < numberOfObjects; j++)
+		firstUsingObject[j + 1] += firstUsingObject[j];
+
+	vector <int> nextUsingObject(firstUsingObject.begin(), firstUsingObject.end() - 1);
+	for (int i = 0; i < numberOfObjects; i++)
+	{
+		for (int k = _firstUsedObject[i]; k < _firstUsedObject[i + 1]; k++)
+			usingObjects[nextUsingObject[_usedObjects[k]]++] = i;
+	}
+
+	//---- independent objects first; an object is ordered as soon as all objects it uses are ordered
+	vector <int> order;
+	order.reserve(numberOfObjects);
+
+	for (int i = 0; i < numberOfObjects; i++)
+	{
+		if (numberOfUsedObjects[i] == 0)
+			order.push_back(i);
+	}
+
+	for (size_t next = 0; next < order.size(); next++)
+	{
+		const int j = order[next];
+
+		for (int k = firstUsingObject[j]; k < firstUsingObject[j + 1]; k++)
+		{
+			const int i = usingObjects[k];
+
+			if (--numberOfUsedObjects[i] == 0)
+				order.push_back(i);
+		}
+	}
+
+	return order;
+}
+
+vector <int> HierarchicalFormulaObjectGraph::FindCycle() const
+{
+	const int numberOfObjects = (int)_objects.size();
+
+	vector <int> visitIndex(numberOfObjects, NOT_VISITED);
+	vector <int> lowLink(numberOfObjects, 0);
+	vector <char> onStack(numberOfObjects, 0);
+	vector <int> componentOfObject(numberOfObjects, NOT_VISITED);
+
+	vector <int> stack;
+	int numberOfVisits = 0;
+	int numberOfComponents = 0;
+
+	//depth first search without recursion (dependency chains can be long):
+	//(object, next used object to visit)
+	vector <pair <int, int> > searchPath;
+
+	for (int root = 0; root < numberOfObjects; root++)
+	{
+		if (visitIndex[root] != NOT_VISITED)
+			continue;
+
+		searchPath.push_back(make_pair(root, _firstUsedObject[root]));
+		visitIndex[root] = lowLink[root] = numberOfVisits++;
+		stack.push_back(root);
+		onStack[root] = 1;
+
+		while (!searchPath.empty())
+		{
+			const int i = searchPath.back().first;
+			int & k = searchPath.back().second;
+
+			if (k < _firstUsedObject[i + 1])
+			{
+				const int j = _usedObjects[k++];
+
+				if (visitIndex[j] == NOT_VISITED)
+				{
+					searchPath.push_back(make_pair(j, _firstUsedObject[j]));
+					visitIndex[j] = lowLink[j] = numberOfVisits++;
+					stack.push_back(j);
+					onStack[j] = 1;
+				}
+				else if (onStack[j])
+					lowLink[i] = min(lowLink[i], visitIndex[j]);
+
+				continue;
+			}
+
+			//all objects used by i are visited
+			searchPath.pop_back();
+			if (!searchPath.empty())
+			{
+				const int parent = searchPath.back().first;
+				lowLink[parent] = min(lowLink[parent], lowLink[i]);
+			}
+
+			if (lowLink[i] != visitIndex[i])
+				continue;
+
+			//i is the root of a strongly connected component
+			vector <int> component;
+			int j;
+			do
+			{
+				j = stack.back();
+				stack.pop_back();
+				onStack[j] = 0;
+				componentOfObject[j] = numberOfComponents;
+				component.push_back(j);
+			} while (j != i);
+
+			numberOfComponents++;
+
+			if (component.size() > 1)
+				return cycleThrough(i, component, componentOfObject);
+
+			//single object is a cycle only if it uses itself
+			for (int l = _firstUsedObject[i]; l < _firstUsedObject[i + 1]; l++)
+			{
+				if (_usedObjects[l] == i)
+					return vector <int>(1, i);
+			}
+		}
+	}
+
+	return vector <int>();
+}
+
+vector <int> HierarchicalFormulaObjectGraph::cycleThrough(int start, const vector <int> & component, const vector <int> & componentOfObject) const
+{
+	//breadth first search from <start> within the component until <start> is reached again
+	const int startComponent = componentOfObject[start];
+
+	vector <int> predecessor(_objects.size(), NOT_VISITED);
+	vector <int> queue(1, start);
+
+	for (size_t next = 0; next < queue.size(); next++)
+	{
+		const int i = queue[next];
+
+		for (int k = _firstUsedObject[i]; k < _firstUsedObject[i + 1]; k++)
+		{
+			const int j = _usedObjects[k];
+
+			if (componentOfObject[j] != startComponent)
+				continue;
+
+			if (j == start)
+			{
+				vector <int> cycle;
+				for (int l = i; l != start; l = predecessor[l])
+					cycle.push_back(l);
+				cycle.push_back(start);
+
+				reverse(cycle.begin(), cycle.end());
+				return cycle;
+			}
+
+			if (predecessor[j] == NOT_VISITED)
+			{
+				predecessor[j] = i;
+				queue.push_back(j);
+			}
+		}
+	}
+
+	//cannot happen for a strongly connected component: report the component itself
+	return component;
+}
+
+string HierarchicalFormulaObjectGraph::CycleDescription(const vector <int> & cycle) const
+{
+	string description;
+
+	for (size_t i = 0; i < cycle.size(); i++)
+		description += _objects[cycle[i]]->GetFullName() + " -> ";
+
+	if (!cycle.empty())
+		description += _objects[cycle[0]]->GetFullName();
+
+	return description;
+}
+
+}//.. end "namespace SimModelNative"
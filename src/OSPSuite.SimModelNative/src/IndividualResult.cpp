@@ -0,0 +1,66 @@
+#include "SimModel/IndividualResult.h"
+#include "SimModel/MathHelper.h"
+
+namespace SimModelNative
+{
+
+IndividualResult::IndividualResult(void)
+{
+	_individual = -1;
+	_status = 0;
+	_numberOfOutputs = 0;
+	_numberOfTimePoints = 0;
+	_next = NULL;
+}
+
+void IndividualResult::Reset(int individual, int numberOfOutputs, int numberOfTimePoints)
+{
+	_individual = individual;
+	_status = 0;
+	_message.clear();
+	_numberOfOutputs = numberOfOutputs;
+	_numberOfTimePoints = numberOfTimePoints;
+
+	//capacity of recycled buffers is retained
+	_timeValues.clear();
+	_values.assign((size_t)numberOfOutputs * numberOfTimePoints, MathHelper::GetNaN());
+
+	_next = NULL;
+}
+
+int IndividualResult::Individual() const
+{
+	return _individual;
+}
+
+int IndividualResult::Status() const
+{
+	return _status;
+}
+
+const std::string & IndividualResult::Message() const
+{
+	return _message;
+}
+
+int IndividualResult::NumberOfOutputs() const
+{
+	return _numberOfOutputs;
+}
+
+int IndividualResult::NumberOfTimePoints() const
+{
+	return _numberOfTimePoints;
+}
+
+const double * IndividualResult::TimeValues() const
+{
+	return _timeValues.empty() ? NULL : &_timeValues[0];
+}
+
+const double * IndividualResult::Values() const
+{
+	return _values.empty() ? NULL : &_values[0];
+}
+
+}//.. end "namespace SimModelNative"
@@ -0,0 +1,162 @@
+#ifdef _WINDOWS
+#pragma warning(disable:4786)
+#endif
+
+#include "SimModel/LinearODESolver.h"
+#include "SimModel/Formula.h"
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+//max. 1-norm of (timeStep*augmented matrix) within one Taylor substep
+const double TAYLOR_SUBSTEP_NORM = 2.0;
+
+//max. number of Taylor terms per substep (far more than needed for TAYLOR_SUBSTEP_NORM)
+const int MAX_TAYLOR_TERMS = 60;
+
+LinearODESolver::LinearODESolver(void)
+{
+	_n = 0;
+	_beta = 1.0;
+	_norm = 0.0;
+	_numberOfAssemblies = 0;
+}
+
+void LinearODESolver::Reset()
+{
+	_numberOfAssemblies = 0;
+}
+
+int LinearODESolver::NumberOfAssemblies() const
+{
+	return _numberOfAssemblies;
+}
+
+void LinearODESolver::Assemble(int n, double * * jacobian, const double * rhsAtZero)
+{
+	int i, j;
+
+	_n = n;
+	_rowStart.assign(n + 1, 0);
+	_columnIndex.clear();
+	_values.clear();
+
+	vector <double> columnNorms(n, 0.0);
+
+	for (i = 0; i < n; i++)
+	{
+		for (j = 0; j < n; j++)
+		{
+			double value = MATRIX_ELEM(jacobian, i, j);
+			if (value == 0.0)
+				continue;
+
+			_columnIndex.push_back(j);
+			_values.push_back(value);
+			columnNorms[j] += fabs(value);
+		}
+		_rowStart[i + 1] = (int)_values.size();
+	}
+
+	double matrixNorm = 0.0;
+	for (j = 0; j < n; j++)
+		matrixNorm = max(matrixNorm, columnNorms[j]);
+
+	double rhsNorm = 0.0;
+	for (i = 0; i < n; i++)
+		rhsNorm += fabs(rhsAtZero[i]);
+
+	//scale the inhomogeneity to the norm of A (to the unit norm if A=0)
+	_beta = 1.0;
+	if (rhsNorm > 0.0)
+		_beta = (matrixNorm > 0.0) ? rhsNorm / matrixNorm : rhsNorm;
+
+	_inhomogeneity.resize(n);
+	for (i = 0; i < n; i++)
+		_inhomogeneity[i] = rhsAtZero[i] / _beta;
+
+	_norm = max(matrixNorm, rhsNorm / _beta);
+
+	_term.resize(n);
+	_nextTerm.resize(n);
+	_result.resize(n);
+
+	_numberOfAssemblies++;
+}
+
+void LinearODESolver::multiply(const double * x, double xAugmented, double * x_out)
+{
+	for (int i = 0; i < _n; i++)
+	{
+		double value = _inhomogeneity[i] * xAugmented;
+		for (int k = _rowStart[i]; k < _rowStart[i + 1]; k++)
+			value += _values[k] * x[_columnIndex[k]];
+		x_out[i] = value;
+	}
+}
+
+void LinearODESolver::Advance(double * y, double timeStep)
+{
+	int i;
+
+	if ((timeStep <= 0.0) || (_n == 0) || (_norm == 0.0))
+		return;
+
+	//split the time step s.t. each substep is well within the convergence radius
+	//of the truncated series (no cancellation, few terms)
+	int numberOfSubsteps = (int)ceil(timeStep * _norm / TAYLOR_SUBSTEP_NORM);
+	numberOfSubsteps = max(numberOfSubsteps, 1);
+	double substep = timeStep / numberOfSubsteps;
+
+	for (int iSubstep = 0; iSubstep < numberOfSubsteps; iSubstep++)
+	{
+		//the augmented component is constant (=beta), its term is only
+		//non-zero in the 0th term of the series
+		double termAugmented = _beta;
+
+		for (i = 0; i < _n; i++)
+		{
+			_term[i] = y[i];
+			_result[i] = y[i];
+		}
+
+		double previousTermNorm = DBL_MAX;
+
+		for (int k = 1; k <= MAX_TAYLOR_TERMS; k++)
+		{
+			multiply(&_term[0], termAugmented, &_nextTerm[0]);
+			termAugmented = 0.0;
+
+			double factor = substep / k;
+			double termNorm = 0.0, resultNorm = 0.0;
+
+			for (i = 0; i < _n; i++)
+			{
+				_term[i] = factor * _nextTerm[i];
+				_result[i] += _term[i];
+
+				termNorm = max(termNorm, fabs(_term[i]));
+				resultNorm = max(resultNorm, fabs(_result[i]));
+			}
+
+			//two consecutive terms below rounding level: series converged
+			if (termNorm + previousTermNorm <= DBL_EPSILON * resultNorm)
+				break;
+
+			if ((termNorm == 0.0) && (resultNorm == 0.0))
+				break;
+
+			previousTermNorm = termNorm;
+		}
+
+		for (i = 0; i < _n; i++)
+			y[i] = _result[i];
+	}
+}
+
+}//.. end "namespace SimModelNative"
@@ -72,6 +72,9 @@ void MatlabODEExporter::WriteMatlabCode (Simulation * sim, const string & OutDir
 		}
 		sim->Finalize();
 	}
+
+	//all formulas are exported
+	sim->FinalizeDeferredFormulas();
 	
 	CheckIfSimulationCanBeExported(sim);
 
@@ -0,0 +1,75 @@
+#include "SimModel/PInvokeHelper.h"
+#include "SimModel/PInvokeEquationCache.h"
+
+namespace SimModelNative
+{
+   using namespace std;
+
+   void SetEquationCacheMaximumSize(int maximumSize)
+   {
+      EquationCache::GetInstance()->SetMaximumSize(maximumSize > 0 ? (size_t)maximumSize : 0);
+   }
+
+   int GetEquationCacheMaximumSize()
+   {
+      return (int)EquationCache::GetInstance()->GetMaximumSize();
+   }
+
+   void ClearEquationCache()
+   {
+      EquationCache::GetInstance()->Clear();
+   }
+
+   void GetEquationCacheStatistics(int& size, long long& hits, long long& misses, long long& evictions)
+   {
+      EquationCache* equationCache = EquationCache::GetInstance();
+
+      uint64_t cacheHits, cacheMisses, cacheEvictions;
+      equationCache->GetStatistics(cacheHits, cacheMisses, cacheEvictions);
+
+      size = (int)equationCache->Size();
+      hits = (long long)cacheHits;
+      misses = (long long)cacheMisses;
+      evictions = (long long)cacheEvictions;
+   }
+
+   void SaveEquationCache(const char* fileName, bool& success, char** errorMessage)
+   {
+      try
+      {
+         EquationCache::GetInstance()->SaveToFile(fileName);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("SaveEquationCache");
+         success = false;
+      }
+   }
+
+   int LoadEquationCache(const char* fileName, bool& success, char** errorMessage)
+   {
+      success = true;
+
+      try
+      {
+         return EquationCache::GetInstance()->LoadFromFile(fileName);
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("LoadEquationCache");
+      }
+
+      success = false;
+      return 0;
+   }
+}//.. end "namespace SimModelNative"
@@ -0,0 +1,270 @@
+#include "SimModel/PInvokeHelper.h"
+#include "SimModel/PInvokePopulationRunner.h"
+
+#if defined(linux) || defined (__APPLE__)
+#include <string.h> //for memcpy
+#endif
+
+namespace SimModelNative
+{
+   using namespace std;
+
+   static vector<string> entityIdsFrom(const char** entityIds, int size)
+   {
+      vector<string> entityIdsVec;
+      for (int i = 0; i < size; i++)
+         entityIdsVec.push_back(entityIds[i]);
+
+      return entityIdsVec;
+   }
+
+   PopulationRunner* CreatePopulationRunner(Simulation* simulation)
+   {
+      return new PopulationRunner(simulation);
+   }
+
+   void DisposePopulationRunner(PopulationRunner* populationRunner)
+   {
+      delete populationRunner;
+   }
+
+   void SetPopulationRunnerNumberOfThreads(PopulationRunner* populationRunner, int numberOfThreads)
+   {
+      populationRunner->SetNumberOfThreads(numberOfThreads);
+   }
+
+   void SetPopulationRunnerExecutionMode(PopulationRunner* populationRunner, int executionMode)
+   {
+      populationRunner->SetExecutionMode((PopulationRunner::ExecutionMode)executionMode);
+   }
+
+   void SetPopulationRunnerEnsembleSize(PopulationRunner* populationRunner, int ensembleSize)
+   {
+      populationRunner->SetEnsembleSize(ensembleSize);
+   }
+
+   void SetPopulationVariableParameters(PopulationRunner* populationRunner, const char** entityIds, int size)
+   {
+      populationRunner->SetVariableParameters(entityIdsFrom(entityIds, size));
+   }
+
+   void SetPopulationVariableSpecies(PopulationRunner* populationRunner, const char** entityIds, int size)
+   {
+      populationRunner->SetVariableSpecies(entityIdsFrom(entityIds, size));
+   }
+
+   void SetPopulationOutputs(PopulationRunner* populationRunner, const char** entityIds, int size)
+   {
+      populationRunner->SetOutputs(entityIdsFrom(entityIds, size));
+   }
+
+   void CancelPopulationRun(PopulationRunner* populationRunner)
+   {
+      populationRunner->Cancel();
+   }
+
+   long GetPopulationRunProgress(PopulationRunner* populationRunner)
+   {
+      return populationRunner->Progress();
+   }
+
+   int GetPopulationNumberOfTimePoints(PopulationRunner* populationRunner, bool& success, char** errorMessage)
+   {
+      success = true;
+
+      try
+      {
+         return populationRunner->NumberOfTimePoints();
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("GetPopulationNumberOfTimePoints");
+      }
+
+      success = false;
+      return 0;
+   }
+
+   void RunPopulation(PopulationRunner* populationRunner, int numberOfIndividuals, const double* values,
+                      double* results, int* statuses, bool& success, char** errorMessage)
+   {
+      try
+      {
+         populationRunner->Run(numberOfIndividuals, values, results, statuses);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("RunPopulation");
+         success = false;
+      }
+   }
+
+   char* GetPopulationRunMessage(PopulationRunner* populationRunner, int individual, bool& success, char** errorMessage)
+   {
+      success = true;
+
+      try
+      {
+         return MarshalString(populationRunner->Message(individual));
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("GetPopulationRunMessage");
+      }
+
+      success = false;
+      return MarshalString("");
+   }
+
+   int GetPopulationNumberOfIndividualsSolvedInEnsembles(PopulationRunner* populationRunner)
+   {
+      return populationRunner->NumberOfIndividualsSolvedInEnsembles();
+   }
+
+   int GetPopulationNumberOfStolenTasks(PopulationRunner* populationRunner)
+   {
+      return populationRunner->NumberOfStolenTasks();
+   }
+
+   char* GetPopulationEnsembleErrors(PopulationRunner* populationRunner)
+   {
+      string ensembleErrors;
+
+      for (const string& ensembleError : populationRunner->EnsembleErrors())
+      {
+         if (!ensembleErrors.empty())
+            ensembleErrors += "\n";
+         ensembleErrors += ensembleError;
+      }
+
+      return MarshalString(ensembleErrors);
+   }
+
+   int FillPopulationWorkerProcesses(PopulationRunner* populationRunner, int* processIds, int size)
+   {
+      const vector<int> workerProcesses = populationRunner->WorkerProcesses();
+
+      for (int i = 0; (i < size) && (i < (int)workerProcesses.size()); i++)
+         processIds[i] = workerProcesses[i];
+
+      return (int)workerProcesses.size();
+   }
+
+   void FillPopulationTimeValues(PopulationRunner* populationRunner, double* timeValues, int size, bool& success, char** errorMessage)
+   {
+      const char* ERROR_SOURCE = "FillPopulationTimeValues";
+
+      try
+      {
+         const vector<double>& populationTimeValues = populationRunner->TimeValues();
+         if ((size < 0) || (populationTimeValues.size() != (size_t)size))
+            throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Time values size does not match");
+
+         if (size > 0)
+            memcpy(timeValues, &populationTimeValues[0], size * sizeof(double));
+
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown(ERROR_SOURCE);
+         success = false;
+      }
+   }
+
+   void StartPopulationStreamingRun(PopulationRunner* populationRunner, int numberOfIndividuals, const double* values,
+                                    PopulationRunner::ResultCallback callback, void* userData, bool& success, char** errorMessage)
+   {
+      try
+      {
+         populationRunner->StartStreamingRun(numberOfIndividuals, values, callback, userData);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("StartPopulationStreamingRun");
+         success = false;
+      }
+   }
+
+   IndividualResult* GetNextPopulationResult(PopulationRunner* populationRunner, int timeoutMs)
+   {
+      return populationRunner->NextResult(timeoutMs);
+   }
+
+   bool IsPopulationStreamingRunCompleted(PopulationRunner* populationRunner)
+   {
+      return populationRunner->StreamingRunCompleted();
+   }
+
+   void ReleasePopulationResult(PopulationRunner* populationRunner, IndividualResult* result)
+   {
+      populationRunner->ReleaseResult(result);
+   }
+
+   void FinishPopulationStreamingRun(PopulationRunner* populationRunner, bool& success, char** errorMessage)
+   {
+      try
+      {
+         populationRunner->FinishStreamingRun();
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("FinishPopulationStreamingRun");
+         success = false;
+      }
+   }
+
+   void GetIndividualResultProperties(IndividualResult* result, int& individual, int& status, int& numberOfOutputs, int& numberOfTimePoints)
+   {
+      individual = result->Individual();
+      status = result->Status();
+      numberOfOutputs = result->NumberOfOutputs();
+      numberOfTimePoints = result->NumberOfTimePoints();
+   }
+
+   char* GetIndividualResultMessage(IndividualResult* result)
+   {
+      return MarshalString(result->Message());
+   }
+
+   const double* GetIndividualResultTimeValues(IndividualResult* result)
+   {
+      return result->TimeValues();
+   }
+
+   const double* GetIndividualResultValues(IndividualResult* result)
+   {
+      return result->Values();
+   }
+}//.. end "namespace SimModelNative"
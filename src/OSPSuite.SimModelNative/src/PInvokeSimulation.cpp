@@ -23,6 +23,29 @@ namespace SimModelNative
       IdentifyUsedParameters = options.IdentifyUsedParameters();
       KeepXMLNodeAsString = options.KeepXMLNodeAsString();
       UseFloatComparisonInUserOutputTimePoints = options.UseFloatComparisonInUserOutputTimePoints();
+      AutoSolverConfiguration = options.AutoSolverConfiguration();
+      SolveLinearSystemsExactly = options.SolveLinearSystemsExactly();
+      StreamingXMLLoad = options.StreamingXMLLoad();
+      NumberOfFinalizeThreads = options.NumberOfFinalizeThreads();
+      UseEquationCache = options.UseEquationCache();
+      LazyFinalize = options.LazyFinalize();
+      LeanMode = options.LeanMode();
+   }
+
+   void SimulationRunStatisticsStructure::CopyFrom(const SimulationRunStatistics& statistics)
+   {
+      SetupTime = statistics.SetupTime();
+      SolveTime = statistics.SolveTime();
+      SolverInstanceReused = statistics.SolverInstanceReused();
+      AvoidedSolverRestarts = statistics.AvoidedSolverRestarts();
+      ScheduledSwitches = statistics.ScheduledSwitches();
+      BandLinearSolverUsed = statistics.BandLinearSolverUsed();
+      LowerHalfBandWidth = statistics.LowerHalfBandWidth();
+      UpperHalfBandWidth = statistics.UpperHalfBandWidth();
+      AdamsMethodUsed = statistics.AdamsMethodUsed();
+      SpectralRadiusEstimate = statistics.SpectralRadiusEstimate();
+      LinearSystemSolvedExactly = statistics.LinearSystemSolvedExactly();
+      BDFSwitchTime = statistics.BDFSwitchTime();
    }
 
    Simulation* CreateSimulation()
@@ -92,11 +115,150 @@ namespace SimModelNative
       }
    }
 
+   Simulation* CloneSimulation(Simulation* simulation, bool& success, char** errorMessage)
+   {
+      try
+      {
+         auto clone = simulation->Clone();
+         success = true;
+         return clone;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("CloneSimulation");
+         success = false;
+      }
+
+      return NULL;
+   }
+
+   void SavePreparsedModel(Simulation* simulation, const char* fileName, bool& success, char** errorMessage)
+   {
+      try
+      {
+         simulation->SavePreparsedModel(fileName);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("SavePreparsedModel");
+         success = false;
+      }
+   }
+
+   void LoadSimulationFromPreparsedModel(Simulation* simulation, const char* fileName, bool& success, char** errorMessage)
+   {
+      try
+      {
+         simulation->LoadFromPreparsedModel(fileName);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("LoadSimulationFromPreparsedModel");
+         success = false;
+      }
+   }
+
+   //indices of the not fixed quantities in the list, which are the indices
+   //in the parameter/species properties (s. Simulation::FillParameterProperties)
+   template <class T> static vector<int> variableIndices(TObjectList<T>& quantities)
+   {
+      vector<int> indices;
+
+      for (int i = 0; i < quantities.size(); i++)
+      {
+         if (!quantities[i]->IsFixed())
+            indices.push_back(i);
+      }
+
+      return indices;
+   }
+
+   template <class T> static void fillVariableIndices(TObjectList<T>& quantities, int* indices, int size)
+   {
+      vector<int> variableQuantityIndices = variableIndices(quantities);
+
+      if (size != (int)variableQuantityIndices.size())
+         throw ErrorData(ErrorData::ED_ERROR, "FillVariableIndices", "Invalid size of the index array");
+
+      for (int i = 0; i < size; i++)
+         indices[i] = variableQuantityIndices[i];
+   }
+
+   int GetNumberOfVariableParameters(Simulation* simulation)
+   {
+      return (int)variableIndices(simulation->Parameters()).size();
+   }
+
+   void FillVariableParameterIndices(Simulation* simulation, int* parameterIndices, int size, bool& success, char** errorMessage)
+   {
+      try
+      {
+         fillVariableIndices(simulation->Parameters(), parameterIndices, size);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("FillVariableParameterIndices");
+         success = false;
+      }
+   }
+
+   int GetNumberOfVariableSpecies(Simulation* simulation)
+   {
+      return (int)variableIndices(simulation->SpeciesList()).size();
+   }
+
+   void FillVariableSpeciesIndices(Simulation* simulation, int* speciesIndices, int size, bool& success, char** errorMessage)
+   {
+      try
+      {
+         fillVariableIndices(simulation->SpeciesList(), speciesIndices, size);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("FillVariableSpeciesIndices");
+         success = false;
+      }
+   }
+
    long GetSimulationProgress(Simulation* simulation)
    {
       return simulation->GetProgress();
    }
 
+   int GetNumberOfDeferredFormulas(Simulation* simulation)
+   {
+      return simulation->GetNumberOfDeferredFormulas();
+   }
+
    void CancelSimulationRun(Simulation* simulation)
    {
       simulation->Cancel();
@@ -135,6 +297,13 @@ namespace SimModelNative
       simulationOptions.IdentifyUsedParameters(options.IdentifyUsedParameters);
       simulationOptions.SetKeepXMLNodeAsString(options.KeepXMLNodeAsString);
       simulationOptions.SetUseFloatComparisonInUserOutputTimePoints(options.UseFloatComparisonInUserOutputTimePoints);
+      simulationOptions.SetAutoSolverConfiguration(options.AutoSolverConfiguration);
+      simulationOptions.SetSolveLinearSystemsExactly(options.SolveLinearSystemsExactly);
+      simulationOptions.SetStreamingXMLLoad(options.StreamingXMLLoad);
+      simulationOptions.SetNumberOfFinalizeThreads(options.NumberOfFinalizeThreads);
+      simulationOptions.SetUseEquationCache(options.UseEquationCache);
+      simulationOptions.SetLazyFinalize(options.LazyFinalize);
+      simulationOptions.SetLeanMode(options.LeanMode);
    }
 
    void RunSimulation(Simulation* simulation, bool& toleranceWasReduced, double& newAbsTol, double& newRelTol, bool& success, char** errorMessage)
@@ -156,6 +325,11 @@ namespace SimModelNative
       }
    }
 
+   void FillSimulationRunStatistics(Simulation* simulation, SimulationRunStatisticsStructure* statistics)
+   {
+      statistics->CopyFrom(simulation->RunStatistics());
+   }
+
    int GetNumberOfTimePoints(Simulation* simulation)
    {
       return simulation->GetNumberOfTimePoints();
@@ -1129,25 +1303,13 @@ namespace SimModelNative
 
       try
       {
-         for (auto idx = 0; idx < simulation->SpeciesList().size(); idx++)
-         {
-            if (simulation->SpeciesList()[idx]->GetPathWithoutRoot() == quantityPath)
-            {
-               success = true;
-               return simulation->SpeciesList()[idx];
-            }
-         }
+         Quantity* quantity = simulation->GetQuantityByPath(quantityPath);
 
-         for (auto idx = 0; idx < simulation->Observers().size(); idx++)
-         {
-            if (simulation->Observers()[idx]->GetPathWithoutRoot() == quantityPath)
-            {
-               success = true;
-               return simulation->Observers()[idx];
-            }
-         }
+         if (quantity == nullptr)
+            throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, string(quantityPath) + " is not a valid path of system variable or observer");
 
-         throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, string(quantityPath) + " is not a valid path of system variable or observer");
+         success = true;
+         return quantity;
 
       }
       catch (ErrorData& ED)
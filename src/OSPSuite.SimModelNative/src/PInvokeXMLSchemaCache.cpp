@@ -0,0 +1,60 @@
+#include "SimModel/PInvokeHelper.h"
+#include "SimModel/PInvokeXMLSchemaCache.h"
+#include "XMLWrapper/XMLCache.h"
+
+namespace SimModelNative
+{
+   using namespace std;
+
+   void LoadXMLSchemaFromFile(const char* fileName, const char* schemaNamespace, bool& success, char** errorMessage)
+   {
+      try
+      {
+         XMLCache* pXMLCache = XMLCache::GetInstance();
+
+         if (schemaNamespace && *schemaNamespace)
+            pXMLCache->SetSchemaNamespace(schemaNamespace);
+
+         pXMLCache->LoadSchemaFromFile(fileName);
+         success = true;
+      }
+      catch (ErrorData& ED)
+      {
+         *errorMessage = ErrorMessageFrom(ED);
+         success = false;
+      }
+      catch (...)
+      {
+         *errorMessage = ErrorMessageFromUnknown("LoadXMLSchemaFromFile");
+         success = false;
+      }
+   }
+
+   bool XMLSchemaIsInitialized()
+   {
+      return XMLCache::GetInstance()->SchemaInitialized();
+   }
+
+   void SetMaximumNumberOfValidatedContents(int maximumNumber)
+   {
+      XMLCache::GetInstance()->SetMaximumNumberOfValidatedContents(maximumNumber > 0 ? (size_t)maximumNumber : 0);
+   }
+
+   int GetMaximumNumberOfValidatedContents()
+   {
+      return (int)XMLCache::GetInstance()->GetMaximumNumberOfValidatedContents();
+   }
+
+   void ClearValidatedContents()
+   {
+      XMLCache::GetInstance()->ClearValidatedContents();
+   }
+
+   void GetValidatedContentsStatistics(int& numberOfValidatedContents, long long& skippedValidations)
+   {
+      XMLCache* pXMLCache = XMLCache::GetInstance();
+
+      numberOfValidatedContents = (int)pXMLCache->NumberOfValidatedContents();
+      skippedValidations = (long long)pXMLCache->NumberOfSkippedValidations();
+   }
+}//.. end "namespace SimModelNative"
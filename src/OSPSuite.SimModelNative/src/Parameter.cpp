@@ -280,6 +280,8 @@ void Parameter::SetTablePoints(const std::vector <ValuePoint> & valuePoints)
 	}
 
 	_valueFormula->SetTablePoints(valuePoints);
+
+	_initialValueChanged = true;
 }
 
 Observer * Parameter::CreateObserverWithId(long objectId, Formula * observerFormula)
@@ -294,6 +296,17 @@ bool Parameter::IsConstant(bool forCurrentRunOnly)
 	return (Quantity::IsConstant(forCurrentRunOnly) && !_calculateSensitivity);
 }
 
+FormulaLinearity Parameter::Linearity()
+{
+	if (_calculateSensitivity)
+		return FL_NONLINEAR;
+
+	if (_valueFormula == NULL)
+		return FL_CONSTANT; //changes by switches (if any) are checked separately
+
+	return _valueFormula->Linearity();
+}
+
 bool Parameter::ExportAsGlobalForMatlab()
 {
 	return (IsChangedBySwitch() || IsUsedBySwitch() || IsTable());
@@ -314,7 +327,7 @@ void Parameter::WriteTableFunctionForMatlab(ostream & mrOut)
 
 	if(tableFormula == NULL)
 		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, 
-		                "Trying to export non-table parameter ("+_fullName+") as a table");
+		                "Trying to export non-table parameter ("+_fullName.Value()+") as a table");
 
 	mrOut<<"function yout = "+TableFunctionNameForMatlab()+"(Time, y)"<<endl<<endl;
 	tableFormula->WriteMatlabCode(mrOut);
@@ -329,7 +342,7 @@ void Parameter::WriteTableFunctionForCpp(ostream & mrOut)
 
 	if (tableFormula == NULL)
 		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,
-		"Trying to export non-table parameter (" + _fullName + ") as a table");
+		"Trying to export non-table parameter (" + _fullName.Value() + ") as a table");
 
 	tableFormula->WriteCppCode(mrOut);
 }
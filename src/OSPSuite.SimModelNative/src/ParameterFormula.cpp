@@ -105,6 +105,11 @@ bool ParameterFormula::IsConstant(bool forCurrentRunOnly)
 	return _quantityRef.IsConstant(forCurrentRunOnly);
 }
 
+FormulaLinearity ParameterFormula::Linearity()
+{
+	return _quantityRef.Linearity();
+}
+
 void ParameterFormula::WriteFormulaMatlabCode (std::ostream & mrOut)
 {
 	if (_quantityRef.IsTime())
@@ -0,0 +1,92 @@
+#include "SimModel/ParsedEquations.h"
+#include <cstring>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+//FNV-1a
+static const uint64_t KEY_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t KEY_PRIME = 1099511628211ULL;
+
+static void hashBytes(uint64_t & key, const void * data, size_t size)
+{
+	const unsigned char * bytes = (const unsigned char *)data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		key ^= bytes[i];
+		key *= KEY_PRIME;
+	}
+}
+
+//length prefix keeps e.g. {"ab","c"} and {"a","bc"} apart
+static void hashString(uint64_t & key, const string & value)
+{
+	const uint64_t length = value.size();
+	hashBytes(key, &length, sizeof(length));
+	hashBytes(key, value.data(), value.size());
+}
+
+static void hashStrings(uint64_t & key, const vector<string> & values)
+{
+	const uint64_t count = values.size();
+	hashBytes(key, &count, sizeof(count));
+
+	for (size_t i = 0; i < values.size(); i++)
+		hashString(key, values[i]);
+}
+
+static uint64_t bitsOf(double value)
+{
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+bool EquationInputs::operator == (const EquationInputs & other) const
+{
+	if ((equation != other.equation) ||
+	    (variableNames != other.variableNames) ||
+	    (parameterNames != other.parameterNames) ||
+	    (parameterNotToSimplifyNames != other.parameterNotToSimplifyNames) ||
+	    (simplifyParameter != other.simplifyParameter) ||
+	    (parameterValues.size() != other.parameterValues.size()))
+		return false;
+
+	for (size_t i = 0; i < parameterValues.size(); i++)
+	{
+		if (bitsOf(parameterValues[i]) != bitsOf(other.parameterValues[i]))
+			return false;
+	}
+
+	return true;
+}
+
+uint64_t ParsedEquations::KeyFor(const EquationInputs & inputs)
+{
+	uint64_t key = KEY_OFFSET_BASIS;
+
+	hashString(key, inputs.equation);
+	hashStrings(key, inputs.variableNames);
+	hashStrings(key, inputs.parameterNames);
+	hashStrings(key, inputs.parameterNotToSimplifyNames);
+
+	const uint64_t numberOfValues = inputs.parameterValues.size();
+	hashBytes(key, &numberOfValues, sizeof(numberOfValues));
+
+	//bit patterns of the values: parameters are only replaced by identical values
+	for (size_t i = 0; i < inputs.parameterValues.size(); i++)
+	{
+		const uint64_t bits = bitsOf(inputs.parameterValues[i]);
+		hashBytes(key, &bits, sizeof(bits));
+	}
+
+	const unsigned char simplify = inputs.simplifyParameter ? 1 : 0;
+	hashBytes(key, &simplify, sizeof(simplify));
+
+	return key;
+}
+
+}//.. end "namespace SimModelNative"
@@ -0,0 +1,1154 @@
+#ifdef _WINDOWS
+#pragma warning(disable:4786)
+#endif
+
+#include "SimModel/PopulationRunner.h"
+#include "SimModel/SimulationTask.h"
+#include "SimModel/MathHelper.h"
+#include "XMLWrapper/XMLHelper.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <new>
+#include <thread>
+
+#if defined(linux) || defined (__APPLE__)
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+PopulationRunner::PopulationRunner(Simulation * model)
+{
+	_model = model;
+	_numberOfThreads = 0;
+	_executionMode = EM_THREADS;
+	_ensembleSize = 1;
+	_numberOfIndividualsSolvedInEnsembles = 0;
+	_numberOfStolenTasks = 0;
+	_cancelRequested = false;
+	_taskGroup = NULL;
+	_processRunState = NULL;
+	_resultCallback = NULL;
+	_resultCallbackUserData = NULL;
+}
+
+PopulationRunner::~PopulationRunner()
+{
+	if (_streamingThread.joinable())
+	{
+		Cancel();
+		_streamingThread.join();
+	}
+
+	releaseWorkers();
+
+	for (size_t i = 0; i < _allResults.size(); i++)
+		delete _allResults[i];
+}
+
+void PopulationRunner::SetNumberOfThreads(int numberOfThreads)
+{
+	_numberOfThreads = max(numberOfThreads, 0);
+}
+
+int PopulationRunner::NumberOfThreads() const
+{
+	return _numberOfThreads;
+}
+
+void PopulationRunner::SetVariableParameters(const vector <string> & entityIds)
+{
+	_variableParameters = entityIds;
+}
+
+void PopulationRunner::SetVariableSpecies(const vector <string> & entityIds)
+{
+	_variableSpecies = entityIds;
+}
+
+void PopulationRunner::SetOutputs(const vector <string> & entityIds)
+{
+	_outputs = entityIds;
+}
+
+void PopulationRunner::Cancel()
+{
+	lock_guard <mutex> lock(_runStateMutex);
+
+	_cancelRequested = true;
+
+	if (_taskGroup != NULL)
+		_taskGroup->Cancel();
+
+#if defined(linux) || defined (__APPLE__)
+	if (_processRunState != NULL)
+	{
+		//running individuals are stopped by terminating their worker processes
+		_processRunState->cancelFlag = true;
+
+		for (size_t i = 0; i < _workerProcesses.size(); i++)
+			kill(_workerProcesses[i], SIGKILL);
+	}
+#endif
+}
+
+long PopulationRunner::Progress()
+{
+	lock_guard <mutex> lock(_runStateMutex);
+
+	if (_taskGroup != NULL)
+		return _taskGroup->Progress();
+
+	if (_processRunState != NULL)
+		return (long)(100.0 * _processRunState->numberOfFinishedIndividuals / _processRunState->numberOfIndividuals);
+
+	return 0;
+}
+
+void PopulationRunner::SetExecutionMode(ExecutionMode executionMode)
+{
+	_executionMode = executionMode;
+}
+
+PopulationRunner::ExecutionMode PopulationRunner::GetExecutionMode() const
+{
+	return _executionMode;
+}
+
+void PopulationRunner::SetEnsembleSize(int ensembleSize)
+{
+	_ensembleSize = max(ensembleSize, 1);
+}
+
+int PopulationRunner::EnsembleSize() const
+{
+	return _ensembleSize;
+}
+
+const string & PopulationRunner::Message(int individual) const
+{
+	const char * ERROR_SOURCE = "PopulationRunner::Message";
+
+	if ((individual < 0) || (individual >= (int)_messages.size()))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Invalid individual index " + XMLHelper::ToString(individual));
+
+	return _messages[individual];
+}
+
+const vector <double> & PopulationRunner::TimeValues() const
+{
+	return _timeValues;
+}
+
+int PopulationRunner::NumberOfIndividualsSolvedInEnsembles() const
+{
+	return _numberOfIndividualsSolvedInEnsembles;
+}
+
+int PopulationRunner::NumberOfStolenTasks()
+{
+	lock_guard <mutex> lock(_runStateMutex);
+	return _numberOfStolenTasks;
+}
+
+vector <int> PopulationRunner::WorkerProcesses()
+{
+	lock_guard <mutex> lock(_runStateMutex);
+	return _workerProcesses;
+}
+
+vector <string> PopulationRunner::EnsembleErrors()
+{
+	lock_guard <mutex> lock(_runStateMutex);
+	return _ensembleErrors;
+}
+
+int PopulationRunner::numberOfValuesPerIndividual() const
+{
+	return (int)(_variableParameters.size() + _variableSpecies.size());
+}
+
+int PopulationRunner::numberOfWorkersFor(int numberOfIndividuals) const
+{
+	int numberOfWorkers = _numberOfThreads;
+	if (numberOfWorkers == 0)
+		numberOfWorkers = max((int)thread::hardware_concurrency(), 1);
+
+	//worker threads run whole ensembles
+	const int numberOfTasks = (_executionMode == EM_THREADS) ? (numberOfIndividuals + _ensembleSize - 1) / _ensembleSize 
+	                                                          : numberOfIndividuals;
+
+	return min(numberOfWorkers, numberOfTasks);
+}
+
+bool PopulationRunner::isStreaming() const
+{
+	return _streamingThread.joinable();
+}
+
+void PopulationRunner::validateSettings()
+{
+	const char * ERROR_SOURCE = "PopulationRunner::validateSettings";
+	size_t i;
+
+	if ((_model == NULL) || !_model->IsFinalized())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Population can only be run for a finalized simulation");
+
+	for (i = 0; i < _variableParameters.size(); i++)
+	{
+		Parameter * parameter = _model->Parameters().GetObjectByEntityId(_variableParameters[i]);
+		if (parameter == NULL)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _variableParameters[i] + " is not a parameter");
+
+		if (parameter->IsFixed())
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Parameter " + parameter->GetFullName() + " is fixed and cannot be varied");
+	}
+
+	for (i = 0; i < _variableSpecies.size(); i++)
+	{
+		Species * species = _model->SpeciesList().GetObjectByEntityId(_variableSpecies[i]);
+		if (species == NULL)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _variableSpecies[i] + " is not a species");
+
+		if (species->IsFixed())
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Variable " + species->GetFullName() + " is fixed and cannot be varied");
+	}
+
+	for (i = 0; i < _outputs.size(); i++)
+	{
+		Quantity * quantity = _model->AllQuantities().GetObjectByEntityId(_outputs[i]);
+		if (quantity == NULL)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _outputs[i] + " is invalid entity id");
+
+		if (dynamic_cast <Variable *> (quantity) == NULL)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _outputs[i] + " is not a species or observer");
+
+		if (!quantity->IsPersistable())
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, quantity->GetFullName() + " is not persistable");
+	}
+}
+
+int PopulationRunner::NumberOfTimePoints()
+{
+	const char * ERROR_SOURCE = "PopulationRunner::NumberOfTimePoints";
+
+	if ((_model == NULL) || !_model->IsFinalized())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation is not finalized");
+
+	//+1 because of the simulation start time (s. DESolver::Solve_ODE)
+	return SimulationTask::NumberOfSimulatedTimeSteps(SimulationTask::OutputTimePoints(_model)) + 1;
+}
+
+Simulation * PopulationRunner::createModelCopy()
+{
+	//same variable parameters and species as in the model
+	//(sensitivities are not calculated in population runs)
+	Simulation * copy = _model->Clone(false);
+	copy->Options().SetShowProgress(false);
+
+	return copy;
+}
+
+void PopulationRunner::cacheQuantities(Worker & worker)
+{
+	size_t i;
+	Simulation * simulation = worker.simulation;
+
+	worker.parameters.clear();
+	for (i = 0; i < _variableParameters.size(); i++)
+		worker.parameters.push_back(simulation->Parameters().GetObjectByEntityId(_variableParameters[i]));
+
+	worker.species.clear();
+	for (i = 0; i < _variableSpecies.size(); i++)
+		worker.species.push_back(simulation->SpeciesList().GetObjectByEntityId(_variableSpecies[i]));
+
+	worker.outputs.clear();
+	for (i = 0; i < _outputs.size(); i++)
+		worker.outputs.push_back(simulation->AllQuantities().GetObjectByEntityId(_outputs[i]));
+
+	worker.timeValues.clear();
+}
+
+void PopulationRunner::prepareWorkers(int numberOfWorkers)
+{
+	const char * ERROR_SOURCE = "PopulationRunner::prepareWorkers";
+
+	//checked before the first copy is created, so that the run fails with a clear message
+	if (((int)_workers.size() < numberOfWorkers) && !_model->CanBeCloned())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,
+		                "Simulation XML is not available - cannot create the model copies for the population run. "
+		                "The XML string must be kept (KeepXMLNodeAsString) if the simulation is run in lean mode or loaded with streaming XML load");
+
+	//model copies are created sequentially in the calling thread
+	//(XML loading may require thread specific initialization, e.g. COM under Windows)
+	while ((int)_workers.size() < numberOfWorkers)
+	{
+		Worker worker;
+		worker.simulation = createModelCopy();
+		_workers.push_back(worker);
+	}
+
+	//(re)cache the quantities of interest for the current settings
+	for (int workerIdx = 0; workerIdx < numberOfWorkers; workerIdx++)
+		cacheQuantities(_workers[workerIdx]);
+}
+
+void PopulationRunner::releaseWorkers()
+{
+	for (size_t i = 0; i < _workers.size(); i++)
+		delete _workers[i].simulation;
+
+	_workers.clear();
+}
+
+void PopulationRunner::Run(int numberOfIndividuals, const double * values, double * results, int * statuses)
+{
+	const char * ERROR_SOURCE = "PopulationRunner::Run";
+
+	if (isStreaming())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Streaming population run is not finished");
+
+	validateSettings();
+
+	_messages.assign(max(numberOfIndividuals, 0), "");
+	_timeValues.clear();
+	resetRunState();
+
+	if (numberOfIndividuals <= 0)
+		return;
+
+	const int numberOfTimePoints = NumberOfTimePoints();
+	const int numberOfWorkers = numberOfWorkersFor(numberOfIndividuals);
+
+	if (_executionMode == EM_PROCESSES)
+		runInProcesses(numberOfIndividuals, values, results, statuses, numberOfWorkers, numberOfTimePoints);
+	else
+		runInThreads(numberOfIndividuals, values, results, statuses, numberOfWorkers, numberOfTimePoints);
+}
+
+void PopulationRunner::runInThreads(int numberOfIndividuals, const double * values, double * results, int * statuses, 
+                                    int numberOfThreads, int numberOfTimePoints)
+{
+	//model copies reflect the model state at their creation:
+	//they are recreated for every population run
+	releaseWorkers();
+	prepareWorkers(numberOfThreads * _ensembleSize);
+
+	const size_t numberOfResultsPerIndividual = _outputs.size() * numberOfTimePoints;
+
+	scheduleIndividuals(numberOfIndividuals, numberOfThreads, values, 
+	                    [&](Worker & worker, TaskGroup & taskGroup, int individual, bool solvedInEnsemble)
+	{
+		statuses[individual] = runIndividual(worker, taskGroup, individual, values, 
+		                                     results + individual * numberOfResultsPerIndividual, numberOfTimePoints, solvedInEnsemble);
+	});
+
+	for (int workerIdx = 0; workerIdx < numberOfThreads; workerIdx++)
+	{
+		if (!_workers[workerIdx].timeValues.empty())
+		{
+			_timeValues = _workers[workerIdx].timeValues;
+			break;
+		}
+	}
+}
+
+void PopulationRunner::scheduleIndividuals(int numberOfIndividuals, int numberOfThreads, const double * values,
+                                           const function<void(Worker & worker, TaskGroup & taskGroup, int individual, bool solvedInEnsemble)> & runTask)
+{
+	//individuals are distributed by the work-stealing scheduler: run times of
+	//single individuals may differ by orders of magnitude
+	TaskGroup taskGroup;
+	{
+		lock_guard <mutex> lock(_runStateMutex);
+		_taskGroup = &taskGroup;
+
+		//canceled before the task group was available (e.g. streaming run canceled immediately)
+		if (_cancelRequested)
+			taskGroup.Cancel();
+	}
+
+	{
+		//shared with all other population runs and single simulation runs (s. TaskScheduler::GetInstance):
+		//the group runs at most <numberOfThreads> individuals (or ensembles) at the same time,
+		//every slot of the group uses its own model copies
+		TaskScheduler & scheduler = TaskScheduler::GetInstance();
+		scheduler.EnsureNumberOfThreads(numberOfThreads);
+		taskGroup.SetMaximumConcurrency(numberOfThreads);
+
+		//one task per ensemble (of one individual if ensembles are not used)
+		for (int firstIndividual = 0; firstIndividual < numberOfIndividuals; firstIndividual += _ensembleSize)
+		{
+			const int numberOfMembers = min(_ensembleSize, numberOfIndividuals - firstIndividual);
+
+			scheduler.Submit(taskGroup, [&, firstIndividual, numberOfMembers](int slot)
+			{
+				Worker * workers = &_workers[(size_t)slot * _ensembleSize];
+
+				vector <bool> solved(numberOfMembers, false);
+				if (numberOfMembers > 1)
+					solved = solveEnsemble(workers, taskGroup, firstIndividual, numberOfMembers, values);
+
+				for (int member = 0; member < numberOfMembers; member++)
+					runTask(workers[member], taskGroup, firstIndividual + member, solved[member]);
+			});
+		}
+
+		scheduler.Wait(taskGroup);
+	}
+
+	{
+		lock_guard <mutex> lock(_runStateMutex);
+		_taskGroup = NULL;
+		_numberOfStolenTasks = taskGroup.NumberOfStolenTasks();
+	}
+}
+
+void PopulationRunner::StartStreamingRun(int numberOfIndividuals, const double * values, ResultCallback callback, void * userData)
+{
+	const char * ERROR_SOURCE = "PopulationRunner::StartStreamingRun";
+
+	if (isStreaming())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Streaming population run is not finished");
+
+	if (_executionMode != EM_THREADS)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Streaming population runs are only available in the thread execution mode");
+
+	validateSettings();
+
+	//results of the previous run which were never retrieved
+	IndividualResult * result;
+	while ((result = _resultQueue.Pop(0)) != NULL)
+		ReleaseResult(result);
+	_resultQueue.Reopen();
+
+	numberOfIndividuals = max(numberOfIndividuals, 0);
+
+	_messages.assign(numberOfIndividuals, "");
+	_timeValues.clear();
+	resetRunState();
+	_streamingError.clear();
+	_streamingValues.assign(values, values + (size_t)numberOfIndividuals * numberOfValuesPerIndividual());
+	_resultCallback = callback;
+	_resultCallbackUserData = userData;
+
+	if (numberOfIndividuals == 0)
+	{
+		_resultQueue.Close();
+		return;
+	}
+
+	const int numberOfTimePoints = NumberOfTimePoints();
+	const int numberOfWorkers = numberOfWorkersFor(numberOfIndividuals);
+
+	//model copies are created in the calling thread (s. prepareWorkers)
+	releaseWorkers();
+	prepareWorkers(numberOfWorkers * _ensembleSize);
+
+	_streamingThread = thread(&PopulationRunner::runStreaming, this, numberOfIndividuals, numberOfWorkers, numberOfTimePoints);
+}
+
+void PopulationRunner::runStreaming(int numberOfIndividuals, int numberOfThreads, int numberOfTimePoints)
+{
+	try
+	{
+		scheduleIndividuals(numberOfIndividuals, numberOfThreads, _streamingValues.data(), 
+		                    [&](Worker & worker, TaskGroup & taskGroup, int individual, bool solvedInEnsemble)
+		{
+			IndividualResult * result = acquireResult(individual, numberOfTimePoints);
+
+			result->_status = runIndividual(worker, taskGroup, individual, _streamingValues.data(), 
+			                                result->_values.data(), numberOfTimePoints, solvedInEnsemble);
+			result->_message = _messages[individual];
+			result->_timeValues = worker.timeValues;
+
+			if (_resultCallback != NULL)
+				_resultCallback(result, _resultCallbackUserData);
+			else
+				_resultQueue.Push(result);
+		});
+
+		for (size_t workerIdx = 0; workerIdx < _workers.size(); workerIdx++)
+		{
+			if (!_workers[workerIdx].timeValues.empty())
+			{
+				_timeValues = _workers[workerIdx].timeValues;
+				break;
+			}
+		}
+	}
+	catch (ErrorData & ED)
+	{
+		_streamingError = ED.GetDescription();
+	}
+	catch (...)
+	{
+		_streamingError = "Unknown error in PopulationRunner::runStreaming";
+	}
+
+	//wakes up the consumer waiting for the next result
+	_resultQueue.Close();
+}
+
+IndividualResult * PopulationRunner::acquireResult(int individual, int numberOfTimePoints)
+{
+	IndividualResult * result = NULL;
+
+	{
+		lock_guard <mutex> lock(_resultPoolMutex);
+
+		if (!_freeResults.empty())
+		{
+			result = _freeResults.back();
+			_freeResults.pop_back();
+		}
+		else
+		{
+			result = new IndividualResult();
+			_allResults.push_back(result);
+		}
+	}
+
+	result->Reset(individual, (int)_outputs.size(), numberOfTimePoints);
+
+	return result;
+}
+
+IndividualResult * PopulationRunner::NextResult(int timeoutMs)
+{
+	return _resultQueue.Pop(timeoutMs);
+}
+
+bool PopulationRunner::StreamingRunCompleted() const
+{
+	return _resultQueue.IsClosed() && (_resultQueue.Size() == 0);
+}
+
+void PopulationRunner::ReleaseResult(IndividualResult * result)
+{
+	if (result == NULL)
+		return;
+
+	lock_guard <mutex> lock(_resultPoolMutex);
+	_freeResults.push_back(result);
+}
+
+void PopulationRunner::FinishStreamingRun()
+{
+	if (_streamingThread.joinable())
+		_streamingThread.join();
+
+	if (!_streamingError.empty())
+	{
+		const string error = _streamingError;
+		_streamingError.clear();
+		throw ErrorData(ErrorData::ED_ERROR, "PopulationRunner::FinishStreamingRun", error);
+	}
+}
+
+#if defined(linux) || defined (__APPLE__)
+
+//POSIX shared memory segment, mapped into the address space of the creating
+//process and inherited by all processes forked afterwards
+class SharedMemorySegment
+{
+private:
+	void * _data;
+	size_t _size;
+
+public:
+	SharedMemorySegment(size_t size)
+	{
+		const char * ERROR_SOURCE = "SharedMemorySegment::SharedMemorySegment";
+		static atomic <int> segmentCounter(0);
+
+		_data = NULL;
+		_size = size;
+
+		const string name = "/SimModel_" + XMLHelper::ToString((int)getpid()) + "_" + XMLHelper::ToString(segmentCounter++);
+
+		int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+		if (fd < 0)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot create shared memory segment " + name + ": " + strerror(errno));
+
+		//name is not required anymore: segment lives as long as it is mapped
+		shm_unlink(name.c_str());
+
+		if (ftruncate(fd, (off_t)_size) != 0)
+		{
+			const string error = strerror(errno);
+			close(fd);
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot allocate shared memory segment " + name + ": " + error);
+		}
+
+		void * data = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+
+		if (data == MAP_FAILED)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot map shared memory segment " + name + ": " + strerror(errno));
+
+		_data = data;
+		memset(_data, 0, _size);
+	}
+
+	~SharedMemorySegment()
+	{
+		if (_data != NULL)
+			munmap(_data, _size);
+	}
+
+	char * Data()
+	{
+		return (char *)_data;
+	}
+};
+
+//results buffers created by AllocateResults: start address and number of values
+static map <double *, size_t> sharedResultsBuffers;
+static mutex sharedResultsBuffersMutex;
+
+double * PopulationRunner::AllocateResults(size_t numberOfValues)
+{
+	//mapping is shared with all worker processes forked while it exists
+	void * data = mmap(NULL, max(numberOfValues, (size_t)1) * sizeof(double), PROT_READ | PROT_WRITE, 
+	                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	if (data == MAP_FAILED)
+		throw ErrorData(ErrorData::ED_ERROR, "PopulationRunner::AllocateResults", 
+		                "Cannot allocate results buffer: " + string(strerror(errno)));
+
+	lock_guard <mutex> lock(sharedResultsBuffersMutex);
+	sharedResultsBuffers[(double *)data] = numberOfValues;
+
+	return (double *)data;
+}
+
+void PopulationRunner::ReleaseResults(double * results)
+{
+	lock_guard <mutex> lock(sharedResultsBuffersMutex);
+
+	map <double *, size_t>::iterator iter = sharedResultsBuffers.find(results);
+	if (iter == sharedResultsBuffers.end())
+		return;
+
+	munmap(iter->first, max(iter->second, (size_t)1) * sizeof(double));
+	sharedResultsBuffers.erase(iter);
+}
+
+//true if [results, results+numberOfResults) is part of a buffer created by AllocateResults
+static bool isSharedResultsBuffer(double * results, size_t numberOfResults)
+{
+	lock_guard <mutex> lock(sharedResultsBuffersMutex);
+
+	//last buffer starting at or before <results>
+	map <double *, size_t>::iterator iter = sharedResultsBuffers.upper_bound(results);
+	if (iter == sharedResultsBuffers.begin())
+		return false;
+	iter--;
+
+	return results + numberOfResults <= iter->first + iter->second;
+}
+
+//terminates all remaining worker processes of a failed population run
+static void killWorkerProcesses(const map <pid_t, int> & processSlots)
+{
+	for (map <pid_t, int>::const_iterator iter = processSlots.begin(); iter != processSlots.end(); iter++)
+		kill(iter->first, SIGKILL);
+
+	for (map <pid_t, int>::const_iterator iter = processSlots.begin(); iter != processSlots.end(); iter++)
+	{
+		int exitStatus;
+		while ((waitpid(iter->first, &exitStatus, 0) < 0) && (errno == EINTR))
+			;
+	}
+}
+
+//rounds <offset> up to the alignment of double values
+static size_t alignedOffset(size_t offset)
+{
+	const size_t alignment = sizeof(double);
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+bool PopulationRunner::forkIsSafe()
+{
+	return (Simulation::NumberOfActiveOperations() == 0) && !TaskScheduler::HasActiveTasks();
+}
+
+void PopulationRunner::runInProcesses(int numberOfIndividuals, const double * values, double * results, int * statuses, 
+                                      int numberOfProcesses, int numberOfTimePoints)
+{
+	const char * ERROR_SOURCE = "PopulationRunner::runInProcesses";
+	int individual, slot;
+
+	//shared state is accessed from several processes
+	static_assert(ATOMIC_INT_LOCK_FREE == 2, "Lock free atomic int required for the process execution mode");
+
+	//only the forking thread exists in a worker process: a lock held by any other thread
+	//at fork time (string pool, equation cache, schema cache, solver libraries, scheduler...)
+	//would never be released there
+	if (!forkIsSafe())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, 
+		                "Process execution mode is not available while other simulations are loaded, finalized or run in this process");
+
+	const size_t numberOfResults = (size_t)numberOfIndividuals * _outputs.size() * numberOfTimePoints;
+
+	//workers write their results directly into a shared results buffer (s. AllocateResults);
+	//results for any other buffer are placed in the shared segment and copied at the end
+	const bool resultsAreShared = isSharedResultsBuffer(results, numberOfResults);
+	const size_t numberOfResultsInSegment = resultsAreShared ? 0 : numberOfResults;
+
+	//---- layout of the shared segment
+	const size_t stateOffset = 0;
+	const size_t currentIndividualsOffset = alignedOffset(stateOffset + sizeof(ProcessRunState));
+	const size_t statusesOffset = alignedOffset(currentIndividualsOffset + numberOfProcesses * sizeof(atomic <int>));
+	const size_t timeValuesOffset = alignedOffset(statusesOffset + numberOfIndividuals * sizeof(atomic <int>));
+	const size_t resultsOffset = alignedOffset(timeValuesOffset + numberOfTimePoints * sizeof(double));
+	const size_t messagesOffset = alignedOffset(resultsOffset + numberOfResultsInSegment * sizeof(double));
+	const size_t segmentSize = messagesOffset + (size_t)numberOfIndividuals * PROCESS_MESSAGE_SIZE;
+
+	SharedMemorySegment segment(segmentSize);
+	char * data = segment.Data();
+
+	ProcessRunState * state = new (data + stateOffset) ProcessRunState();
+	state->numberOfIndividuals = numberOfIndividuals;
+	state->numberOfTimePoints = numberOfTimePoints;
+	state->currentIndividuals = (atomic <int> *)(data + currentIndividualsOffset);
+	state->statuses = (atomic <int> *)(data + statusesOffset);
+	state->timeValues = (double *)(data + timeValuesOffset);
+	state->results = resultsAreShared ? results : (double *)(data + resultsOffset);
+	state->messages = data + messagesOffset;
+
+	for (slot = 0; slot < numberOfProcesses; slot++)
+		new (&state->currentIndividuals[slot]) atomic <int> (-1);
+	for (individual = 0; individual < numberOfIndividuals; individual++)
+		new (&state->statuses[individual]) atomic <int> (PROCESS_INDIVIDUAL_NOT_FINISHED);
+
+	//workers run the (finalized) model itself: every process has its own copy-on-write copy
+	Worker worker;
+	worker.simulation = _model;
+	cacheQuantities(worker);
+
+	//---- start worker processes
+	map <pid_t, int> processSlots;
+
+	auto startWorkerProcess = [&](int processSlot)
+	{
+		//e.g. a simulation was started by another thread after the run was started
+		if (!forkIsSafe())
+		{
+			errno = EBUSY;
+			return false;
+		}
+
+		pid_t pid = fork();
+
+		if (pid == 0)
+		{
+			//worker process: never returns
+			runWorkerProcess(worker, *state, processSlot, values);
+		}
+
+		if (pid < 0)
+			return false;
+
+		processSlots[pid] = processSlot;
+
+		lock_guard <mutex> lock(_runStateMutex);
+		_workerProcesses.push_back(pid);
+
+		return true;
+	};
+
+	{
+		lock_guard <mutex> lock(_runStateMutex);
+		_processRunState = state;
+		_workerProcesses.clear();
+
+		//canceled before the run state was available
+		if (_cancelRequested)
+			state->cancelFlag = true;
+	}
+
+	string startError;
+	for (slot = 0; slot < numberOfProcesses; slot++)
+	{
+		if (!startWorkerProcess(slot))
+		{
+			startError = strerror(errno);
+			break;
+		}
+	}
+
+	//---- wait for the worker processes. Crashed workers are replaced as long as 
+	//     individuals are left (only own child processes are waited for)
+	string waitError;
+
+	while (!processSlots.empty() && waitError.empty())
+	{
+		bool processFinished = false;
+
+		for (map <pid_t, int>::iterator iter = processSlots.begin(); iter != processSlots.end(); )
+		{
+			int exitStatus = 0;
+			pid_t pid = waitpid(iter->first, &exitStatus, WNOHANG);
+
+			if (pid == 0)
+			{
+				iter++;
+				continue; //still running
+			}
+
+			if (pid < 0)
+			{
+				if (errno == EINTR)
+					continue; //interrupted by a signal: wait again
+
+				//e.g. ECHILD if SIGCHLD is ignored by the calling process: exit state of the
+				//worker (and so of its current individual) is lost
+				waitError = "Cannot wait for worker process " + XMLHelper::ToString((int)iter->first) + ": " + strerror(errno);
+				processSlots.erase(iter); //process id might be reused already: never kill it
+				break;
+			}
+
+			processFinished = true;
+			const int processSlot = iter->second;
+			iter = processSlots.erase(iter);
+
+			{
+				lock_guard <mutex> lock(_runStateMutex);
+				_workerProcesses.erase(std::remove(_workerProcesses.begin(), _workerProcesses.end(), pid), _workerProcesses.end());
+			}
+
+			if (WIFEXITED(exitStatus) && (WEXITSTATUS(exitStatus) == 0))
+				continue; //regular end: no individuals left
+
+			//worker crashed (or was killed by cancel): the individual it was running failed.
+			//The worker might have been stopped after publishing the status of its individual
+			//but before clearing it: finished individuals are neither overwritten nor counted twice
+			individual = state->currentIndividuals[processSlot];
+			state->currentIndividuals[processSlot] = -1;
+
+			int notFinished = PROCESS_INDIVIDUAL_NOT_FINISHED;
+			if ((individual >= 0) && state->statuses[individual].compare_exchange_strong(notFinished, IRS_FAILED))
+			{
+				string message = state->cancelFlag ? "Population run was canceled" : "Worker process terminated unexpectedly";
+				if (WIFSIGNALED(exitStatus) && !state->cancelFlag)
+					message += " (signal " + XMLHelper::ToString(WTERMSIG(exitStatus)) + ")";
+
+				double * individualResults = state->results + (size_t)individual * _outputs.size() * numberOfTimePoints;
+				std::fill(individualResults, individualResults + _outputs.size() * numberOfTimePoints, MathHelper::GetNaN());
+				_messages[individual] = message;
+				state->messages[(size_t)individual * PROCESS_MESSAGE_SIZE] = '\0'; //might be written already by the worker
+				state->numberOfFinishedIndividuals++;
+			}
+
+			if (!state->cancelFlag && (state->nextIndividual < numberOfIndividuals) && !startWorkerProcess(processSlot))
+				startError = strerror(errno);
+		}
+
+		if (!processFinished)
+			this_thread::sleep_for(chrono::milliseconds(PROCESS_POLLING_INTERVAL));
+	}
+
+	{
+		lock_guard <mutex> lock(_runStateMutex);
+		_processRunState = NULL;
+		_workerProcesses.clear();
+	}
+
+	if (!waitError.empty())
+	{
+		//states of the individuals are unreliable: the whole run fails
+		killWorkerProcesses(processSlots);
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, waitError);
+	}
+
+	//---- collect the results written by the workers
+	if (!resultsAreShared)
+		std::copy(state->results, state->results + numberOfResults, results);
+
+	for (individual = 0; individual < numberOfIndividuals; individual++)
+	{
+		const int status = state->statuses[individual];
+
+		if (status == PROCESS_INDIVIDUAL_NOT_FINISHED)
+		{
+			//not simulated at all (canceled or no worker could be started)
+			double * individualResults = results + (size_t)individual * _outputs.size() * numberOfTimePoints;
+			std::fill(individualResults, individualResults + _outputs.size() * numberOfTimePoints, MathHelper::GetNaN());
+
+			statuses[individual] = IRS_FAILED;
+			if (state->cancelFlag)
+				_messages[individual] = "Population run was canceled";
+			else
+				_messages[individual] = "Individual was not simulated: no worker process available" + 
+				                        (startError.empty() ? string("") : " (" + startError + ")");
+			continue;
+		}
+
+		statuses[individual] = status;
+
+		//messages of crashed individuals were set above
+		const char * message = state->messages + (size_t)individual * PROCESS_MESSAGE_SIZE;
+		if (message[0] != '\0')
+			_messages[individual] = message;
+	}
+
+	if (state->timeValuesAvailable)
+		_timeValues.assign(state->timeValues, state->timeValues + numberOfTimePoints);
+
+	if ((numberOfProcesses > 0) && !startError.empty() && (state->numberOfFinishedIndividuals == 0))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot start worker process: " + startError);
+}
+
+void PopulationRunner::runWorkerProcess(Worker & worker, ProcessRunState & state, int processSlot, const double * values)
+{
+	//solver time limit, progress etc. of the parent are not relevant here; 
+	//errors of single individuals are caught by runIndividual
+	TaskGroup taskGroup;
+
+	while (!state.cancelFlag)
+	{
+		const int individual = state.nextIndividual++;
+		if (individual >= state.numberOfIndividuals)
+			break;
+
+		state.currentIndividuals[processSlot] = individual;
+
+		double * individualResults = state.results + (size_t)individual * worker.outputs.size() * state.numberOfTimePoints;
+		const int status = runIndividual(worker, taskGroup, individual, values, individualResults, state.numberOfTimePoints);
+
+		//message is truncated if required
+		strncpy(state.messages + (size_t)individual * PROCESS_MESSAGE_SIZE, _messages[individual].c_str(), PROCESS_MESSAGE_SIZE - 1);
+
+		if (!worker.timeValues.empty() && !state.timeValuesAvailable.exchange(true))
+			std::copy(worker.timeValues.begin(), worker.timeValues.end(), state.timeValues);
+
+		//once the status is published, the individual is not failed by the parent anymore
+		//if this process is stopped (s. runInProcesses)
+		state.statuses[individual] = status;
+		state.numberOfFinishedIndividuals++;
+		state.currentIndividuals[processSlot] = -1;
+	}
+
+	//skip destructors and exit handlers of the parent process state
+	_exit(0);
+}
+
+#else
+
+void PopulationRunner::runInProcesses(int numberOfIndividuals, const double * values, double * results, int * statuses, 
+                                      int numberOfProcesses, int numberOfTimePoints)
+{
+	throw ErrorData(ErrorData::ED_ERROR, "PopulationRunner::runInProcesses", 
+	                "Process execution mode is only available under Linux and macOS");
+}
+
+double * PopulationRunner::AllocateResults(size_t numberOfValues)
+{
+	return new double[max(numberOfValues, (size_t)1)];
+}
+
+void PopulationRunner::ReleaseResults(double * results)
+{
+	delete[] results;
+}
+
+#endif
+
+void PopulationRunner::setIndividualValues(Worker & worker, int individual, const double * values)
+{
+	size_t i;
+	const size_t numberOfParameters = worker.parameters.size();
+	const double * individualValues = values + (size_t)individual * numberOfValuesPerIndividual();
+
+	for (i = 0; i < numberOfParameters; i++)
+		worker.parameters[i]->SetInitialValue(individualValues[i]);
+
+	for (i = 0; i < worker.species.size(); i++)
+		worker.species[i]->SetInitialValue(individualValues[numberOfParameters + i]);
+}
+
+vector <bool> PopulationRunner::solveEnsemble(Worker * workers, TaskGroup & taskGroup, int firstIndividual, int numberOfMembers, 
+                                              const double * values)
+{
+	int member;
+	vector <bool> solved(numberOfMembers, false);
+	vector <Simulation *> simulations;
+
+	if (taskGroup.IsCanceled())
+		return solved;
+
+	try
+	{
+		for (member = 0; member < numberOfMembers; member++)
+		{
+			setIndividualValues(workers[member], firstIndividual + member, values);
+			simulations.push_back(workers[member].simulation);
+		}
+
+		for (member = 0; member < numberOfMembers; member++)
+			taskGroup.SimulationStarted(simulations[member]);
+
+		string errorMessage;
+
+		try
+		{
+			EnsembleSolver ensembleSolver;
+			solved = ensembleSolver.Solve(simulations);
+		}
+		catch (ErrorData & ED)
+		{
+			errorMessage = ED.GetDescription();
+		}
+		catch (...)
+		{
+			errorMessage = "Unknown error";
+		}
+
+		for (member = 0; member < numberOfMembers; member++)
+			taskGroup.SimulationFinished(simulations[member]);
+
+		if (!errorMessage.empty())
+			addEnsembleError(firstIndividual, numberOfMembers, errorMessage);
+	}
+	catch (ErrorData & ED)
+	{
+		addEnsembleError(firstIndividual, numberOfMembers, ED.GetDescription());
+	}
+	catch (...)
+	{
+		addEnsembleError(firstIndividual, numberOfMembers, "Unknown error");
+	}
+
+	//individuals not solved are run on their own (and report their errors)
+	_numberOfIndividualsSolvedInEnsembles += (int)count(solved.begin(), solved.end(), true);
+
+	return solved;
+}
+
+void PopulationRunner::addEnsembleError(int firstIndividual, int numberOfMembers, const string & errorMessage)
+{
+	lock_guard <mutex> lock(_runStateMutex);
+	_ensembleErrors.push_back("Ensemble of individuals " + XMLHelper::ToString(firstIndividual) + ".." + 
+	                          XMLHelper::ToString(firstIndividual + numberOfMembers - 1) + " failed: " + errorMessage);
+}
+
+void PopulationRunner::resetRunState()
+{
+	_numberOfIndividualsSolvedInEnsembles = 0;
+
+	lock_guard <mutex> lock(_runStateMutex);
+	_ensembleErrors.clear();
+	_numberOfStolenTasks = 0;
+	_cancelRequested = false;
+}
+
+int PopulationRunner::runIndividual(Worker & worker, TaskGroup & taskGroup, int individual, const double * values, double * individualResults, 
+                                    int numberOfTimePoints, bool solvedInEnsemble)
+{
+	const char * ERROR_SOURCE = "PopulationRunner::runIndividual";
+
+	const size_t numberOfOutputs = worker.outputs.size();
+
+	size_t i;
+	string errorMessage;
+
+	try
+	{
+		Simulation * simulation = worker.simulation;
+
+		if (!solvedInEnsemble)
+		{
+			if (taskGroup.IsCanceled())
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Population run was canceled");
+
+			setIndividualValues(worker, individual, values);
+
+			bool toleranceWasReduced;
+			double newAbsTol, newRelTol;
+
+			bool wasCanceled;
+
+			taskGroup.SimulationStarted(simulation);
+			try
+			{
+				simulation->RunSimulation(toleranceWasReduced, newAbsTol, newRelTol);
+
+				//canceled runs are finished without error, but with incomplete results
+				wasCanceled = simulation->GetCancelFlag();
+			}
+			catch (...)
+			{
+				taskGroup.SimulationFinished(simulation);
+				throw;
+			}
+			taskGroup.SimulationFinished(simulation);
+
+			if (wasCanceled)
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Population run was canceled");
+		}
+
+		if (simulation->GetNumberOfTimePoints() != numberOfTimePoints)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unexpected number of output time points: " + 
+			                XMLHelper::ToString(simulation->GetNumberOfTimePoints()));
+
+		for (i = 0; i < numberOfOutputs; i++)
+		{
+			Quantity * quantity = worker.outputs[i];
+			Variable * variable = dynamic_cast <Variable *> (quantity);
+			double * outputResults = individualResults + i * numberOfTimePoints;
+
+			//constant quantities have only one value
+			if (quantity->IsConstant(false))
+				std::fill(outputResults, outputResults + numberOfTimePoints, variable->GetValues()[0]);
+			else
+				std::copy(variable->GetValues(), variable->GetValues() + numberOfTimePoints, outputResults);
+		}
+
+		if (worker.timeValues.empty())
+			worker.timeValues.assign(simulation->GetTimeValues(), simulation->GetTimeValues() + numberOfTimePoints);
+
+		const TObjectVector<SolverWarning> & solverWarnings = simulation->SolverWarnings();
+		if (solverWarnings.size() == 0)
+			return IRS_SUCCESS;
+
+		string warnings;
+		for (i = 0; i < (size_t)solverWarnings.size(); i++)
+		{
+			if (i > 0)
+				warnings += "\n";
+			warnings += "t=" + XMLHelper::ToString(solverWarnings[i]->Time()) + ": " + solverWarnings[i]->Message();
+		}
+		_messages[individual] = warnings;
+
+		return IRS_SUCCESS_WITH_WARNINGS;
+	}
+	catch (ErrorData & ED)
+	{
+		errorMessage = ED.GetDescription();
+	}
+	catch (...)
+	{
+		errorMessage = "Unknown error in " + string(ERROR_SOURCE);
+	}
+
+	std::fill(individualResults, individualResults + numberOfOutputs * numberOfTimePoints, MathHelper::GetNaN());
+	_messages[individual] = errorMessage;
+
+	return IRS_FAILED;
+}
+
+}//.. end "namespace SimModelNative"
@@ -30,6 +30,14 @@ bool PowerFormula::IsZero(void)
 	return false;
 }
 
+FormulaLinearity PowerFormula::Linearity()
+{
+	if ((m_BaseFormula->Linearity() == FL_CONSTANT) && (m_ExponentFormula->Linearity() == FL_CONSTANT))
+		return FL_CONSTANT;
+
+	return FL_NONLINEAR;
+}
+
 void PowerFormula::LoadFromXMLNode (const XMLNode & pNode)
 {
 	// Check if the current tag is actually the one we expect
@@ -0,0 +1,549 @@
+#include "SimModel/PreparsedModel.h"
+#include "XMLWrapper/XMLHelper.h"
+#include "../../OSPSuite.SimModelNative/version.h"
+#include "ErrorData.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace SimModelNative
+{
+
+using namespace std;
+using namespace PreparsedModelFormat;
+
+static const char PREPARSED_MODEL_MAGIC[8] = {'S', 'M', 'C', 'M', 'O', 'D', 'E', 'L'};
+
+//records are written/read as they are: layout must not depend on the compiler
+static_assert(sizeof(Header) == 176, "unexpected preparsed model header size");
+static_assert(sizeof(Node) == 24, "unexpected preparsed model node size");
+static_assert(sizeof(Equation) == 16, "unexpected preparsed model equation size");
+static_assert(sizeof(VariableParameter) == 32, "unexpected preparsed model parameter size");
+static_assert(sizeof(TablePoint) == 24, "unexpected preparsed model table point size");
+static_assert(sizeof(PreparsedModelFormat::VariableSpecies) == 24, "unexpected preparsed model species size");
+
+static uint64_t alignedOffset(uint64_t offset)
+{
+	return (offset + 7) & ~(uint64_t)7;
+}
+
+static bool equationKeyLess(const Equation & equation1, const Equation & equation2)
+{
+	return equation1.key < equation2.key;
+}
+
+//-------------------------------------------------------------------------------------
+// PreparsedModelWriter
+//-------------------------------------------------------------------------------------
+
+PreparsedModelWriter::PreparsedModelWriter()
+{
+	_simulationNode = NO_INDEX;
+	_useBandLinearSolver = false;
+}
+
+uint32_t PreparsedModelWriter::addString(const string & value)
+{
+	unordered_map <string, uint32_t>::const_iterator iter = _stringOffsets.find(value);
+	if (iter != _stringOffsets.end())
+		return iter->second;
+
+	if (_strings.size() + value.size() + 1 >= NO_INDEX)
+		throw ErrorData(ErrorData::ED_ERROR, "PreparsedModelWriter::addString", "Model is too large to be saved as preparsed model");
+
+	const uint32_t offset = (uint32_t)_strings.size();
+	_strings.insert(_strings.end(), value.begin(), value.end());
+	_strings.push_back('\0');
+
+	_stringOffsets[value] = offset;
+
+	return offset;
+}
+
+uint32_t PreparsedModelWriter::addNode(const XMLNode & node)
+{
+	const uint32_t nodeIndex = (uint32_t)_nodes.size();
+
+	Node nodeRecord;
+	nodeRecord.name = addString(node.GetNodeName());
+	nodeRecord.value = NO_INDEX;
+	nodeRecord.firstAttribute = (uint32_t)_attributes.size();
+	nodeRecord.numberOfAttributes = 0;
+	nodeRecord.firstChild = NO_INDEX;
+	nodeRecord.nextSibling = NO_INDEX;
+
+	vector <string> attributeNames, attributeValues;
+	node.GetAttributes(attributeNames, attributeValues);
+
+	for (size_t i = 0; i < attributeNames.size(); i++)
+	{
+		Attribute attribute;
+		attribute.name = addString(attributeNames[i]);
+		attribute.value = addString(attributeValues[i]);
+		_attributes.push_back(attribute);
+	}
+	nodeRecord.numberOfAttributes = (uint32_t)attributeNames.size();
+
+	_nodes.push_back(nodeRecord);
+
+	//---- child elements (in document order). Text is only kept for elements without child elements
+	uint32_t previousChild = NO_INDEX;
+
+	for (XMLNode child = node.GetFirstChild(); !child.IsNull(); child = child.GetNextSibling())
+	{
+		if (!child.IsElement())
+			continue;
+
+		const uint32_t childIndex = addNode(child);
+
+		if (previousChild == NO_INDEX)
+			_nodes[nodeIndex].firstChild = childIndex;
+		else
+			_nodes[previousChild].nextSibling = childIndex;
+
+		previousChild = childIndex;
+	}
+
+	if (previousChild == NO_INDEX)
+	{
+		const string value = node.GetValue();
+		if (!value.empty())
+			_nodes[nodeIndex].value = addString(value);
+	}
+
+	return nodeIndex;
+}
+
+void PreparsedModelWriter::SetSimulationNode(const XMLNode & simulationNode)
+{
+	_simulationNode = addNode(simulationNode);
+}
+
+void PreparsedModelWriter::SetVariableParameters(vector <ParameterInfo> & variableParameters)
+{
+	_variableParameters.clear();
+	_tablePoints.clear();
+
+	for (size_t i = 0; i < variableParameters.size(); i++)
+	{
+		ParameterInfo & parameterInfo = variableParameters[i];
+
+		VariableParameter parameter;
+		parameter.id = parameterInfo.GetId();
+		parameter.value = parameterInfo.GetValue();
+		parameter.calculateSensitivity = parameterInfo.CalculateSensitivity() ? 1 : 0;
+		parameter.isTable = parameterInfo.IsTable() ? 1 : 0;
+		parameter.firstTablePoint = (uint32_t)_tablePoints.size();
+		parameter.numberOfTablePoints = 0;
+
+		const vector <ValuePoint> & valuePoints = parameterInfo.GetTablePoints();
+		for (size_t j = 0; j < valuePoints.size(); j++)
+		{
+			TablePoint tablePoint;
+			tablePoint.x = valuePoints[j].X;
+			tablePoint.y = valuePoints[j].Y;
+			tablePoint.restartSolver = valuePoints[j].RestartSolver ? 1 : 0;
+			tablePoint.reserved = 0;
+			_tablePoints.push_back(tablePoint);
+		}
+		parameter.numberOfTablePoints = (uint32_t)valuePoints.size();
+
+		_variableParameters.push_back(parameter);
+	}
+}
+
+void PreparsedModelWriter::SetVariableSpecies(vector <SpeciesInfo> & variableSpecies)
+{
+	_variableSpecies.clear();
+
+	for (size_t i = 0; i < variableSpecies.size(); i++)
+	{
+		VariableSpecies species;
+		species.id = variableSpecies[i].GetId();
+		species.value = variableSpecies[i].GetValue();
+		species.scaleFactor = variableSpecies[i].GetScaleFactor();
+
+		_variableSpecies.push_back(species);
+	}
+}
+
+void PreparsedModelWriter::SetUseBandLinearSolver(bool useBandLinearSolver)
+{
+	_useBandLinearSolver = useBandLinearSolver;
+}
+
+XMLNode PreparsedModelWriter::GetRateNode(uint64_t /*key*/, const EquationInputs & /*inputs*/)
+{
+	return XMLNode();
+}
+
+void PreparsedModelWriter::AddRateNode(uint64_t key, const EquationInputs & inputs, const XMLNode & rateNode)
+{
+	const string & equation = inputs.equation;
+
+	if (!_recordedEquations.insert(make_pair(key, equation)).second)
+		return; //same equation parsed with the same inputs before
+
+	Equation equationRecord;
+	equationRecord.key = key;
+	equationRecord.equation = addString(equation);
+	equationRecord.rateNode = addNode(rateNode);
+
+	_equations.push_back(equationRecord);
+}
+
+void PreparsedModelWriter::Write(const string & fileName)
+{
+	const char * ERROR_SOURCE = "PreparsedModelWriter::Write";
+
+	if (_simulationNode == NO_INDEX)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation node was not set");
+
+	stable_sort(_equations.begin(), _equations.end(), equationKeyLess);
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PREPARSED_MODEL_MAGIC, sizeof(header.magic));
+	header.byteOrderMark = BYTE_ORDER_MARK;
+	header.formatVersion = FORMAT_VERSION;
+	strncpy(header.simModelVersion, VER_FILE_VERSION_STR, sizeof(header.simModelVersion) - 1);
+	header.simulationNode = _simulationNode;
+	header.useBandLinearSolver = _useBandLinearSolver ? 1 : 0;
+
+	//---- section layout (every section 8-byte aligned)
+	uint64_t offset = sizeof(Header);
+	Section * sections[] = {&header.strings, &header.nodes, &header.attributes, &header.equations,
+	                        &header.variableParameters, &header.tablePoints, &header.variableSpecies};
+	const void * sectionData[] = {_strings.data(), _nodes.data(), _attributes.data(), _equations.data(),
+	                              _variableParameters.data(), _tablePoints.data(), _variableSpecies.data()};
+	const uint64_t sectionCounts[] = {_strings.size(), _nodes.size(), _attributes.size(), _equations.size(),
+	                                  _variableParameters.size(), _tablePoints.size(), _variableSpecies.size()};
+	const uint64_t recordSizes[] = {sizeof(char), sizeof(Node), sizeof(Attribute), sizeof(Equation),
+	                                sizeof(VariableParameter), sizeof(TablePoint), sizeof(VariableSpecies)};
+	const size_t numberOfSections = sizeof(sections) / sizeof(sections[0]);
+
+	for (size_t i = 0; i < numberOfSections; i++)
+	{
+		offset = alignedOffset(offset);
+		sections[i]->offset = offset;
+		sections[i]->count = sectionCounts[i];
+		offset += sectionCounts[i] * recordSizes[i];
+	}
+	header.fileSize = offset;
+
+	//---- write into a temporary file first: existing file might be mapped by another process
+	const string temporaryFileName = fileName + ".tmp";
+	{
+		ofstream out(temporaryFileName.c_str(), ios::out | ios::binary | ios::trunc);
+		if (!out)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot create file " + temporaryFileName);
+
+		out.write((const char *)&header, sizeof(header));
+		uint64_t position = sizeof(header);
+		const char padding[8] = {0};
+
+		for (size_t i = 0; i < numberOfSections; i++)
+		{
+			out.write(padding, (streamsize)(sections[i]->offset - position));
+			out.write((const char *)sectionData[i], (streamsize)(sectionCounts[i] * recordSizes[i]));
+			position = sections[i]->offset + sectionCounts[i] * recordSizes[i];
+		}
+
+		out.close();
+		if (out.fail())
+		{
+			remove(temporaryFileName.c_str());
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot write file " + temporaryFileName);
+		}
+	}
+
+	if (rename(temporaryFileName.c_str(), fileName.c_str()) != 0)
+	{
+		//rename does not replace existing files on Windows
+		remove(fileName.c_str());
+
+		if (rename(temporaryFileName.c_str(), fileName.c_str()) != 0)
+		{
+			remove(temporaryFileName.c_str());
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot write file " + fileName);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+// PreparsedModel
+//-------------------------------------------------------------------------------------
+
+PreparsedModel::PreparsedModel(const string & fileName)
+{
+	_fileName = fileName;
+	_data = NULL;
+	_size = 0;
+
+	_header = NULL;
+	_strings = NULL;
+	_nodes = NULL;
+	_attributes = NULL;
+	_equations = NULL;
+	_variableParameters = NULL;
+	_tablePoints = NULL;
+	_variableSpecies = NULL;
+	_ignoreEquations = false;
+
+	readFile();
+	validate();
+}
+
+PreparsedModel::~PreparsedModel()
+{
+	if (!_rateNodesDocument.IsNull())
+		_rateNodesDocument.Release();
+}
+
+void PreparsedModel::readFile()
+{
+	const char * ERROR_SOURCE = "PreparsedModel::readFile";
+
+	//the whole file is read at once: every record is used exactly once while loading
+	//(the element tree is converted into the XML DOM), so mapping the file gains nothing
+	ifstream file(_fileName.c_str(), ios::binary | ios::ate);
+	if (!file)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot open preparsed model file " + _fileName);
+
+	const streamoff fileSize = file.tellg();
+	if (fileSize < (streamoff)sizeof(Header))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is not a preparsed model file");
+	_size = (uint64_t)fileSize;
+
+	//8 byte aligned, like the sections in the file
+	_buffer.resize((size_t)((_size + 7) / 8));
+
+	file.seekg(0);
+	if (!file.read((char *)_buffer.data(), (streamsize)_size))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot read preparsed model file " + _fileName);
+
+	_data = (const char *)_buffer.data();
+}
+
+template <typename T> const T * PreparsedModel::section(const Section & section, size_t recordSize)
+{
+	if ((section.offset % 8 != 0) || (section.offset > _size) ||
+		(section.count > (_size - section.offset) / recordSize))
+		throw ErrorData(ErrorData::ED_ERROR, "PreparsedModel::section", _fileName + ": invalid section");
+
+	return (const T *)(_data + section.offset);
+}
+
+void PreparsedModel::validate()
+{
+	const char * ERROR_SOURCE = "PreparsedModel::validate";
+	uint64_t i;
+
+	_header = (const Header *)_data;
+
+	if (memcmp(_header->magic, PREPARSED_MODEL_MAGIC, sizeof(_header->magic)) != 0)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is not a preparsed model file");
+
+	if (_header->byteOrderMark != BYTE_ORDER_MARK)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " was created on a machine with different byte order");
+
+	if (_header->formatVersion != FORMAT_VERSION)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + ": unsupported format version " +
+		                XMLHelper::ToString((int)_header->formatVersion));
+
+	if (_header->fileSize != _size)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is truncated");
+
+	//rate nodes are created by the equation parser and may change between versions
+	const string simModelVersion(_header->simModelVersion,
+	                             strnlen(_header->simModelVersion, sizeof(_header->simModelVersion)));
+	_ignoreEquations = (simModelVersion != VER_FILE_VERSION_STR);
+
+	_strings = section<char>(_header->strings, sizeof(char));
+	_nodes = section<Node>(_header->nodes, sizeof(Node));
+	_attributes = section<Attribute>(_header->attributes, sizeof(Attribute));
+	_equations = section<Equation>(_header->equations, sizeof(Equation));
+	_variableParameters = section<VariableParameter>(_header->variableParameters, sizeof(VariableParameter));
+	_tablePoints = section<TablePoint>(_header->tablePoints, sizeof(TablePoint));
+	_variableSpecies = section<PreparsedModelFormat::VariableSpecies>(_header->variableSpecies, sizeof(PreparsedModelFormat::VariableSpecies));
+
+	//---- references between records. Invalid files must not crash the loader
+	const uint64_t stringsSize = _header->strings.count;
+	const uint64_t numberOfNodes = _header->nodes.count;
+
+	if ((stringsSize == 0) || (_strings[stringsSize - 1] != '\0') || (_header->simulationNode >= numberOfNodes))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is corrupt");
+
+	for (i = 0; i < numberOfNodes; i++)
+	{
+		const Node & node = _nodes[i];
+
+		if ((node.name >= stringsSize) ||
+			((node.value != NO_INDEX) && (node.value >= stringsSize)) ||
+			((uint64_t)node.firstAttribute + node.numberOfAttributes > _header->attributes.count) ||
+			((node.firstChild != NO_INDEX) && ((node.firstChild <= i) || (node.firstChild >= numberOfNodes))) ||
+			((node.nextSibling != NO_INDEX) && ((node.nextSibling <= i) || (node.nextSibling >= numberOfNodes))))
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is corrupt (node " + XMLHelper::ToString((int)i) + ")");
+	}
+
+	for (i = 0; i < _header->attributes.count; i++)
+	{
+		if ((_attributes[i].name >= stringsSize) || (_attributes[i].value >= stringsSize))
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is corrupt (attribute " + XMLHelper::ToString((int)i) + ")");
+	}
+
+	for (i = 0; i < _header->equations.count; i++)
+	{
+		if ((_equations[i].equation >= stringsSize) || (_equations[i].rateNode >= numberOfNodes) ||
+			((i > 0) && (_equations[i].key < _equations[i - 1].key)))
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is corrupt (equation " + XMLHelper::ToString((int)i) + ")");
+	}
+
+	for (i = 0; i < _header->variableParameters.count; i++)
+	{
+		const VariableParameter & parameter = _variableParameters[i];
+
+		if ((uint64_t)parameter.firstTablePoint + parameter.numberOfTablePoints > _header->tablePoints.count)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _fileName + " is corrupt (parameter " + XMLHelper::ToString((int)i) + ")");
+	}
+}
+
+const char * PreparsedModel::stringAt(uint32_t offset) const
+{
+	return _strings + offset;
+}
+
+void PreparsedModel::fillNode(XMLNode & node, uint32_t nodeIndex) const
+{
+	const Node & nodeRecord = _nodes[nodeIndex];
+
+	for (uint32_t i = 0; i < nodeRecord.numberOfAttributes; i++)
+	{
+		const Attribute & attribute = _attributes[nodeRecord.firstAttribute + i];
+		node.SetAttribute(stringAt(attribute.name), stringAt(attribute.value));
+	}
+
+	if (nodeRecord.value != NO_INDEX)
+		node.SetValue(stringAt(nodeRecord.value));
+
+	for (uint32_t child = nodeRecord.firstChild; child != NO_INDEX; child = _nodes[child].nextSibling)
+	{
+		XMLNode childNode = node.CreateChildNode(stringAt(_nodes[child].name));
+		fillNode(childNode, child);
+	}
+}
+
+XMLDocument PreparsedModel::CreateSimulationDocument()
+{
+	XMLDocument document;
+	document.Create();
+
+	try
+	{
+		XMLNode simulationNode = document.CreateRootNode(stringAt(_nodes[_header->simulationNode].name));
+		fillNode(simulationNode, _header->simulationNode);
+	}
+	catch (...)
+	{
+		document.Release();
+		throw;
+	}
+
+	return document;
+}
+
+vector <ParameterInfo> PreparsedModel::VariableParameters()
+{
+	vector <ParameterInfo> variableParameters;
+
+	for (uint64_t i = 0; i < _header->variableParameters.count; i++)
+	{
+		const VariableParameter & parameter = _variableParameters[i];
+
+		ParameterInfo parameterInfo;
+		parameterInfo.SetId((long)parameter.id);
+		parameterInfo.SetCalculateSensitivity(parameter.calculateSensitivity != 0);
+
+		if (parameter.isTable != 0)
+		{
+			vector <ValuePoint> valuePoints;
+			for (uint32_t j = 0; j < parameter.numberOfTablePoints; j++)
+			{
+				const TablePoint & tablePoint = _tablePoints[parameter.firstTablePoint + j];
+				valuePoints.push_back(ValuePoint(tablePoint.x, tablePoint.y, tablePoint.restartSolver != 0));
+			}
+			parameterInfo.SetTablePoints(valuePoints);
+		}
+		else
+			parameterInfo.SetValue(parameter.value);
+
+		variableParameters.push_back(parameterInfo);
+	}
+
+	return variableParameters;
+}
+
+vector <SpeciesInfo> PreparsedModel::VariableSpecies()
+{
+	vector <SpeciesInfo> variableSpecies;
+
+	for (uint64_t i = 0; i < _header->variableSpecies.count; i++)
+	{
+		SpeciesInfo speciesInfo;
+		speciesInfo.SetId((long)_variableSpecies[i].id);
+		speciesInfo.SetValue(_variableSpecies[i].value);
+		speciesInfo.SetScaleFactor(_variableSpecies[i].scaleFactor);
+
+		variableSpecies.push_back(speciesInfo);
+	}
+
+	return variableSpecies;
+}
+
+bool PreparsedModel::UseBandLinearSolver()
+{
+	return _header->useBandLinearSolver != 0;
+}
+
+XMLNode PreparsedModel::GetRateNode(uint64_t key, const EquationInputs & inputs)
+{
+	const string & equation = inputs.equation;
+
+	if (_ignoreEquations)
+		return XMLNode();
+
+	Equation searchedEquation;
+	searchedEquation.key = key;
+
+	const Equation * equationsEnd = _equations + _header->equations.count;
+	const Equation * iter = lower_bound(_equations, equationsEnd, searchedEquation, equationKeyLess);
+
+	//equation itself is compared as well: keys are hashes
+	for (; (iter != equationsEnd) && (iter->key == key); iter++)
+	{
+		if (equation != stringAt(iter->equation))
+			continue;
+
+		if (_rateNodesDocument.IsNull())
+			_rateNodesDocument.Create();
+
+		XMLNode rateNode = _rateNodesDocument.CreateNode(stringAt(_nodes[iter->rateNode].name));
+		fillNode(rateNode, iter->rateNode);
+
+		//return a copy independent of the shared document, so that the caller can use it without the lock
+		XMLNode rateNodeCopy = rateNode.Clone(true);
+		rateNode.FreeNode();
+
+		return rateNodeCopy;
+	}
+
+	return XMLNode();
+}
+
+void PreparsedModel::AddRateNode(uint64_t /*key*/, const EquationInputs & /*inputs*/, const XMLNode & /*rateNode*/)
+{
+}
+
+}//.. end "namespace SimModelNative"
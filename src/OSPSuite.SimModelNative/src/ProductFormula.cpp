@@ -289,6 +289,25 @@ bool ProductFormula::IsZero(void)
 	return false;
 }
 
+FormulaLinearity ProductFormula::Linearity()
+{
+	//product is linear if at most one multiplier is non-constant
+	FormulaLinearity linearity = FL_CONSTANT;
+	for (int iFormula = 0;iFormula != _noOfMultipliers;iFormula++)
+	{
+		FormulaLinearity multiplierLinearity = _multiplierFormulas[iFormula]->Linearity();
+		if (multiplierLinearity == FL_CONSTANT)
+			continue;
+
+		if (linearity != FL_CONSTANT)
+			return FL_NONLINEAR;
+
+		linearity = multiplierLinearity;
+	}
+
+	return linearity;
+}
+
 void ProductFormula::AppendUsedVariables(set<int> & usedVariablesIndices, const set<int> & variablesIndicesUsedInSwitchAssignments)
 {
 	for (int iFormula = 0;iFormula != _noOfMultipliers;iFormula++)
@@ -5,6 +5,7 @@
 #include "SimModel/Quantity.h"
 #include "SimModel/Formula.h"
 #include "SimModel/Simulation.h"
+#include "SimModel/SimulationXMLWriter.h"
 #include "SimModel/MathHelper.h"
 #include "XMLWrapper/XMLHelper.h"
 
@@ -24,6 +25,7 @@ Quantity::Quantity(void)
 
 	_isChangedBySwitch = false;
 	_isFixed = true;
+	_initialValueChanged = false;
 
 	_isUsedBySwitch = false;
 
@@ -110,10 +112,11 @@ void Quantity::XMLFinalizeInstance (const XMLNode & pNode, Simulation * sim)
 	string objectPathDelimiter = sim->GetObjectPathDelimiter();
 
 	if(sim->GetXMLVersion() < 4)
-		_fullName = _containerPath + objectPathDelimiter + _name;
+		_fullName = _containerPath.Value() + objectPathDelimiter + _name.Value();
 	else
 	{
-		_fullName = _containerPath != "" ? _containerPath : _name;
+		//same pooled string as container path or name
+		_fullName = !_containerPath.IsEmpty() ? _containerPath : _name;
 	}
 
 	setPathWithoutRoot(objectPathDelimiter);
@@ -121,7 +124,7 @@ void Quantity::XMLFinalizeInstance (const XMLNode & pNode, Simulation * sim)
 	//---- make sure only one of {formulaID, value} attributes is present
 	bool hasValueAttribute = pNode.HasAttribute(XMLConstants::Value);
 	if (hasValueAttribute && pNode.HasAttribute(getFormulaXMLAttributeName()))
-		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Quantity "+_fullName+" has both formula and value attributes");
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Quantity "+_fullName.Value()+" has both formula and value attributes");
 
 	//---- check if value is given directly instead of formula
 	if (hasValueAttribute)
@@ -171,12 +174,13 @@ void Quantity::XMLFinalizeInstance (const XMLNode & pNode, Simulation * sim)
 
 void Quantity::setPathWithoutRoot(const string & objectPathDelimiter)
 {
-	size_t firstdelimiterpos = _fullName.find_first_of(objectPathDelimiter);
+	const string & fullName = _fullName;
+	size_t firstdelimiterpos = fullName.find_first_of(objectPathDelimiter);
 
 	if (firstdelimiterpos == string::npos)
-		_pathWithoutRoot = _fullName;
+		_pathWithoutRoot = fullName;
 	else
-		_pathWithoutRoot = _fullName.substr(firstdelimiterpos + 1);
+		_pathWithoutRoot = fullName.substr(firstdelimiterpos + 1);
 }
 
 std::string Quantity::GetPathWithoutRoot(void)
@@ -198,7 +202,7 @@ double Quantity::getDoubleFromSpecialValue(string & sValue, const char * ERROR_S
 		return MathHelper::GetNegInf();
 
 	//invalid value
-	throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Quantity "+_fullName+" has invalid value "+sValue);
+	throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Quantity "+_fullName.Value()+" has invalid value "+sValue);
 }
 
 bool Quantity::Simplify (bool forCurrentRunOnly)
@@ -241,6 +245,18 @@ void Quantity::SetInitialValue(double value)
 
 	_value = value;
 	_originalValue = value;
+
+	_initialValueChanged = true;
+}
+
+bool Quantity::InitialValueChanged(void)
+{
+	return _initialValueChanged;
+}
+
+void Quantity::ResetInitialValueChanged(void)
+{
+	_initialValueChanged = false;
 }
 
 void Quantity::SetConstantValue(double value)
@@ -249,6 +265,11 @@ void Quantity::SetConstantValue(double value)
 	_value = value;
 }
 
+double Quantity::GetConstantValue(void)
+{
+	return _value;
+}
+
 bool Quantity::IsConstant(bool forCurrentRunOnly)
 {
 	if (forCurrentRunOnly)
@@ -257,6 +278,12 @@ bool Quantity::IsConstant(bool forCurrentRunOnly)
 	return (_valueFormula == NULL) && _isFixed && !_isChangedBySwitch;
 }
 
+FormulaLinearity Quantity::Linearity()
+{
+	//e.g. observers: value is not computed from y
+	return FL_NONLINEAR;
+}
+
 void Quantity::ReplaceRefIndependentFormula(void)
 {
 	double value;
@@ -390,10 +417,8 @@ long Quantity::GetFormulaId(void)
 
 //TODO this will NOT work properly for changed table formulas
 // the function must be adjusted for table formulas
-void Quantity::UpdateFormulaInXMLNode(XMLNode & pFormulaListNode, XMLNode & pQuantitiesListNode)
+void Quantity::UpdateFormulaInXML(SimulationXMLWriter & xmlWriter)
 {
-	const char * ERROR_SOURCE = "Quantity::UpdateFormulaInXMLNode";
-
 	//only NOT FIXED parameters must be updated in XML
 	//Other parameters cannot be changed by user (whether constant or not)
 	if(_isFixed)
@@ -406,59 +431,10 @@ void Quantity::UpdateFormulaInXMLNode(XMLNode & pFormulaListNode, XMLNode & pQua
 	//---- check if parameter was const in original XML.
 	//     Then value-attribute must be set
 	if (_originalFormulaID==INVALID_QUANTITY_ID)
-	{
-		for (XMLNode pQuantityNode = pQuantitiesListNode.GetFirstChild(); !pQuantityNode.IsNull();pQuantityNode = pQuantityNode.GetNextSibling())
-		{
-			long quantityId = (long)pQuantityNode.GetAttribute(XMLConstants::Id, INVALID_QUANTITY_ID);
-
-			if (quantityId != _id)
-				continue;
-
-			//found quantity node: set value and exit
-			if (MathHelper::IsNaN(_value))
-				pQuantityNode.SetAttribute(XMLConstants::Value, "NaN");
-			else
-				pQuantityNode.SetAttribute(XMLConstants::Value, _value);
-
-			return;
-		}
-
-		//quantity with the stored id not found - should never happen
-		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, 
-			"Quantity with id "+_idAsString+" not found in the list");
-	}
-
-	for (XMLNode pFormulaNode = pFormulaListNode.GetFirstChild(); !pFormulaNode.IsNull();pFormulaNode = pFormulaNode.GetNextSibling())
-	{
-		long formulaId = (long)pFormulaNode.GetAttribute(XMLConstants::Id, INVALID_QUANTITY_ID);
-
-		if (formulaId != _originalFormulaID)
-			continue;
-
-		//remove old formula node
-		pFormulaListNode.RemoveChildNode(pFormulaNode);
-
-		//---- create new explicit formula node with formula equation=<quantity value>
-		XMLNode newFormulaNode = pFormulaListNode.CreateChildNode(XMLConstants::ExplicitFormula);
-
-		//set formula id
-		newFormulaNode.SetAttribute(XMLConstants::Id, formulaId);
-
-		XMLNode equationNode = newFormulaNode.CreateChildNode(XMLConstants::Equation);
-		equationNode.SetValue(_value);
-
-		//add empty parameter- and variables lists (required by schema)
-		newFormulaNode.CreateChildNode(XMLConstants::ParameterList);
-		newFormulaNode.CreateChildNode(XMLConstants::VariableList);
-
-		//exit function
-		return;
-	}
-
-	//formula with the stored id not found - should never happen
-	throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, 
-		"Formula with id "+XMLHelper::ToString(_originalFormulaID)+
-		" not found (quantity id: "+XMLHelper::ToString(_id)+")");
+		xmlWriter.SetQuantityValue(_id, _value);
+	else
+		//replace formula by explicit formula with equation=<quantity value>
+		xmlWriter.SetFormulaValue(_originalFormulaID, _value);
 }
 
 void Quantity::AppendUsedVariables(set<int> & usedVariablesIndices, const set<int> & variablesIndicesUsedInSwitchAssignments)
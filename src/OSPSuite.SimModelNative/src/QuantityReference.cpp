@@ -235,6 +235,14 @@ bool QuantityReference::IsConstant(bool forCurrentRunOnly)
 	return _quantity->IsConstant(forCurrentRunOnly);
 }
 
+FormulaLinearity QuantityReference::Linearity()
+{
+	if (_isTime)
+		return FL_NONLINEAR;
+
+	return _quantity->Linearity();
+}
+
 bool QuantityReference::IsChangedBySwitch(void)
 {
 	if (_isTime)
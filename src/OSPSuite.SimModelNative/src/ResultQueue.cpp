@@ -0,0 +1,136 @@
+#include "SimModel/ResultQueue.h"
+#include <chrono>
+#include <thread>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+ResultQueue::ResultQueue(void)
+{
+	_stub._next = NULL;
+	_head = &_stub;
+	_tail = &_stub;
+
+	_size = 0;
+	_consumerWaiting = false;
+	_isClosed = false;
+}
+
+void ResultQueue::pushNode(IndividualResult * result)
+{
+	result->_next.store(NULL, memory_order_relaxed);
+	IndividualResult * previous = _head.exchange(result, memory_order_acq_rel);
+	previous->_next.store(result, memory_order_release);
+}
+
+IndividualResult * ResultQueue::tryPopNode()
+{
+	IndividualResult * tail = _tail;
+	IndividualResult * next = tail->_next.load(memory_order_acquire);
+
+	if (tail == &_stub)
+	{
+		if (next == NULL)
+			return NULL; //empty
+
+		_tail = next;
+		tail = next;
+		next = next->_next.load(memory_order_acquire);
+	}
+
+	if (next != NULL)
+	{
+		_tail = next;
+		return tail;
+	}
+
+	//a producer is just linking a new node
+	if (tail != _head.load(memory_order_acquire))
+		return NULL;
+
+	//tail is the last node: push the stub behind it, so that tail can be removed
+	pushNode(&_stub);
+
+	next = tail->_next.load(memory_order_acquire);
+	if (next != NULL)
+	{
+		_tail = next;
+		return tail;
+	}
+
+	return NULL;
+}
+
+void ResultQueue::Push(IndividualResult * result)
+{
+	pushNode(result);
+	_size++;
+
+	if (_consumerWaiting)
+	{
+		lock_guard <mutex> lock(_mutex);
+		_resultAvailable.notify_one();
+	}
+}
+
+IndividualResult * ResultQueue::Pop(int timeoutMs)
+{
+	IndividualResult * result = tryPopNode();
+
+	if ((result == NULL) && (timeoutMs != 0))
+	{
+		_consumerWaiting = true;
+
+		{
+			unique_lock <mutex> lock(_mutex);
+			auto resultAvailable = [this] { return (_size > 0) || _isClosed; };
+
+			if (timeoutMs < 0)
+				_resultAvailable.wait(lock, resultAvailable);
+			else
+				_resultAvailable.wait_for(lock, chrono::milliseconds(timeoutMs), resultAvailable);
+		}
+
+		_consumerWaiting = false;
+
+		//the producer may still be linking the result: retry until it's visible
+		while ((result == NULL) && (_size > 0))
+		{
+			result = tryPopNode();
+			if (result == NULL)
+				this_thread::yield();
+		}
+	}
+
+	if (result != NULL)
+		_size--;
+
+	return result;
+}
+
+void ResultQueue::Close()
+{
+	_isClosed = true;
+
+	lock_guard <mutex> lock(_mutex);
+	_resultAvailable.notify_all();
+}
+
+void ResultQueue::Reopen()
+{
+	_isClosed = false;
+}
+
+bool ResultQueue::IsClosed() const
+{
+	return _isClosed;
+}
+
+int ResultQueue::Size() const
+{
+	return _size;
+}
+
+}//.. end "namespace SimModelNative"
@@ -0,0 +1,134 @@
+#include "SimModel/RunContext.h"
+#include "SimModel/GlobalConstants.h"
+
+#include <assert.h>
+
+namespace SimModelNative
+{
+
+RunContext::RunContext(void)
+{
+	_latestTimeIndex = DE_INVALID_INDEX;
+	_progress = 0;
+	_cancelFlag = false;
+	_isRunning = false;
+	_externalCancelFlag = NULL;
+}
+
+RunContext::~RunContext(void)
+{
+	Release();
+}
+
+void RunContext::Reset()
+{
+	_solverWarnings.clear();
+	_runStatistics.Reset();
+
+	_cancelFlag = false;
+	_progress = 0;
+}
+
+bool RunContext::TryStartRun()
+{
+	bool isRunning = false;
+	return _isRunning.compare_exchange_strong(isRunning, true);
+}
+
+void RunContext::FinishRun()
+{
+	_isRunning = false;
+}
+
+void RunContext::Release()
+{
+	_solverWarnings.clear();
+
+	_timeValues.clear();
+	_timeValues.shrink_to_fit();
+	_latestTimeIndex = DE_INVALID_INDEX;
+
+	_cancelFlag = false;
+}
+
+void RunContext::RedimTimeValues(int numberOfTimePoints, double startTime)
+{
+	assert(numberOfTimePoints > 0);
+
+	_timeValues.assign(numberOfTimePoints, 0.0);
+	_timeValues[0] = startTime;
+	_latestTimeIndex = DE_INVALID_INDEX;
+}
+
+void RunContext::SetTimeValue(int index, double value)
+{
+	assert((index >= 0) && (index < (int)_timeValues.size()));
+	_timeValues[index] = value;
+
+	_latestTimeIndex = index;
+}
+
+double * RunContext::TimeValues()
+{
+	return _timeValues.empty() ? NULL : &_timeValues[0];
+}
+
+int RunContext::NumberOfTimePoints() const
+{
+	return (int)_timeValues.size();
+}
+
+long RunContext::Progress() const
+{
+	return _progress;
+}
+
+void RunContext::SetProgress(long progress)
+{
+	_progress = progress;
+}
+
+void RunContext::Cancel()
+{
+	_cancelFlag = true;
+}
+
+bool RunContext::IsCanceled() const
+{
+	if (_cancelFlag)
+		return true;
+
+	return (_externalCancelFlag != NULL) && *_externalCancelFlag;
+}
+
+void RunContext::SetExternalCancelFlag(const std::atomic<bool> * externalCancelFlag)
+{
+	_externalCancelFlag = externalCancelFlag;
+}
+
+void RunContext::AddWarning(const std::string & msg, double solverTime)
+{
+	_solverWarnings.push_back(new SolverWarning(solverTime, msg));
+}
+
+void RunContext::ClearSolverWarnings()
+{
+	_solverWarnings.clear();
+}
+
+const TObjectVector<SolverWarning> & RunContext::SolverWarnings() const
+{
+	return _solverWarnings;
+}
+
+SimulationRunStatistics & RunContext::RunStatistics()
+{
+	return _runStatistics;
+}
+
+SwitchSchedule & RunContext::GetSwitchSchedule()
+{
+	return _switchSchedule;
+}
+
+}//.. end "namespace SimModelNative"
@@ -0,0 +1,220 @@
+#include "SimModel/RunSimplificationCache.h"
+#include "SimModel/Quantity.h"
+#include "SimModel/Formula.h"
+#include <algorithm>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+RunSimplificationCache::RunSimplificationCache()
+{
+	_isValid = false;
+	_simplifiedObjectsChanged = false;
+}
+
+void RunSimplificationCache::Clear()
+{
+	_objects.clear();
+	_positionOfObjectIndex.clear();
+	_dependentObjects.clear();
+	_variableObjects.clear();
+	_isSimplified.clear();
+	_simplifiedValues.clear();
+	_simplifiedObjects.clear();
+	_hadFormula.clear();
+	_isAffected.clear();
+	_affectedObjects.clear();
+
+	_isValid = false;
+	_simplifiedObjectsChanged = false;
+}
+
+void RunSimplificationCache::Setup(const vector <vector <HierarchicalFormulaObject *> > & leveledObjects)
+{
+	size_t level, i, j;
+
+	Clear();
+
+	for (level = 0; level < leveledObjects.size(); level++)
+		_objects.insert(_objects.end(), leveledObjects[level].begin(), leveledObjects[level].end());
+
+	const int numberOfObjects = (int)_objects.size();
+
+	_positionOfObjectIndex.assign(numberOfObjects, -1);
+	for (int position = 0; position < numberOfObjects; position++)
+		_positionOfObjectIndex[_objects[position]->GetObjectIndex()] = position;
+
+	_dependentObjects.resize(numberOfObjects);
+	for (int position = 0; position < numberOfObjects; position++)
+	{
+		HierarchicalFormulaObject * object = _objects[position];
+
+		if (!object->IsFixed())
+			_variableObjects.push_back(position);
+
+		vector <HierarchicalFormulaObject *> usedObjects = object->GetUsedHierarchicalFormulaObjects();
+		for (i = 0; i < usedObjects.size(); i++)
+		{
+			vector <int> & dependentObjects = _dependentObjects[_positionOfObjectIndex[usedObjects[i]->GetObjectIndex()]];
+
+			//an object may be used several times by the same formula
+			for (j = 0; j < dependentObjects.size(); j++)
+			{
+				if (dependentObjects[j] == position)
+					break;
+			}
+
+			if (j == dependentObjects.size())
+				dependentObjects.push_back(position);
+		}
+	}
+
+	_isSimplified.assign(numberOfObjects, false);
+	_simplifiedValues.assign(numberOfObjects, 0.0);
+	_hadFormula.assign(numberOfObjects, false);
+	_isAffected.assign(numberOfObjects, false);
+}
+
+bool RunSimplificationCache::IsValid() const
+{
+	return _isValid;
+}
+
+void RunSimplificationCache::SaveFormulaState()
+{
+	for (size_t position = 0; position < _objects.size(); position++)
+		_hadFormula[position] = (_objects[position]->GetFormula() != NULL);
+}
+
+void RunSimplificationCache::updateObject(int position, bool hadFormula)
+{
+	HierarchicalFormulaObject * object = _objects[position];
+
+	//only formulas replaced by a value in the current run must be cached:
+	//objects without formula keep their value anyway
+	const bool isSimplified = hadFormula && (object->GetFormula() == NULL);
+
+	if (isSimplified != _isSimplified[position])
+		_simplifiedObjectsChanged = true;
+
+	_isSimplified[position] = isSimplified;
+
+	if (isSimplified)
+		_simplifiedValues[position] = object->GetConstantValue();
+}
+
+void RunSimplificationCache::updateSimplifiedObjects()
+{
+	if (!_simplifiedObjectsChanged)
+		return;
+
+	_simplifiedObjects.clear();
+	for (size_t position = 0; position < _objects.size(); position++)
+	{
+		if (_isSimplified[position])
+			_simplifiedObjects.push_back((int)position);
+	}
+
+	_simplifiedObjectsChanged = false;
+}
+
+void RunSimplificationCache::Update()
+{
+	size_t i;
+
+	_simplifiedObjectsChanged = true;
+	for (i = 0; i < _objects.size(); i++)
+		updateObject((int)i, _hadFormula[i]);
+	updateSimplifiedObjects();
+
+	//all changes until now are reflected by the cached values
+	for (i = 0; i < _variableObjects.size(); i++)
+		_objects[_variableObjects[i]]->ResetInitialValueChanged();
+
+	_isValid = true;
+}
+
+void RunSimplificationCache::markAffectedObjects()
+{
+	size_t i, j;
+
+	_affectedObjects.clear();
+
+	//changed objects and all objects depending on them (depth first)
+	vector <int> objectsToVisit;
+	for (i = 0; i < _variableObjects.size(); i++)
+	{
+		const int position = _variableObjects[i];
+		HierarchicalFormulaObject * object = _objects[position];
+
+		if (!object->InitialValueChanged())
+			continue;
+
+		object->ResetInitialValueChanged();
+
+		if (!_isAffected[position])
+		{
+			_isAffected[position] = true;
+			objectsToVisit.push_back(position);
+		}
+	}
+
+	while (!objectsToVisit.empty())
+	{
+		const int position = objectsToVisit.back();
+		objectsToVisit.pop_back();
+		_affectedObjects.push_back(position);
+
+		const vector <int> & dependentObjects = _dependentObjects[position];
+		for (j = 0; j < dependentObjects.size(); j++)
+		{
+			if (_isAffected[dependentObjects[j]])
+				continue;
+
+			_isAffected[dependentObjects[j]] = true;
+			objectsToVisit.push_back(dependentObjects[j]);
+		}
+	}
+
+	//affected objects must be simplified bottom up
+	sort(_affectedObjects.begin(), _affectedObjects.end());
+}
+
+int RunSimplificationCache::SimplifyChangedObjects()
+{
+	size_t i;
+
+	markAffectedObjects();
+
+	//---- not affected objects: restore cached values first, so that affected 
+	//     objects using them don't have to simplify them again
+	for (i = 0; i < _simplifiedObjects.size(); i++)
+	{
+		const int position = _simplifiedObjects[i];
+		if (!_isAffected[position])
+			_objects[position]->SetConstantValue(_simplifiedValues[position]);
+	}
+
+	//---- affected objects: simplify again (same as Simulation::SimplifyObjects(true))
+	for (i = 0; i < _affectedObjects.size(); i++)
+	{
+		const int position = _affectedObjects[i];
+		HierarchicalFormulaObject * object = _objects[position];
+
+		const bool hadFormula = (object->GetFormula() != NULL);
+
+		if (!object->IsConstant(true))
+			object->Simplify(true);
+
+		updateObject(position, hadFormula);
+		_isAffected[position] = false;
+	}
+
+	updateSimplifiedObjects();
+
+	return (int)_affectedObjects.size();
+}
+
+}//.. end "namespace SimModelNative"
@@ -120,6 +120,14 @@ bool SimpleProductFormula::IsZero(void)
 	return (m_K == 0.0);
 }
 
+FormulaLinearity SimpleProductFormula::Linearity()
+{
+	if (m_ODEIndexVectorSize == 0)
+		return FL_CONSTANT;
+
+	return (m_ODEIndexVectorSize == 1) ? FL_LINEAR : FL_NONLINEAR;
+}
+
 double SimpleProductFormula::DE_Compute (const double * y, const double time, ScaleFactorUsageMode scaleFactorMode)
 {
 	//Formula is K1*A*B-C - K2*D*E*F				
@@ -6,11 +6,23 @@
 #include "XMLWrapper/XMLNode.h"
 #include "XMLWrapper/XMLDocument.h"
 #include "XMLWrapper/XMLHelper.h"
+#include "XMLWrapper/XMLReader.h"
 #include <time.h>
+#include <fstream>
+#include <sstream>
 #include "SimModel/ParameterFormula.h"
 #include "SimModel/BandwidthReduction.h"
 #include "../../OSPSuite.SimModelNative/version.h"
 #include "SimModel/SimulationTask.h"
+#include "SimModel/SwitchTask.h"
+#include "SimModel/SolverConfigurationTask.h"
+#include "SimModel/PreparsedModel.h"
+#include "SimModel/EquationCache.h"
+#include "SimModel/ExplicitFormula.h"
+#include "SimModel/HierarchicalFormulaObjectGraph.h"
+#include "SimModel/TaskScheduler.h"
+#include <algorithm>
+#include <exception>
 
 #ifdef _WINDOWS
 #include <atlbase.h>
@@ -29,10 +41,28 @@ namespace SimModelNative
 
 using namespace std;
 
-Simulation::Simulation(void)
+std::atomic<int> Simulation::_numberOfActiveOperations(0);
+
+//counts an operation of a simulation as active as long as it exists (s. Simulation::NumberOfActiveOperations)
+class ActiveOperation
 {
-	m_TimeValues = NULL;
+private:
+	atomic<int> & _numberOfActiveOperations;
 
+public:
+	ActiveOperation(atomic<int> & numberOfActiveOperations) : _numberOfActiveOperations(numberOfActiveOperations)
+	{
+		_numberOfActiveOperations++;
+	}
+
+	~ActiveOperation()
+	{
+		_numberOfActiveOperations--;
+	}
+};
+
+Simulation::Simulation(void)
+{
 	ResetScalarProperties();
 }
 
@@ -47,6 +77,8 @@ void Simulation::ReleaseMemory()
 
 	if (!m_XMLDoc.IsNull())
 		m_XMLDoc.Release();
+
+	_parsedEquations.reset();
 }
 
 SimulationOptions & Simulation::Options()
@@ -54,6 +86,21 @@ SimulationOptions & Simulation::Options()
 	return _options;
 }
 
+SimulationRunStatistics & Simulation::RunStatistics()
+{
+	return _runContext.RunStatistics();
+}
+
+RunContext & Simulation::GetRunContext()
+{
+	return _runContext;
+}
+
+int Simulation::NumberOfActiveOperations()
+{
+	return _numberOfActiveOperations;
+}
+
 bool Simulation::UseBandLinearSolver()
 {
 	return m_Solver.UseBandLinearSolver();
@@ -83,6 +130,7 @@ void Simulation::SetupBandLinearSolver()
 void Simulation::Finalize ()
 {
 	const char * ERROR_SOURCE = "Simulation::Finalize";
+	ActiveOperation activeOperation(_numberOfActiveOperations);
 
 	if (!_isLoaded)
 		throw  ErrorData(ErrorData::ED_ERROR,ERROR_SOURCE, "Simulation was not loaded yet - cannot finalize!!");
@@ -107,6 +155,7 @@ void Simulation::Finalize ()
 	//set hierarchy levels of dependent formula objects
 	//(after simplifying, dependencies have changed because some formula objects were simplified)
 	SetupHierarchicalFormulaObjects(DontCheckForCyclingDependencies);
+	_runSimplificationCache.Setup(_leveledHierarchicalFormulaObjects);
 
 	// Second pass: Determine equation numbers
 	DE_SetSpeciesIndex();	
@@ -117,10 +166,18 @@ void Simulation::Finalize ()
 	//finalize switches
 	FinalizeSwitches();
 
+	//identify switches which don't require solver restart
+	SwitchTask::AnalyzeSwitchImpact(this);
+
 	CreateObserversForPersistableParameters();
 
 	SimulationTask::CacheRHSUsedVariables(this);
 
+	//in auto configuration mode: select dense or band linear solver
+	//from the structure of the ODE system
+	if (_options.AutoSolverConfiguration())
+		SolverConfigurationTask::SelectLinearSolver(this);
+
 	//Setup band linear solver. Band solver will only be used if
 	// m_Solver.UseBandLinearSolver() = true
 	//
@@ -129,12 +186,168 @@ void Simulation::Finalize ()
 	
 	//Everything ok, we can allow the run 
 	_isFinalized = true;
+
+	//values of a preparsed model
+	if (!_pendingParameterValues.empty() || !_pendingSpeciesValues.empty())
+	{
+		SetParametersValues(_pendingParameterValues);
+		SetDEVariablesProperties(_pendingSpeciesValues);
+
+		_pendingParameterValues.clear();
+		_pendingSpeciesValues.clear();
+	}
+
+	if (_options.LeanMode())
+		releaseXMLDocument();
+}
+
+void Simulation::releaseXMLDocument()
+{
+	//GetSimulationXMLString uses the XML string (s. SimulationOptions::KeepXMLNodeAsString),
+	//updated with the current state of the simulation objects
+	if (!m_XMLDoc.IsNull())
+		m_XMLDoc.Release();
+	m_SimNode = XMLNode();
+
+	//parsed equations are still required for the formulas finalized on demand
+	if (_deferredFormulas.empty())
+		_parsedEquations.reset();
+}
+
+ParsedEquations * Simulation::GetParsedEquations()
+{
+	//preparsed model (or its writer) has precedence
+	if (_parsedEquations)
+		return _parsedEquations.get();
+
+	if (_options.UseEquationCache())
+		return EquationCache::GetInstance();
+
+	return NULL;
 }
 
+//formulas finalized by one task of the parallel finalization
+const int FORMULAS_PER_FINALIZE_TASK = 64;
+
 void Simulation::FinalizeFormulas()
 {
-	for(int i=0;i<_formulas.size();i++)
-		_formulas[i]->Finalize();
+	const char * ERROR_SOURCE = "Simulation::FinalizeFormulas";
+
+	vector <Formula *> formulas;
+	formulas.reserve(_formulas.size());
+
+	if (_options.LazyFinalize())
+	{
+		//only parsing of explicit formulas is expensive: all other formulas
+		//are finalized anyway (table formulas are also referenced by other formulas)
+		set <Formula *> usedFormulas = SimulationTask::FormulasUsedInSimulation(this);
+
+		for (int i = 0; i < _formulas.size(); i++)
+		{
+			Formula * formula = _formulas[i];
+
+			if ((usedFormulas.find(formula) == usedFormulas.end()) && (dynamic_cast<ExplicitFormula *>(formula) != NULL))
+				_deferredFormulas.insert(formula);
+			else
+				formulas.push_back(formula);
+		}
+	}
+	else
+	{
+		for (int i = 0; i < _formulas.size(); i++)
+			formulas.push_back(_formulas[i]);
+	}
+
+	const int numberOfFormulas = (int)formulas.size();
+	int numberOfThreads = _options.NumberOfFinalizeThreads();
+
+	if (numberOfThreads <= 0)
+		numberOfThreads = max((int)thread::hardware_concurrency(), 1);
+
+	const int numberOfTasks = (numberOfFormulas + FORMULAS_PER_FINALIZE_TASK - 1) / FORMULAS_PER_FINALIZE_TASK;
+	numberOfThreads = min(numberOfThreads, numberOfTasks);
+
+	if (numberOfThreads <= 1)
+	{
+		for(int i=0;i<numberOfFormulas;i++)
+			formulas[i]->Finalize();
+
+		return;
+	}
+
+	//Formulas are finalized independently of each other: a formula only reads
+	//the (scalar) values of constant quantities, which are not changed anymore.
+	//So the result does not depend on the number of threads.
+	//
+	//Errors are collected per task; the error of the first failing formula
+	//is thrown, as in the sequential finalization
+	vector <exception_ptr> errors(numberOfTasks);
+
+	{
+		TaskScheduler & scheduler = TaskScheduler::GetInstance();
+		scheduler.EnsureNumberOfThreads(numberOfThreads);
+
+		TaskGroup taskGroup;
+		taskGroup.SetMaximumConcurrency(numberOfThreads);
+
+		for (int task = 0; task < numberOfTasks; task++)
+		{
+			//COM is initialized by the workers of the scheduler (rate nodes of the parsed equations are COM objects)
+			scheduler.Submit(taskGroup, [&, task](int /*slot*/)
+			{
+				const int firstFormula = task * FORMULAS_PER_FINALIZE_TASK;
+				const int lastFormula = min(firstFormula + FORMULAS_PER_FINALIZE_TASK, numberOfFormulas);
+
+				for (int i = firstFormula; (i < lastFormula) && !errors[task]; i++)
+				{
+					try
+					{
+						formulas[i]->Finalize();
+					}
+					catch (ErrorData &)
+					{
+						errors[task] = current_exception();
+					}
+					catch (...)
+					{
+						errors[task] = make_exception_ptr(ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unknown error in formula with id=" + XMLHelper::ToString(formulas[i]->GetId())));
+					}
+				}
+			});
+		}
+
+		scheduler.Wait(taskGroup);
+	}
+
+	for (int task = 0; task < numberOfTasks; task++)
+	{
+		if (errors[task])
+			rethrow_exception(errors[task]);
+	}
+}
+
+void Simulation::finalizeDeferredFormula(Formula * formula)
+{
+	set <Formula *>::iterator iter = _deferredFormulas.find(formula);
+	if (iter == _deferredFormulas.end())
+		return;
+
+	//until then, formula was evaluated as set up while loading (all references treated as parameters),
+	//which gives the same values
+	formula->Finalize();
+	_deferredFormulas.erase(iter);
+}
+
+void Simulation::FinalizeDeferredFormulas()
+{
+	//in the order of the formulas, as in FinalizeFormulas
+	for (int i = 0; (i < _formulas.size()) && !_deferredFormulas.empty(); i++)
+		finalizeDeferredFormula(_formulas[i]);
+}
+
+int Simulation::GetNumberOfDeferredFormulas() const
+{
+	return (int)_deferredFormulas.size();
 }
 
 void Simulation::DE_SetSpeciesIndex()
@@ -154,6 +367,19 @@ void Simulation::DE_SetSpeciesIndex()
 		_DE_Variables.push_back(species);
 	}
 	assert(_DE_Variables.size()==m_ODE_NumUnknowns);
+
+	//initial values of DE variables must be calculated in the order of their hierarchy levels
+	_leveledDEVariables.clear();
+	for(size_t i=0; i<_leveledHierarchicalFormulaObjects.size(); i++)
+	{
+		for(size_t j=0; j<_leveledHierarchicalFormulaObjects[i].size(); j++)
+		{
+			Species * species = dynamic_cast<Species *>(_leveledHierarchicalFormulaObjects[i][j]);
+			if (species && !species->IsConstantDuringCalculation())
+				_leveledDEVariables.push_back(species);
+		}
+	}
+	assert((int)_leveledDEVariables.size()==m_ODE_NumUnknowns);
 }
 
 TObjectList<Quantity> & Simulation::AllQuantities(void)
@@ -181,6 +407,28 @@ TObjectList<Observer> & Simulation::Observers(void)
 	return _observers;
 }
 
+Quantity * Simulation::GetQuantityByPath(const string & pathWithoutRoot)
+{
+	//observers for persistable parameters are added while finalizing
+	if (_numberOfQuantitiesByPath != _species.size() + _observers.size())
+	{
+		_quantitiesByPath.clear();
+
+		//emplace keeps the first quantity with the same path (species before observers)
+		for (int i = 0; i < _species.size(); i++)
+			_quantitiesByPath.emplace(_species[i]->GetPathWithoutRoot(), _species[i]);
+
+		for (int i = 0; i < _observers.size(); i++)
+			_quantitiesByPath.emplace(_observers[i]->GetPathWithoutRoot(), _observers[i]);
+
+		_numberOfQuantitiesByPath = _species.size() + _observers.size();
+	}
+
+	unordered_map<string, Quantity *>::const_iterator iter = _quantitiesByPath.find(pathWithoutRoot);
+
+	return (iter != _quantitiesByPath.end()) ? iter->second : NULL;
+}
+
 TObjectList<Switch> & Simulation::Switches(void)
 {
 	return _switches;
@@ -266,10 +514,8 @@ void Simulation::ResetScalarProperties(void)
 {
 	_isLoaded = false;
 	_isFinalized = false;
+	_numberOfQuantitiesByPath = 0;
 	m_ODE_NumUnknowns = 0;
-	_numberOfTimePoints = 0;
-	_cancelFlag = false;
-	m_TimeLatestIndex = DE_INVALID_INDEX;
 	m_XMLString = "";
 	_XML_Version = OLD_SIMMODEL_XML_VERSION;
 }
@@ -287,15 +533,25 @@ void Simulation::ResetSimulation(void)
 	_switches.clear();
 	_formulas.clear();
 
-	_solverWarnings.clear();
-
 	_leveledHierarchicalFormulaObjects.clear();
+	_runSimplificationCache.Clear();
+
+	_quantitiesByPath.clear();
 
-	if (m_TimeValues)
-		delete[] m_TimeValues;
-	m_TimeValues = NULL;
+	_runContext.Release();
 
 	_DE_Variables.clear();
+	_leveledDEVariables.clear();
+
+	_pendingParameterValues.clear();
+	_pendingSpeciesValues.clear();
+
+	_deferredFormulas.clear();
+
+	_xmlWriter.reset();
+
+	//cached solver instance belongs to the previous simulation
+	m_Solver.ReleaseSolver();
 }
 
 #ifdef _WINDOWS
@@ -316,17 +572,41 @@ std::string DescriptionFromComError(const _com_error & e)
 void Simulation::LoadFromXMLFile   (const string & sFileName)
 {
 	const char * ERROR_SOURCE = "Simulation::LoadFromXMLFile";
+	ActiveOperation activeOperation(_numberOfActiveOperations);
 
 	try
 	{
 		if (!m_XMLDoc.IsNull())
 			m_XMLDoc.Release();
 
+		m_SimNode = XMLNode();
+
+		_parsedEquations.reset();
+
+		//same XML is often loaded repeatedly (e.g. populations): validated only once
+		uint64_t contentHash = _options.ValidateWithXMLSchema() ? XMLHelper::FileContentHash(sFileName) : 0;
+
+		if (UseStreamingXMLLoad())
+		{
+			LoadFromXMLReader([&sFileName](XMLReader & reader) { reader.OpenFile(sFileName); }, contentHash);
+
+			//save XML string if required (<Simulation> element only, as for the DOM)
+			if (_options.KeepXMLNodeAsString())
+			{
+				ifstream file(sFileName.c_str(), ios::binary);
+				ostringstream content;
+				content << file.rdbuf();
+				m_XMLString = SimulationXMLWriter::SimulationElementOf(content.str());
+			}
+
+			return;
+		}
+
 		// Create XML DOM
 		m_XMLDoc = XMLDocument::FromFile(sFileName);
 
 		//load simulation from m_XMLDoc
-		LoadFromXMLDocument();
+		LoadFromXMLDocument(contentHash);
 	}
 	catch(ErrorData &)
 	{
@@ -355,17 +635,36 @@ void Simulation::LoadFromXMLFile   (const string & sFileName)
 void Simulation::LoadFromXMLString (const string & sSimulationXML)
 {
 	const char * ERROR_SOURCE = "Simulation::LoadFromXMLString";
+	ActiveOperation activeOperation(_numberOfActiveOperations);
 
 	try
 	{
 		if (!m_XMLDoc.IsNull())
 			m_XMLDoc.Release();
 
+		m_SimNode = XMLNode();
+
+		_parsedEquations.reset();
+
+		//same XML is often loaded repeatedly (e.g. populations): validated only once
+		uint64_t contentHash = _options.ValidateWithXMLSchema() ? XMLHelper::ContentHash(sSimulationXML) : 0;
+
+		if (UseStreamingXMLLoad())
+		{
+			LoadFromXMLReader([&sSimulationXML](XMLReader & reader) { reader.OpenString(sSimulationXML); }, contentHash);
+
+			//save XML string if required (<Simulation> element only, as for the DOM)
+			if (_options.KeepXMLNodeAsString())
+				m_XMLString = SimulationXMLWriter::SimulationElementOf(sSimulationXML);
+
+			return;
+		}
+
 		// Create XML DOM
 		m_XMLDoc = XMLDocument::FromString(sSimulationXML);
 		
 		//load simulation from m_XMLDoc
-		LoadFromXMLDocument();
+		LoadFromXMLDocument(contentHash);
 	}
 	catch(ErrorData &)
 	{
@@ -391,20 +690,37 @@ void Simulation::LoadFromXMLString (const string & sSimulationXML)
 	}
 }
 
-void Simulation::LoadFromXMLDocument(void)
+bool Simulation::xmlValidationRequired(uint64_t contentHash, uint64_t & schemaGeneration)
+{
+	const char * ERROR_SOURCE = "Simulation::xmlValidationRequired";
+
+	if (!_options.ValidateWithXMLSchema())
+		return false;
+
+	XMLCache* pXMLCache = XMLCache::GetInstance();
+
+	if (!pXMLCache->SchemaInitialized())
+		throw ErrorData(ErrorData::ED_ERROR,ERROR_SOURCE,"Simulation Schema File is not specified");
+
+	//before the validator gets the schema (s. XMLCache::SchemaGeneration)
+	schemaGeneration = pXMLCache->SchemaGeneration();
+
+	return !pXMLCache->IsValidatedContent(contentHash);
+}
+
+void Simulation::LoadFromXMLDocument(uint64_t contentHash)
 {
 	const char * ERROR_SOURCE = "Simulation::LoadFromXMLDocument";
 
 	assert(!m_XMLDoc.IsNull());
 
-	if (_options.ValidateWithXMLSchema())
+	uint64_t schemaGeneration;
+	if (xmlValidationRequired(contentHash, schemaGeneration))
 	{
 		XMLCache* pXMLCache = XMLCache::GetInstance();
 
-		if (!pXMLCache->SchemaInitialized())
-			throw ErrorData(ErrorData::ED_ERROR,ERROR_SOURCE,"Simulation Schema File is not specified");
-
 		XMLHelper::ValidateXMLDomWithSchema(m_XMLDoc,pXMLCache);
+		pXMLCache->AddValidatedContent(contentHash, schemaGeneration);
 	}
 
 	// Get "<Simulation>" tag
@@ -416,10 +732,24 @@ void Simulation::LoadFromXMLDocument(void)
 	if (m_SimNode.IsNull())
 		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,"Unable to find node <Simulation> in the XML File");
 
+	LoadFromSimulationNode(m_SimNode);
+}
+
+void Simulation::LoadFromSimulationNode(const XMLNode & simNode)
+{
 	//---- Load simulation from current node
-	LoadFromXMLNode(m_SimNode); //1st pass
+	LoadFromXMLNode(simNode); //1st pass
 
 	//save references to all quantities in common vector
+	FillAllQuantities();
+
+	XMLFinalizeInstance(simNode, this); //2nd pass (resolve references etc.)
+
+	SimulationTask::MarkUsedParameters(this);
+}
+
+void Simulation::FillAllQuantities()
+{
 	int i;
 
 	for (i = 0; i < _parameters.size(); i++)
@@ -432,112 +762,442 @@ void Simulation::LoadFromXMLDocument(void)
 
 	for(i=0;i<_observers.size();i++)
 		_allQuantities.Add(_observers[i]);
+}
+
+bool Simulation::UseStreamingXMLLoad()
+{
+	if (!_options.StreamingXMLLoad())
+		return false;
+
+	//schema validation requires the DOM if the reader cannot validate
+	return !_options.ValidateWithXMLSchema() || XMLReader::SupportsSchemaValidation();
+}
 
-	XMLFinalizeInstance(m_SimNode, this); //2nd pass (resolve references etc.)
+void Simulation::LoadFromXMLReader(const std::function<void(XMLReader &)> & openReader, uint64_t contentHash)
+{
+	const char * ERROR_SOURCE = "Simulation::LoadFromXMLReader";
+
+	//delete previous stuff if available
+	ResetSimulation();
+
+	XMLReader reader;
+
+	//---- 1st pass: create all objects
+	openReader(reader);
+
+	//document is validated while it is read
+	uint64_t schemaGeneration;
+	bool validate = xmlValidationRequired(contentHash, schemaGeneration);
+	if (validate)
+		reader.ValidateWithSchema(XMLCache::GetInstance());
+
+	if (!reader.NextElement() || (reader.ElementName() != XMLConstants::Simulation))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,"Unable to find node <Simulation> in the XML File");
+
+	//simulation attributes
+	XMLNode simNode = reader.CurrentElement();
+	_objectPathDelimiter=simNode.GetAttribute(XMLConstants::ObjectPathDelimiter);
+	_XML_Version=(int)simNode.GetAttribute(XMLConstants::SimModelXMLVersion, OLD_SIMMODEL_XML_VERSION);
+
+	readSimulationElements(reader, false);
+	reader.Close();
+
+	if (validate)
+		XMLCache::GetInstance()->AddValidatedContent(contentHash, schemaGeneration);
+
+	FillAllQuantities();
+
+	_isLoaded = true;
+
+	//---- 2nd pass: resolve references etc.
+	openReader(reader);
+	reader.NextElement(); //<Simulation>
+
+	readSimulationElements(reader, true);
+	reader.Close();
 
 	SimulationTask::MarkUsedParameters(this);
 }
 
-//estimate and save hierarchy level of each HFObject and 
-//arrange them according to hierarchy level in _leveledHierarchicalFormulaObjects
-void Simulation::SetupHierarchicalFormulaObjects (enum CheckForCyclingDependenciesMode checkMode)
+void Simulation::readSimulationElements(XMLReader & reader, bool finalize)
 {
-	TObjectVector<HierarchicalFormulaObject> SimHObjects;
+	//solver properties must be finalized after the parameters and switches
+	//(s. XMLFinalizeInstance), so the (small) solver node is kept until the end
+	string solverXML;
+	bool solverFound = false, outputSchemaFound = false;
 
-	try
+	bool hasElement = reader.NextElement();
+
+	while (hasElement)
 	{
-		int i, j, simHOBjectsSize;
-		HierarchicalFormulaObject * HObject;
+		const string elementName = reader.ElementName();
 
-		//---- get all HF objects
-		
-		for (j=0; j<_allQuantities.size(); j++)
+		if (elementName == XMLConstants::Solver)
 		{
-			HObject = _allQuantities[j]->GetHierarchicalFormulaObject();
+			XMLNode pNode = reader.ExpandCurrentElement();
+
+			if (finalize)
+				solverXML = pNode.GetXML();
+			else
+				m_Solver.LoadFromXMLNode(pNode);
 
-			if (HObject)
-				SimHObjects.push_back(HObject);
+			solverFound = true;
+			hasElement = reader.NextElement();
+			continue;
 		}
-		
-		//cache objects size for speedup
-		simHOBjectsSize = SimHObjects.size();
 
-		//---- for each HF object:
-		//       - save list of all HF objects (needed for cycling dep. check)
-		//       - set  HF object index (1..#HFObjects) (dito)
-		for (i=0; i<simHOBjectsSize; i++)
+		if (elementName == XMLConstants::OutputSchema)
 		{
-			HObject = SimHObjects[i];
-			
-			//set the list of all hierarchical formula objects
-			HObject->SetHierarchicalObjects(SimHObjects);
-			
-			//set object index in the list of all objects
-			HObject->SetObjectIndex(i);
+			XMLNode pNode = reader.ExpandCurrentElement();
+
+			if (finalize)
+				_outputSchema.XMLFinalizeInstance(pNode, this);
+			else
+				_outputSchema.LoadFromXMLNode(pNode);
+
+			outputSchemaFound = true;
+			hasElement = reader.NextElement();
+			continue;
 		}
 
-		if (checkMode == CheckForCyclingDependencies)
+		if ((elementName != XMLConstants::ParameterList) && (elementName != XMLConstants::VariableList) &&
+			(elementName != XMLConstants::ObserverList) && (elementName != XMLConstants::SwitchList) &&
+			(elementName != XMLConstants::FormulaList))
 		{
-			//---- check for cycling dependencies
-			for (i=0; i<simHOBjectsSize; i++)
-			{
-				HObject = SimHObjects[i];
-				
-				//check cyclic dependencies
-				HObject->CheckCyclicDependencies();			
-			}
+			hasElement = reader.NextElement(true); //not used by the simulation
+			continue;
 		}
-		
-		//---- set hierarchy depth level
-		bool HLevelAdjusted = true;
-		while(HLevelAdjusted)
+
+		//objects of the list: one element at a time
+		for (hasElement = reader.NextElement(); hasElement && (reader.Depth() == 2); hasElement = reader.NextElement())
 		{
-			HLevelAdjusted = false;
-			
-			for (i=0; i<simHOBjectsSize; i++)
+			XMLNode pObjectNode = reader.ExpandCurrentElement();
+
+			if (elementName == XMLConstants::ParameterList)
+			{
+				if (finalize)
+					SimModelXMLHelper<Parameter>::ObjectXMLFinalizeInstance(_parameters, pObjectNode, this);
+				else
+					SimModelXMLHelper<Parameter>::ObjectLoadFromXMLNode(_parameters, pObjectNode);
+			}
+			else if (elementName == XMLConstants::VariableList)
 			{
-				HObject = SimHObjects[i];
-				HLevelAdjusted |= HObject->AdjustHierarchyLevel();
+				if (finalize)
+					SimModelXMLHelper<Species>::ObjectXMLFinalizeInstance(_species, pObjectNode, this);
+				else
+					SimModelXMLHelper<Species>::ObjectLoadFromXMLNode(_species, pObjectNode);
+			}
+			else if (elementName == XMLConstants::ObserverList)
+			{
+				if (finalize)
+					SimModelXMLHelper<Observer>::ObjectXMLFinalizeInstance(_observers, pObjectNode, this);
+				else
+					SimModelXMLHelper<Observer>::ObjectLoadFromXMLNode(_observers, pObjectNode);
+			}
+			else if (elementName == XMLConstants::SwitchList)
+			{
+				if (finalize)
+					SimModelXMLHelper<Switch>::ObjectXMLFinalizeInstance(_switches, pObjectNode, this);
+				else
+					SimModelXMLHelper<Switch>::ObjectLoadFromXMLNode(_switches, pObjectNode);
+			}
+			else if (finalize)
+				SimModelXMLHelper<Formula>::ObjectXMLFinalizeInstance(_formulas, pObjectNode, this);
+			else
+			{
+				Formula * formula = FormulaFactory::CreateFormula(pObjectNode.GetNodeName());
+				formula->LoadFromXMLNode(pObjectNode);
+
+				_formulas.Add(formula);
 			}
 		}
+	}
+
+	//missing nodes are handled as in LoadFromXMLNode/XMLFinalizeInstance
+	if (!finalize)
+	{
+		if (!solverFound)
+			m_Solver.LoadFromXMLNode(XMLNode());
 
-		//---- arrange and save HF objects according to their hierarchy level
-		int HLevelIdx, MaxHLevel = HFOBJECT_TOP_LEVEL - 1;
+		if (!outputSchemaFound)
+			_outputSchema.LoadFromXMLNode(XMLNode());
 
-		//get max. hierarchy level
-		for (i = 0; i < simHOBjectsSize; i++) 
+		return;
+	}
+
+	if (solverFound)
+	{
+		XMLDocument solverDoc = XMLDocument::FromString(solverXML);
+
+		try
 		{
-			HObject = SimHObjects[i];
-			
-			if (HObject->GetHierarchyLevel() > MaxHLevel)
-				MaxHLevel = HObject->GetHierarchyLevel();
+			m_Solver.XMLFinalizeInstance(solverDoc.GetRootElement(), this);
+		}
+		catch (...)
+		{
+			solverDoc.Release();
+			throw;
 		}
 
-		//save HF objects in local list for later use (bottom up)
-		_leveledHierarchicalFormulaObjects.clear();
+		solverDoc.Release();
+	}
+	else
+		m_Solver.XMLFinalizeInstance(XMLNode(), this);
 
-		for (HLevelIdx = HFOBJECT_TOP_LEVEL; HLevelIdx <= MaxHLevel; HLevelIdx++)
-		{
-			vector <HierarchicalFormulaObject *> HFObjectsForLevel;
+	if (!outputSchemaFound)
+		_outputSchema.XMLFinalizeInstance(XMLNode(), this);
+}
 
-			for (i = 0; i < simHOBjectsSize; i++)
-			{
-				HObject = SimHObjects[i];
-				
-				if (HObject->GetHierarchyLevel() == HLevelIdx)
-					HFObjectsForLevel.push_back(HObject);
-			}
+Simulation * Simulation::Clone(bool calculateSensitivity /*= true*/)
+{
+	const char * ERROR_SOURCE = "Simulation::Clone";
 
-			_leveledHierarchicalFormulaObjects.push_back(HFObjectsForLevel);
-		}
+	if (!_isFinalized)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation is not finalized - cannot clone");
 
-		SimHObjects.FreeVector();
+	if (!CanBeCloned())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, 
+		                "Simulation XML is not available - cannot clone (XML string must be kept if the XML DOM is released or not created)");
+
+	//XML DOM is released in lean mode and not created at all by the streaming load:
+	//the clone is loaded from the XML string instead (s. SimulationOptions::KeepXMLNodeAsString)
+	bool xmlDocumentAvailable = !m_XMLDoc.IsNull() && !m_SimNode.IsNull();
+
+	Simulation * clone = new Simulation();
+
+	try
+	{
+		clone->Options().CopyFrom(_options);
+
+		if (xmlDocumentAvailable)
+			clone->LoadFromSimulationNode(m_SimNode);
+		else
+			clone->LoadFromXMLString(m_XMLString);
+
+		//equations were already parsed for this simulation (e.g. preparsed model)
+		if (_parsedEquations)
+			clone->_parsedEquations = _parsedEquations;
+
+		//---- same variable parameters and species as in this simulation
+		vector <ParameterInfo> variableParameters;
+		vector <SpeciesInfo> variableSpecies;
+		InitialFillVariableInfos(variableParameters, variableSpecies, calculateSensitivity);
+
+		clone->SetVariableParameters(variableParameters);
+		clone->SetVariableDEVariables(variableSpecies);
+
+		clone->SetUseBandLinearSolver(UseBandLinearSolver());
+		clone->Finalize();
+
+		//---- current values of variable parameters and species
+		FillParameterProperties(variableParameters);
+		clone->SetParametersValues(variableParameters);
+
+		FillDEVariableProperties(variableSpecies);
+		clone->SetDEVariablesProperties(variableSpecies);
 	}
-	catch(...)
+	catch (...)
+	{
+		delete clone;
+		throw;
+	}
+
+	return clone;
+}
+
+bool Simulation::CanBeCloned() const
+{
+	return (!m_XMLDoc.IsNull() && !m_SimNode.IsNull()) || (m_XMLString != "");
+}
+
+void Simulation::InitialFillVariableInfos(vector <ParameterInfo> & variableParameters,
+                                          vector <SpeciesInfo> & variableSpecies,
+                                          bool calculateSensitivity)
+{
+	int i;
+
+	variableParameters.clear();
+	for (i = 0; i < _parameters.size(); i++)
 	{
-		SimHObjects.FreeVector();
+		Parameter * parameter = _parameters[i];
+		if (parameter->IsFixed())
+			continue;
+
+		ParameterInfo parameterInfo;
+		parameter->InitialFillInfo(parameterInfo);
+		parameterInfo.SetCalculateSensitivity(calculateSensitivity && parameter->CalculateSensitivity());
+		variableParameters.push_back(parameterInfo);
+	}
+
+	variableSpecies.clear();
+	for (i = 0; i < _species.size(); i++)
+	{
+		Species * species = _species[i];
+		if (species->IsFixed())
+			continue;
+
+		SpeciesInfo speciesInfo;
+		species->InitialFillInfo(speciesInfo);
+		variableSpecies.push_back(speciesInfo);
+	}
+}
+
+void Simulation::SavePreparsedModel(const string & fileName)
+{
+	const char * ERROR_SOURCE = "Simulation::SavePreparsedModel";
+
+	if (!_isFinalized)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation is not finalized - cannot save preparsed model");
+
+	if (m_XMLDoc.IsNull() || m_SimNode.IsNull())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation XML is not available - cannot save preparsed model");
+
+	shared_ptr <PreparsedModelWriter> writer = make_shared <PreparsedModelWriter> ();
+	writer->SetSimulationNode(m_SimNode);
+
+	vector <ParameterInfo> variableParameters;
+	vector <SpeciesInfo> variableSpecies;
+	InitialFillVariableInfos(variableParameters, variableSpecies, true);
+
+	//---- record the parsed equations by finalizing a copy of the simulation 
+	//     exactly as LoadFromPreparsedModel will do it.
+	//     (formulas of this simulation are already finalized, their equations are not available anymore)
+	Simulation * recordingSimulation = new Simulation();
+
+	try
+	{
+		recordingSimulation->Options().CopyFrom(_options);
+		recordingSimulation->Options().SetNumberOfFinalizeThreads(1); //equations are recorded in the order of the formulas
+		recordingSimulation->_parsedEquations = writer;
+		recordingSimulation->LoadFromSimulationNode(m_SimNode);
+
+		recordingSimulation->SetVariableParameters(variableParameters);
+		recordingSimulation->SetVariableDEVariables(variableSpecies);
+		recordingSimulation->SetUseBandLinearSolver(UseBandLinearSolver());
+		recordingSimulation->Finalize();
+	}
+	catch (...)
+	{
+		delete recordingSimulation;
 		throw;
 	}
+
+	delete recordingSimulation;
+
+	//---- current values of variable parameters and species
+	FillParameterProperties(variableParameters);
+	FillDEVariableProperties(variableSpecies);
+
+	writer->SetVariableParameters(variableParameters);
+	writer->SetVariableSpecies(variableSpecies);
+	writer->SetUseBandLinearSolver(UseBandLinearSolver());
+
+	writer->Write(fileName);
+}
+
+void Simulation::LoadFromPreparsedModel(const string & fileName)
+{
+	const char * ERROR_SOURCE = "Simulation::LoadFromPreparsedModel";
+	ActiveOperation activeOperation(_numberOfActiveOperations);
+
+	try
+	{
+		if (!m_XMLDoc.IsNull())
+			m_XMLDoc.Release();
+		m_SimNode = XMLNode();
+
+		_parsedEquations.reset();
+
+		shared_ptr <PreparsedModel> preparsedModel = make_shared <PreparsedModel> (fileName);
+
+		m_XMLDoc = preparsedModel->CreateSimulationDocument();
+		m_SimNode = m_XMLDoc.GetRootElement();
+
+		_parsedEquations = preparsedModel;
+
+		LoadFromSimulationNode(m_SimNode);
+
+		vector <ParameterInfo> variableParameters = preparsedModel->VariableParameters();
+		vector <SpeciesInfo> variableSpecies = preparsedModel->VariableSpecies();
+
+		SetVariableParameters(variableParameters);
+		SetVariableDEVariables(variableSpecies);
+		SetUseBandLinearSolver(preparsedModel->UseBandLinearSolver());
+
+		_pendingParameterValues = variableParameters;
+		_pendingSpeciesValues = variableSpecies;
+	}
+	catch(ErrorData &)
+	{
+		throw;
+	}
+	catch (std::bad_alloc& )
+	{
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,
+			            "Out of memory during loading from the preparsed model '" + fileName + "'");
+	}
+	catch(...)
+	{
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,
+		                "Unknown Error occured during loading from the preparsed model '" + fileName + "'");
+	}
+}
+
+//estimate and save hierarchy level of each HFObject and 
+//arrange them according to hierarchy level in _leveledHierarchicalFormulaObjects
+void Simulation::SetupHierarchicalFormulaObjects (enum CheckForCyclingDependenciesMode checkMode)
+{
+	const char * ERROR_SOURCE = "Simulation::SetupHierarchicalFormulaObjects";
+
+	int i;
+	HierarchicalFormulaObject * HObject;
+
+	//---- get all HF objects
+	vector <HierarchicalFormulaObject *> SimHObjects;
+
+	for (i=0; i<_allQuantities.size(); i++)
+	{
+		HObject = _allQuantities[i]->GetHierarchicalFormulaObject();
+
+		if (HObject)
+			SimHObjects.push_back(HObject);
+	}
+
+	//---- dependency graph (sets HF object index (0..#HFObjects-1))
+	HierarchicalFormulaObjectGraph graph(SimHObjects);
+
+	//objects on (or depending on) a cycle cannot be ordered
+	vector <int> dependencyOrder = graph.DependencyOrder();
+
+	if ((checkMode == CheckForCyclingDependencies) || (dependencyOrder.size() != SimHObjects.size()))
+	{
+		vector <int> cycle = graph.FindCycle();
+
+		if (!cycle.empty())
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cyclic dependencies found for " + 
+			                SimHObjects[cycle[0]]->GetFullName() + ": " + graph.CycleDescription(cycle));
+	}
+
+	//---- set hierarchy depth level (used objects first)
+	int MaxHLevel = HFOBJECT_TOP_LEVEL - 1;
+
+	for (size_t orderIdx = 0; orderIdx < dependencyOrder.size(); orderIdx++)
+	{
+		HObject = SimHObjects[dependencyOrder[orderIdx]];
+		HObject->AdjustHierarchyLevel();
+
+		MaxHLevel = max(MaxHLevel, HObject->GetHierarchyLevel());
+	}
+
+	//---- arrange and save HF objects according to their hierarchy level (bottom up)
+	_leveledHierarchicalFormulaObjects.clear();
+	_leveledHierarchicalFormulaObjects.resize(MaxHLevel - HFOBJECT_TOP_LEVEL + 1);
+
+	for (i = 0; i < (int)SimHObjects.size(); i++)
+	{
+		HObject = SimHObjects[i];
+		_leveledHierarchicalFormulaObjects[HObject->GetHierarchyLevel() - HFOBJECT_TOP_LEVEL].push_back(HObject);
+	}
 }
 
 void Simulation::SimplifyObjects(bool forCurrentRunOnly)
@@ -592,6 +1252,24 @@ void Simulation::SimplifyObjects(bool forCurrentRunOnly)
 	}
 }
 
+void Simulation::SimplifyObjectsForCurrentRun()
+{
+	if (!_runSimplificationCache.IsValid())
+	{
+		//first run: simplify everything and cache the results
+		_runSimplificationCache.SaveFormulaState();
+		SimplifyObjects(true);
+		_runSimplificationCache.Update();
+		return;
+	}
+
+	_runSimplificationCache.SimplifyChangedObjects();
+
+	//formulas of switches are simplified as in SimplifyObjects
+	for(int i=0; i<_switches.size(); i++)
+		_switches[i]->SimplifyFormulas(true);
+}
+
 string Simulation::GetObjectPathDelimiter(void) const
 {
 	return _objectPathDelimiter;
@@ -624,22 +1302,8 @@ void Simulation::RedimAndInitValues (int numberOfTimePoints,
 	if (numberOfTimePoints<2) //should never happen
 		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "At least one time step for performing simulation required");
 
-	//set number of output time points
-	_numberOfTimePoints = numberOfTimePoints;
-
-	//---- redim time values vector
-	if (m_TimeValues != NULL)
-	{
-		delete[] m_TimeValues;
-		m_TimeValues = NULL;
-	}
-	
-	m_TimeValues = new double[numberOfTimePoints];
-	if (!m_TimeValues)
-		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,"Cannot allocate memory for time values vector");
-
-	//set initial time
-	m_TimeValues[0] = GetStartTime();
+	//---- redim time values vector and set initial time
+	_runContext.RedimTimeValues(numberOfTimePoints, GetStartTime());
 
 	//---- redim species values vector and set their initial value
 	for(i=0; i<_species.size(); i++)
@@ -709,7 +1373,6 @@ double * Simulation::GetDEInitialValues ()
 	
 	try
 	{
-		unsigned int i,j;
 		int k;
 
 		//allocate memory (must be released by caller!)
@@ -721,29 +1384,19 @@ double * Simulation::GetDEInitialValues ()
 		for(k=0; k<m_ODE_NumUnknowns; k++)
 			initialvalues[k] = MathHelper::GetNaN();
 
-		//loop through all hierarchical formula objects according to their level
-		//(starting with independent objects)
-		//For every HFObject, which is species and not constant during simulation:
+		//loop through all DE variables according to the hierarchy level of their 
+		//initial value formulas (starting with independent objects):
 		//  get species initial value and put it into the array
-		for(i=0; i<_leveledHierarchicalFormulaObjects.size(); i++)
+		//Initial values which could be simplified for the current run are just read
+		for(size_t i=0; i<_leveledDEVariables.size(); i++)
 		{
-			for(j=0; j<_leveledHierarchicalFormulaObjects[i].size(); j++)
-			{
-				HierarchicalFormulaObject * HFObject = _leveledHierarchicalFormulaObjects[i][j];
+			Species * species = _leveledDEVariables[i];
 
-				Species * species = dynamic_cast<Species *>(HFObject);
-				if (!species)
-					continue; //not a species (parameter, etc.)
+			int speciesDEIndex = species->GetODEIndex();
+			assert(speciesDEIndex != DE_INVALID_INDEX);
+			assert((speciesDEIndex>=0) && (speciesDEIndex<m_ODE_NumUnknowns));
 
-				if (species->IsConstantDuringCalculation())
-					continue; //is not part of ode system
-
-				int speciesDEIndex = species->GetODEIndex();
-				assert(speciesDEIndex != DE_INVALID_INDEX);
-				assert((speciesDEIndex>=0) && (speciesDEIndex<m_ODE_NumUnknowns));
-
-				initialvalues[speciesDEIndex] = species->GetInitialValue(initialvalues, GetStartTime());
-			}
+			initialvalues[speciesDEIndex] = species->GetInitialValue(initialvalues, GetStartTime());
 		}
 		
 		//perform some checks of initial values
@@ -805,34 +1458,40 @@ Species * Simulation::GetDEVariableFromIndex (int DESpeciesIndex)
 	return species;
 }
 
-bool Simulation::PerformSwitchUpdate (double * y, double time)
+bool Simulation::PerformSwitchUpdate (double * y, double time, bool & solverRestartRequired)
 {
 	bool switchUpdate = false;
+	solverRestartRequired = false;
+
+	SwitchSchedule & switchSchedule = _runContext.GetSwitchSchedule();
+
+	if (switchSchedule.IsCompiled())
+		return switchSchedule.PerformSwitchUpdate(_switches, y, time, solverRestartRequired);
 
 	for(int i=0; i<_switches.size(); i++)
-		switchUpdate |= _switches[i]->PerformSwitchUpdate(y, time);
+		switchUpdate |= _switches[i]->PerformSwitchUpdate(y, time, solverRestartRequired);
 	
 	return switchUpdate;
 }
 
 void Simulation::Cancel()
 {
-	_cancelFlag = true;
+	_runContext.Cancel();
 }
 
 bool Simulation::GetCancelFlag ()
 {
-	return _cancelFlag;
+	return _runContext.IsCanceled();
 }
 
 long Simulation::GetProgress ()
 {
-	return _progress;
+	return _runContext.Progress();
 }
 
 void Simulation::SetProgress (long progress)
 {
-	_progress = progress;
+	_runContext.SetProgress(progress);
 }
 
 void Simulation::AddToLog (const string & msg, bool PrintTime /*= false*/, bool FirstLogEntry /*= false*/)
@@ -875,7 +1534,7 @@ void Simulation::AddToLog (const string & msg, bool PrintTime /*= false*/, bool
 
 void Simulation::AddWarning(const std::string & msg, double solverTime)
 {
-	_solverWarnings.push_back(new SolverWarning(solverTime,msg));
+	_runContext.AddWarning(msg, solverTime);
 }
 
 //<sensitivityValues> has dimensions [NoOf_ODE_Variables] x [NoOf_Sensitivity_Parameters]
@@ -991,33 +1650,24 @@ void Simulation::SetObserverValues(int index, const double * y, const double tim
 
 void Simulation::SetTimeValue (int index, double value)
 {
-	assert((index>=0) && (index<_numberOfTimePoints));
-    m_TimeValues[index] = value;
-    
-    m_TimeLatestIndex = index;
+	_runContext.SetTimeValue(index, value);
 }
 
 void Simulation::RunSimulation (bool & toleranceWasReduced, double & newAbsTol, double & newRelTol)
 {
 	const char * ERROR_SOURCE = "Simulation::RunSimulation";
+	ActiveOperation activeOperation(_numberOfActiveOperations);
+
+	//quantity values, switch states and solver data are stored in the model objects (s. RunContext)
+	if (!_runContext.TryStartRun())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, 
+		                "Simulation is already running - concurrent runs require separate simulation instances (s. Clone)");
 
 	try
 	{	
 		toleranceWasReduced=false;
 		
-		_solverWarnings.clear();
-
-		if (!_isFinalized)
-			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation is not finalized");
-		
-		AddToLog("Starting simulation run...", true);
-		
-		_cancelFlag = false;
-		_progress = 0;
-		
-		//simplify parameters that could not be simplified earlier (in Finalize)
-		//(e.g. parameters that depend on not fixed constant parameters)
-		SimplifyObjects(true);
+		prepareRun();
 		
 		AddToLog("Params simplified, starting solving ODE...", true);
 		
@@ -1051,7 +1701,7 @@ void Simulation::RunSimulation (bool & toleranceWasReduced, double & newAbsTol,
 					ResetState();
 
                //reset solver warnings
-               _solverWarnings.clear();
+               _runContext.ClearSolverWarnings();
 				}
 				else
 					throw;
@@ -1063,19 +1713,22 @@ void Simulation::RunSimulation (bool & toleranceWasReduced, double & newAbsTol,
 		//reset simulation state (parameter values changed by switches etc.)
 		ResetState();
 		
-		_progress = 100;
+		_runContext.SetProgress(100);
 		
 		AddToLog("Simulation finished!", true);
 
 		newAbsTol = m_Solver.GetSolverProperties().GetAbsTol();
 		newRelTol = m_Solver.GetSolverProperties().GetRelTol();
+
+		_runContext.FinishRun();
 	}
 	catch(ErrorData &)
 	{
 		//reset simulation state (parameter values changed by switches etc.)
 		ResetState();
 		
-		_progress = 100;
+		_runContext.SetProgress(100);
+		_runContext.FinishRun();
 		throw;
 	}
 	catch(SimModelSolverErrorData & SED)
@@ -1083,7 +1736,8 @@ void Simulation::RunSimulation (bool & toleranceWasReduced, double & newAbsTol,
 		//reset simulation state (parameter values changed by switches etc.)
 		ResetState();
 		
-	    _progress = 100;
+		_runContext.SetProgress(100);
+		_runContext.FinishRun();
 		throw ErrorData(ErrorData::ED_ERROR, SED.GetSource(), SED.GetDescription());
 	}
 	catch(...)
@@ -1091,11 +1745,34 @@ void Simulation::RunSimulation (bool & toleranceWasReduced, double & newAbsTol,
 		//reset simulation state (parameter values changed by switches etc.)
 		ResetState();
 		
-		_progress = 100;
+		_runContext.SetProgress(100);
+		_runContext.FinishRun();
 		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,"Unknown Error occured during solving of the ODE system");
 	}
 }
 
+void Simulation::prepareRun()
+{
+	const char * ERROR_SOURCE = "Simulation::prepareRun";
+
+	//clears warnings and statistics of the previous run, resets progress and cancellation flag
+	_runContext.Reset();
+
+	if (!_isFinalized)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation is not finalized");
+	
+	AddToLog("Starting simulation run...", true);
+	
+	//simplify parameters that could not be simplified earlier (in Finalize)
+	//(e.g. parameters that depend on not fixed constant parameters)
+	SimplifyObjectsForCurrentRun();
+
+	//switches with time-only conditions are fired from the schedule
+	SwitchSchedule & switchSchedule = _runContext.GetSwitchSchedule();
+	switchSchedule.Compile(_switches);
+	_runContext.RunStatistics().SetScheduledSwitches(switchSchedule.NumberOfScheduledSwitches());
+}
+
 void Simulation::ResetState()
 {
 	int i;
@@ -1109,12 +1786,12 @@ void Simulation::ResetState()
 
 double * Simulation::GetTimeValues ()
 {
-	return m_TimeValues;
+	return _runContext.TimeValues();
 }
 
 int Simulation::GetNumberOfTimePoints ()
 {
-	return _numberOfTimePoints;
+	return _runContext.NumberOfTimePoints();
 }
 
 void Simulation::FinalizeSwitches()
@@ -1125,7 +1802,7 @@ void Simulation::FinalizeSwitches()
 
 const TObjectVector<SolverWarning> & Simulation::SolverWarnings() const
 {
-	return _solverWarnings;
+	return _runContext.SolverWarnings();
 }
 
 bool Simulation::IsFinalized ()
@@ -1188,6 +1865,9 @@ void Simulation::FillParameterProperties(vector<ParameterInfo> & paramProperties
 				if (!parameter)
 					throw ErrorData(ErrorData::ED_ERROR,ERROR_SOURCE,"Cannot get parameter from id " +XMLHelper::ToString(parameterInfo.GetId()));
 
+				//formula of a parameter not used in the simulation might not be finalized yet
+				finalizeDeferredFormula(parameter->GetFormula());
+
 				parameter->FillInfo(parameterInfo, speciesInitialValues,simStartTime);
 			}
 
@@ -1373,72 +2053,28 @@ std::string Simulation::GetSimulationXMLString ()
 		if (m_XMLString=="")
 			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Simulation XML String is empty");
 
-		// Create XML DOM
-		XMLDocument pXMLDoc = XMLDocument::FromString(m_XMLString);
-		assert(!pXMLDoc.IsNull());
-
-		// Get "<Simulation>" tag
-		XMLNode oSimNode = pXMLDoc.GetRootElement();
-		while (!oSimNode.IsNull() && !oSimNode.HasName(XMLConstants::Simulation))
-			oSimNode = oSimNode.GetNextSibling();
-
-		// If this didn't work for some reason...
-		if (oSimNode.IsNull())
-			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unable to find node <Simulation> in the XML string");
-
-		XMLNode formulaListNode = oSimNode.GetChildNode(XMLConstants::FormulaList);
-		XMLNode speciesListNode = oSimNode.GetChildNode(XMLConstants::VariableList);
-		XMLNode parametersListNode = oSimNode.GetChildNode(XMLConstants::ParameterList);
+		//original XML is indexed once; every call copies it with the current values
+		//of the simulation objects instead of updating an XML DOM
+		if (!_xmlWriter)
+			_xmlWriter = make_shared <SimulationXMLWriter> (m_XMLString);
 
 		//Update parameter values in XML
 		int idx;
 
 		for(idx=0; idx<_parameters.size(); idx++)
-			_parameters[idx]->UpdateFormulaInXMLNode(formulaListNode, parametersListNode);
+			_parameters[idx]->UpdateFormulaInXML(*_xmlWriter);
 
       for (idx = 0; idx < _species.size(); idx++)
       {
-         _species[idx]->UpdateFormulaInXMLNode(formulaListNode, speciesListNode);
+         _species[idx]->UpdateFormulaInXML(*_xmlWriter);
          //also update the scale factor in the XML node.
-         _species[idx]->UpdateScaleFactorInXMLNode(speciesListNode);
+         _species[idx]->UpdateScaleFactorInXML(*_xmlWriter);
       }
 
-		XMLNode outputSchemaNode = oSimNode.GetChildNode(XMLConstants::OutputSchema);
-		
-		//---- remove <OutputIntervalList> subnode from xml (if exists)
-		XMLNode intervalsNode = outputSchemaNode.GetChildNode(XMLConstants::OutputIntervalList);
-		if (!intervalsNode.IsNull())
-			outputSchemaNode.RemoveChildNode(intervalsNode);
-
-		//---- remove <OutputTimeList> subnode from xml (if exists)
-		XMLNode pointsNode = outputSchemaNode.GetChildNode(XMLConstants::OutputTimeList);
-		if (!pointsNode.IsNull())
-			outputSchemaNode.RemoveChildNode(pointsNode);
-
-		//---- add new intervals to xml
-		intervalsNode = outputSchemaNode.CreateChildNode(XMLConstants::OutputIntervalList);
-
-		for (int intervalIdx = 0; intervalIdx < _outputSchema.OutputIntervals().size(); intervalIdx++)
-		{
-			OutputInterval * interval = _outputSchema.OutputIntervals()[intervalIdx];
-
-			XMLNode intervalNode = intervalsNode.CreateChildNode(XMLConstants::OutputInterval);
-
-			intervalNode.SetAttribute(XMLConstants::Distribution,
-				interval->IntervalDistribution() == OutputIntervalDistribution::Equidistant ?
-				XMLConstants::DistributionEquidistant : XMLConstants::DistributionLogarithmic);
-
-			intervalNode.CreateChildNode(XMLConstants::StartTime).SetValue(interval->StartTime());
-			intervalNode.CreateChildNode(XMLConstants::EndTime).SetValue(interval->EndTime());
-			intervalNode.CreateChildNode(XMLConstants::NumberOfTimePoints).SetValue(interval->NumberOfTimePoints());
-		}
-
-		m_XMLString = pXMLDoc.ToString();
-
-		//Release Doc
-		pXMLDoc.Release();
+		//---- replace output intervals/time points of the original XML by the current intervals
+		_xmlWriter->SetOutputIntervals(_outputSchema);
 
-		return m_XMLString;
+		return _xmlWriter->Write();
 	}
 	catch(ErrorData &)
 	{
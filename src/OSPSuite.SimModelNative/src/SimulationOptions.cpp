@@ -19,6 +19,20 @@ SimulationOptions::SimulationOptions(void)
 	                              //only required from Matlab/R and can be set = true in SimModelComp
 
 	_useFloatComparisonInUserOutputTimePoints = true; //default for PK-Sim/MoBi
+
+	_autoSolverConfiguration = false; //use BDF and dense/band linear solver as set by user
+
+	_solveLinearSystemsExactly = false;
+
+	_streamingXMLLoad = false; //keep the XML DOM (required for cloning)
+
+	_numberOfFinalizeThreads = 1; //finalize formulas sequentially
+
+	_useEquationCache = false; //parse equations of every simulation
+
+	_lazyFinalize = false; //finalize all formulas
+
+	_leanMode = false; //keep the XML DOM (required for cloning)
 }
 
 void SimulationOptions::CopyFrom(SimulationOptions & srcOptions)
@@ -32,6 +46,13 @@ void SimulationOptions::CopyFrom(SimulationOptions & srcOptions)
 	_keepXMLNodeAsString = srcOptions.KeepXMLNodeAsString();
 	_useFloatComparisonInUserOutputTimePoints = srcOptions.UseFloatComparisonInUserOutputTimePoints();
 	_identifyUsedParameters = srcOptions.IdentifyUsedParameters();
+	_autoSolverConfiguration = srcOptions.AutoSolverConfiguration();
+	_solveLinearSystemsExactly = srcOptions.SolveLinearSystemsExactly();
+	_streamingXMLLoad = srcOptions.StreamingXMLLoad();
+	_numberOfFinalizeThreads = srcOptions.NumberOfFinalizeThreads();
+	_useEquationCache = srcOptions.UseEquationCache();
+	_lazyFinalize = srcOptions.LazyFinalize();
+	_leanMode = srcOptions.LeanMode();
 }
 
 void SimulationOptions::WriteLogFile(bool writeLogFile)
@@ -135,5 +156,75 @@ void SimulationOptions::SetUseFloatComparisonInUserOutputTimePoints(bool useFloa
 	_useFloatComparisonInUserOutputTimePoints = useFloatComparisonInOutputSchema;
 }
 
+bool SimulationOptions::AutoSolverConfiguration() const
+{
+	return _autoSolverConfiguration;
+}
+
+void SimulationOptions::SetAutoSolverConfiguration(bool autoSolverConfiguration)
+{
+	_autoSolverConfiguration = autoSolverConfiguration;
+}
+
+bool SimulationOptions::SolveLinearSystemsExactly() const
+{
+	return _solveLinearSystemsExactly;
+}
+
+void SimulationOptions::SetSolveLinearSystemsExactly(bool solveLinearSystemsExactly)
+{
+	_solveLinearSystemsExactly = solveLinearSystemsExactly;
+}
+
+bool SimulationOptions::StreamingXMLLoad() const
+{
+	return _streamingXMLLoad;
+}
+
+void SimulationOptions::SetStreamingXMLLoad(bool streamingXMLLoad)
+{
+	_streamingXMLLoad = streamingXMLLoad;
+}
+
+int SimulationOptions::NumberOfFinalizeThreads() const
+{
+	return _numberOfFinalizeThreads;
+}
+
+void SimulationOptions::SetNumberOfFinalizeThreads(int numberOfFinalizeThreads)
+{
+	_numberOfFinalizeThreads = numberOfFinalizeThreads;
+}
+
+bool SimulationOptions::UseEquationCache() const
+{
+	return _useEquationCache;
+}
+
+void SimulationOptions::SetUseEquationCache(bool useEquationCache)
+{
+	_useEquationCache = useEquationCache;
+}
+
+bool SimulationOptions::LazyFinalize() const
+{
+	return _lazyFinalize;
+}
+
+void SimulationOptions::SetLazyFinalize(bool lazyFinalize)
+{
+	_lazyFinalize = lazyFinalize;
+}
+
+bool SimulationOptions::LeanMode() const
+{
+	return _leanMode;
+}
+
+void SimulationOptions::SetLeanMode(bool leanMode)
+{
+	_leanMode = leanMode;
+}
+
 
 }//.. end "namespace SimModelNative"
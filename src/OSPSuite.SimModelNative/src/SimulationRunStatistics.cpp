@@ -0,0 +1,138 @@
+#include "SimModel/SimulationRunStatistics.h"
+#include "SimModel/MathHelper.h"
+
+namespace SimModelNative
+{
+
+SimulationRunStatistics::SimulationRunStatistics(void)
+{
+	Reset();
+}
+
+void SimulationRunStatistics::Reset()
+{
+	_setupTime = 0.0;
+	_solveTime = 0.0;
+	_solverInstanceReused = false;
+	_avoidedSolverRestarts = 0;
+	_scheduledSwitches = 0;
+	_bandLinearSolverUsed = false;
+	_lowerHalfBandWidth = 0;
+	_upperHalfBandWidth = 0;
+	_adamsMethodUsed = false;
+	_spectralRadiusEstimate = MathHelper::GetNaN();
+	_bdfSwitchTime = MathHelper::GetNaN();
+	_linearSystemSolvedExactly = false;
+}
+
+double SimulationRunStatistics::SetupTime() const
+{
+	return _setupTime;
+}
+
+void SimulationRunStatistics::AddSetupTime(double setupTime)
+{
+	//setup and solve times are accumulated over all solving attempts
+	//of one run (e.g. if tolerances were reduced)
+	_setupTime += setupTime;
+}
+
+double SimulationRunStatistics::SolveTime() const
+{
+	return _solveTime;
+}
+
+void SimulationRunStatistics::AddSolveTime(double solveTime)
+{
+	_solveTime += solveTime;
+}
+
+bool SimulationRunStatistics::SolverInstanceReused() const
+{
+	return _solverInstanceReused;
+}
+
+void SimulationRunStatistics::SetSolverInstanceReused(bool solverInstanceReused)
+{
+	_solverInstanceReused = solverInstanceReused;
+}
+
+int SimulationRunStatistics::AvoidedSolverRestarts() const
+{
+	return _avoidedSolverRestarts;
+}
+
+void SimulationRunStatistics::IncrementAvoidedSolverRestarts()
+{
+	_avoidedSolverRestarts++;
+}
+
+int SimulationRunStatistics::ScheduledSwitches() const
+{
+	return _scheduledSwitches;
+}
+
+void SimulationRunStatistics::SetScheduledSwitches(int scheduledSwitches)
+{
+	_scheduledSwitches = scheduledSwitches;
+}
+
+bool SimulationRunStatistics::BandLinearSolverUsed() const
+{
+	return _bandLinearSolverUsed;
+}
+
+int SimulationRunStatistics::LowerHalfBandWidth() const
+{
+	return _lowerHalfBandWidth;
+}
+
+int SimulationRunStatistics::UpperHalfBandWidth() const
+{
+	return _upperHalfBandWidth;
+}
+
+bool SimulationRunStatistics::AdamsMethodUsed() const
+{
+	return _adamsMethodUsed;
+}
+
+void SimulationRunStatistics::SetSolverConfiguration(bool bandLinearSolverUsed, int lowerHalfBandWidth, int upperHalfBandWidth, bool adamsMethodUsed)
+{
+	_bandLinearSolverUsed = bandLinearSolverUsed;
+	_lowerHalfBandWidth = bandLinearSolverUsed ? lowerHalfBandWidth : 0;
+	_upperHalfBandWidth = bandLinearSolverUsed ? upperHalfBandWidth : 0;
+	_adamsMethodUsed = adamsMethodUsed;
+}
+
+double SimulationRunStatistics::SpectralRadiusEstimate() const
+{
+	return _spectralRadiusEstimate;
+}
+
+void SimulationRunStatistics::SetSpectralRadiusEstimate(double spectralRadiusEstimate)
+{
+	_spectralRadiusEstimate = spectralRadiusEstimate;
+}
+
+double SimulationRunStatistics::BDFSwitchTime() const
+{
+	return _bdfSwitchTime;
+}
+
+void SimulationRunStatistics::SetBDFSwitchTime(double bdfSwitchTime)
+{
+	_bdfSwitchTime = bdfSwitchTime;
+}
+
+bool SimulationRunStatistics::LinearSystemSolvedExactly() const
+{
+	return _linearSystemSolvedExactly;
+}
+
+void SimulationRunStatistics::SetLinearSystemSolvedExactly(bool linearSystemSolvedExactly)
+{
+	_linearSystemSolvedExactly = linearSystemSolvedExactly;
+}
+
+}//.. end "namespace SimModelNative"
@@ -270,6 +270,69 @@ void SimulationTask::MarkUsedParameters(Simulation * sim)
 	}
 }
 
+set<Formula *> SimulationTask::FormulasUsedInSimulation(Simulation * sim)
+{
+	set<Formula *> usedFormulas;
+	set<int> usedParameterIds;
+	int idx;
+
+	//parameters used by a formula are appended recursively (s. QuantityReference::AppendUsedParameters)
+	auto appendFormula = [&](Formula * formula)
+	{
+		if (formula == NULL)
+			return;
+
+		if (usedFormulas.insert(formula).second)
+			formula->AppendUsedParameters(usedParameterIds);
+	};
+
+	TObjectList<Species> & species = sim->SpeciesList();
+	for (idx = 0; idx < species.size(); idx++)
+	{
+		appendFormula(species[idx]->GetInitialFormula());
+
+		TObjectList<Formula> & rhsFormulas = species[idx]->RHSFormulaList();
+		for (int i = 0; i < rhsFormulas.size(); i++)
+			appendFormula(rhsFormulas[i]);
+	}
+
+	TObjectList<Observer> & observers = sim->Observers();
+	for (idx = 0; idx < observers.size(); idx++)
+	{
+		appendFormula(observers[idx]->getValueFormula());
+	}
+
+	//all switches, even if they will never fire (s. Switch::Finalize)
+	TObjectList<Switch> & switches = sim->Switches();
+	for (idx = 0; idx < switches.size(); idx++)
+	{
+		appendFormula(switches[idx]->GetConditionFormula());
+
+		TObjectVector<FormulaChange> & formulaChanges = switches[idx]->FormulaChanges();
+		for (int i = 0; i < formulaChanges.size(); i++)
+			appendFormula(formulaChanges[i]->GetNewFormula());
+	}
+
+	//persistable parameters will become observers (s. Simulation::CreateObserversForPersistableParameters)
+	TObjectList<Parameter> & parameters = sim->Parameters();
+	for (idx = 0; idx < parameters.size(); idx++)
+	{
+		if (parameters[idx]->IsPersistable())
+			appendFormula(parameters[idx]->GetFormula());
+	}
+
+	//value formulas of used parameters (parameters used by them are already contained in <usedParameterIds>)
+	for (set<int>::const_iterator iter = usedParameterIds.begin(); iter != usedParameterIds.end(); iter++)
+	{
+		Parameter * parameter = parameters.GetObjectById(*iter);
+
+		if ((parameter != NULL) && (parameter->GetFormula() != NULL))
+			usedFormulas.insert(parameter->GetFormula());
+	}
+
+	return usedFormulas;
+}
+
 string SimulationTask::GetErrorMessageForNegativeVariables(const vector<string> & positiveVariablesWithNegativeValues, double solverOutputTime)
 {
 	string msg;
@@ -317,6 +380,39 @@ void SimulationTask::CacheRHSUsedVariables(Simulation * sim)
 	//WriteRHSDependencyMatrix("C:\\VSS\\SimModel\\trunk\\Test\\TestForPurify\\RHSDepMatrix.txt");
 }
 
+bool SimulationTask::ODESystemIsLinear(Simulation * sim)
+{
+	int i, j;
+
+	//sensitivity equations are not supported by the linear solver
+	if (sim->SensitivityParameters().size() > 0)
+		return false;
+
+	for (i = 0; i < sim->GetODENumUnknowns(); i++)
+	{
+		if (!sim->GetDEVariableFromIndex(i)->HasLinearRHS())
+			return false;
+	}
+
+	//new values of species are applied once at the switch time; all other
+	//quantities must remain constant until the next switch
+	for (i = 0; i < sim->Switches().size(); i++)
+	{
+		TObjectVector<FormulaChange> & formulaChanges = sim->Switches()[i]->FormulaChanges();
+		for (j = 0; j < formulaChanges.size(); j++)
+		{
+			FormulaChange * formulaChange = formulaChanges[j];
+			if (formulaChange->UseAsValue() || (dynamic_cast<Species *>(formulaChange->GetQuantity()) != NULL))
+				continue;
+
+			if (formulaChange->GetNewFormula()->Linearity() != FL_CONSTANT)
+				return false;
+		}
+	}
+
+	return true;
+}
+
 //for debug only: write out RHS dependency matrix
 void SimulationTask::WriteRHSDependencyMatrix(Simulation * sim, const string & filename)
 {
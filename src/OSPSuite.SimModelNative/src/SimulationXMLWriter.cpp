@@ -0,0 +1,468 @@
+#include "SimModel/SimulationXMLWriter.h"
+#include "SimModel/GlobalConstants.h"
+#include "SimModel/MathHelper.h"
+#include "XMLWrapper/XMLHelper.h"
+#include "ErrorData.h"
+
+#include <cstdlib>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+static bool isXMLSpace(char c)
+{
+	return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+SimulationXMLWriter::SimulationXMLWriter(const string & xml) :
+	_xml(xml)
+{
+	_outputSchemaEnd.start = _outputSchemaEnd.end = 0;
+	_simulationElement.start = _simulationElement.end = 0;
+	_hasOutputSchema = false;
+	_outputSchemaIsEmptyElement = false;
+
+	index();
+}
+
+string SimulationXMLWriter::localNameOf(const string & name)
+{
+	size_t colon = name.find(':');
+
+	return (colon == string::npos) ? name : name.substr(colon + 1);
+}
+
+size_t SimulationXMLWriter::skipBehind(size_t position, const string & delimiter) const
+{
+	size_t delimiterPosition = _xml.find(delimiter, position);
+
+	if (delimiterPosition == string::npos)
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationXMLWriter::skipBehind",
+		                "Unexpected end of the simulation XML (missing \"" + delimiter + "\")");
+
+	return delimiterPosition + delimiter.size();
+}
+
+bool SimulationXMLWriter::nextTag(size_t & position, Tag & tag) const
+{
+	const char * ERROR_SOURCE = "SimulationXMLWriter::nextTag";
+
+	for (;;)
+	{
+		size_t start = _xml.find('<', position);
+		if (start == string::npos)
+			return false;
+
+		if (_xml.compare(start, 4, "<!--") == 0)
+		{
+			position = skipBehind(start + 4, "-->");
+			continue;
+		}
+
+		if (_xml.compare(start, 9, "<![CDATA[") == 0)
+		{
+			position = skipBehind(start + 9, "]]>");
+			continue;
+		}
+
+		if (_xml.compare(start, 2, "<?") == 0)
+		{
+			position = skipBehind(start + 2, "?>");
+			continue;
+		}
+
+		if (_xml.compare(start, 2, "<!") == 0)
+		{
+			//document type declaration, possibly with internal subset
+			size_t subsetStart = _xml.find('[', start);
+			size_t declarationEnd = _xml.find('>', start);
+
+			if ((subsetStart != string::npos) && (subsetStart < declarationEnd))
+				position = skipBehind(skipBehind(subsetStart, "]"), ">");
+			else
+				position = skipBehind(start, ">");
+
+			continue;
+		}
+
+		//---- start or end tag
+		size_t current = start + 1;
+
+		tag.start = start;
+		tag.isEndTag = (current < _xml.size()) && (_xml[current] == '/');
+		if (tag.isEndTag)
+			current++;
+
+		size_t nameStart = current;
+		while ((current < _xml.size()) && !isXMLSpace(_xml[current]) && (_xml[current] != '>') && (_xml[current] != '/'))
+			current++;
+
+		tag.nameEnd = current;
+		tag.name = _xml.substr(nameStart, current - nameStart);
+
+		//attribute values can contain '>'
+		char quote = 0;
+		for (; current < _xml.size(); current++)
+		{
+			char c = _xml[current];
+
+			if (quote != 0)
+			{
+				if (c == quote)
+					quote = 0;
+			}
+			else if ((c == '"') || (c == '\''))
+				quote = c;
+			else if (c == '>')
+				break;
+		}
+
+		if ((current >= _xml.size()) || tag.name.empty())
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,
+			                "Invalid tag at position " + to_string(start) + " of the simulation XML");
+
+		tag.isEmptyElement = !tag.isEndTag && (_xml[current - 1] == '/');
+		tag.end = current + 1;
+
+		position = tag.end;
+
+		return true;
+	}
+}
+
+bool SimulationXMLWriter::findAttribute(const Tag & tag, const string & attributeName, TextRange & valueRange, size_t * attributeStart) const
+{
+	size_t current = tag.nameEnd;
+	const size_t attributesEnd = tag.end - (tag.isEmptyElement ? 2 : 1);
+
+	for (;;)
+	{
+		while ((current < attributesEnd) && isXMLSpace(_xml[current]))
+			current++;
+
+		if (current >= attributesEnd)
+			return false;
+
+		size_t nameStart = current;
+		while ((current < attributesEnd) && !isXMLSpace(_xml[current]) && (_xml[current] != '='))
+			current++;
+
+		size_t nameEnd = current;
+
+		while ((current < attributesEnd) && (isXMLSpace(_xml[current]) || (_xml[current] == '=')))
+			current++;
+
+		if (current >= attributesEnd)
+			return false;
+
+		char quote = _xml[current];
+		size_t valueEnd = _xml.find(quote, current + 1);
+
+		if ((valueEnd == string::npos) || (valueEnd >= attributesEnd))
+			return false;
+
+		if (_xml.compare(nameStart, nameEnd - nameStart, attributeName) == 0)
+		{
+			valueRange.start = current + 1;
+			valueRange.end = valueEnd;
+
+			if (attributeStart)
+				*attributeStart = nameStart;
+
+			return true;
+		}
+
+		current = valueEnd + 1;
+	}
+}
+
+long SimulationXMLWriter::idOf(const Tag & tag) const
+{
+	TextRange idRange;
+
+	if (!findAttribute(tag, XMLConstants::Id, idRange))
+		return INVALID_QUANTITY_ID;
+
+	//same conversion as XMLNode::GetAttribute
+	return (long)atof(_xml.substr(idRange.start, idRange.end - idRange.start).c_str());
+}
+
+void SimulationXMLWriter::index()
+{
+	const char * ERROR_SOURCE = "SimulationXMLWriter::index";
+
+	vector <OpenElement> openElements;
+	size_t position = 0;
+	Tag tag;
+
+	while (nextTag(position, tag))
+	{
+		if (tag.isEndTag)
+		{
+			if (openElements.empty())
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,
+				                "Unexpected end tag </" + tag.name + "> in the simulation XML");
+
+			TextRange range = { openElements.back().start, tag.end };
+			indexElement(openElements, range);
+
+			if ((openElements.size() == 2) && (openElements.back().localName == XMLConstants::OutputSchema))
+				_outputSchemaEnd.start = _outputSchemaEnd.end = tag.start;
+
+			openElements.pop_back();
+
+			//<Simulation> is complete
+			if (openElements.empty())
+			{
+				_simulationElement = range;
+				return;
+			}
+
+			continue;
+		}
+
+		string localName = localNameOf(tag.name);
+
+		if (openElements.empty())
+		{
+			if (localName != XMLConstants::Simulation)
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unable to find node <Simulation> in the XML string");
+
+			_prefix = tag.name.substr(0, tag.name.size() - localName.size());
+		}
+
+		long id = ((openElements.size() == 2) ? idOf(tag) : INVALID_QUANTITY_ID);
+
+		indexStartTag(openElements, tag, id);
+
+		OpenElement element = { localName, tag.start, id };
+		openElements.push_back(element);
+
+		if (tag.isEmptyElement)
+		{
+			TextRange range = { tag.start, tag.end };
+			indexElement(openElements, range);
+
+			openElements.pop_back();
+
+			if (openElements.empty())
+			{
+				_simulationElement = range;
+				return;
+			}
+		}
+	}
+
+	throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unable to find node <Simulation> in the XML string");
+}
+
+void SimulationXMLWriter::indexStartTag(const vector <OpenElement> & openElements, const Tag & tag, long id)
+{
+	//<openElements> are the parents of the element: <Simulation>, <...List>
+	if (openElements.size() == 1)
+	{
+		if (localNameOf(tag.name) != XMLConstants::OutputSchema)
+			return;
+
+		_hasOutputSchema = true;
+		_outputSchemaIsEmptyElement = tag.isEmptyElement;
+		_outputSchemaName = tag.name;
+
+		if (tag.isEmptyElement)
+		{
+			_outputSchemaEnd.start = tag.end - 2;
+			_outputSchemaEnd.end = tag.end;
+		}
+
+		return;
+	}
+
+	if (openElements.size() != 2)
+		return;
+
+	const string & listName = openElements[1].localName;
+
+	if ((listName != XMLConstants::ParameterList) && (listName != XMLConstants::VariableList))
+		return;
+
+	ValueAttribute valueAttribute;
+	valueAttribute.exists = findAttribute(tag, XMLConstants::Value, valueAttribute.value);
+	valueAttribute.formulaAttributeExists = false;
+
+	if (!valueAttribute.exists)
+	{
+		valueAttribute.value.start = valueAttribute.value.end = tag.nameEnd;
+
+		const string & formulaAttributeName = (listName == XMLConstants::ParameterList) ? 
+		                                      XMLConstants::FormulaId : XMLConstants::InitialValueFormulaId;
+		TextRange formulaId;
+		size_t attributeStart;
+
+		valueAttribute.formulaAttributeExists = findAttribute(tag, formulaAttributeName, formulaId, &attributeStart);
+		if (valueAttribute.formulaAttributeExists)
+		{
+			valueAttribute.formulaAttribute.start = attributeStart;
+			valueAttribute.formulaAttribute.end = formulaId.end + 1; //closing quote
+		}
+	}
+
+	_quantityValues[id] = valueAttribute;
+}
+
+void SimulationXMLWriter::indexElement(const vector <OpenElement> & openElements, const TextRange & range)
+{
+	//<openElements> end with the element itself
+	const size_t depth = openElements.size();
+	const OpenElement & element = openElements.back();
+
+	if ((depth == 3) && (openElements[1].localName == XMLConstants::FormulaList))
+		_formulas[element.id] = range;
+
+	else if ((depth == 3) && (openElements[1].localName == XMLConstants::OutputSchema))
+	{
+		if ((element.localName == XMLConstants::OutputIntervalList) || (element.localName == XMLConstants::OutputTimeList))
+			_outputLists.push_back(range);
+	}
+
+	else if ((depth == 4) && (openElements[1].localName == XMLConstants::VariableList) &&
+	         (element.localName == XMLConstants::ScaleFactor))
+		_scaleFactors[openElements[2].id] = range;
+}
+
+void SimulationXMLWriter::replace(const TextRange & range, const string & text)
+{
+	_replacements[range.start] = make_pair(range.end, text);
+}
+
+void SimulationXMLWriter::SetQuantityValue(long quantityId, double value)
+{
+	auto iter = _quantityValues.find(quantityId);
+
+	//quantity with the given id not found - should never happen
+	if (iter == _quantityValues.end())
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationXMLWriter::SetQuantityValue",
+		                "Quantity with id " + to_string(quantityId) + " not found in the list");
+
+	string valueString = MathHelper::IsNaN(value) ? "NaN" : XMLHelper::ToString(value);
+
+	if (iter->second.exists)
+		replace(iter->second.value, valueString);
+
+	//quantity must not have both formula and value attributes (s. Quantity::XMLFinalizeInstance)
+	else if (iter->second.formulaAttributeExists)
+		replace(iter->second.formulaAttribute, XMLConstants::Value + "=\"" + valueString + "\"");
+
+	else
+		replace(iter->second.value, " " + XMLConstants::Value + "=\"" + valueString + "\"");
+}
+
+void SimulationXMLWriter::SetFormulaValue(long formulaId, double value)
+{
+	auto iter = _formulas.find(formulaId);
+
+	if (iter == _formulas.end())
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationXMLWriter::SetFormulaValue",
+		                "Formula with id " + to_string(formulaId) + " not found");
+
+	//explicit formula with equation=<value> and empty parameter- and variables lists (required by schema)
+	const string explicitFormula = _prefix + XMLConstants::ExplicitFormula;
+	const string equation = _prefix + XMLConstants::Equation;
+
+	replace(iter->second,
+	        "<" + explicitFormula + " " + XMLConstants::Id + "=\"" + to_string(formulaId) + "\">" +
+	        "<" + equation + ">" + XMLHelper::ToString(value) + "</" + equation + ">" +
+	        "<" + _prefix + XMLConstants::ParameterList + "/>" +
+	        "<" + _prefix + XMLConstants::VariableList + "/>" +
+	        "</" + explicitFormula + ">");
+}
+
+void SimulationXMLWriter::SetScaleFactor(long speciesId, double scaleFactor)
+{
+	auto iter = _scaleFactors.find(speciesId);
+
+	if (iter == _scaleFactors.end())
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationXMLWriter::SetScaleFactor",
+		                "Species with id " + to_string(speciesId) + " not found in the list");
+
+	const string scaleFactorName = _prefix + XMLConstants::ScaleFactor;
+
+	replace(iter->second, "<" + scaleFactorName + ">" + XMLHelper::ToString(scaleFactor) + "</" + scaleFactorName + ">");
+}
+
+void SimulationXMLWriter::SetOutputIntervals(OutputSchema & outputSchema)
+{
+	if (!_hasOutputSchema)
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationXMLWriter::SetOutputIntervals",
+		                "Unable to find node <" + XMLConstants::OutputSchema + "> in the XML string");
+
+	//---- remove <OutputIntervalList> and <OutputTimeList>
+	for (size_t i = 0; i < _outputLists.size(); i++)
+		replace(_outputLists[i], "");
+
+	//---- add new intervals
+	const string intervalList = _prefix + XMLConstants::OutputIntervalList;
+	const string intervalName = _prefix + XMLConstants::OutputInterval;
+
+	string intervals = "<" + intervalList + ">";
+
+	for (int intervalIdx = 0; intervalIdx < outputSchema.OutputIntervals().size(); intervalIdx++)
+	{
+		OutputInterval * interval = outputSchema.OutputIntervals()[intervalIdx];
+
+		const string & distribution = interval->IntervalDistribution() == OutputIntervalDistribution::Equidistant ?
+			XMLConstants::DistributionEquidistant : XMLConstants::DistributionLogarithmic;
+
+		intervals += "<" + intervalName + " " + XMLConstants::Distribution + "=\"" + distribution + "\">";
+		intervals += "<" + _prefix + XMLConstants::StartTime + ">" + XMLHelper::ToString(interval->StartTime()) +
+		             "</" + _prefix + XMLConstants::StartTime + ">";
+		intervals += "<" + _prefix + XMLConstants::EndTime + ">" + XMLHelper::ToString(interval->EndTime()) +
+		             "</" + _prefix + XMLConstants::EndTime + ">";
+		intervals += "<" + _prefix + XMLConstants::NumberOfTimePoints + ">" + XMLHelper::ToString(interval->NumberOfTimePoints()) +
+		             "</" + _prefix + XMLConstants::NumberOfTimePoints + ">";
+		intervals += "</" + intervalName + ">";
+	}
+
+	intervals += "</" + intervalList + ">";
+
+	if (_outputSchemaIsEmptyElement)
+		replace(_outputSchemaEnd, ">" + intervals + "</" + _outputSchemaName + ">");
+	else
+		replace(_outputSchemaEnd, intervals);
+}
+
+string SimulationXMLWriter::Write()
+{
+	size_t replacementsSize = 0;
+	for (auto iter = _replacements.begin(); iter != _replacements.end(); iter++)
+		replacementsSize += iter->second.second.size();
+
+	string xml;
+	xml.reserve(_xml.size() + replacementsSize);
+
+	//replaced parts do not overlap
+	size_t position = 0;
+	for (auto iter = _replacements.begin(); iter != _replacements.end(); iter++)
+	{
+		xml.append(_xml, position, iter->first - position);
+		xml += iter->second.second;
+		position = iter->second.first;
+	}
+
+	xml.append(_xml, position, string::npos);
+
+	_replacements.clear();
+
+	return xml;
+}
+
+string SimulationXMLWriter::SimulationElementOf(const string & xml)
+{
+	SimulationXMLWriter writer(xml);
+	const TextRange & range = writer._simulationElement;
+
+	return xml.substr(range.start, range.end - range.start);
+}
+
+}//.. end "namespace SimModelNative"
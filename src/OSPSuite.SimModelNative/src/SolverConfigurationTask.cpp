@@ -0,0 +1,64 @@
+#include "SimModel/SolverConfigurationTask.h"
+#include "SimModel/Simulation.h"
+#include "SimModel/BandwidthReduction.h"
+#include "SimModel/MathHelper.h"
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+//systems smaller than this are always solved with the dense solver
+//(factorization costs are negligible compared to the band solver overhead)
+const int MIN_NUMBER_OF_UNKNOWNS_FOR_BAND_SOLVER = 20;
+
+//band solver must be at least this factor cheaper than the dense solver
+const double BAND_SOLVER_MIN_SPEEDUP = 2.0;
+
+//maximal (spectral radius * time span) of a system considered non-stiff.
+//Adams method needs approx. that many steps just to stay stable
+const double MAX_NONSTIFF_STIFFNESS_INDICATOR = 100.0;
+
+void SolverConfigurationTask::SelectLinearSolver(Simulation * sim)
+{
+	BandwidthReductionTask bandwidthReductionTask(sim);
+	bandwidthReductionTask.EstimateHalfBandWidths();
+
+	int numberOfUnknowns = (int)sim->DE_Variables().size();
+	int lowerHalfBandWidth = bandwidthReductionTask.GetLowerHalfBandWidth();
+	int upperHalfBandWidth = bandwidthReductionTask.GetUpperHalfBandWidth();
+
+	bool useBandLinearSolver = UseBandLinearSolver(numberOfUnknowns, lowerHalfBandWidth, upperHalfBandWidth);
+
+	sim->SetUseBandLinearSolver(useBandLinearSolver);
+
+	sim->AddToLog("Automatic solver configuration: " + MathHelper::ToString(numberOfUnknowns) + " unknowns" +
+		", half bandwidths " + MathHelper::ToString(lowerHalfBandWidth) + "/" + MathHelper::ToString(upperHalfBandWidth) +
+		", density " + MathHelper::ToString(bandwidthReductionTask.GetDensity()) +
+		" => " + (useBandLinearSolver ? "band" : "dense") + " linear solver");
+}
+
+bool SolverConfigurationTask::UseBandLinearSolver(int numberOfUnknowns, int lowerHalfBandWidth, int upperHalfBandWidth)
+{
+	if (numberOfUnknowns < MIN_NUMBER_OF_UNKNOWNS_FOR_BAND_SOLVER)
+		return false;
+
+	double n = numberOfUnknowns;
+
+	//operation counts of the LU factorization
+	double denseCosts = n * n * n / 3.0;
+	double bandCosts = n * (lowerHalfBandWidth + 1.0) * (lowerHalfBandWidth + upperHalfBandWidth + 1.0);
+
+	return bandCosts * BAND_SOLVER_MIN_SPEEDUP < denseCosts;
+}
+
+int SolverConfigurationTask::SelectIntegrationMethod(double spectralRadius, double timeSpan)
+{
+	//spectral radius could not be estimated (e.g. RHS not defined at perturbed values)
+	if (!MathHelper::IsFinite(spectralRadius))
+		return BDF;
+
+	return (spectralRadius * timeSpan <= MAX_NONSTIFF_STIFFNESS_INDICATOR) ? ADAMS : BDF;
+}
+
+}//.. end "namespace SimModelNative"
@@ -4,6 +4,7 @@
 
 #include "SimModel/Species.h"
 #include "SimModel/Simulation.h"
+#include "SimModel/SimulationXMLWriter.h"
 #include <vector>
 #include "XMLWrapper/XMLHelper.h"
 #include "SimModel/SimulationTask.h"
@@ -79,11 +80,13 @@ void Species::LoadFromXMLNode (const XMLNode & pNode)
 
 	_negativeValuesAllowed = (pNode.GetAttribute(XMLConstants::NegativeValuesAllowed, _negativeValuesAllowed ? 1 : 0) == 1);
 
-	if ((_containerPath.find("SalivaGland") != string::npos) ||
-		(_containerPath.find("IgG_Source") != string::npos) ||
-		(_containerPath.find("ParticleBin_") != string::npos)||
-		(_containerPath.find("|Events|") != string::npos) ||
-		(_containerPath.find("|Applications|") != string::npos))
+	const string & containerPath = _containerPath;
+
+	if ((containerPath.find("SalivaGland") != string::npos) ||
+		(containerPath.find("IgG_Source") != string::npos) ||
+		(containerPath.find("ParticleBin_") != string::npos)||
+		(containerPath.find("|Events|") != string::npos) ||
+		(containerPath.find("|Applications|") != string::npos))
 		_negativeValuesAllowed = true;
 }
 
@@ -95,28 +98,9 @@ string Species::getFormulaXMLAttributeName()
 /*
 Update the scale factor value in the XML node of the species.
 */
-void Species::UpdateScaleFactorInXMLNode(const XMLNode & speciesListNode)
+void Species::UpdateScaleFactorInXML(SimulationXMLWriter & xmlWriter)
 {
-   const char * ERROR_SOURCE = "Species::UpdateScaleFactorInXMLNode";
-
-   //Iterate through all species nodes to find the right one.
-   for (XMLNode speciesNode = speciesListNode.GetFirstChild(); !speciesNode.IsNull(); speciesNode = speciesNode.GetNextSibling())
-   {
-      long quantityId = (long)speciesNode.GetAttribute(XMLConstants::Id, INVALID_QUANTITY_ID);
-
-      if (quantityId != _id)
-         continue;
-
-      //Found species node - update the value of the scale factor node.
-      XMLNode scaleFactorNode = speciesNode.GetChildNode(XMLConstants::ScaleFactor);
-      scaleFactorNode.SetValue(m_ODEScaleFactor);
-
-      return;
-   }
-
-   //Species with the stored id not found - should never happen
-   throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE,
-      "Species with id " + _idAsString + " not found in the list");
+   xmlWriter.SetScaleFactor(_id, m_ODEScaleFactor);
 }
 
 void Species::XMLFinalizeInstance (const XMLNode & pNode, Simulation * sim)
@@ -162,6 +146,29 @@ bool Species::IsConstant(bool forCurrentRunOnly)
 	return (Quantity::IsConstant(forCurrentRunOnly) && IsConstantDuringCalculation());
 }
 
+FormulaLinearity Species::Linearity()
+{
+	if (!IsConstantDuringCalculation())
+		return FL_LINEAR; //DE variable
+
+	//constant species: value is given by the initial value
+	if ((_valueFormula == NULL) || (_valueFormula->Linearity() == FL_CONSTANT))
+		return FL_CONSTANT;
+
+	return FL_NONLINEAR;
+}
+
+bool Species::HasLinearRHS()
+{
+	for (int i = 0; i < _rhsFormulaListSize; i++)
+	{
+		if (_rhsFormulaList[i]->Linearity() == FL_NONLINEAR)
+			return false;
+	}
+
+	return true;
+}
+
 double Species::GetValue (const double * y, double time, ScaleFactorUsageMode scaleFactorMode)
 {
 //	assert(_valueFormula==NULL);
@@ -364,6 +371,11 @@ Formula * Species::GetInitialFormula()
 	return  _valueFormula;
 }
 
+TObjectList<Formula> & Species::RHSFormulaList()
+{
+	return _rhsFormulaList;
+}
+
 //will be called between Load and Finalize of the parent simulation
 //must set all properties of the quantity info (name, unit, id, ...)
 //The quantity formula may not be evaluated at this time point
@@ -0,0 +1,108 @@
+#include "SimModel/StringPool.h"
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+StringPool & StringPool::instance()
+{
+	//never destroyed: pooled strings might be released after static destruction
+	static StringPool * pool = new StringPool();
+	return *pool;
+}
+
+StringPool::Shard & StringPool::shardOf(string_view value)
+{
+	return instance()._shards[hash <string_view>()(value) % NUMBER_OF_SHARDS];
+}
+
+shared_ptr <const string> StringPool::Intern(const string & value)
+{
+	Shard & shard = shardOf(value);
+	lock_guard <mutex> lock(shard.mutex);
+
+	auto iter = shard.values.find(string_view(value));
+
+	if (iter != shard.values.end())
+	{
+		shared_ptr <const string> pooledValue = iter->second.lock();
+		if (pooledValue)
+			return pooledValue;
+
+		//last user is just releasing the value (s. release)
+		shard.values.erase(iter);
+	}
+
+	shared_ptr <const string> pooledValue(new string(value), &StringPool::release);
+	shard.values.emplace(string_view(*pooledValue), pooledValue);
+
+	return pooledValue;
+}
+
+void StringPool::release(const string * value)
+{
+	{
+		Shard & shard = shardOf(*value);
+		lock_guard <mutex> lock(shard.mutex);
+
+		//value might have been pooled again in the meantime (s. Intern)
+		auto iter = shard.values.find(string_view(*value));
+		if ((iter != shard.values.end()) && iter->second.expired())
+			shard.values.erase(iter);
+	}
+
+	delete value;
+}
+
+size_t StringPool::Size()
+{
+	StringPool & pool = instance();
+	size_t size = 0;
+
+	for (size_t i = 0; i < NUMBER_OF_SHARDS; i++)
+	{
+		lock_guard <mutex> lock(pool._shards[i].mutex);
+		size += pool._shards[i].values.size();
+	}
+
+	return size;
+}
+
+PooledString::PooledString()
+{
+}
+
+PooledString::PooledString(const string & value)
+{
+	*this = value;
+}
+
+PooledString & PooledString::operator = (const string & value)
+{
+	if (value.empty())
+		_value.reset();
+	else
+		_value = StringPool::Intern(value);
+
+	return *this;
+}
+
+const string & PooledString::Value() const
+{
+	static const string EMPTY_STRING;
+
+	return _value ? *_value : EMPTY_STRING;
+}
+
+PooledString::operator const string & () const
+{
+	return Value();
+}
+
+bool PooledString::IsEmpty() const
+{
+	return !_value;
+}
+
+}//.. end "namespace SimModelNative"
@@ -3,6 +3,7 @@
 #include "XMLWrapper/XMLNode.h"
 #include "SimModel/ConstantFormula.h"
 #include <assert.h>
+#include <algorithm>
 
 namespace SimModelNative
 {
@@ -38,6 +39,15 @@ bool SumFormula::IsZero(void)
 	return true;
 }
 
+FormulaLinearity SumFormula::Linearity()
+{
+	FormulaLinearity linearity = FL_CONSTANT;
+	for (int i=0; i<_noOfSummands; i++)
+		linearity = std::max(linearity, _summandFormulas[i]->Linearity());
+
+	return linearity;
+}
+
 void SumFormula::LoadFromXMLNode (const XMLNode & pNode)
 {
 	// Partial XML
@@ -71,7 +71,7 @@ void Switch::SimplifyFormulas(bool forCurrentRunOnly)
 		_formulaChangeVector[i]->GetNewFormula()->Simplify(forCurrentRunOnly);
 }
 
-bool Switch::PerformSwitchUpdate (double * y, double time)
+bool Switch::PerformSwitchUpdate (double * y, double time, bool & solverRestartRequired)
 {
 	//In OneTime-mode: check if switch was already fired. nothing to do if so
 	if (_oneTime && _wasFired)
@@ -83,17 +83,40 @@ bool Switch::PerformSwitchUpdate (double * y, double time)
 	if (!switchConditionApplies)
 		return false; //switch not active by now
 
+	return FireSwitch(y, time, solverRestartRequired);
+}
+
+bool Switch::PerformScheduledSwitchUpdate (double * y, double time, bool & solverRestartRequired)
+{
+	if (_oneTime && _wasFired)
+		return false;
+
+	return FireSwitch(y, time, solverRestartRequired);
+}
+
+bool Switch::FireSwitch (double * y, double time, bool & solverRestartRequired)
+{
 	//update was-fired flag
 	_wasFired = true;
 
 	bool switchUpdate = false;
 	
 	for(int i=0; i<_formulaChangeVector.size(); i++)
-		switchUpdate |= _formulaChangeVector[i]->PerformSwitchUpdate(y, time);
+		switchUpdate |= _formulaChangeVector[i]->PerformSwitchUpdate(y, time, solverRestartRequired);
 
 	return switchUpdate;
 }
 
+TObjectVector<FormulaChange> & Switch::FormulaChanges()
+{
+	return _formulaChangeVector;
+}
+
+Formula * Switch::GetConditionFormula()
+{
+	return _conditionFormula;
+}
+
 void Switch::Finalize()
 {
 	for(int i=0; i<_formulaChangeVector.size(); i++)
@@ -105,6 +128,11 @@ vector <double> Switch::SwitchTimePoints()
 	return _conditionFormula->SwitchTimePoints();
 }
 
+bool Switch::ScheduledTimePoints(vector <double> & scheduledTimePoints)
+{
+	return _conditionFormula->AppendScheduledTimePoints(scheduledTimePoints);
+}
+
 void Switch::WriteMatlabCode (std::ostream & mrOut)
 {
 	mrOut<<"    switchConditionApplies = ";
@@ -0,0 +1,90 @@
+#ifdef _WINDOWS
+#pragma warning(disable:4786)
+#endif
+
+#include "SimModel/SwitchSchedule.h"
+#include <algorithm>
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+SwitchSchedule::SwitchSchedule(void)
+{
+	_numberOfScheduledSwitches = 0;
+	_isCompiled = false;
+}
+
+void SwitchSchedule::Compile(TObjectList<Switch> & switches)
+{
+	_scheduledSwitches.clear();
+	_conditionalSwitches.clear();
+	_numberOfScheduledSwitches = 0;
+
+	for (int switchIdx = 0; switchIdx < switches.size(); switchIdx++)
+	{
+		vector <double> scheduledTimePoints;
+
+		if (!switches[switchIdx]->ScheduledTimePoints(scheduledTimePoints))
+		{
+			_conditionalSwitches.push_back(switchIdx);
+			continue;
+		}
+
+		for (auto timePoint : scheduledTimePoints)
+			_scheduledSwitches.push_back(make_pair(timePoint, switchIdx));
+
+		_numberOfScheduledSwitches++;
+	}
+
+	//switch condition like "(Time == P1) Or (Time == P2)" with P1 == P2 must be fired only once
+	sort(_scheduledSwitches.begin(), _scheduledSwitches.end());
+	_scheduledSwitches.erase(unique(_scheduledSwitches.begin(), _scheduledSwitches.end()), _scheduledSwitches.end());
+
+	_isCompiled = true;
+}
+
+bool SwitchSchedule::IsCompiled() const
+{
+	return _isCompiled;
+}
+
+int SwitchSchedule::NumberOfScheduledSwitches() const
+{
+	return _numberOfScheduledSwitches;
+}
+
+bool SwitchSchedule::PerformSwitchUpdate(TObjectList<Switch> & switches, double * y, double time, bool & solverRestartRequired)
+{
+	bool switchUpdate = false;
+
+	//switches scheduled for the given time point
+	auto scheduledIt = lower_bound(_scheduledSwitches.begin(), _scheduledSwitches.end(), make_pair(time, -1));
+	auto conditionalIt = _conditionalSwitches.begin();
+
+	//merge scheduled and conditional switches, keeping the switch order
+	while (true)
+	{
+		bool hasScheduled = (scheduledIt != _scheduledSwitches.end()) && (scheduledIt->first == time);
+		bool hasConditional = (conditionalIt != _conditionalSwitches.end());
+
+		if (!hasScheduled && !hasConditional)
+			break;
+
+		if (hasScheduled && (!hasConditional || (scheduledIt->second < *conditionalIt)))
+		{
+			switchUpdate |= switches[scheduledIt->second]->PerformScheduledSwitchUpdate(y, time, solverRestartRequired);
+			scheduledIt++;
+		}
+		else
+		{
+			switchUpdate |= switches[*conditionalIt]->PerformSwitchUpdate(y, time, solverRestartRequired);
+			conditionalIt++;
+		}
+	}
+
+	return switchUpdate;
+}
+
+}//.. end "namespace SimModelNative"
@@ -3,6 +3,8 @@
 #endif
 
 #include "SimModel/SwitchTask.h" 
+#include "SimModel/Simulation.h"
+#include <set>
 
 namespace SimModelNative
 {
@@ -24,4 +26,65 @@ namespace SimModelNative
 		return switchTimePoints;
 	}
 
+	void SwitchTask::AnalyzeSwitchImpact(Simulation * sim)
+	{
+		int idx, switchIdx, changeIdx;
+		set<int> rhsParameterIds;
+
+		//---- collect all parameters used in the RHS
+		//     (values of species constant during calculation are given by their initial formula)
+		TObjectList<Species> & species = sim->SpeciesList();
+		for (idx = 0; idx < species.size(); idx++)
+			species[idx]->AppendUsedParameters(rhsParameterIds, species[idx]->IsConstantDuringCalculation());
+
+		//observers used in other formulas might be used in the RHS indirectly
+		TObjectList<Observer> & observers = sim->Observers();
+		for (idx = 0; idx < observers.size(); idx++)
+		{
+			if (observers[idx]->IsUsedInFormulas())
+				observers[idx]->AppendUsedParameters(rhsParameterIds);
+		}
+
+		//---- if a quantity used in the RHS gets a new formula by a switch, 
+		//     all parameters used in the new formula become RHS parameters as well.
+		//     Repeat until no further parameters were added
+		TObjectList<Switch> & switches = sim->Switches();
+		bool rhsParametersAdded = true;
+
+		while (rhsParametersAdded)
+		{
+			rhsParametersAdded = false;
+
+			for (switchIdx = 0; switchIdx < switches.size(); switchIdx++)
+			{
+				TObjectVector<FormulaChange> & formulaChanges = switches[switchIdx]->FormulaChanges();
+
+				for (changeIdx = 0; changeIdx < formulaChanges.size(); changeIdx++)
+				{
+					FormulaChange * formulaChange = formulaChanges[changeIdx];
+					if (!formulaChange->ChangedQuantityIsUsedInRHS(rhsParameterIds))
+						continue;
+
+					size_t numberOfRHSParameters = rhsParameterIds.size();
+					formulaChange->GetNewFormula()->AppendUsedParameters(rhsParameterIds);
+
+					if (rhsParameterIds.size() > numberOfRHSParameters)
+						rhsParametersAdded = true;
+				}
+			}
+		}
+
+		//---- finally mark all formula changes 
+		for (switchIdx = 0; switchIdx < switches.size(); switchIdx++)
+		{
+			TObjectVector<FormulaChange> & formulaChanges = switches[switchIdx]->FormulaChanges();
+
+			for (changeIdx = 0; changeIdx < formulaChanges.size(); changeIdx++)
+			{
+				FormulaChange * formulaChange = formulaChanges[changeIdx];
+				formulaChange->SetAffectsRHS(formulaChange->ChangedQuantityIsUsedInRHS(rhsParameterIds));
+			}
+		}
+	}
+
 }//.. end "namespace SimModelNative"
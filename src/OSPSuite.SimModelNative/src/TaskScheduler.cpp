@@ -0,0 +1,395 @@
+#include "SimModel/TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WINDOWS
+#include <objbase.h>
+#endif
+
+namespace SimModelNative
+{
+
+using namespace std;
+
+//scheduler and index of the worker running in the current thread (NULL/-1 for all other threads)
+static thread_local TaskScheduler * currentScheduler = NULL;
+static thread_local int currentWorkerIndex = -1;
+
+//interval (in ms) in which a task waiting for another group checks for new tasks
+static const int HELPING_WAIT_INTERVAL = 10;
+
+//-------------------------------------------------------------------------
+//---- TaskGroup
+
+TaskGroup::TaskGroup(void)
+{
+	_numberOfTasks = 0;
+	_numberOfFinishedTasks = 0;
+	_numberOfStolenTasks = 0;
+	_maximumConcurrency = 0;
+	_homeQueue = -1;
+	_cancelFlag = false;
+	_progress = 0;
+}
+
+void TaskGroup::SetMaximumConcurrency(int maximumConcurrency)
+{
+	lock_guard <mutex> lock(_mutex);
+
+	_maximumConcurrency = max(maximumConcurrency, 0);
+
+	//slot 0 is used first
+	_freeSlots.clear();
+	for (int slot = _maximumConcurrency - 1; slot >= 0; slot--)
+		_freeSlots.push_back(slot);
+}
+
+int TaskGroup::MaximumConcurrency() const
+{
+	return _maximumConcurrency;
+}
+
+void TaskGroup::taskSubmitted()
+{
+	lock_guard <mutex> lock(_mutex);
+	_numberOfTasks++;
+}
+
+bool TaskGroup::tryAcquireSlot(int workerIndex, bool stolen, int & slot)
+{
+	lock_guard <mutex> lock(_mutex);
+
+	if (_maximumConcurrency == 0)
+		slot = workerIndex;
+	else
+	{
+		if (_freeSlots.empty())
+			return false;
+
+		slot = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+
+	if (stolen)
+		_numberOfStolenTasks++;
+
+	return true;
+}
+
+bool TaskGroup::taskFinished(int slot)
+{
+	//group might be destroyed as soon as the lock is released (s. Wait)
+	lock_guard <mutex> lock(_mutex);
+	_numberOfFinishedTasks++;
+
+	bool slotReleased = false;
+	if (_maximumConcurrency > 0)
+	{
+		_freeSlots.push_back(slot);
+		slotReleased = true;
+	}
+
+	if (_numberOfFinishedTasks == _numberOfTasks)
+		_allTasksFinished.notify_all();
+
+	return slotReleased;
+}
+
+bool TaskGroup::allTasksFinished()
+{
+	lock_guard <mutex> lock(_mutex);
+	return _numberOfFinishedTasks == _numberOfTasks;
+}
+
+void TaskGroup::Cancel()
+{
+	//running simulations check the group flag (s. RunContext::IsCanceled)
+	_cancelFlag = true;
+}
+
+bool TaskGroup::IsCanceled() const
+{
+	return _cancelFlag;
+}
+
+void TaskGroup::SimulationStarted(Simulation * simulation)
+{
+	lock_guard <mutex> lock(_mutex);
+
+	simulation->GetRunContext().SetExternalCancelFlag(&_cancelFlag);
+	_runningSimulations.insert(simulation);
+}
+
+void TaskGroup::SimulationFinished(Simulation * simulation)
+{
+	lock_guard <mutex> lock(_mutex);
+
+	simulation->GetRunContext().SetExternalCancelFlag(NULL);
+	_runningSimulations.erase(simulation);
+}
+
+long TaskGroup::Progress()
+{
+	lock_guard <mutex> lock(_mutex);
+
+	if (_numberOfTasks == 0)
+		return 100;
+
+	double progress = 100.0 * _numberOfFinishedTasks;
+	for (set <Simulation *>::iterator iter = _runningSimulations.begin(); iter != _runningSimulations.end(); iter++)
+		progress += (*iter)->GetProgress();
+
+	_progress = max(_progress, min((long)(progress / _numberOfTasks), 100L));
+
+	return _progress;
+}
+
+int TaskGroup::NumberOfStolenTasks()
+{
+	lock_guard <mutex> lock(_mutex);
+	return _numberOfStolenTasks;
+}
+
+void TaskGroup::Wait()
+{
+	unique_lock <mutex> lock(_mutex);
+	_allTasksFinished.wait(lock, [this] { return _numberOfFinishedTasks == _numberOfTasks; });
+}
+
+//-------------------------------------------------------------------------
+//---- TaskScheduler
+
+std::atomic<TaskScheduler *> TaskScheduler::_instance(NULL);
+std::mutex TaskScheduler::_instanceMutex;
+
+TaskScheduler & TaskScheduler::GetInstance()
+{
+	TaskScheduler * instance = _instance.load(std::memory_order_acquire);
+	if (instance != NULL)
+		return *instance;
+
+	lock_guard<mutex> lock(_instanceMutex);
+
+	instance = _instance.load(std::memory_order_relaxed);
+	if (instance == NULL)
+	{
+		//never destroyed: joining the workers while the library is unloaded could dead lock
+		instance = new TaskScheduler(max((int)thread::hardware_concurrency(), 1));
+		_instance.store(instance, std::memory_order_release);
+	}
+
+	return *instance;
+}
+
+TaskScheduler::TaskScheduler(int numberOfThreads)
+{
+	_numberOfPendingTasks = 0;
+	_numberOfRunningTasks = 0;
+	_generation = 0;
+	_nextQueue = 0;
+
+	addWorkers(numberOfThreads);
+}
+
+void TaskScheduler::addWorkers(int numberOfThreads)
+{
+	unique_lock <shared_mutex> lock(_queuesMutex);
+
+	const int numberOfExistingThreads = (int)_threads.size();
+
+	for (int i = numberOfExistingThreads; i < numberOfThreads; i++)
+		_queues.push_back(unique_ptr <WorkerQueue> (new WorkerQueue()));
+
+	//new workers start taking tasks as soon as the queues are unlocked
+	for (int workerIndex = numberOfExistingThreads; workerIndex < numberOfThreads; workerIndex++)
+		_threads.push_back(thread(&TaskScheduler::workerLoop, this, workerIndex));
+}
+
+bool TaskScheduler::HasActiveTasks()
+{
+	TaskScheduler * instance = _instance.load(std::memory_order_acquire);
+	if (instance == NULL)
+		return false;
+
+	lock_guard <mutex> lock(instance->_mutex);
+	return (instance->_numberOfPendingTasks > 0) || (instance->_numberOfRunningTasks > 0);
+}
+
+int TaskScheduler::NumberOfThreads() const
+{
+	shared_lock <shared_mutex> lock(_queuesMutex);
+	return (int)_threads.size();
+}
+
+void TaskScheduler::EnsureNumberOfThreads(int numberOfThreads)
+{
+	if (numberOfThreads > NumberOfThreads())
+		addWorkers(numberOfThreads);
+}
+
+void TaskScheduler::notifyTaskAvailable()
+{
+	{
+		lock_guard <mutex> lock(_mutex);
+		_generation++;
+	}
+	_taskAvailable.notify_all();
+}
+
+void TaskScheduler::Submit(TaskGroup & group, const Task & task, TaskPriority priority /*= TP_BATCH*/)
+{
+	group.taskSubmitted();
+
+	ScheduledTask scheduledTask;
+	scheduledTask.task = task;
+	scheduledTask.group = &group;
+
+	{
+		shared_lock <shared_mutex> queuesLock(_queuesMutex);
+
+		if (currentScheduler == this)
+			scheduledTask.queue = currentWorkerIndex;
+		else
+		{
+			lock_guard <mutex> groupLock(group._mutex);
+			if (group._homeQueue < 0)
+				group._homeQueue = (int)(_nextQueue++ % _queues.size());
+			scheduledTask.queue = group._homeQueue;
+		}
+
+		WorkerQueue & queue = *_queues[scheduledTask.queue];
+		lock_guard <mutex> lock(queue.mutex);
+		queue.tasks[priority].push_back(scheduledTask);
+	}
+
+	{
+		lock_guard <mutex> lock(_mutex);
+		_numberOfPendingTasks++;
+		_generation++;
+	}
+	_taskAvailable.notify_one();
+}
+
+bool TaskScheduler::tryTakeTask(int workerIndex, ScheduledTask & scheduledTask, int & slot)
+{
+	shared_lock <shared_mutex> queuesLock(_queuesMutex);
+
+	const int numberOfQueues = (int)_queues.size();
+	bool taskFound = false;
+
+	for (int priority = 0; (priority < TP_NUMBER_OF_PRIORITIES) && !taskFound; priority++)
+	{
+		//own queue first (oldest task), then steal from the others (newest task).
+		//Tasks of groups running with their maximum concurrency are skipped
+		for (int i = 0; (i < numberOfQueues) && !taskFound; i++)
+		{
+			const bool isOwnQueue = (i == 0);
+			WorkerQueue & queue = *_queues[(workerIndex + i) % numberOfQueues];
+			deque <ScheduledTask> & tasks = queue.tasks[priority];
+
+			lock_guard <mutex> lock(queue.mutex);
+
+			for (size_t j = 0; (j < tasks.size()) && !taskFound; j++)
+			{
+				const size_t taskIndex = isOwnQueue ? j : tasks.size() - 1 - j;
+				if (!tasks[taskIndex].group->tryAcquireSlot(workerIndex, !isOwnQueue, slot))
+					continue;
+
+				scheduledTask = tasks[taskIndex];
+				tasks.erase(tasks.begin() + taskIndex);
+				taskFound = true;
+			}
+		}
+	}
+
+	if (taskFound)
+	{
+		lock_guard <mutex> lock(_mutex);
+		_numberOfPendingTasks--;
+		_numberOfRunningTasks++;
+	}
+
+	return taskFound;
+}
+
+void TaskScheduler::execute(ScheduledTask & scheduledTask, int slot)
+{
+	try
+	{
+		scheduledTask.task(slot);
+	}
+	catch (...)
+	{
+		//tasks must report their errors themselves
+	}
+
+	{
+		lock_guard <mutex> lock(_mutex);
+		_numberOfRunningTasks--;
+	}
+
+	//pending tasks of the group might wait for the released slot
+	if (scheduledTask.group->taskFinished(slot))
+		notifyTaskAvailable();
+}
+
+void TaskScheduler::workerLoop(int workerIndex)
+{
+	currentScheduler = this;
+	currentWorkerIndex = workerIndex;
+
+#ifdef _WINDOWS
+	//rate nodes of the parsed equations are COM objects (s. Simulation::FinalizeFormulas)
+	CoInitializeEx(NULL, COINIT_MULTITHREADED);
+#endif
+
+	while (true)
+	{
+		unsigned long long generation;
+		{
+			lock_guard <mutex> lock(_mutex);
+			generation = _generation;
+		}
+
+		ScheduledTask scheduledTask;
+		int slot;
+
+		if (tryTakeTask(workerIndex, scheduledTask, slot))
+		{
+			execute(scheduledTask, slot);
+			continue;
+		}
+
+		//nothing executable: wait for new tasks or released slots
+		unique_lock <mutex> lock(_mutex);
+		_taskAvailable.wait(lock, [&] { return _generation != generation; });
+	}
+}
+
+void TaskScheduler::Wait(TaskGroup & group)
+{
+	if (currentScheduler != this)
+	{
+		group.Wait();
+		return;
+	}
+
+	//called by a task: blocking the worker could dead lock if all workers wait
+	while (!group.allTasksFinished())
+	{
+		ScheduledTask scheduledTask;
+		int slot;
+
+		if (tryTakeTask(currentWorkerIndex, scheduledTask, slot))
+		{
+			execute(scheduledTask, slot);
+			continue;
+		}
+
+		unique_lock <mutex> lock(group._mutex);
+		group._allTasksFinished.wait_for(lock, chrono::milliseconds(HELPING_WAIT_INTERVAL),
+		                                 [&group] { return group._numberOfFinishedTasks == group._numberOfTasks; });
+	}
+}
+
+}//.. end "namespace SimModelNative"
@@ -39,6 +39,11 @@ bool UnaryFunctionFormula::IsZero()
 	return false;
 }
 
+FormulaLinearity UnaryFunctionFormula::Linearity()
+{
+	return (m_ArgumentFormula->Linearity() == FL_CONSTANT) ? FL_CONSTANT : FL_NONLINEAR;
+}
+
 void UnaryFunctionFormula::LoadFromXMLNode (const XMLNode & pNode)
 {
 	// Check if the current tag is actually the one we expect
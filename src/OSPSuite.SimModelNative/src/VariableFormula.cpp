@@ -24,6 +24,11 @@ bool VariableFormula::IsZero(void)
 	return false;
 }
 
+FormulaLinearity VariableFormula::Linearity()
+{
+	return FL_LINEAR;
+}
+
 void VariableFormula::LoadFromXMLNode (const XMLNode & pNode)
 {
 	 // Check if the current tag is actually the one we expect
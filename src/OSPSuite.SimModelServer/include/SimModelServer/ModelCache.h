@@ -0,0 +1,107 @@
+#ifndef _SimModelServer_ModelCache_H_
+#define _SimModelServer_ModelCache_H_
+
+#include "SimModel/Simulation.h"
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SimModelServer
+{
+
+//finalized model (template) and the copies used to run it.
+//Every run needs its own copy; copies are created on demand by cloning the template
+//(which loads and finalizes the copy again) and are kept for the next runs.
+//At most <maxNumberOfCopies> copies are created: further runs wait for a released copy
+class CachedModel
+{
+private:
+	SimModelNative::Simulation * _template;
+	std::vector <SimModelNative::Simulation *> _idleCopies;
+	size_t _numberOfCopies;
+	size_t _maxNumberOfCopies;
+	std::mutex _mutex;
+	std::condition_variable _copyReleased;
+
+	//model definition, compared on every cache hit (s. ModelCache::Find)
+	std::string _simulationXML;
+	std::vector <std::string> _variableParameters;
+	std::vector <std::string> _variableSpecies;
+	std::vector <std::string> _outputs;
+	int _numberOfTimePoints;
+
+public:
+	//loads and finalizes the model. Throws ErrorData if the model is invalid
+	CachedModel(const std::string & simulationXML, const std::vector <std::string> & variableParameters,
+	            const std::vector <std::string> & variableSpecies, const std::vector <std::string> & outputs,
+	            size_t maxNumberOfCopies);
+	~CachedModel();
+
+	//true if the model was created from exactly this definition
+	bool HasDefinition(const std::string & simulationXML, const std::vector <std::string> & variableParameters,
+	                   const std::vector <std::string> & variableSpecies, const std::vector <std::string> & outputs) const;
+
+	const std::string & SimulationXML() const;
+	const std::vector <std::string> & VariableParameters() const;
+	const std::vector <std::string> & VariableSpecies() const;
+	const std::vector <std::string> & Outputs() const;
+	int NumberOfTimePoints() const;
+
+	//copy of the model for one run (must be passed to ReleaseCopy when done)
+	SimModelNative::Simulation * AcquireCopy();
+	void ReleaseCopy(SimModelNative::Simulation * copy);
+
+	size_t NumberOfCopies();
+};
+
+//least recently used cache of finalized models, keyed by the content hash of the model
+//definition (XML, variable parameters/species and outputs).
+//Definitions are compared on every hit: a model whose hash collides with the one of
+//another cached model gets the next free key.
+//Evicted models stay alive until their running requests are finished
+class ModelCache
+{
+private:
+	typedef std::list <uint64_t> KeyList;
+
+	struct Entry
+	{
+		std::shared_ptr <CachedModel> model;
+		KeyList::iterator position;
+	};
+
+	size_t _capacity;
+	KeyList _keys; //most recently used first
+	std::unordered_map <uint64_t, Entry> _entries;
+	std::mutex _mutex;
+
+public:
+	ModelCache(size_t capacity);
+
+	static uint64_t KeyFor(const std::string & simulationXML, const std::vector <std::string> & variableParameters,
+	                       const std::vector <std::string> & variableSpecies, const std::vector <std::string> & outputs);
+
+	//NULL if not cached
+	std::shared_ptr <CachedModel> Find(uint64_t key);
+
+	//model with the given definition. <key>: hash of the definition (s. KeyFor); returns the key of the model.
+	//NULL if not cached
+	std::shared_ptr <CachedModel> Find(uint64_t & key, const std::string & simulationXML, const std::vector <std::string> & variableParameters,
+	                                   const std::vector <std::string> & variableSpecies, const std::vector <std::string> & outputs);
+
+	//adds the model and evicts the least recently used models above the capacity.
+	//If the model was added in the meantime (by another request), the cached model is returned.
+	//<key>: hash of the definition (s. KeyFor); returns the key of the model
+	std::shared_ptr <CachedModel> Add(uint64_t & key, const std::shared_ptr <CachedModel> & model);
+
+	size_t Size();
+};
+
+}//.. end "namespace SimModelServer"
+
+#endif //_SimModelServer_ModelCache_H_
@@ -0,0 +1,102 @@
+#ifndef _SimModelServer_Protocol_H_
+#define _SimModelServer_Protocol_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SimModelServer
+{
+
+//Binary protocol between simulation server and clients (local Unix domain socket,
+//so all values are transferred in the byte order of the host).
+//
+//Every message is one frame: FrameHeader followed by <payloadSize> bytes.
+//Strings are encoded as [uint32 length][characters], arrays of doubles as
+//[uint32 count][values].
+//
+//Requests and responses:
+//  MT_LOAD_MODEL  [string simulationXML][uint32 n][n strings: variable parameter entity ids]
+//                 [uint32 n][n strings: variable species entity ids][uint32 n][n strings: output entity ids]
+//              -> MT_MODEL_LOADED [uint64 modelKey][uint32 numberOfTimePoints]
+//  MT_RUN         [uint64 modelKey][doubles: values of variable parameters, then variable species]
+//              -> MT_RUN_RESULT [uint32 status][string message][uint32 numberOfOutputs][uint32 numberOfTimePoints]
+//                               [numberOfTimePoints doubles: time values][numberOfOutputs x numberOfTimePoints doubles]
+//              -> MT_UNKNOWN_MODEL if the model is not (or no longer) cached: client must load it again
+//  any request -> MT_ERROR [string message] if the request could not be processed
+//
+//Status of a run is one of PopulationRunner::IndividualRunStatus
+enum MessageType
+{
+	MT_LOAD_MODEL = 1,
+	MT_RUN = 2,
+
+	MT_MODEL_LOADED = 101,
+	MT_RUN_RESULT = 102,
+	MT_UNKNOWN_MODEL = 103,
+	MT_ERROR = 199
+};
+
+const uint32_t FRAME_MAGIC = 0x56534D53; //"SMSV"
+
+//frames above this size are rejected (protects the server against corrupt frames)
+const uint64_t MAX_PAYLOAD_SIZE = (uint64_t)1 << 30;
+
+struct FrameHeader
+{
+	uint32_t magic;
+	uint32_t type;
+	uint64_t payloadSize;
+};
+
+//serializes the payload of one frame
+class FrameWriter
+{
+private:
+	std::vector <char> _data;
+
+	void append(const void * data, size_t size);
+
+public:
+	void AddUInt32(uint32_t value);
+	void AddUInt64(uint64_t value);
+	void AddString(const std::string & value);
+	void AddStrings(const std::vector <std::string> & values);
+	void AddDoubles(const double * values, size_t count);
+
+	//values without count (count is known from other fields of the frame)
+	void AddDoubleValues(const double * values, size_t count);
+
+	const std::vector <char> & Data() const;
+};
+
+//deserializes the payload of one frame. Throws ErrorData if the payload is too short
+class FrameReader
+{
+private:
+	const std::vector <char> & _data;
+	size_t _position;
+
+	void read(void * data, size_t size);
+
+public:
+	FrameReader(const std::vector <char> & data);
+
+	uint32_t ReadUInt32();
+	uint64_t ReadUInt64();
+	std::string ReadString();
+	std::vector <std::string> ReadStrings();
+	std::vector <double> ReadDoubles();
+	void ReadDoubleValues(double * values, size_t count);
+};
+
+//reads the next frame from <socket>. Returns false if the peer closed the connection
+//before the frame started. Throws ErrorData on I/O errors or invalid frames
+bool ReadFrame(int socket, uint32_t & type, std::vector <char> & payload);
+
+//writes one frame to <socket>. Throws ErrorData on I/O errors
+void WriteFrame(int socket, uint32_t type, const std::vector <char> & payload);
+
+}//.. end "namespace SimModelServer"
+
+#endif //_SimModelServer_Protocol_H_
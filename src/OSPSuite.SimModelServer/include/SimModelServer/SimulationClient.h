@@ -0,0 +1,66 @@
+#ifndef _SimModelServer_SimulationClient_H_
+#define _SimModelServer_SimulationClient_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace SimModelServer
+{
+
+//results of one run (s. MT_RUN_RESULT in Protocol.h)
+struct RunResult
+{
+	uint32_t status;     //0 = success, 1 = success with warnings, 2 = failed
+	std::string message; //solver warnings or error message
+	uint32_t numberOfOutputs;
+	uint32_t numberOfTimePoints;
+	std::vector <double> timeValues;
+
+	//values of output i are stored at [i*numberOfTimePoints .. (i+1)*numberOfTimePoints-1]
+	std::vector <double> values;
+};
+
+//Connection to a simulation server. Not thread safe: use one client per thread.
+//All methods throw ErrorData on connection or server errors
+class SimulationClient
+{
+private:
+	struct ModelDefinition
+	{
+		std::string simulationXML;
+		std::vector <std::string> variableParameters;
+		std::vector <std::string> variableSpecies;
+		std::vector <std::string> outputs;
+
+		//key of the model on the server. Differs from the key returned by LoadModel
+		//if the model was reloaded and got another key (e.g. because of a hash collision)
+		uint64_t serverKey;
+	};
+
+	int _socket;
+
+	//definitions of the loaded models, used to reload a model evicted from the server cache
+	std::map <uint64_t, ModelDefinition> _models;
+
+	void request(uint32_t requestType, const std::vector <char> & request, uint32_t & responseType, std::vector <char> & response);
+	uint64_t loadModel(const ModelDefinition & model);
+	std::vector <char> runRequest(uint64_t serverKey, const std::vector <double> & values);
+
+public:
+	SimulationClient(const std::string & socketPath);
+	~SimulationClient();
+
+	//loads and finalizes the model on the server (or finds it in the server cache).
+	//Returns the key of the model used by Run
+	uint64_t LoadModel(const std::string & simulationXML, const std::vector <std::string> & variableParameters,
+	                   const std::vector <std::string> & variableSpecies, const std::vector <std::string> & outputs);
+
+	//<values>: values of the variable parameters followed by the values of the variable species
+	RunResult Run(uint64_t modelKey, const std::vector <double> & values);
+};
+
+}//.. end "namespace SimModelServer"
+
+#endif //_SimModelServer_SimulationClient_H_
@@ -0,0 +1,89 @@
+#ifndef _SimModelServer_SimulationServer_H_
+#define _SimModelServer_SimulationServer_H_
+
+#include "SimModelServer/ModelCache.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SimModelServer
+{
+
+//Fixed number of worker threads processing the requests of all connections.
+//The queue of pending requests is bounded: if it's full, Push() blocks the
+//connection thread, which then stops reading from its socket (back-pressure to the client)
+class RequestQueue
+{
+private:
+	std::deque <std::function<void()> > _requests;
+	size_t _capacity;
+	bool _isStopped;
+	std::mutex _mutex;
+	std::condition_variable _notEmpty;
+	std::condition_variable _notFull;
+
+	std::vector <std::thread> _workers;
+
+	void work();
+
+public:
+	RequestQueue(int numberOfWorkers, size_t capacity);
+	~RequestQueue();
+
+	//false if the queue was stopped
+	bool Push(const std::function<void()> & request);
+
+	//pending requests are still processed, then the workers are joined
+	void Stop();
+};
+
+//Local simulation server: keeps finalized models warm and runs them on request
+//(s. Protocol.h). Every connection is served by its own thread, which reads the
+//requests of the connection one by one and waits for their responses. Loading
+//and running of models is done by the workers of the request queue
+class SimulationServer
+{
+private:
+	std::string _socketPath;
+	int _listenSocket;
+	std::atomic <bool> _isStopped;
+
+	ModelCache _modelCache;
+	size_t _maxNumberOfCopiesPerModel;
+	RequestQueue _requestQueue;
+
+	//---- connections (every one served by its own detached thread)
+	int _maxNumberOfConnections;
+	std::vector <int> _connectionSockets;
+	std::mutex _connectionsMutex;
+	std::condition_variable _connectionClosed;
+
+	void serveConnection(int socket);
+
+	//process one request and return the response frame
+	uint32_t loadModel(const std::vector <char> & request, std::vector <char> & response);
+	uint32_t runModel(const std::vector <char> & request, std::vector <char> & response);
+
+public:
+	//<numberOfWorkers>: 0 = number of hardware threads
+	//<maxNumberOfCopiesPerModel>: max. number of copies used to run one cached model (0 = number of workers)
+	//<maxPendingRequests>: capacity of the request queue (0 = 4 per worker)
+	SimulationServer(const std::string & socketPath, int numberOfWorkers, size_t cacheCapacity, size_t maxNumberOfCopiesPerModel,
+	                 size_t maxPendingRequests, int maxNumberOfConnections);
+	~SimulationServer();
+
+	//accepts connections until Stop() is called. Throws ErrorData if the socket cannot be created
+	void Run();
+
+	//can be called from another thread or from a signal handler
+	void Stop();
+};
+
+}//.. end "namespace SimModelServer"
+
+#endif //_SimModelServer_SimulationServer_H_
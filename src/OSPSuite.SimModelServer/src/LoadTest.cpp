@@ -0,0 +1,163 @@
+//Load test for the simulation server: <clients> concurrent clients send <requests> run requests each,
+//with the values of the variable parameters randomly perturbed by up to +-20%.
+//Reports throughput, latency percentiles and failed runs
+
+#include "SimModelServer/SimulationClient.h"
+#include "ErrorData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace SimModelServer;
+
+static void printUsage()
+{
+	cout << "Usage: OSPSuite.SimModelLoadTest --model <simulation xml> --parameter <entity id>=<value> [--parameter ...]" << endl
+	     << "                                 --output <entity id> [--output ...] [--socket <path>] [--clients <n>] [--requests <n>]" << endl
+	     << "  --socket    Unix domain socket of the server (default: /tmp/simmodel.sock)" << endl
+	     << "  --clients   number of concurrent clients (default: 8)" << endl
+	     << "  --requests  number of run requests per client (default: 100)" << endl;
+}
+
+static double percentile(const vector <double> & sortedValues, double p)
+{
+	if (sortedValues.empty())
+		return 0.0;
+
+	size_t idx = (size_t)(p * (sortedValues.size() - 1) + 0.5);
+	return sortedValues[min(idx, sortedValues.size() - 1)];
+}
+
+int main(int argc, char * argv[])
+{
+	string socketPath = "/tmp/simmodel.sock";
+	string modelFile;
+	vector <string> parameters, outputs;
+	vector <double> parameterValues;
+	int numberOfClients = 8;
+	int numberOfRequests = 100;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		const string argument = argv[i];
+		const string value = argv[i + 1];
+
+		if (argument == "--socket")
+			socketPath = value;
+		else if (argument == "--model")
+			modelFile = value;
+		else if (argument == "--output")
+			outputs.push_back(value);
+		else if (argument == "--clients")
+			numberOfClients = max(atoi(value.c_str()), 1);
+		else if (argument == "--requests")
+			numberOfRequests = max(atoi(value.c_str()), 1);
+		else if ((argument == "--parameter") && (value.find('=') != string::npos))
+		{
+			parameters.push_back(value.substr(0, value.find('=')));
+			parameterValues.push_back(atof(value.substr(value.find('=') + 1).c_str()));
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (modelFile.empty() || outputs.empty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	ifstream modelStream(modelFile.c_str());
+	if (!modelStream)
+	{
+		cerr << "Cannot read " << modelFile << endl;
+		return 1;
+	}
+	stringstream simulationXML;
+	simulationXML << modelStream.rdbuf();
+
+	vector <double> latencies;
+	mutex latenciesMutex;
+	atomic <int> failedRuns(0), failedRequests(0);
+
+	const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	vector <thread> clients;
+	for (int clientIdx = 0; clientIdx < numberOfClients; clientIdx++)
+	{
+		clients.push_back(thread([&, clientIdx]()
+		{
+			mt19937 random(clientIdx);
+			uniform_real_distribution <double> factor(0.8, 1.2);
+			vector <double> clientLatencies;
+
+			try
+			{
+				SimulationClient client(socketPath);
+				const uint64_t modelKey = client.LoadModel(simulationXML.str(), parameters, vector <string> (), outputs);
+
+				vector <double> values(parameterValues.size());
+
+				for (int requestIdx = 0; requestIdx < numberOfRequests; requestIdx++)
+				{
+					for (size_t i = 0; i < values.size(); i++)
+						values[i] = parameterValues[i] * factor(random);
+
+					const chrono::steady_clock::time_point requestStart = chrono::steady_clock::now();
+
+					try
+					{
+						RunResult result = client.Run(modelKey, values);
+						if (result.status == 2)
+							failedRuns++;
+					}
+					catch (ErrorData &)
+					{
+						failedRequests++;
+					}
+
+					clientLatencies.push_back(chrono::duration <double, milli> (chrono::steady_clock::now() - requestStart).count());
+				}
+			}
+			catch (ErrorData & ED)
+			{
+				cerr << "Client " << clientIdx << ": " << ED.GetDescription() << endl;
+				failedRequests += numberOfRequests - (int)clientLatencies.size();
+			}
+
+			lock_guard <mutex> lock(latenciesMutex);
+			latencies.insert(latencies.end(), clientLatencies.begin(), clientLatencies.end());
+		}));
+	}
+
+	for (size_t i = 0; i < clients.size(); i++)
+		clients[i].join();
+
+	const double elapsedSeconds = chrono::duration <double> (chrono::steady_clock::now() - start).count();
+
+	sort(latencies.begin(), latencies.end());
+
+	cout << "Requests:        " << numberOfClients * numberOfRequests << " (" << numberOfClients << " clients)" << endl
+	     << "Elapsed:         " << elapsedSeconds << " s" << endl
+	     << "Throughput:      " << latencies.size() / elapsedSeconds << " runs/s" << endl
+	     << "Latency p50:     " << percentile(latencies, 0.50) << " ms" << endl
+	     << "Latency p95:     " << percentile(latencies, 0.95) << " ms" << endl
+	     << "Latency p99:     " << percentile(latencies, 0.99) << " ms" << endl
+	     << "Failed runs:     " << failedRuns << endl
+	     << "Failed requests: " << failedRequests << endl;
+
+	return (failedRuns + failedRequests) == 0 ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+#include "SimModelServer/ModelCache.h"
+#include "SimModel/SimulationTask.h"
+#include "XMLWrapper/XMLHelper.h"
+#include <algorithm>
+
+namespace SimModelServer
+{
+
+using namespace std;
+using namespace SimModelNative;
+
+CachedModel::CachedModel(const string & simulationXML, const vector <string> & variableParameters,
+                         const vector <string> & variableSpecies, const vector <string> & outputs,
+                         size_t maxNumberOfCopies)
+{
+	const char * ERROR_SOURCE = "CachedModel::CachedModel";
+	size_t i;
+
+	_numberOfCopies = 0;
+	_maxNumberOfCopies = max(maxNumberOfCopies, (size_t)1);
+
+	_simulationXML = simulationXML;
+	_variableParameters = variableParameters;
+	_variableSpecies = variableSpecies;
+	_outputs = outputs;
+	_numberOfTimePoints = 0;
+
+	_template = new Simulation();
+
+	try
+	{
+		_template->LoadFromXMLString(simulationXML);
+
+		//---- variable parameters/species must be set before finalizing
+		for (i = 0; i < _variableParameters.size(); i++)
+		{
+			Parameter * parameter = _template->Parameters().GetObjectByEntityId(_variableParameters[i]);
+			if (parameter == NULL)
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _variableParameters[i] + " is not a parameter");
+
+			parameter->SetIsFixed(false);
+			parameter->SetCalculateSensitivity(false);
+		}
+
+		for (i = 0; i < _variableSpecies.size(); i++)
+		{
+			Species * species = _template->SpeciesList().GetObjectByEntityId(_variableSpecies[i]);
+			if (species == NULL)
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _variableSpecies[i] + " is not a species");
+
+			species->SetIsFixed(false);
+		}
+
+		_template->Options().SetShowProgress(false);
+		_template->Finalize();
+
+		for (i = 0; i < _outputs.size(); i++)
+		{
+			Quantity * quantity = _template->AllQuantities().GetObjectByEntityId(_outputs[i]);
+			if ((quantity == NULL) || (dynamic_cast <Variable *> (quantity) == NULL))
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, _outputs[i] + " is not a species or observer");
+
+			if (!quantity->IsPersistable())
+				throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, quantity->GetFullName() + " is not persistable");
+		}
+
+		//+1 because of the simulation start time (s. DESolver::Solve_ODE)
+		_numberOfTimePoints = SimulationTask::NumberOfSimulatedTimeSteps(SimulationTask::OutputTimePoints(_template)) + 1;
+	}
+	catch (...)
+	{
+		delete _template;
+		throw;
+	}
+}
+
+CachedModel::~CachedModel()
+{
+	for (size_t i = 0; i < _idleCopies.size(); i++)
+		delete _idleCopies[i];
+
+	delete _template;
+}
+
+bool CachedModel::HasDefinition(const string & simulationXML, const vector <string> & variableParameters,
+                                const vector <string> & variableSpecies, const vector <string> & outputs) const
+{
+	return (_variableParameters == variableParameters) && (_variableSpecies == variableSpecies) &&
+	       (_outputs == outputs) && (_simulationXML == simulationXML);
+}
+
+const string & CachedModel::SimulationXML() const
+{
+	return _simulationXML;
+}
+
+const vector <string> & CachedModel::VariableParameters() const
+{
+	return _variableParameters;
+}
+
+const vector <string> & CachedModel::VariableSpecies() const
+{
+	return _variableSpecies;
+}
+
+const vector <string> & CachedModel::Outputs() const
+{
+	return _outputs;
+}
+
+int CachedModel::NumberOfTimePoints() const
+{
+	return _numberOfTimePoints;
+}
+
+Simulation * CachedModel::AcquireCopy()
+{
+	//template is never run: it's only read while cloning
+	unique_lock <mutex> lock(_mutex);
+
+	//waiting for a copy is cheaper than cloning (and finalizing) another one
+	_copyReleased.wait(lock, [this] { return !_idleCopies.empty() || (_numberOfCopies < _maxNumberOfCopies); });
+
+	if (!_idleCopies.empty())
+	{
+		Simulation * copy = _idleCopies.back();
+		_idleCopies.pop_back();
+		return copy;
+	}
+
+	Simulation * copy = _template->Clone(false);
+	copy->Options().SetShowProgress(false);
+	_numberOfCopies++;
+
+	return copy;
+}
+
+void CachedModel::ReleaseCopy(Simulation * copy)
+{
+	{
+		lock_guard <mutex> lock(_mutex);
+		_idleCopies.push_back(copy);
+	}
+	_copyReleased.notify_one();
+}
+
+size_t CachedModel::NumberOfCopies()
+{
+	lock_guard <mutex> lock(_mutex);
+	return _numberOfCopies;
+}
+
+ModelCache::ModelCache(size_t capacity)
+{
+	_capacity = max(capacity, (size_t)1);
+}
+
+uint64_t ModelCache::KeyFor(const string & simulationXML, const vector <string> & variableParameters,
+                            const vector <string> & variableSpecies, const vector <string> & outputs)
+{
+	//separators keep e.g. {"ab"},{} and {"a"},{"b"} apart
+	uint64_t key = XMLHelper::ContentHash(simulationXML);
+
+	const vector <string> * idLists[] = {&variableParameters, &variableSpecies, &outputs};
+	for (size_t list = 0; list < 3; list++)
+	{
+		key = XMLHelper::ContentHash(string(1, '\x1e'), key);
+		for (size_t i = 0; i < idLists[list]->size(); i++)
+			key = XMLHelper::ContentHash((*idLists[list])[i] + '\x1f', key);
+	}
+
+	return key;
+}
+
+shared_ptr <CachedModel> ModelCache::Find(uint64_t & key, const string & simulationXML, const vector <string> & variableParameters,
+                                          const vector <string> & variableSpecies, const vector <string> & outputs)
+{
+	lock_guard <mutex> lock(_mutex);
+
+	//models with colliding hashes are placed at the following keys (s. Add)
+	for (unordered_map <uint64_t, Entry>::iterator iter = _entries.find(key); iter != _entries.end(); iter = _entries.find(++key))
+	{
+		if (!iter->second.model->HasDefinition(simulationXML, variableParameters, variableSpecies, outputs))
+			continue;
+
+		_keys.splice(_keys.begin(), _keys, iter->second.position);
+		return iter->second.model;
+	}
+
+	return shared_ptr <CachedModel>();
+}
+
+shared_ptr <CachedModel> ModelCache::Find(uint64_t key)
+{
+	lock_guard <mutex> lock(_mutex);
+
+	unordered_map <uint64_t, Entry>::iterator iter = _entries.find(key);
+	if (iter == _entries.end())
+		return shared_ptr <CachedModel>();
+
+	//most recently used now
+	_keys.splice(_keys.begin(), _keys, iter->second.position);
+
+	return iter->second.model;
+}
+
+shared_ptr <CachedModel> ModelCache::Add(uint64_t & key, const shared_ptr <CachedModel> & model)
+{
+	lock_guard <mutex> lock(_mutex);
+
+	for (unordered_map <uint64_t, Entry>::iterator iter = _entries.find(key); iter != _entries.end(); iter = _entries.find(++key))
+	{
+		const shared_ptr <CachedModel> & cachedModel = iter->second.model;
+
+		if (!cachedModel->HasDefinition(model->SimulationXML(), model->VariableParameters(), model->VariableSpecies(), model->Outputs()))
+			continue; //hash collision: try the next key
+
+		_keys.splice(_keys.begin(), _keys, iter->second.position);
+		return cachedModel;
+	}
+
+	_keys.push_front(key);
+
+	Entry entry;
+	entry.model = model;
+	entry.position = _keys.begin();
+	_entries[key] = entry;
+
+	while (_entries.size() > _capacity)
+	{
+		_entries.erase(_keys.back());
+		_keys.pop_back();
+	}
+
+	return model;
+}
+
+size_t ModelCache::Size()
+{
+	lock_guard <mutex> lock(_mutex);
+	return _entries.size();
+}
+
+}//.. end "namespace SimModelServer"
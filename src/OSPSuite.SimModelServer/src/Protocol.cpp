@@ -0,0 +1,215 @@
+#include "SimModelServer/Protocol.h"
+#include "ErrorData.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace SimModelServer
+{
+
+using namespace std;
+
+void FrameWriter::append(const void * data, size_t size)
+{
+	const char * bytes = (const char *)data;
+	_data.insert(_data.end(), bytes, bytes + size);
+}
+
+void FrameWriter::AddUInt32(uint32_t value)
+{
+	append(&value, sizeof(value));
+}
+
+void FrameWriter::AddUInt64(uint64_t value)
+{
+	append(&value, sizeof(value));
+}
+
+void FrameWriter::AddString(const string & value)
+{
+	AddUInt32((uint32_t)value.size());
+	append(value.data(), value.size());
+}
+
+void FrameWriter::AddStrings(const vector <string> & values)
+{
+	AddUInt32((uint32_t)values.size());
+	for (size_t i = 0; i < values.size(); i++)
+		AddString(values[i]);
+}
+
+void FrameWriter::AddDoubles(const double * values, size_t count)
+{
+	AddUInt32((uint32_t)count);
+	AddDoubleValues(values, count);
+}
+
+void FrameWriter::AddDoubleValues(const double * values, size_t count)
+{
+	append(values, count * sizeof(double));
+}
+
+const vector <char> & FrameWriter::Data() const
+{
+	return _data;
+}
+
+FrameReader::FrameReader(const vector <char> & data)
+	: _data(data), _position(0)
+{
+}
+
+void FrameReader::read(void * data, size_t size)
+{
+	if (size > _data.size() - _position)
+		throw ErrorData(ErrorData::ED_ERROR, "FrameReader::read", "Invalid frame: unexpected end of payload");
+
+	memcpy(data, _data.data() + _position, size);
+	_position += size;
+}
+
+uint32_t FrameReader::ReadUInt32()
+{
+	uint32_t value;
+	read(&value, sizeof(value));
+	return value;
+}
+
+uint64_t FrameReader::ReadUInt64()
+{
+	uint64_t value;
+	read(&value, sizeof(value));
+	return value;
+}
+
+string FrameReader::ReadString()
+{
+	const uint32_t size = ReadUInt32();
+	if (size > _data.size() - _position)
+		throw ErrorData(ErrorData::ED_ERROR, "FrameReader::ReadString", "Invalid frame: unexpected end of payload");
+
+	string value(_data.data() + _position, size);
+	_position += size;
+
+	return value;
+}
+
+vector <string> FrameReader::ReadStrings()
+{
+	const uint32_t count = ReadUInt32();
+
+	vector <string> values;
+	for (uint32_t i = 0; i < count; i++)
+		values.push_back(ReadString());
+
+	return values;
+}
+
+vector <double> FrameReader::ReadDoubles()
+{
+	const uint32_t count = ReadUInt32();
+	if ((uint64_t)count * sizeof(double) > _data.size() - _position)
+		throw ErrorData(ErrorData::ED_ERROR, "FrameReader::ReadDoubles", "Invalid frame: unexpected end of payload");
+
+	vector <double> values(count);
+	ReadDoubleValues(values.data(), count);
+
+	return values;
+}
+
+void FrameReader::ReadDoubleValues(double * values, size_t count)
+{
+	read(values, count * sizeof(double));
+}
+
+//reads exactly <size> bytes. Returns false if the connection was closed before the first byte
+static bool readFully(int socket, void * data, size_t size)
+{
+	const char * ERROR_SOURCE = "SimModelServer::ReadFrame";
+	char * bytes = (char *)data;
+	size_t received = 0;
+
+	while (received < size)
+	{
+		ssize_t count = recv(socket, bytes + received, size - received, 0);
+
+		if ((count < 0) && (errno == EINTR))
+			continue;
+
+		if (count < 0)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, string("Cannot read from socket: ") + strerror(errno));
+
+		if (count == 0)
+		{
+			if (received == 0)
+				return false;
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Connection closed within a frame");
+		}
+
+		received += count;
+	}
+
+	return true;
+}
+
+static void writeFully(int socket, const void * data, size_t size)
+{
+	const char * bytes = (const char *)data;
+	size_t sent = 0;
+
+	while (sent < size)
+	{
+		//no SIGPIPE if the peer is gone: error is reported instead
+#ifdef MSG_NOSIGNAL
+		ssize_t count = send(socket, bytes + sent, size - sent, MSG_NOSIGNAL);
+#else
+		ssize_t count = send(socket, bytes + sent, size - sent, 0);
+#endif
+
+		if ((count < 0) && (errno == EINTR))
+			continue;
+
+		if (count < 0)
+			throw ErrorData(ErrorData::ED_ERROR, "SimModelServer::WriteFrame", string("Cannot write to socket: ") + strerror(errno));
+
+		sent += count;
+	}
+}
+
+bool ReadFrame(int socket, uint32_t & type, vector <char> & payload)
+{
+	const char * ERROR_SOURCE = "SimModelServer::ReadFrame";
+	FrameHeader header;
+
+	if (!readFully(socket, &header, sizeof(header)))
+		return false;
+
+	if (header.magic != FRAME_MAGIC)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Invalid frame: wrong magic number");
+
+	if (header.payloadSize > MAX_PAYLOAD_SIZE)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Invalid frame: payload too large");
+
+	type = header.type;
+	payload.resize((size_t)header.payloadSize);
+
+	if ((header.payloadSize > 0) && !readFully(socket, payload.data(), payload.size()))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Connection closed within a frame");
+
+	return true;
+}
+
+void WriteFrame(int socket, uint32_t type, const vector <char> & payload)
+{
+	FrameHeader header;
+	header.magic = FRAME_MAGIC;
+	header.type = type;
+	header.payloadSize = payload.size();
+
+	writeFully(socket, &header, sizeof(header));
+	writeFully(socket, payload.data(), payload.size());
+}
+
+}//.. end "namespace SimModelServer"
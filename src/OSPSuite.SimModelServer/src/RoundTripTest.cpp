@@ -0,0 +1,213 @@
+//Round trip test for the simulation server: starts a server in this process, loads and runs
+//a model by a client and compares the results with a run of the model without the server.
+//Also checks the model cache (reload of evicted models, colliding keys, number of model copies).
+//Usage: OSPSuite.SimModelRoundTripTest <directory of S3_reduced.xml>
+
+#include "SimModelServer/SimulationServer.h"
+#include "SimModelServer/SimulationClient.h"
+#include "SimModel/PopulationRunner.h"
+#include "ErrorData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace std;
+using namespace SimModelNative;
+using namespace SimModelServer;
+
+static int numberOfFailedChecks = 0;
+
+static void check(bool condition, const string & description)
+{
+	if (condition)
+		return;
+
+	cerr << "FAILED: " << description << endl;
+	numberOfFailedChecks++;
+}
+
+//values of <output> for <values> of the variable parameters, simulated without the server
+static vector <double> runDirectly(const string & simulationXML, const vector <string> & variableParameters,
+                                   const vector <double> & values, const string & output)
+{
+	Simulation simulation;
+	simulation.LoadFromXMLString(simulationXML);
+
+	for (size_t i = 0; i < variableParameters.size(); i++)
+	{
+		Parameter * parameter = simulation.Parameters().GetObjectByEntityId(variableParameters[i]);
+		parameter->SetIsFixed(false);
+		parameter->SetCalculateSensitivity(false);
+	}
+
+	simulation.Options().SetShowProgress(false);
+	simulation.Finalize();
+
+	for (size_t i = 0; i < variableParameters.size(); i++)
+		simulation.Parameters().GetObjectByEntityId(variableParameters[i])->SetInitialValue(values[i]);
+
+	bool toleranceWasReduced;
+	double newAbsTol, newRelTol;
+	simulation.RunSimulation(toleranceWasReduced, newAbsTol, newRelTol);
+
+	Quantity * quantity = simulation.AllQuantities().GetObjectByEntityId(output);
+	Variable * variable = dynamic_cast <Variable *> (quantity);
+	const int numberOfTimePoints = simulation.GetNumberOfTimePoints();
+
+	if (quantity->IsConstant(false))
+		return vector <double> (numberOfTimePoints, variable->GetValues()[0]);
+
+	return vector <double> (variable->GetValues(), variable->GetValues() + numberOfTimePoints);
+}
+
+static bool sameValues(const vector <double> & values, const vector <double> & expectedValues)
+{
+	if (values.size() != expectedValues.size())
+		return false;
+
+	//same model and solver settings: results must be (almost) identical
+	for (size_t i = 0; i < values.size(); i++)
+		if (fabs(values[i] - expectedValues[i]) > 1e-10 * max(fabs(expectedValues[i]), 1.0))
+			return false;
+
+	return true;
+}
+
+static void testClientServerRoundTrip(const string & simulationXML)
+{
+	const string socketPath = "/tmp/simmodel_roundtrip_" + to_string((int)getpid()) + ".sock";
+	const vector <string> parameters = {"A0", "k"};
+	const vector <string> outputs = {"C1"};
+	const vector <double> values = {5.0, 0.15};
+
+	//cache of one model: loading a second model evicts the first one
+	SimulationServer server(socketPath, 2, 1, 1, 0, 4);
+	future <void> serverRun = async(launch::async, [&server]() { server.Run(); });
+
+	try
+	{
+		//server is listening as soon as a client can connect
+		unique_ptr <SimulationClient> client;
+		for (int attempt = 0; !client; attempt++)
+		{
+			try
+			{
+				client.reset(new SimulationClient(socketPath));
+			}
+			catch (ErrorData &)
+			{
+				if (attempt == 100)
+					throw;
+				this_thread::sleep_for(chrono::milliseconds(50));
+			}
+		}
+
+		const uint64_t modelKey = client->LoadModel(simulationXML, parameters, vector <string> (), outputs);
+		check(client->LoadModel(simulationXML, parameters, vector <string> (), outputs) == modelKey,
+		      "same model definition gets the same key");
+
+		const vector <double> expectedValues = runDirectly(simulationXML, parameters, values, "C1");
+
+		RunResult result = client->Run(modelKey, values);
+		check(result.status == PopulationRunner::IRS_SUCCESS, "run by the server succeeds: " + result.message);
+		check((result.numberOfOutputs == 1) && (result.numberOfTimePoints == expectedValues.size()), "number of outputs and time points");
+		check(sameValues(result.values, expectedValues), "results of the server equal the results of a direct run");
+
+		//other definition of the same XML: other key, evicts the first model
+		const uint64_t otherModelKey = client->LoadModel(simulationXML, {"A0"}, vector <string> (), outputs);
+		check(otherModelKey != modelKey, "other model definition gets another key");
+
+		result = client->Run(modelKey, values);
+		check(result.status == PopulationRunner::IRS_SUCCESS, "evicted model is reloaded by the client: " + result.message);
+		check(sameValues(result.values, expectedValues), "results of the reloaded model equal the results of a direct run");
+	}
+	catch (ErrorData & ED)
+	{
+		check(false, "client/server round trip: " + ED.GetDescription());
+	}
+
+	server.Stop();
+	serverRun.get();
+}
+
+static void testModelCache(const string & simulationXML)
+{
+	const vector <string> outputs = {"C1"};
+	const vector <string> noSpecies;
+
+	shared_ptr <CachedModel> model = make_shared <CachedModel> (simulationXML, vector <string> {"A0", "k"}, noSpecies, outputs, 1);
+	shared_ptr <CachedModel> otherModel = make_shared <CachedModel> (simulationXML, vector <string> {"A0"}, noSpecies, outputs, 1);
+
+	//---- both models get the same hash
+	ModelCache cache(4);
+	const uint64_t hash = 42;
+
+	uint64_t key = hash;
+	check(cache.Add(key, model) == model, "model is added");
+	const uint64_t modelKey = key;
+
+	key = hash;
+	check(cache.Add(key, otherModel) == otherModel, "model with colliding hash is added");
+	check(key != modelKey, "model with colliding hash gets another key");
+	const uint64_t otherModelKey = key;
+
+	key = hash;
+	check(cache.Find(key, simulationXML, {"A0"}, noSpecies, outputs) == otherModel, "model with colliding hash is found by its definition");
+	check(key == otherModelKey, "key of the model with colliding hash is returned");
+
+	key = hash;
+	check(!cache.Find(key, simulationXML, {"k"}, noSpecies, outputs), "definition which is not cached is not found");
+
+	//---- no more copies than allowed: second run waits for the copy of the first one
+	Simulation * copy = model->AcquireCopy();
+	future <Simulation *> secondCopy = async(launch::async, [&model]() { return model->AcquireCopy(); });
+
+	check(secondCopy.wait_for(chrono::milliseconds(200)) == future_status::timeout, "second run waits for a copy");
+	model->ReleaseCopy(copy);
+	check(secondCopy.get() == copy, "released copy is reused");
+	model->ReleaseCopy(copy);
+
+	check(model->NumberOfCopies() == 1, "only one copy of the model is created");
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc != 2)
+	{
+		cout << "Usage: OSPSuite.SimModelRoundTripTest <directory of S3_reduced.xml>" << endl;
+		return 1;
+	}
+
+	ifstream modelStream((string(argv[1]) + "/S3_reduced.xml").c_str());
+	if (!modelStream)
+	{
+		cerr << "Cannot read " << argv[1] << "/S3_reduced.xml" << endl;
+		return 1;
+	}
+	stringstream simulationXML;
+	simulationXML << modelStream.rdbuf();
+
+	try
+	{
+		testClientServerRoundTrip(simulationXML.str());
+		testModelCache(simulationXML.str());
+	}
+	catch (ErrorData & ED)
+	{
+		check(false, ED.GetDescription());
+	}
+
+	cout << (numberOfFailedChecks == 0 ? "All checks passed" : to_string(numberOfFailedChecks) + " check(s) failed") << endl;
+
+	return numberOfFailedChecks == 0 ? 0 : 1;
+}
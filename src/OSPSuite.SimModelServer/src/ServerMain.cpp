@@ -0,0 +1,99 @@
+#include "SimModelServer/SimulationServer.h"
+#include "ErrorData.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace SimModelServer;
+
+static SimulationServer * runningServer = NULL;
+
+static void stopServer(int)
+{
+	if (runningServer != NULL)
+		runningServer->Stop();
+}
+
+static void printUsage()
+{
+	cout << "Usage: OSPSuite.SimModelServer [--socket <path>] [--workers <n>] [--cache <n>] [--copies <n>] [--queue <n>] [--connections <n>]" << endl
+	     << "  --socket       Unix domain socket to listen on (default: /tmp/simmodel.sock)" << endl
+	     << "  --workers      number of worker threads running the models (default: number of hardware threads)" << endl
+	     << "  --cache        max. number of finalized models kept in memory (default: 16)" << endl
+	     << "  --copies       max. number of copies used to run one cached model (default: number of workers)" << endl
+	     << "  --queue        max. number of pending requests (default: 4 per worker)" << endl
+	     << "  --connections  max. number of simultaneous client connections (default: 64)" << endl;
+}
+
+int main(int argc, char * argv[])
+{
+	string socketPath = "/tmp/simmodel.sock";
+	int numberOfWorkers = 0;
+	int cacheCapacity = 16;
+	int maxNumberOfCopiesPerModel = 0;
+	int maxPendingRequests = 0;
+	int maxNumberOfConnections = 64;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const string argument = argv[i];
+
+		if ((argument == "--help") || (argument == "-h"))
+		{
+			printUsage();
+			return 0;
+		}
+
+		if (i + 1 >= argc)
+		{
+			printUsage();
+			return 1;
+		}
+
+		const string value = argv[++i];
+
+		if (argument == "--socket")
+			socketPath = value;
+		else if (argument == "--workers")
+			numberOfWorkers = atoi(value.c_str());
+		else if (argument == "--cache")
+			cacheCapacity = atoi(value.c_str());
+		else if (argument == "--copies")
+			maxNumberOfCopiesPerModel = atoi(value.c_str());
+		else if (argument == "--queue")
+			maxPendingRequests = atoi(value.c_str());
+		else if (argument == "--connections")
+			maxNumberOfConnections = atoi(value.c_str());
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	try
+	{
+		SimulationServer server(socketPath, numberOfWorkers, (size_t)max(cacheCapacity, 1), (size_t)max(maxNumberOfCopiesPerModel, 0),
+		                        (size_t)max(maxPendingRequests, 0), maxNumberOfConnections);
+
+		runningServer = &server;
+		signal(SIGINT, stopServer);
+		signal(SIGTERM, stopServer);
+
+		cout << "Listening on " << socketPath << endl;
+		server.Run();
+
+		runningServer = NULL;
+	}
+	catch (ErrorData & ED)
+	{
+		cerr << ED.GetDescription() << endl;
+		return 1;
+	}
+
+	return 0;
+}
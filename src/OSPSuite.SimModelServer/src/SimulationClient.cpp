@@ -0,0 +1,146 @@
+#include "SimModelServer/SimulationClient.h"
+#include "SimModelServer/Protocol.h"
+#include "ErrorData.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace SimModelServer
+{
+
+using namespace std;
+
+SimulationClient::SimulationClient(const string & socketPath)
+{
+	const char * ERROR_SOURCE = "SimulationClient::SimulationClient";
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (socketPath.size() >= sizeof(address.sun_path))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Socket path too long: " + socketPath);
+	strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+	_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (_socket < 0)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, string("Cannot create socket: ") + strerror(errno));
+
+	if (connect(_socket, (sockaddr *)&address, sizeof(address)) != 0)
+	{
+		const string error = strerror(errno);
+		close(_socket);
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot connect to " + socketPath + ": " + error);
+	}
+}
+
+SimulationClient::~SimulationClient()
+{
+	close(_socket);
+}
+
+void SimulationClient::request(uint32_t requestType, const vector <char> & request, uint32_t & responseType, vector <char> & response)
+{
+	WriteFrame(_socket, requestType, request);
+
+	if (!ReadFrame(_socket, responseType, response))
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationClient::request", "Connection closed by server");
+
+	if (responseType == MT_ERROR)
+	{
+		FrameReader reader(response);
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationServer", reader.ReadString());
+	}
+}
+
+uint64_t SimulationClient::loadModel(const ModelDefinition & model)
+{
+	FrameWriter writer;
+	writer.AddString(model.simulationXML);
+	writer.AddStrings(model.variableParameters);
+	writer.AddStrings(model.variableSpecies);
+	writer.AddStrings(model.outputs);
+
+	uint32_t responseType;
+	vector <char> response;
+	request(MT_LOAD_MODEL, writer.Data(), responseType, response);
+
+	if (responseType != MT_MODEL_LOADED)
+		throw ErrorData(ErrorData::ED_ERROR, "SimulationClient::LoadModel", "Unexpected response from server");
+
+	FrameReader reader(response);
+	return reader.ReadUInt64();
+}
+
+uint64_t SimulationClient::LoadModel(const string & simulationXML, const vector <string> & variableParameters,
+                                     const vector <string> & variableSpecies, const vector <string> & outputs)
+{
+	ModelDefinition model;
+	model.simulationXML = simulationXML;
+	model.variableParameters = variableParameters;
+	model.variableSpecies = variableSpecies;
+	model.outputs = outputs;
+
+	const uint64_t key = loadModel(model);
+	model.serverKey = key;
+	_models[key] = model;
+
+	return key;
+}
+
+vector <char> SimulationClient::runRequest(uint64_t serverKey, const vector <double> & values)
+{
+	FrameWriter writer;
+	writer.AddUInt64(serverKey);
+	writer.AddDoubles(values.data(), values.size());
+
+	return writer.Data();
+}
+
+RunResult SimulationClient::Run(uint64_t modelKey, const vector <double> & values)
+{
+	const char * ERROR_SOURCE = "SimulationClient::Run";
+
+	map <uint64_t, ModelDefinition>::iterator model = _models.find(modelKey);
+
+	//key used by the server for the model now (s. ModelDefinition)
+	uint64_t serverKey = model != _models.end() ? model->second.serverKey : modelKey;
+
+	uint32_t responseType;
+	vector <char> response;
+	request(MT_RUN, runRequest(serverKey, values), responseType, response);
+
+	//model was evicted from the server cache (or the server was restarted): load it again
+	if (responseType == MT_UNKNOWN_MODEL)
+	{
+		if (model == _models.end())
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Model was not loaded by this client");
+
+		model->second.serverKey = loadModel(model->second);
+		request(MT_RUN, runRequest(model->second.serverKey, values), responseType, response);
+	}
+
+	if (responseType != MT_RUN_RESULT)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unexpected response from server");
+
+	FrameReader reader(response);
+	RunResult result;
+
+	result.status = reader.ReadUInt32();
+	result.message = reader.ReadString();
+	result.numberOfOutputs = reader.ReadUInt32();
+	result.numberOfTimePoints = reader.ReadUInt32();
+
+	result.timeValues.resize(result.numberOfTimePoints);
+	reader.ReadDoubleValues(result.timeValues.data(), result.timeValues.size());
+
+	result.values.resize((size_t)result.numberOfOutputs * result.numberOfTimePoints);
+	reader.ReadDoubleValues(result.values.data(), result.values.size());
+
+	return result;
+}
+
+}//.. end "namespace SimModelServer"
@@ -0,0 +1,390 @@
+#include "SimModelServer/SimulationServer.h"
+#include "SimModelServer/Protocol.h"
+#include "SimModel/PopulationRunner.h"
+#include "SimModel/MathHelper.h"
+#include "XMLWrapper/XMLHelper.h"
+
+#include <algorithm>
+#include <future>
+#include <memory>
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace SimModelServer
+{
+
+using namespace std;
+using namespace SimModelNative;
+
+//interval (in ms) for checking the stop flag while waiting for connections
+const int ACCEPT_POLLING_INTERVAL = 200;
+
+RequestQueue::RequestQueue(int numberOfWorkers, size_t capacity)
+{
+	_capacity = max(capacity, (size_t)1);
+	_isStopped = false;
+
+	for (int workerIdx = 0; workerIdx < max(numberOfWorkers, 1); workerIdx++)
+		_workers.push_back(thread(&RequestQueue::work, this));
+}
+
+RequestQueue::~RequestQueue()
+{
+	Stop();
+}
+
+bool RequestQueue::Push(const function<void()> & request)
+{
+	unique_lock <mutex> lock(_mutex);
+
+	_notFull.wait(lock, [this] { return _isStopped || (_requests.size() < _capacity); });
+	if (_isStopped)
+		return false;
+
+	_requests.push_back(request);
+	_notEmpty.notify_one();
+
+	return true;
+}
+
+void RequestQueue::work()
+{
+	while (true)
+	{
+		function<void()> request;
+		{
+			unique_lock <mutex> lock(_mutex);
+
+			_notEmpty.wait(lock, [this] { return _isStopped || !_requests.empty(); });
+			if (_requests.empty())
+				return; //stopped and nothing left
+
+			request = _requests.front();
+			_requests.pop_front();
+			_notFull.notify_one();
+		}
+
+		request();
+	}
+}
+
+void RequestQueue::Stop()
+{
+	{
+		lock_guard <mutex> lock(_mutex);
+		_isStopped = true;
+	}
+	_notEmpty.notify_all();
+	_notFull.notify_all();
+
+	for (size_t workerIdx = 0; workerIdx < _workers.size(); workerIdx++)
+		if (_workers[workerIdx].joinable())
+			_workers[workerIdx].join();
+}
+
+static int numberOfWorkersFor(int numberOfWorkers)
+{
+	return numberOfWorkers > 0 ? numberOfWorkers : max((int)thread::hardware_concurrency(), 1);
+}
+
+SimulationServer::SimulationServer(const string & socketPath, int numberOfWorkers, size_t cacheCapacity, size_t maxNumberOfCopiesPerModel,
+                                   size_t maxPendingRequests, int maxNumberOfConnections)
+	: _modelCache(cacheCapacity),
+	  _requestQueue(numberOfWorkersFor(numberOfWorkers),
+	                maxPendingRequests > 0 ? maxPendingRequests : 4 * numberOfWorkersFor(numberOfWorkers))
+{
+	_socketPath = socketPath;
+	_listenSocket = -1;
+	_isStopped = false;
+	_maxNumberOfConnections = max(maxNumberOfConnections, 1);
+
+	//more copies than workers are never used at the same time
+	_maxNumberOfCopiesPerModel = maxNumberOfCopiesPerModel > 0 ? maxNumberOfCopiesPerModel : (size_t)numberOfWorkersFor(numberOfWorkers);
+}
+
+SimulationServer::~SimulationServer()
+{
+	Stop();
+	_requestQueue.Stop();
+}
+
+void SimulationServer::Stop()
+{
+	_isStopped = true;
+}
+
+void SimulationServer::Run()
+{
+	const char * ERROR_SOURCE = "SimulationServer::Run";
+
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (_socketPath.size() >= sizeof(address.sun_path))
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Socket path too long: " + _socketPath);
+	strncpy(address.sun_path, _socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+	_listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (_listenSocket < 0)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, string("Cannot create socket: ") + strerror(errno));
+
+	//socket file of a previous (crashed) server instance
+	unlink(_socketPath.c_str());
+
+	if ((bind(_listenSocket, (sockaddr *)&address, sizeof(address)) != 0) || (listen(_listenSocket, SOMAXCONN) != 0))
+	{
+		const string error = strerror(errno);
+		close(_listenSocket);
+		_listenSocket = -1;
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Cannot listen on " + _socketPath + ": " + error);
+	}
+
+	//---- accept connections until stopped. If the max. number of connections is reached,
+	//     new connections wait in the listen backlog
+	while (!_isStopped)
+	{
+		{
+			unique_lock <mutex> lock(_connectionsMutex);
+			_connectionClosed.wait_for(lock, chrono::milliseconds(ACCEPT_POLLING_INTERVAL),
+			                           [this] { return (int)_connectionSockets.size() < _maxNumberOfConnections; });
+
+			if ((int)_connectionSockets.size() >= _maxNumberOfConnections)
+				continue;
+		}
+
+		pollfd listenPoll;
+		listenPoll.fd = _listenSocket;
+		listenPoll.events = POLLIN;
+		listenPoll.revents = 0;
+
+		if (poll(&listenPoll, 1, ACCEPT_POLLING_INTERVAL) <= 0)
+			continue;
+
+		const int connectionSocket = accept(_listenSocket, NULL, NULL);
+		if (connectionSocket < 0)
+			continue;
+
+		{
+			lock_guard <mutex> lock(_connectionsMutex);
+			_connectionSockets.push_back(connectionSocket);
+		}
+
+		thread(&SimulationServer::serveConnection, this, connectionSocket).detach();
+	}
+
+	close(_listenSocket);
+	_listenSocket = -1;
+	unlink(_socketPath.c_str());
+
+	//---- close all connections: connection threads finish their current request and exit
+	unique_lock <mutex> lock(_connectionsMutex);
+
+	for (size_t i = 0; i < _connectionSockets.size(); i++)
+		shutdown(_connectionSockets[i], SHUT_RDWR);
+
+	_connectionClosed.wait(lock, [this] { return _connectionSockets.empty(); });
+}
+
+void SimulationServer::serveConnection(int socket)
+{
+	try
+	{
+		uint32_t requestType;
+		vector <char> request;
+
+		while (!_isStopped && ReadFrame(socket, requestType, request))
+		{
+			uint32_t responseType = MT_ERROR;
+			vector <char> response;
+
+			//request is processed by a worker; the connection thread waits for the response
+			promise <void> processed;
+			future <void> responseAvailable = processed.get_future();
+
+			bool queued = _requestQueue.Push([&]()
+			{
+				try
+				{
+					if (requestType == MT_LOAD_MODEL)
+						responseType = loadModel(request, response);
+					else if (requestType == MT_RUN)
+						responseType = runModel(request, response);
+					else
+						throw ErrorData(ErrorData::ED_ERROR, "SimulationServer::serveConnection",
+						                "Unknown request type " + XMLHelper::ToString((int)requestType));
+				}
+				catch (ErrorData & ED)
+				{
+					FrameWriter error;
+					error.AddString(ED.GetDescription());
+					responseType = MT_ERROR;
+					response = error.Data();
+				}
+				catch (...)
+				{
+					FrameWriter error;
+					error.AddString("Unknown error in SimulationServer::serveConnection");
+					responseType = MT_ERROR;
+					response = error.Data();
+				}
+
+				processed.set_value();
+			});
+
+			if (!queued)
+				break; //server is stopping
+
+			responseAvailable.wait();
+
+			WriteFrame(socket, responseType, response);
+		}
+	}
+	catch (...)
+	{
+		//I/O errors or invalid frames: connection is closed
+	}
+
+	close(socket);
+
+	lock_guard <mutex> lock(_connectionsMutex);
+	_connectionSockets.erase(std::remove(_connectionSockets.begin(), _connectionSockets.end(), socket), _connectionSockets.end());
+	_connectionClosed.notify_all();
+}
+
+uint32_t SimulationServer::loadModel(const vector <char> & request, vector <char> & response)
+{
+	FrameReader reader(request);
+
+	const string simulationXML = reader.ReadString();
+	const vector <string> variableParameters = reader.ReadStrings();
+	const vector <string> variableSpecies = reader.ReadStrings();
+	const vector <string> outputs = reader.ReadStrings();
+
+	//models are loaded outside of the cache lock: loading the same model by concurrent requests is rare
+	//and results in the same cache entry
+	const uint64_t hash = ModelCache::KeyFor(simulationXML, variableParameters, variableSpecies, outputs);
+	uint64_t key = hash;
+
+	shared_ptr <CachedModel> model = _modelCache.Find(key, simulationXML, variableParameters, variableSpecies, outputs);
+	if (!model)
+	{
+		key = hash;
+		model = _modelCache.Add(key, make_shared <CachedModel> (simulationXML, variableParameters, variableSpecies, outputs, 
+		                                                        _maxNumberOfCopiesPerModel));
+	}
+
+	FrameWriter writer;
+	writer.AddUInt64(key);
+	writer.AddUInt32((uint32_t)model->NumberOfTimePoints());
+	response = writer.Data();
+
+	return MT_MODEL_LOADED;
+}
+
+uint32_t SimulationServer::runModel(const vector <char> & request, vector <char> & response)
+{
+	const char * ERROR_SOURCE = "SimulationServer::runModel";
+	size_t i;
+
+	FrameReader reader(request);
+
+	const uint64_t key = reader.ReadUInt64();
+	const vector <double> values = reader.ReadDoubles();
+
+	shared_ptr <CachedModel> model = _modelCache.Find(key);
+	if (!model)
+	{
+		response.clear();
+		return MT_UNKNOWN_MODEL;
+	}
+
+	const vector <string> & variableParameters = model->VariableParameters();
+	const vector <string> & variableSpecies = model->VariableSpecies();
+	const vector <string> & outputs = model->Outputs();
+
+	if (values.size() != variableParameters.size() + variableSpecies.size())
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Expected " +
+		                XMLHelper::ToString((int)(variableParameters.size() + variableSpecies.size())) + " values");
+
+	const int numberOfTimePoints = model->NumberOfTimePoints();
+	vector <double> timeValues(numberOfTimePoints, MathHelper::GetNaN());
+	vector <double> results(outputs.size() * numberOfTimePoints, MathHelper::GetNaN());
+
+	uint32_t status = PopulationRunner::IRS_FAILED;
+	string message;
+
+	Simulation * simulation = model->AcquireCopy();
+
+	try
+	{
+		for (i = 0; i < variableParameters.size(); i++)
+			simulation->Parameters().GetObjectByEntityId(variableParameters[i])->SetInitialValue(values[i]);
+
+		for (i = 0; i < variableSpecies.size(); i++)
+			simulation->SpeciesList().GetObjectByEntityId(variableSpecies[i])->SetInitialValue(values[variableParameters.size() + i]);
+
+		bool toleranceWasReduced;
+		double newAbsTol, newRelTol;
+		simulation->RunSimulation(toleranceWasReduced, newAbsTol, newRelTol);
+
+		if (simulation->GetNumberOfTimePoints() != numberOfTimePoints)
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unexpected number of output time points: " +
+			                XMLHelper::ToString(simulation->GetNumberOfTimePoints()));
+
+		std::copy(simulation->GetTimeValues(), simulation->GetTimeValues() + numberOfTimePoints, timeValues.begin());
+
+		for (i = 0; i < outputs.size(); i++)
+		{
+			Quantity * quantity = simulation->AllQuantities().GetObjectByEntityId(outputs[i]);
+			Variable * variable = dynamic_cast <Variable *> (quantity);
+			double * outputResults = &results[i * numberOfTimePoints];
+
+			//constant quantities have only one value
+			if (quantity->IsConstant(false))
+				std::fill(outputResults, outputResults + numberOfTimePoints, variable->GetValues()[0]);
+			else
+				std::copy(variable->GetValues(), variable->GetValues() + numberOfTimePoints, outputResults);
+		}
+
+		const TObjectVector<SolverWarning> & solverWarnings = simulation->SolverWarnings();
+		for (i = 0; i < (size_t)solverWarnings.size(); i++)
+		{
+			if (i > 0)
+				message += "\n";
+			message += "t=" + XMLHelper::ToString(solverWarnings[i]->Time()) + ": " + solverWarnings[i]->Message();
+		}
+
+		status = solverWarnings.size() == 0 ? PopulationRunner::IRS_SUCCESS : PopulationRunner::IRS_SUCCESS_WITH_WARNINGS;
+	}
+	catch (ErrorData & ED)
+	{
+		message = ED.GetDescription();
+		std::fill(results.begin(), results.end(), MathHelper::GetNaN());
+	}
+	catch (...)
+	{
+		message = "Unknown error in " + string(ERROR_SOURCE);
+		std::fill(results.begin(), results.end(), MathHelper::GetNaN());
+	}
+
+	model->ReleaseCopy(simulation);
+
+	FrameWriter writer;
+	writer.AddUInt32(status);
+	writer.AddString(message);
+	writer.AddUInt32((uint32_t)outputs.size());
+	writer.AddUInt32((uint32_t)numberOfTimePoints);
+	writer.AddDoubleValues(timeValues.data(), timeValues.size());
+	writer.AddDoubleValues(results.data(), results.size());
+	response = writer.Data();
+
+	return MT_RUN_RESULT;
+}
+
+}//.. end "namespace SimModelServer"
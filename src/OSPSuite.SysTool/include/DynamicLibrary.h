@@ -75,6 +75,7 @@
 #include "SysToolConfig.h"
 
 #include <map>
+#include <mutex>
 
 using namespace std;
 
@@ -139,6 +140,8 @@ public:
   DynamicLibrary& operator=( const DynamicLibrary& other);
 };
 
+// Process-wide cache of loaded libraries. GetLibrary can be called from any thread;
+// a library is loaded only once and never unloaded before the process ends
 class SYSTOOL_EXPORT DynamicLibraryFactory
 {
  public:
@@ -152,8 +155,7 @@ class SYSTOOL_EXPORT DynamicLibraryFactory
   static DynamicLibraryFactory* GetFactory();
 
   map<string,DynamicLibrary*> m_libraryMap;
-
-  static DynamicLibraryFactory* ms_factory;
+  mutex m_libraryMapMutex;
 };
 
 #endif // DYNAMIC_LIBRARY_H
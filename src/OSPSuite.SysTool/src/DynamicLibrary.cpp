@@ -145,8 +145,6 @@ DynamicLibrary::SetErrorMessage()
 
 // -- DynamicLibraryFactory
 
-DynamicLibraryFactory* DynamicLibraryFactory::ms_factory = NULL;
-
 DynamicLibraryFactory::DynamicLibraryFactory()
 {
 
@@ -179,6 +177,8 @@ DynamicLibraryFactory::GetLibrary( const string& libraryName )
 DynamicLibrary*
 DynamicLibraryFactory::FindLibrary( const string& libraryName )
 {
+  lock_guard<mutex> lock(m_libraryMapMutex);
+
   DynamicLibrary* library = NULL;
   map<string,DynamicLibrary*>::iterator iter = m_libraryMap.find(libraryName);
   if (iter != m_libraryMap.end())
@@ -199,12 +199,9 @@ DynamicLibraryFactory::FindLibrary( const string& libraryName )
 DynamicLibraryFactory*
 DynamicLibraryFactory::GetFactory()
 {
-  if (ms_factory == NULL)
-  {
-    static DynamicLibraryFactory factory;
-    ms_factory = &factory;
-  }
-  return ms_factory;
+  // initialization of function-local statics is thread safe
+  static DynamicLibraryFactory factory;
+  return &factory;
 }
 
   map<string,DynamicLibrary*> m_libraryMap;
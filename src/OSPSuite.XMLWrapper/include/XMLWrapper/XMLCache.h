@@ -5,6 +5,12 @@
 #include "XMLWrapper/XMLHelper.h"
 #include <cmath>
 #include <assert.h>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #if defined(linux) || defined (__APPLE__)
 #include <libxml/parser.h>
@@ -14,14 +20,41 @@
 #endif
 
 
+//Process-wide cache of the simulation schema and of the XML contents already validated with it.
+//
+//Concurrency: all public methods can be called from any thread.
+//The compiled schema is shared by concurrent validators (s. GetSchemaCache): 
+//loading a new schema does not affect validations which are already running.
+//Validation results are cached only for the schema generation they were started with
+//(s. SchemaGeneration, AddValidatedContent)
 class XMLCache
 {
 	private:
-		bool m_SchemaInitialized;
-		static XMLCache * m_Instance;
+		std::atomic<bool> m_SchemaInitialized;
+		static std::atomic<XMLCache *> m_Instance;
+		static std::mutex m_InstanceMutex;
 		std::string m_SchemaNamespace;
+		mutable std::mutex m_SchemaMutex;
+
+		//---- hashes of the XML contents validated with the current schema (s. XMLHelper::ContentHash),
+		//     most recently used first
+		std::list<uint64_t> m_ValidatedContents;
+		std::unordered_map<uint64_t, std::list<uint64_t>::iterator> m_ValidatedContentsByHash;
+		size_t m_MaximumNumberOfValidatedContents;
+		uint64_t m_NumberOfSkippedValidations;
+
+		//incremented with every schema load; 
+		//written with m_SchemaMutex and m_ValidatedContentsMutex locked, read with one of them locked
+		uint64_t m_SchemaGeneration;
+
+		mutable std::mutex m_ValidatedContentsMutex;
+
+		void clearValidatedContents();
 
 	public:
+		//default maximum number of validated XML contents remembered
+		static const size_t DEFAULT_MAXIMUM_NUMBER_OF_VALIDATED_CONTENTS = 1000;
+
 		XMLWRAPPER_EXPORT static XMLCache * GetInstance ();
 		XMLWRAPPER_EXPORT XMLCache ();
 		XMLWRAPPER_EXPORT virtual ~XMLCache ();
@@ -30,6 +63,28 @@ class XMLCache
 		XMLWRAPPER_EXPORT bool SchemaInitialized () const;
 		XMLWRAPPER_EXPORT void SetSchemaNamespace(std::string schemaNamespace);
 
+		//must be retrieved BEFORE the validator gets the schema (s. GetSchemaCache) and passed to AddValidatedContent
+		XMLWRAPPER_EXPORT uint64_t SchemaGeneration() const;
+
+		//true if an XML with <contentHash> was validated with the current schema before
+		XMLWRAPPER_EXPORT bool IsValidatedContent(uint64_t contentHash);
+
+		//XML with <contentHash> was validated successfully with the schema of <schemaGeneration>.
+		//Ignored if another schema was loaded in the meantime
+		XMLWRAPPER_EXPORT void AddValidatedContent(uint64_t contentHash, uint64_t schemaGeneration);
+
+		//least recently validated contents are forgotten if the maximum is exceeded.
+		//0: validation results are not cached
+		XMLWRAPPER_EXPORT size_t GetMaximumNumberOfValidatedContents();
+		XMLWRAPPER_EXPORT void SetMaximumNumberOfValidatedContents(size_t maximumNumber);
+		XMLWRAPPER_EXPORT size_t NumberOfValidatedContents();
+
+		//number of validations skipped because the content was validated before
+		XMLWRAPPER_EXPORT uint64_t NumberOfSkippedValidations();
+
+		//forgets all validation results and resets the number of skipped validations
+		XMLWRAPPER_EXPORT void ClearValidatedContents();
+
 #ifdef _WINDOWS
 		typedef MSXML2::IXMLDOMSchemaCollectionPtr LocalSchemaType ;
 
@@ -41,14 +96,16 @@ class XMLCache
 
 
 #if defined(linux) || defined (__APPLE__)
-		typedef xmlSchemaPtr LocalSchemaType;
+		//compiled schema is freed when the cache and all validators using it are done
+		typedef std::shared_ptr<xmlSchema> LocalSchemaType;
 
 	private:
-	    xmlSchemaPtr m_Linux_SchemaCache;
+	    std::shared_ptr<xmlSchema> m_Linux_SchemaCache;
 
 #endif
 
 	public:
+		//current schema; validators must keep it as long as they are validating
 		const LocalSchemaType GetSchemaCache () const;
 };
 
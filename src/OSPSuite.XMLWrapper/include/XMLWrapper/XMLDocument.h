@@ -50,6 +50,7 @@ class XMLWRAPPER_EXPORT XMLDocument
 
 		friend class XMLHelper;
 		friend class XMLCache;
+		friend class XMLReader;
 };
 
 #endif //_XMLDocument_H_
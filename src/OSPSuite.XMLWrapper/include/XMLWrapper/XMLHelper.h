@@ -7,6 +7,7 @@
 #include <msxml.h>
 #endif
 
+#include <cstdint>
 #include <string>
 
 // Windows only
@@ -52,6 +53,11 @@ class XMLWRAPPER_EXPORT XMLHelper
 		static std::string StringReplace (const std::string & source, const char * find, const char * replace, bool CaseSensitive = true);
 		static std::string StringReplace (const std::string & source, const std::string & find, const std::string & replace, bool CaseSensitive = true);
 		static bool IsNumeric (const std::string & aString);
+
+		//64 bit hash of <content> (xxHash64), e.g. to recognize XML already validated (s. XMLCache).
+		//<seed> allows to chain the hashes of several parts
+		static uint64_t ContentHash (const std::string & content, uint64_t seed = 0);
+		static uint64_t FileContentHash (const std::string & sFileName);
 };
 
 #endif //_XMLHelper_H_
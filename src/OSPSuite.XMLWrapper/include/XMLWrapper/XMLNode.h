@@ -2,6 +2,7 @@
 #define _XMLNode_H_
 
 #include <string>
+#include <vector>
 
 #ifdef _WINDOWS
 #pragma warning( disable : 4251)
@@ -29,12 +30,18 @@ class XMLWRAPPER_EXPORT XMLNode
 		const std::string GetNodeName () const;
 		const bool IsNull () const;
 
+		//false for text, comment, ... nodes
+		bool IsElement () const;
+
 		XMLNode Clone(bool recursive) const;
 		void FreeNode();
 
 		bool HasAttribute (const std::string & mcrName) const;
 		const std::string GetAttribute (const std::string & mcrName, const std::string & mcrDefault = "") const;
 		const double GetAttribute (const std::string & mcrName, const double mcDefault) const;
+
+		//names and values of all attributes (including namespace declarations)
+		void GetAttributes (std::vector <std::string> & names, std::vector <std::string> & values) const;
 		void SetAttribute (const std::string & mcrName, const std::string & mcrValue);
 		void SetAttribute (const std::string & mcrName, const double mcValue);
 		const bool HasName (const std::string & mcrName) const;
@@ -71,6 +78,7 @@ class XMLWRAPPER_EXPORT XMLNode
 		const bool operator != (const XMLNode & mcrRhs);
 
 		friend class XMLDocument;
+		friend class XMLReader;
 };
 
 #endif //_XMLNode_H_
@@ -0,0 +1,99 @@
+#ifndef _XMLReader_H_
+#define _XMLReader_H_
+
+#include <memory>
+#include <string>
+
+#include "XMLWrapper/XMLNode.h"
+#include "XMLWrapper/XMLDocument.h"
+
+#if defined(linux) || defined (__APPLE__)
+#include <libxml/xmlreader.h>
+#endif
+
+class XMLCache;
+
+//Forward only (pull) reader of an XML document.
+//
+//Only the current element is kept in memory: the subtree of an element is
+//created on demand (ExpandCurrentElement) and released when the reader is moved on,
+//so the memory required for reading does not grow with the size of the document.
+class XMLWRAPPER_EXPORT XMLReader
+{
+	private:
+		std::string _source; //file name (for error messages)
+
+		//subtree of the current element was expanded (and thus already read)
+		bool _expanded;
+
+#ifdef _WINDOWS
+		IUnknown * _reader; //IXmlReader
+		IUnknown * _stream; //IStream
+		int _depth;
+		std::string _name;
+		bool _isEmptyElement;
+
+		//document owning the nodes created for the current element
+		XMLDocument _nodesDocument;
+		XMLNode _currentElement;
+
+		bool readNode(int & nodeType);
+		void readCurrentElement();
+		XMLNode createElement();
+		void skipCurrentElement();
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+		xmlTextReaderPtr _reader;
+		xmlSchemaValidCtxtPtr _schemaValidationContext;
+		std::shared_ptr<xmlSchema> _schema; //used by _schemaValidationContext
+
+		int checkReadResult(int result);
+#endif
+
+		void open();
+
+		//not copyable
+		XMLReader(const XMLReader &);
+		XMLReader & operator = (const XMLReader &);
+
+	public:
+		XMLReader();
+		~XMLReader();
+
+		void OpenFile(const std::string & fileName);
+
+		//<xml> must not be changed or destroyed before the reader is closed
+		void OpenString(const std::string & xml);
+
+		void Close();
+
+		//false if the documents cannot be validated while they are read
+		static bool SupportsSchemaValidation();
+
+		//validate the document against the schema of <pCache> while reading
+		//(must be called before the first element is read)
+		void ValidateWithSchema(const XMLCache * pCache);
+
+		//moves to the next element (start tag).
+		//If <skipSubtree> is true or the current element was expanded,
+		//the child elements of the current element are skipped.
+		//Returns false at the end of the document
+		bool NextElement(bool skipSubtree = false);
+
+		//depth of the current element (root element: 0)
+		int Depth() const;
+
+		//name of the current element
+		const std::string ElementName() const;
+
+		//current element with its attributes only (child nodes are not read).
+		//Node is owned by the reader and valid only until the reader is moved on
+		XMLNode CurrentElement();
+
+		//current element with all its attributes and child nodes.
+		//Node is owned by the reader and valid only until the reader is moved on
+		XMLNode ExpandCurrentElement();
+};
+
+#endif //_XMLReader_H_
@@ -6,39 +6,49 @@
 #endif
 
 
-XMLCache * XMLCache::m_Instance;
+std::atomic<XMLCache *> XMLCache::m_Instance(NULL);
+std::mutex XMLCache::m_InstanceMutex;
+
 XMLCache * XMLCache::GetInstance ()
 {
 	// Implement the XML Cache as a singleton for sake of ease of use.
 
-	// Check if we already have an instance
-	if (m_Instance == NULL) {
+	// Check if we already have an instance (no locking once created)
+	XMLCache * instance = m_Instance.load(std::memory_order_acquire);
+	if (instance != NULL)
+		return instance;
+
+	std::lock_guard<std::mutex> lock(m_InstanceMutex);
 
-		// We don't. Create instance
-		m_Instance = new XMLCache();
+	// Another thread may have created the instance in the meantime
+	instance = m_Instance.load(std::memory_order_relaxed);
+	if (instance == NULL)
+	{
+		instance = new XMLCache();
+		m_Instance.store(instance, std::memory_order_release);
 	}
 
 	// Return pointer to instance.
-	return m_Instance;
+	return instance;
 }
 
 XMLCache::XMLCache ()
 {
-	m_Instance = NULL;
 	m_SchemaInitialized = false;
 	m_SchemaNamespace = "http://www.pk-sim.com/SimModelSchema";//for backwards compatibility
+	m_MaximumNumberOfValidatedContents = DEFAULT_MAXIMUM_NUMBER_OF_VALIDATED_CONTENTS;
+	m_NumberOfSkippedValidations = 0;
+	m_SchemaGeneration = 0;
 
 #ifdef _WINDOWS
 	m_Windows_SchemaCache = NULL;
 #endif
-#if defined(linux) || defined (__APPLE__)
-	m_Linux_SchemaCache = NULL;
-#endif
 }
 
 XMLCache::~XMLCache ()
 {
-	m_Instance = NULL;
+	XMLCache * instance = this;
+	m_Instance.compare_exchange_strong(instance, NULL);
 
 #ifdef _WINDOWS
 	if (m_Windows_SchemaCache)
@@ -47,11 +57,7 @@ XMLCache::~XMLCache ()
 	}
 #endif
 #if defined(linux) || defined (__APPLE__)
-    if (m_Linux_SchemaCache)
-    {
-      xmlSchemaFree(m_Linux_SchemaCache);
-      m_Linux_SchemaCache = NULL;
-    }
+    m_Linux_SchemaCache.reset();
     xmlSchemaCleanupTypes();
 #endif
 }
@@ -125,22 +131,46 @@ bool XMLCache::SchemaInitialized () const
 
 void XMLCache::LoadSchemaFromXMLDom (XMLDocument pXMLDoc)
 {
+	std::lock_guard<std::mutex> lock(m_SchemaMutex);
+
+    //contents validated with the previous schema must be validated again;
+    //validations still running with the previous schema are not cached anymore
+    {
+      std::lock_guard<std::mutex> validatedContentsLock(m_ValidatedContentsMutex);
+      clearValidatedContents();
+      m_SchemaGeneration++;
+    }
+
 #ifdef _WINDOWS
     assert(!pXMLDoc.IsNull());
 
-    m_Windows_SchemaCache.CreateInstance(__uuidof(MSXML2::XMLSchemaCache60));
-    m_Windows_SchemaCache->add(m_SchemaNamespace.c_str(), pXMLDoc.m_Windows_DocumentPtr.GetInterfacePtr());
+    //previous schema collection is kept by validators still using it
+    MSXML2::IXMLDOMSchemaCollectionPtr schemaCache;
+    schemaCache.CreateInstance(__uuidof(MSXML2::XMLSchemaCache60));
+    schemaCache->add(m_SchemaNamespace.c_str(), pXMLDoc.m_Windows_DocumentPtr.GetInterfacePtr());
+
+    m_Windows_SchemaCache = schemaCache;
     m_SchemaInitialized = true;
 #endif
 #if defined(linux) || defined (__APPLE__)
     xmlSchemaParserCtxtPtr ctxt;
+
+    // previous schema is replaced (and freed as soon as validators still using it are done)
+    m_Linux_SchemaCache.reset();
+    m_SchemaInitialized = false;
+
     ctxt = xmlSchemaNewDocParserCtxt(pXMLDoc.m_Linux_DocumentPtr);
     xmlSchemaSetParserErrors(ctxt,
         (xmlSchemaValidityErrorFunc) fprintf,
         (xmlSchemaValidityWarningFunc) fprintf,
         stderr);
-    m_Linux_SchemaCache = xmlSchemaParse(ctxt);
+    xmlSchemaPtr schema = xmlSchemaParse(ctxt);
     xmlSchemaFreeParserCtxt(ctxt);
+
+    if (schema == NULL)
+      throw ErrorData(ErrorData::ED_ERROR, "XMLCache::LoadSchemaFromXMLDom", "Schema could not be parsed");
+
+    m_Linux_SchemaCache = std::shared_ptr<xmlSchema>(schema, xmlSchemaFree);
     m_SchemaInitialized = true;
 
 #endif
@@ -148,11 +178,14 @@ void XMLCache::LoadSchemaFromXMLDom (XMLDocument pXMLDoc)
 
 void XMLCache::SetSchemaNamespace(std::string schemaNamespace)
 {
+	std::lock_guard<std::mutex> lock(m_SchemaMutex);
 	m_SchemaNamespace = schemaNamespace;
 }
 
 const XMLCache::LocalSchemaType XMLCache::GetSchemaCache () const
 {
+	std::lock_guard<std::mutex> lock(m_SchemaMutex);
+
 #ifdef _WINDOWS
     return m_Windows_SchemaCache;
 #endif
@@ -163,3 +196,91 @@ const XMLCache::LocalSchemaType XMLCache::GetSchemaCache () const
 #endif
 }
 
+
+void XMLCache::clearValidatedContents()
+{
+	m_ValidatedContents.clear();
+	m_ValidatedContentsByHash.clear();
+}
+
+uint64_t XMLCache::SchemaGeneration() const
+{
+	//a schema load in progress holds the schema mutex until the new schema is set,
+	//so the generation returned here is never newer than the schema got afterwards
+	std::lock_guard<std::mutex> lock(m_SchemaMutex);
+	return m_SchemaGeneration;
+}
+
+bool XMLCache::IsValidatedContent(uint64_t contentHash)
+{
+	std::lock_guard<std::mutex> lock(m_ValidatedContentsMutex);
+
+	auto iter = m_ValidatedContentsByHash.find(contentHash);
+	if (iter == m_ValidatedContentsByHash.end())
+		return false;
+
+	m_ValidatedContents.splice(m_ValidatedContents.begin(), m_ValidatedContents, iter->second);
+	m_NumberOfSkippedValidations++;
+
+	return true;
+}
+
+void XMLCache::AddValidatedContent(uint64_t contentHash, uint64_t schemaGeneration)
+{
+	std::lock_guard<std::mutex> lock(m_ValidatedContentsMutex);
+
+	if ((m_MaximumNumberOfValidatedContents == 0) || (schemaGeneration != m_SchemaGeneration))
+		return;
+
+	//same content might have been validated by another thread in the meantime
+	if (m_ValidatedContentsByHash.find(contentHash) != m_ValidatedContentsByHash.end())
+		return;
+
+	m_ValidatedContents.push_front(contentHash);
+	m_ValidatedContentsByHash[contentHash] = m_ValidatedContents.begin();
+
+	while (m_ValidatedContents.size() > m_MaximumNumberOfValidatedContents)
+	{
+		m_ValidatedContentsByHash.erase(m_ValidatedContents.back());
+		m_ValidatedContents.pop_back();
+	}
+}
+
+size_t XMLCache::GetMaximumNumberOfValidatedContents()
+{
+	std::lock_guard<std::mutex> lock(m_ValidatedContentsMutex);
+	return m_MaximumNumberOfValidatedContents;
+}
+
+void XMLCache::SetMaximumNumberOfValidatedContents(size_t maximumNumber)
+{
+	std::lock_guard<std::mutex> lock(m_ValidatedContentsMutex);
+
+	m_MaximumNumberOfValidatedContents = maximumNumber;
+
+	while (m_ValidatedContents.size() > m_MaximumNumberOfValidatedContents)
+	{
+		m_ValidatedContentsByHash.erase(m_ValidatedContents.back());
+		m_ValidatedContents.pop_back();
+	}
+}
+
+size_t XMLCache::NumberOfValidatedContents()
+{
+	std::lock_guard<std::mutex> lock(m_ValidatedContentsMutex);
+	return m_ValidatedContents.size();
+}
+
+uint64_t XMLCache::NumberOfSkippedValidations()
+{
+	std::lock_guard<std::mutex> lock(m_ValidatedContentsMutex);
+	return m_NumberOfSkippedValidations;
+}
+
+void XMLCache::ClearValidatedContents()
+{
+	std::lock_guard<std::mutex> lock(m_ValidatedContentsMutex);
+
+	clearValidatedContents();
+	m_NumberOfSkippedValidations = 0;
+}
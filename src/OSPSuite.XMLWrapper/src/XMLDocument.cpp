@@ -9,7 +9,17 @@
 #endif
 
 #if defined(linux) || defined (__APPLE__)
+#include <mutex>
+
 static const char* gs_xmlEncoding = "UTF-8";
+
+// libxml2 global state must be initialized once, before documents are 
+// parsed or created from several threads at the same time
+static void initializeParser()
+{
+	static std::once_flag parserInitialized;
+	std::call_once(parserInitialized, xmlInitParser);
+}
 #endif
 
 XMLDocument::XMLDocument()
@@ -90,6 +100,7 @@ void XMLDocument::Create()
 
 #if defined(linux) || defined (__APPLE__)
     // ============================================= LINUX
+  initializeParser();
   m_Linux_DocumentPtr = xmlNewDoc(BAD_CAST "1.0");
   if(m_Linux_DocumentPtr == NULL)
     throw "Creating XML Document failed";
@@ -199,6 +210,8 @@ XMLDocument XMLDocument::FromString (const std::string & mcrXML)
 #if defined(linux) || defined (__APPLE__)
 		// ========================================================== LINUX
 
+		initializeParser();
+
 		// Read document from memory
 		ret.m_Linux_DocumentPtr =
 			xmlReadMemory(mcrXML.c_str(), mcrXML.size(), "noname.xml", NULL, XML_PARSE_NOBLANKS | XML_PARSE_XINCLUDE);
@@ -321,6 +334,8 @@ XMLDocument XMLDocument::FromFile (const std::string & mcrFilename)
 #if defined(linux) || defined (__APPLE__)
 	// ============================================= LINUX
 
+	initializeParser();
+
 	// Load XML document
 	ret.m_Linux_DocumentPtr = xmlReadFile(mcrFilename.c_str(), NULL, XML_PARSE_NOBLANKS | XML_PARSE_XINCLUDE);
 
@@ -1,4 +1,5 @@
 #include <sstream>
+#include <fstream>
 
 #include "ErrorData.h"
 #include "XMLWrapper/XMLHelper.h"
@@ -224,10 +225,13 @@ void XMLHelper::ValidateXMLDomWithSchema(XMLDocument pXMLDoc, const XMLCache* pC
 #if defined(linux) || defined (__APPLE__)
    assert(!pXMLDoc.IsNull());
    assert(pCache != NULL);
-   assert(pCache->GetSchemaCache() != NULL);
+
+   //schema stays alive during validation even if another schema is loaded in the meantime
+   XMLCache::LocalSchemaType schema = pCache->GetSchemaCache();
+   assert(schema != NULL);
 
    xmlSchemaValidCtxtPtr ctxt;
-   ctxt = xmlSchemaNewValidCtxt(pCache->GetSchemaCache());
+   ctxt = xmlSchemaNewValidCtxt(schema.get());
    xmlSchemaSetValidErrors(ctxt,
       (xmlSchemaValidityErrorFunc)fprintf,
       (xmlSchemaValidityWarningFunc)fprintf,
@@ -307,3 +311,116 @@ bool XMLHelper::IsNumeric(const std::string& aString)
    return (*pend == '\0');
 }
 
+
+//---- xxHash64 (s. https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md)
+static const uint64_t XXH_PRIME64_1 = 11400714785074694791ULL;
+static const uint64_t XXH_PRIME64_2 = 14029467366897019727ULL;
+static const uint64_t XXH_PRIME64_3 = 1609587929392839161ULL;
+static const uint64_t XXH_PRIME64_4 = 9650029242287828579ULL;
+static const uint64_t XXH_PRIME64_5 = 2870177450012600261ULL;
+
+static uint64_t xxhRotateLeft(uint64_t value, int bits)
+{
+   return (value << bits) | (value >> (64 - bits));
+}
+
+//little endian platforms only (hashes are not persisted)
+static uint64_t xxhRead64(const unsigned char* data)
+{
+   uint64_t value;
+   memcpy(&value, data, sizeof(value));
+   return value;
+}
+
+static uint32_t xxhRead32(const unsigned char* data)
+{
+   uint32_t value;
+   memcpy(&value, data, sizeof(value));
+   return value;
+}
+
+static uint64_t xxhRound(uint64_t accumulator, uint64_t input)
+{
+   accumulator += input * XXH_PRIME64_2;
+   accumulator = xxhRotateLeft(accumulator, 31);
+   return accumulator * XXH_PRIME64_1;
+}
+
+static uint64_t xxhMergeRound(uint64_t accumulator, uint64_t value)
+{
+   accumulator ^= xxhRound(0, value);
+   return accumulator * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+uint64_t XMLHelper::ContentHash(const std::string& content, uint64_t seed)
+{
+   const unsigned char* data = (const unsigned char*)content.data();
+   const unsigned char* end = data + content.size();
+   uint64_t hash;
+
+   if (content.size() >= 32)
+   {
+      uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+      uint64_t v2 = seed + XXH_PRIME64_2;
+      uint64_t v3 = seed;
+      uint64_t v4 = seed - XXH_PRIME64_1;
+
+      for (; data + 32 <= end; data += 32)
+      {
+         v1 = xxhRound(v1, xxhRead64(data));
+         v2 = xxhRound(v2, xxhRead64(data + 8));
+         v3 = xxhRound(v3, xxhRead64(data + 16));
+         v4 = xxhRound(v4, xxhRead64(data + 24));
+      }
+
+      hash = xxhRotateLeft(v1, 1) + xxhRotateLeft(v2, 7) + xxhRotateLeft(v3, 12) + xxhRotateLeft(v4, 18);
+      hash = xxhMergeRound(hash, v1);
+      hash = xxhMergeRound(hash, v2);
+      hash = xxhMergeRound(hash, v3);
+      hash = xxhMergeRound(hash, v4);
+   }
+   else
+      hash = seed + XXH_PRIME64_5;
+
+   hash += (uint64_t)content.size();
+
+   for (; data + 8 <= end; data += 8)
+   {
+      hash ^= xxhRound(0, xxhRead64(data));
+      hash = xxhRotateLeft(hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+   }
+
+   if (data + 4 <= end)
+   {
+      hash ^= (uint64_t)xxhRead32(data) * XXH_PRIME64_1;
+      hash = xxhRotateLeft(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+      data += 4;
+   }
+
+   for (; data < end; data++)
+   {
+      hash ^= (*data) * XXH_PRIME64_5;
+      hash = xxhRotateLeft(hash, 11) * XXH_PRIME64_1;
+   }
+
+   //avalanche
+   hash ^= hash >> 33;
+   hash *= XXH_PRIME64_2;
+   hash ^= hash >> 29;
+   hash *= XXH_PRIME64_3;
+   hash ^= hash >> 32;
+
+   return hash;
+}
+
+uint64_t XMLHelper::FileContentHash(const std::string& sFileName)
+{
+   std::ifstream file(sFileName.c_str(), std::ios::binary);
+   if (!file)
+      throw ErrorData(ErrorData::ED_ERROR, "XMLHelper::FileContentHash", "Unable to open file " + sFileName);
+
+   std::ostringstream content;
+   content << file.rdbuf();
+
+   return ContentHash(content.str());
+}
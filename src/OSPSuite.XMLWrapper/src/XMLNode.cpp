@@ -147,6 +147,24 @@ const bool XMLNode::IsNull () const
 #endif
 }
 
+bool XMLNode::IsElement () const
+{
+  if (IsNull())
+  {
+    throw ErrorData(ErrorData::ED_ERROR, "XMLNode::IsElement",
+        "Trying to access empty XML node.");
+  }
+#ifdef _WINDOWS
+	// ============================================= WINDOWS
+	return (m_Windows_NodePtr -> nodeType == MSXML2::NODE_ELEMENT);
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	// ============================================= LINUX
+	return (m_Linux_NodePtr -> type == XML_ELEMENT_NODE);
+#endif
+}
+
 XMLNode XMLNode::Clone(bool recursive) const
 {
   if (IsNull())
@@ -157,9 +175,8 @@ XMLNode XMLNode::Clone(bool recursive) const
   XMLNode nodeCopy;
 #ifdef _WINDOWS
   // ============================================= WINDOWS
-  // TODO: is a deep copy necessary?
-  // For now just copy the pointer
-  nodeCopy.m_Windows_NodePtr = m_Windows_NodePtr;
+  // copy is independent of the original (e.g. can be used by another thread)
+  nodeCopy.m_Windows_NodePtr = m_Windows_NodePtr->cloneNode(recursive ? VARIANT_TRUE : VARIANT_FALSE);
 #endif
 
 #if defined(linux) || defined (__APPLE__)
@@ -269,6 +286,53 @@ const double XMLNode::GetAttribute (const std::string & mcrName, const double mc
 	return XMLHelper::ToDouble(value);
 }
 
+void XMLNode::GetAttributes (std::vector <std::string> & names, std::vector <std::string> & values) const
+{
+  if (IsNull())
+  {
+    throw ErrorData(ErrorData::ED_ERROR, "XMLNode::GetAttributes",
+        "Trying to access empty XML node.");
+  }
+
+	names.clear();
+	values.clear();
+
+#ifdef _WINDOWS
+	// ============================================= WINDOWS
+	// (namespace declarations are attributes in MSXML)
+	MSXML2::IXMLDOMNamedNodeMapPtr attributes = m_Windows_NodePtr -> Getattributes();
+
+	for (long i = 0; (attributes != NULL) && (i < attributes -> Getlength()); i++)
+	{
+		MSXML2::IXMLDOMNodePtr attribute = attributes -> Getitem(i);
+
+		names.push_back(BStrToSTDString(attribute -> GetnodeName()));
+		values.push_back(BStrToSTDString(attribute -> Gettext()));
+	}
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	// ============================================= LINUX
+
+	// Namespace declarations are not stored as attributes by libxml2
+	for (xmlNsPtr ns = m_Linux_NodePtr -> nsDef; ns != NULL; ns = ns -> next)
+	{
+		names.push_back(ns -> prefix != NULL ? std::string("xmlns:") + (char *) ns -> prefix : std::string("xmlns"));
+		values.push_back(ns -> href != NULL ? (char *) ns -> href : "");
+	}
+
+	for (xmlAttrPtr attribute = m_Linux_NodePtr -> properties; attribute != NULL; attribute = attribute -> next)
+	{
+		xmlChar * value = xmlNodeListGetString(m_Linux_NodePtr -> doc, attribute -> children, 1);
+
+		names.push_back((char *) attribute -> name);
+		values.push_back(value != NULL ? (char *) value : "");
+
+		xmlFree(value);
+	}
+#endif
+}
+
 void XMLNode::SetAttribute (const std::string & mcrName, const std::string & mcrValue)
 {
   if (IsNull())
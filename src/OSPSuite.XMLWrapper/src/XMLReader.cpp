@@ -0,0 +1,501 @@
+#include "ErrorData.h"
+#include "XMLWrapper/XMLReader.h"
+#include "XMLWrapper/XMLCache.h"
+
+#ifdef _WINDOWS
+#include "XMLWrapper/WindowsHelper.h"
+#include <xmllite.h>
+#include <shlwapi.h>
+#include <vector>
+#pragma comment(lib, "xmllite.lib")
+#pragma comment(lib, "shlwapi.lib")
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+
+// s. XMLDocument.cpp
+static void initializeParser()
+{
+	static std::once_flag parserInitialized;
+	std::call_once(parserInitialized, xmlInitParser);
+}
+
+//writes schema validation errors/warnings to <stream> (stderr)
+static void writeValidationMessage(void * stream, const char * format, ...)
+{
+	va_list arguments;
+	va_start(arguments, format);
+	vfprintf((FILE *)stream, format, arguments);
+	va_end(arguments);
+}
+#endif
+
+XMLReader::XMLReader()
+{
+	_expanded = false;
+
+#ifdef _WINDOWS
+	_reader = NULL;
+	_stream = NULL;
+	_depth = -1;
+	_isEmptyElement = false;
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	_reader = NULL;
+	_schemaValidationContext = NULL;
+#endif
+}
+
+XMLReader::~XMLReader()
+{
+	try
+	{
+		Close();
+	}
+	catch (...)
+	{
+	}
+}
+
+void XMLReader::OpenFile(const std::string & fileName)
+{
+	Close();
+	_source = "XML file \"" + fileName + "\"";
+
+#ifdef _WINDOWS
+	IStream * stream = NULL;
+	HRESULT hr = SHCreateStreamOnFileA(fileName.c_str(), STGM_READ | STGM_SHARE_DENY_WRITE, &stream);
+
+	if (FAILED(hr))
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::OpenFile",
+		                "Loading of " + _source + " failed: " + DescriptionFromHResult(hr));
+
+	_stream = stream;
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	initializeParser();
+
+	_reader = xmlReaderForFile(fileName.c_str(), NULL, XML_PARSE_NOBLANKS | XML_PARSE_XINCLUDE);
+
+	if (_reader == NULL)
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::OpenFile", "Loading of " + _source + " failed.");
+#endif
+
+	open();
+}
+
+void XMLReader::OpenString(const std::string & xml)
+{
+	Close();
+	_source = "XML string";
+
+#ifdef _WINDOWS
+	IStream * stream = SHCreateMemStream((const BYTE *)xml.c_str(), (UINT)xml.size());
+
+	if (stream == NULL)
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::OpenString", "Out of memory during loading from the XML string");
+
+	_stream = stream;
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	initializeParser();
+
+	_reader = xmlReaderForMemory(xml.c_str(), (int)xml.size(), "noname.xml", NULL, XML_PARSE_NOBLANKS | XML_PARSE_XINCLUDE);
+
+	if (_reader == NULL)
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::OpenString", "Interpreting of XML string failed.");
+#endif
+
+	open();
+}
+
+void XMLReader::open()
+{
+	_expanded = false;
+
+#ifdef _WINDOWS
+	try
+	{
+		IXmlReader * reader = NULL;
+		HRESULT hr = CreateXmlReader(__uuidof(IXmlReader), (void **)&reader, NULL);
+
+		if (FAILED(hr))
+			throw ErrorData(ErrorData::ED_ERROR, "XMLReader::open", "Unable to create XML reader: " + DescriptionFromHResult(hr));
+
+		_reader = reader;
+
+		reader->SetProperty(XmlReaderProperty_DtdProcessing, DtdProcessing_Prohibit);
+
+		hr = reader->SetInput(_stream);
+		if (FAILED(hr))
+			throw ErrorData(ErrorData::ED_ERROR, "XMLReader::open", "Reading of " + _source + " failed: " + DescriptionFromHResult(hr));
+
+		_nodesDocument.Create();
+	}
+	catch (...)
+	{
+		Close();
+		throw;
+	}
+#endif
+}
+
+void XMLReader::Close()
+{
+	_expanded = false;
+
+#ifdef _WINDOWS
+	_currentElement = XMLNode();
+
+	if (!_nodesDocument.IsNull())
+		_nodesDocument.Release();
+
+	if (_reader != NULL)
+		_reader->Release();
+	_reader = NULL;
+
+	if (_stream != NULL)
+		_stream->Release();
+	_stream = NULL;
+
+	_depth = -1;
+	_name = "";
+	_isEmptyElement = false;
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	if (_reader != NULL)
+		xmlFreeTextReader(_reader);
+	_reader = NULL;
+
+	if (_schemaValidationContext != NULL)
+		xmlSchemaFreeValidCtxt(_schemaValidationContext);
+	_schemaValidationContext = NULL;
+	_schema.reset();
+#endif
+}
+
+bool XMLReader::SupportsSchemaValidation()
+{
+#ifdef _WINDOWS
+	//XmlLite is not validating
+	return false;
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	return true;
+#endif
+}
+
+void XMLReader::ValidateWithSchema(const XMLCache * pCache)
+{
+	const char * ERROR_SOURCE = "XMLReader::ValidateWithSchema";
+
+#ifdef _WINDOWS
+	throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Schema validation is not supported by the XML reader");
+#endif
+
+#if defined(linux) || defined (__APPLE__)
+	if (_reader == NULL)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "XML reader is not open");
+
+	assert(pCache != NULL);
+
+	//kept until the reader is closed (s. XMLCache::GetSchemaCache)
+	_schema = pCache->GetSchemaCache();
+	assert(_schema != NULL);
+
+	_schemaValidationContext = xmlSchemaNewValidCtxt(_schema.get());
+	if (_schemaValidationContext == NULL)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unable to create schema validation context");
+
+	//same error reporting as XMLHelper::ValidateXMLDomWithSchema
+	xmlSchemaSetValidErrors(_schemaValidationContext, writeValidationMessage, writeValidationMessage, stderr);
+
+	if (xmlTextReaderSchemaValidateCtxt(_reader, _schemaValidationContext, 0) != 0)
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unable to validate " + _source + " with schema");
+#endif
+}
+
+#if defined(linux) || defined (__APPLE__)
+
+int XMLReader::checkReadResult(int result)
+{
+	if (result < 0)
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::NextElement", "Reading of " + _source + " failed.");
+
+	return result;
+}
+
+bool XMLReader::NextElement(bool skipSubtree)
+{
+	if (_reader == NULL)
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::NextElement", "XML reader is not open");
+
+	int result = (skipSubtree || _expanded) ? xmlTextReaderNext(_reader) : xmlTextReaderRead(_reader);
+	_expanded = false;
+
+	while ((checkReadResult(result) == 1) && (xmlTextReaderNodeType(_reader) != XML_READER_TYPE_ELEMENT))
+		result = xmlTextReaderRead(_reader);
+
+	return result == 1;
+}
+
+int XMLReader::Depth() const
+{
+	return xmlTextReaderDepth(_reader);
+}
+
+const std::string XMLReader::ElementName() const
+{
+	const xmlChar * name = xmlTextReaderConstName(_reader);
+
+	return name != NULL ? std::string((const char *)name) : "";
+}
+
+XMLNode XMLReader::CurrentElement()
+{
+	XMLNode node;
+	node.m_Linux_NodePtr = xmlTextReaderCurrentNode(_reader);
+
+	if (node.IsNull())
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::CurrentElement",
+		                "Reading of element <" + ElementName() + "> of " + _source + " failed.");
+
+	return node;
+}
+
+XMLNode XMLReader::ExpandCurrentElement()
+{
+	XMLNode node;
+	node.m_Linux_NodePtr = xmlTextReaderExpand(_reader);
+
+	if (node.IsNull())
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::ExpandCurrentElement",
+		                "Reading of element <" + ElementName() + "> of " + _source + " failed.");
+
+	_expanded = true;
+
+	return node;
+}
+
+#endif
+
+#ifdef _WINDOWS
+
+bool XMLReader::readNode(int & nodeType)
+{
+	XmlNodeType xmlNodeType;
+	HRESULT hr = ((IXmlReader *)_reader)->Read(&xmlNodeType);
+
+	if (hr == S_FALSE)
+		return false; //end of document
+
+	if (FAILED(hr))
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::NextElement",
+		                "Reading of " + _source + " failed: " + DescriptionFromHResult(hr));
+
+	nodeType = (int)xmlNodeType;
+
+	return true;
+}
+
+void XMLReader::readCurrentElement()
+{
+	IXmlReader * reader = (IXmlReader *)_reader;
+
+	const WCHAR * name;
+	UINT depth;
+
+	reader->GetQualifiedName(&name, NULL);
+	reader->GetDepth(&depth);
+
+	_name = BStrToSTDString((BSTR)_bstr_t(name));
+	_depth = (int)depth;
+	_isEmptyElement = (reader->IsEmptyElement() == TRUE);
+	_expanded = false;
+}
+
+void XMLReader::skipCurrentElement()
+{
+	int nodeType;
+
+	if (_expanded || _isEmptyElement || (_depth < 0))
+		return; //nothing left to skip
+
+	while (readNode(nodeType))
+	{
+		if (nodeType != XmlNodeType_EndElement)
+			continue;
+
+		UINT depth;
+		((IXmlReader *)_reader)->GetDepth(&depth);
+
+		if ((int)depth == _depth)
+			return;
+	}
+}
+
+bool XMLReader::NextElement(bool skipSubtree)
+{
+	int nodeType;
+
+	if (_reader == NULL)
+		throw ErrorData(ErrorData::ED_ERROR, "XMLReader::NextElement", "XML reader is not open");
+
+	//release nodes of the previous element
+	_currentElement = XMLNode();
+
+	if (skipSubtree)
+		skipCurrentElement();
+
+	while (readNode(nodeType))
+	{
+		if (nodeType == XmlNodeType_Element)
+		{
+			readCurrentElement();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int XMLReader::Depth() const
+{
+	return _depth;
+}
+
+const std::string XMLReader::ElementName() const
+{
+	return _name;
+}
+
+//creates element node for the element at the current reader position, with all its attributes
+XMLNode XMLReader::createElement()
+{
+	IXmlReader * reader = (IXmlReader *)_reader;
+	const WCHAR * name;
+	const WCHAR * value;
+
+	reader->GetQualifiedName(&name, NULL);
+
+	XMLNode node;
+	node.m_Windows_NodePtr = _nodesDocument.m_Windows_DocumentPtr->createElement(_bstr_t(name));
+
+	MSXML2::IXMLDOMElementPtr element = node.m_Windows_NodePtr;
+
+	for (HRESULT hr = reader->MoveToFirstAttribute(); hr == S_OK; hr = reader->MoveToNextAttribute())
+	{
+		const WCHAR * prefix;
+		reader->GetPrefix(&prefix, NULL);
+		reader->GetQualifiedName(&name, NULL);
+
+		//namespace declarations are not relevant for the content
+		if ((wcscmp(prefix, L"xmlns") == 0) || (wcscmp(name, L"xmlns") == 0))
+			continue;
+
+		reader->GetValue(&value, NULL);
+		element->setAttribute(_bstr_t(name), _variant_t(value));
+	}
+	reader->MoveToElement();
+
+	return node;
+}
+
+XMLNode XMLReader::CurrentElement()
+{
+	if (!_expanded)
+	{
+		try
+		{
+			_currentElement = createElement();
+		}
+		catch (_com_error & e)
+		{
+			throw ErrorData(ErrorData::ED_ERROR, "XMLReader::CurrentElement (" + SourceFromComError(e) + ")",
+			                DescriptionFromComError(e));
+		}
+	}
+
+	return _currentElement;
+}
+
+XMLNode XMLReader::ExpandCurrentElement()
+{
+	const char * ERROR_SOURCE = "XMLReader::ExpandCurrentElement";
+
+	if (_expanded)
+		return _currentElement;
+
+	try
+	{
+		IXmlReader * reader = (IXmlReader *)_reader;
+
+		_currentElement = createElement();
+		_expanded = true;
+
+		if (_isEmptyElement)
+			return _currentElement;
+
+		//read the subtree of the element and create the corresponding nodes
+		std::vector <MSXML2::IXMLDOMNodePtr> openElements;
+		openElements.push_back(_currentElement.m_Windows_NodePtr);
+
+		int nodeType;
+		const WCHAR * value;
+
+		while (!openElements.empty() && readNode(nodeType))
+		{
+			switch (nodeType)
+			{
+				case XmlNodeType_Element:
+				{
+					const bool isEmptyElement = (reader->IsEmptyElement() == TRUE);
+					XMLNode child = createElement();
+
+					openElements.back()->appendChild(child.m_Windows_NodePtr);
+
+					if (!isEmptyElement)
+						openElements.push_back(child.m_Windows_NodePtr);
+
+					break;
+				}
+				case XmlNodeType_Text:
+				case XmlNodeType_CDATA:
+					reader->GetValue(&value, NULL);
+					openElements.back()->appendChild(_nodesDocument.m_Windows_DocumentPtr->createTextNode(_bstr_t(value)));
+					break;
+
+				case XmlNodeType_EndElement:
+					openElements.pop_back();
+					break;
+
+				default:
+					break; //whitespace, comments, ...
+			}
+		}
+
+		if (!openElements.empty())
+			throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE, "Unexpected end of " + _source);
+	}
+	catch (ErrorData &)
+	{
+		throw;
+	}
+	catch (_com_error & e)
+	{
+		throw ErrorData(ErrorData::ED_ERROR, ERROR_SOURCE + std::string(" (") + SourceFromComError(e) + ")",
+		                DescriptionFromComError(e));
+	}
+
+	return _currentElement;
+}
+
+#endif
@@ -9,6 +9,7 @@
 #include "SimModel/CppODEExporter.h"
 #include "SimModel/PInvokeQuantity.h"
 #include "SimModel/PInvokeSimulation.h"
+#include "SimModel/PInvokeEquationCache.h"
 #include "DynamicLibrary.h"
 
 using namespace std;
@@ -36,6 +37,14 @@ void TestLeaks(void);
 void Test1(const string& simName);
 void TestSetTablePoints();
 void TestCPPExport(const string& simName);
+void TestCloneSimulation(const string& simName, int numberOfCopies);
+void TestPreparsedModel(const string& simName, int numberOfLoads);
+void TestStreamingXMLLoad(const string& simName);
+void TestParallelFinalize(const string& simName, int maxNumberOfThreads);
+void TestEquationCache(const string& simName, int numberOfSimulations);
+void TestLoadTime(int numberOfLoads);
+void TestLazyFinalize(const string& simName);
+void TestLeanMode(const string& simName, int numberOfSimulations);
 
 void ClearDynamicLibrary();
 
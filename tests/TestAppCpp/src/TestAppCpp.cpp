@@ -2,6 +2,7 @@
 #include <thread>
 //#include <vld.h>
 #include <windows.h>
+#include <psapi.h>
 #include <ppl.h>
 
 using namespace concurrency;
@@ -19,11 +20,19 @@ int main(int argc, char** argv)
       string simName;
 //      simName = "CPPExportTest01";
 //      simName = "Test_dynamic_reduced_3"; 
-//      simName = "SimModel4_ExampleInput06_Modified";
+      simName = "SimModel4_ExampleInput06_Modified";
       //simName = "SolverError01";
 
       //TestCPPExport(simName);
       //Test1(simName);
+      TestCloneSimulation(simName, 10);
+      //TestPreparsedModel(simName, 10);
+      //TestStreamingXMLLoad(simName);
+      //TestParallelFinalize(simName, 8);
+      //TestEquationCache(simName, 5);
+      //TestLoadTime(10);
+      //TestLazyFinalize(simName);
+      //TestLeanMode(simName, 20);
 
       TestParallel1(argc, argv);
    }
@@ -297,4 +306,400 @@ void TestCPPExport(const string& simName)
          DisposeSimulation(sim);
       throw;
    }
-}
\ No newline at end of file
+}
+
+//compares the time required for creating <numberOfCopies> finalized instances of a simulation
+//by loading+finalizing from the XML string with the time required for cloning a finalized simulation
+void TestCloneSimulation(const string& simName, int numberOfCopies)
+{
+   bool success;
+   char* errorMsg = NULL;
+
+   Simulation* sim = NULL;
+   vector<Simulation*> copies;
+
+   try
+   {
+      sim = LoadSimulation(simName, true);
+      FinalizeSimulation(sim);
+
+      auto simulationString = readFileIntoString(TestFileFrom(simName));
+
+      cout << endl << "Load + finalize " << numberOfCopies << " copies ... " << endl; 	fflush(stdout);
+      auto t1 = GetTickCount64();
+      for (auto i = 0; i < numberOfCopies; i++)
+      {
+         auto copy = LoadSimulationFromString(simulationString);
+         copies.push_back(copy);
+         FinalizeSimulation(copy);
+      }
+      auto t2 = GetTickCount64();
+      cout << "Load + finalize overall: "; 	fflush(stdout);
+      ShowTimeSpan(t1, t2);
+
+      for (auto copy : copies)
+         DisposeSimulation(copy);
+      copies.clear();
+
+      cout << endl << "Clone " << numberOfCopies << " copies ... "; 	fflush(stdout);
+      t1 = GetTickCount64();
+      for (auto i = 0; i < numberOfCopies; i++)
+      {
+         auto copy = CloneSimulation(sim, success, &errorMsg);
+         evalPInvokeErrorMsg(success, errorMsg);
+         copies.push_back(copy);
+      }
+      t2 = GetTickCount64();
+      ShowTimeSpan(t1, t2);
+
+      //clones must be runnable independently of the original simulation
+      for (auto copy : copies)
+         RunSimulation(copy, false);
+
+      for (auto copy : copies)
+         DisposeSimulation(copy);
+      copies.clear();
+
+      DisposeSimulation(sim);
+      sim = NULL;
+   }
+   catch (...)
+   {
+      for (auto copy : copies)
+         DisposeSimulation(copy);
+      if (sim != NULL)
+         DisposeSimulation(sim);
+      throw;
+   }
+}
+
+//compares the cold start time (load + finalize) of a simulation from the XML file
+//with the cold start time from the preparsed model of the simulation
+void TestPreparsedModel(const string& simName, int numberOfLoads)
+{
+   bool success;
+   char* errorMsg = NULL;
+
+   const string preparsedModelFile = TestFileFrom(simName) + ".smp";
+
+   Simulation* sim = LoadSimulation(simName);
+   FinalizeSimulation(sim);
+
+   SavePreparsedModel(sim, preparsedModelFile.c_str(), success, &errorMsg);
+   DisposeSimulation(sim);
+   evalPInvokeErrorMsg(success, errorMsg);
+
+   cout << endl << "Load + finalize from XML " << numberOfLoads << " times ... " << endl; 	fflush(stdout);
+   auto t1 = GetTickCount64();
+   for (auto i = 0; i < numberOfLoads; i++)
+   {
+      sim = CreateSimulation();
+      LoadSimulationFromXMLFile(sim, TestFileFrom(simName).c_str(), success, &errorMsg);
+      if (success)
+         FinalizeSimulation(sim, success, &errorMsg);
+      DisposeSimulation(sim);
+      evalPInvokeErrorMsg(success, errorMsg);
+   }
+   auto t2 = GetTickCount64();
+   cout << "Load + finalize from XML overall: "; 	fflush(stdout);
+   ShowTimeSpan(t1, t2);
+
+   cout << endl << "Load + finalize from preparsed model " << numberOfLoads << " times ... " << endl; 	fflush(stdout);
+   t1 = GetTickCount64();
+   for (auto i = 0; i < numberOfLoads; i++)
+   {
+      sim = CreateSimulation();
+      LoadSimulationFromPreparsedModel(sim, preparsedModelFile.c_str(), success, &errorMsg);
+      if (success)
+         FinalizeSimulation(sim, success, &errorMsg);
+      DisposeSimulation(sim);
+      evalPInvokeErrorMsg(success, errorMsg);
+   }
+   t2 = GetTickCount64();
+   cout << "Load + finalize from preparsed model overall: "; 	fflush(stdout);
+   ShowTimeSpan(t1, t2);
+
+   //compiled simulation must be runnable
+   sim = CreateSimulation();
+   LoadSimulationFromPreparsedModel(sim, preparsedModelFile.c_str(), success, &errorMsg);
+   if (success)
+      FinalizeSimulation(sim, success, &errorMsg);
+   if (!success)
+   {
+      DisposeSimulation(sim);
+      evalPInvokeErrorMsg(success, errorMsg);
+   }
+   RunSimulation(sim, false);
+   DisposeSimulation(sim);
+
+   remove(preparsedModelFile.c_str());
+}
+
+SIZE_T WorkingSetSize(SIZE_T& peakWorkingSetSize)
+{
+   PROCESS_MEMORY_COUNTERS counters;
+   GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+   peakWorkingSetSize = counters.PeakWorkingSetSize;
+   return counters.WorkingSetSize;
+}
+
+Simulation* LoadSimulationForMemoryTest(const string& simName, bool streamingXMLLoad,
+                                        SIZE_T& peakMemoryIncrease, SIZE_T& memoryIncrease)
+{
+   bool success;
+   char* errorMsg = NULL;
+   SIZE_T peakBefore, peakAfter;
+
+   Simulation* sim = CreateSimulation();
+
+   SimulationOptionsStructure options{};
+   FillSimulationOptions(sim, &options);
+   options.StreamingXMLLoad = streamingXMLLoad;
+   SetSimulationOptions(sim, options);
+
+   auto memoryBefore = WorkingSetSize(peakBefore);
+   LoadSimulationFromXMLFile(sim, TestFileFrom(simName).c_str(), success, &errorMsg);
+   auto memoryAfter = WorkingSetSize(peakAfter);
+
+   if (!success)
+   {
+      DisposeSimulation(sim);
+      evalPInvokeErrorMsg(success, errorMsg);
+   }
+
+   peakMemoryIncrease = peakAfter > memoryBefore ? peakAfter - memoryBefore : 0;
+   memoryIncrease = memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0;
+
+   return sim;
+}
+
+//compares peak and steady state memory of loading a simulation with and without the XML DOM.
+//Streaming load is measured first, because the peak working set of the process cannot be reset
+void TestStreamingXMLLoad(const string& simName)
+{
+   SIZE_T peakMemoryIncrease, memoryIncrease;
+
+   auto sim = LoadSimulationForMemoryTest(simName, true, peakMemoryIncrease, memoryIncrease);
+   cout << endl << "Streaming load: peak memory +" << peakMemoryIncrease / 1024 << " kB, after load +" << memoryIncrease / 1024 << " kB" << endl;
+   FinalizeSimulation(sim);
+   RunSimulation(sim, false);
+   DisposeSimulation(sim);
+
+   sim = LoadSimulationForMemoryTest(simName, false, peakMemoryIncrease, memoryIncrease);
+   cout << endl << "DOM load: peak memory +" << peakMemoryIncrease / 1024 << " kB, after load +" << memoryIncrease / 1024 << " kB" << endl;
+   FinalizeSimulation(sim);
+   RunSimulation(sim, false);
+   DisposeSimulation(sim);
+}
+
+//finalize time of a simulation for 1..<maxNumberOfThreads> finalize threads
+void TestParallelFinalize(const string& simName, int maxNumberOfThreads)
+{
+   bool success;
+   char* errorMsg = NULL;
+
+   for (auto numberOfThreads = 1; numberOfThreads <= maxNumberOfThreads; numberOfThreads++)
+   {
+      Simulation* sim = LoadSimulation(simName);
+
+      SimulationOptionsStructure options{};
+      FillSimulationOptions(sim, &options);
+      options.NumberOfFinalizeThreads = numberOfThreads;
+      SetSimulationOptions(sim, options);
+
+      auto t1 = GetTickCount64();
+      FinalizeSimulation(sim, success, &errorMsg);
+      auto t2 = GetTickCount64();
+
+      if (!success)
+      {
+         DisposeSimulation(sim);
+         evalPInvokeErrorMsg(success, errorMsg);
+      }
+
+      cout << "Finalize with " << numberOfThreads << " thread(s): "; 	fflush(stdout);
+      ShowTimeSpan(t1, t2);
+
+      DisposeSimulation(sim);
+   }
+}
+
+void TestEquationCache(const string& simName, int numberOfSimulations)
+{
+   bool success;
+   char* errorMsg = NULL;
+
+   ClearEquationCache();
+
+   //first simulation parses all equations, all others take them from the cache
+   for (auto i = 1; i <= numberOfSimulations; i++)
+   {
+      Simulation* sim = LoadSimulation(simName);
+
+      SimulationOptionsStructure options{};
+      FillSimulationOptions(sim, &options);
+      options.UseEquationCache = true;
+      SetSimulationOptions(sim, options);
+
+      auto t1 = GetTickCount64();
+      FinalizeSimulation(sim, success, &errorMsg);
+      auto t2 = GetTickCount64();
+
+      if (!success)
+      {
+         DisposeSimulation(sim);
+         evalPInvokeErrorMsg(success, errorMsg);
+      }
+
+      int size;
+      long long hits, misses, evictions;
+      GetEquationCacheStatistics(size, hits, misses, evictions);
+
+      cout << "Finalize simulation " << i << " (cached equations: " << size << ", hits: " << hits << ", misses: " << misses << "): "; 	fflush(stdout);
+      ShowTimeSpan(t1, t2);
+
+      DisposeSimulation(sim);
+   }
+
+   ClearEquationCache();
+}
+
+//load/finalize times of the largest test models and time for looking up all species/observers by path
+void TestLoadTime(int numberOfLoads)
+{
+   bool success;
+   char* errorMsg = NULL;
+
+   const string simNames[] = {"S30_negativeValues", "12.0_Brockmoller2005_CPA", "PKSim_Input_NewSchema_01"};
+
+   for (const string& simName : simNames)
+   {
+      ULONGLONG loadTime = 0, finalizeTime = 0, lookupTime = 0;
+
+      for (auto i = 0; i < numberOfLoads; i++)
+      {
+         Simulation* sim = CreateSimulation();
+
+         auto t1 = GetTickCount64();
+         LoadSimulationFromXMLFile(sim, TestFileFrom(simName).c_str(), success, &errorMsg);
+         auto t2 = GetTickCount64();
+         loadTime += t2 - t1;
+
+         if (success)
+         {
+            FinalizeSimulation(sim, success, &errorMsg);
+            finalizeTime += GetTickCount64() - t2;
+         }
+
+         if (success)
+         {
+            vector<string> paths;
+            for (auto idx = 0; idx < sim->SpeciesList().size(); idx++)
+               paths.push_back(sim->SpeciesList()[idx]->GetPathWithoutRoot());
+            for (auto idx = 0; idx < sim->Observers().size(); idx++)
+               paths.push_back(sim->Observers()[idx]->GetPathWithoutRoot());
+
+            t1 = GetTickCount64();
+            for (auto& path : paths)
+            {
+               GetQuantityByPath(sim, path.c_str(), success, &errorMsg);
+               if (!success)
+                  break;
+            }
+            lookupTime += GetTickCount64() - t1;
+         }
+
+         DisposeSimulation(sim);
+         evalPInvokeErrorMsg(success, errorMsg);
+      }
+
+      cout << simName << " (" << numberOfLoads << " times)" << endl;
+      cout << "   Load: "; 	fflush(stdout);
+      ShowTimeSpan(0, loadTime);
+      cout << "   Finalize: "; 	fflush(stdout);
+      ShowTimeSpan(0, finalizeTime);
+      cout << "   Lookup of all species/observers by path: "; 	fflush(stdout);
+      ShowTimeSpan(0, lookupTime);
+   }
+}
+
+//finalize time and memory of a simulation with and without lazy finalization
+void TestLazyFinalize(const string& simName)
+{
+   bool success;
+   char* errorMsg = NULL;
+   SIZE_T peak;
+
+   for (auto lazyFinalize : { true, false })
+   {
+      Simulation* sim = LoadSimulation(simName);
+
+      SimulationOptionsStructure options{};
+      FillSimulationOptions(sim, &options);
+      options.LazyFinalize = lazyFinalize;
+      SetSimulationOptions(sim, options);
+
+      auto memoryBefore = WorkingSetSize(peak);
+      auto t1 = GetTickCount64();
+      FinalizeSimulation(sim, success, &errorMsg);
+      auto t2 = GetTickCount64();
+      auto memoryAfter = WorkingSetSize(peak);
+
+      if (!success)
+      {
+         DisposeSimulation(sim);
+         evalPInvokeErrorMsg(success, errorMsg);
+      }
+
+      auto memoryIncrease = memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0;
+
+      cout << (lazyFinalize ? "Lazy finalize" : "Finalize") << " (deferred formulas: " << GetNumberOfDeferredFormulas(sim)
+           << ", memory +" << memoryIncrease / 1024 << " kB): "; 	fflush(stdout);
+      ShowTimeSpan(t1, t2);
+
+      RunSimulation(sim, false);
+      DisposeSimulation(sim);
+   }
+}
+
+//memory of <numberOfSimulations> finalized simulations kept at the same time, with and without lean mode
+void TestLeanMode(const string& simName, int numberOfSimulations)
+{
+   bool success;
+   char* errorMsg = NULL;
+   SIZE_T peak;
+
+   for (auto leanMode : { true, false })
+   {
+      vector<Simulation*> simulations;
+      auto memoryBefore = WorkingSetSize(peak);
+
+      for (auto i = 0; i < numberOfSimulations; i++)
+      {
+         Simulation* sim = LoadSimulation(simName);
+         simulations.push_back(sim);
+
+         SimulationOptionsStructure options{};
+         FillSimulationOptions(sim, &options);
+         options.LeanMode = leanMode;
+         SetSimulationOptions(sim, options);
+
+         FinalizeSimulation(sim, success, &errorMsg);
+         if (!success)
+            break;
+      }
+
+      auto memoryAfter = WorkingSetSize(peak);
+
+      for (auto sim : simulations)
+         DisposeSimulation(sim);
+
+      evalPInvokeErrorMsg(success, errorMsg);
+
+      auto memoryIncrease = memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0;
+
+      cout << numberOfSimulations << " simulations " << (leanMode ? "in lean mode" : "keeping the XML DOM")
+           << ": +" << memoryIncrease / 1024 << " kB (" << memoryIncrease / 1024 / numberOfSimulations << " kB per simulation)" << endl;
+   }
+}